@@ -0,0 +1,172 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchCfg.cpp
+    \brief    Benchmark configuration class
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "TAppBenchCfg.h"
+#include "TAppCommon/program_options_lite.h"
+#include "TLibCommon/TComSIMD.h"
+#ifdef WIN32
+#define strdup _strdup
+#endif
+
+using namespace std;
+namespace po = df::program_options_lite;
+
+//! \ingroup TAppBenchmark
+//! \{
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** \param argc number of arguments
+    \param argv array of arguments
+ */
+Bool TAppBenchCfg::parseCfg( Int argc, Char* argv[] )
+{
+  Bool do_help = false;
+  string cfg_InputFile;
+  string cfg_EncoderConfigFile;
+  string cfg_BitstreamFile;
+  string cfg_OutputFile;
+
+  po::Options opts;
+  opts.addOptions()
+
+  ("help", do_help, false, "this help text")
+  ("InputFile,i",         cfg_InputFile,         string(""), "raw 4:2:0 YUV input providing the picture data of the kernels and of the end-to-end encode\n"
+                                                             "synthetic data is used if omitted")
+  ("EncoderConfig,c",     cfg_EncoderConfigFile, string(""), "encoder configuration file of the end-to-end encode, which is skipped if omitted")
+  ("BitstreamFile,b",     cfg_BitstreamFile,     string(""), "bitstream of the end-to-end decode and of the picture level kernels\n"
+                                                             "written by the end-to-end encode when an encoder configuration is given\n"
+                                                             "the deblocking and transform kernels use synthetic coding data if omitted")
+  ("OutputFile,o",        cfg_OutputFile,        string("bench.json"), "JSON result file name")
+  ("SourceWidth,-wdt",    m_iSourceWidth,        0, "picture width, 832 for synthetic data")
+  ("SourceHeight,-hgt",   m_iSourceHeight,       0, "picture height, 480 for synthetic data")
+  ("InputBitDepth",       m_inputBitDepth,       8, "bit depth of the input file samples")
+  ("InternalBitDepth",    m_internalBitDepth,    0, "bit depth of the kernels (default: InputBitDepth)")
+  ("FrameRate,-fr",       m_iFrameRate,         30, "frame rate of the end-to-end encode")
+  ("FramesToBeEncoded,f", m_framesToBeEncoded,   8, "number of frames of the end-to-end encode")
+  ("Kernels",             m_kernels,             string("all"), "comma separated list of the benchmarks to run:\n"
+                                                                "rdcost, interp, trquant, deblock, sao, cabac, encode, decode or all\n"
+                                                                "the checks of the SIMD kernels against the C ones: trquant-check\n"
+                                                                "and the checks of the encoder on synthetic sequences: threads-check, subpel-check, scenecut-check")
+  ("MinTime",             m_dMinTime,          0.1, "minimum duration of one measurement in seconds")
+  ("Repetitions",         m_iRepetitions,        5, "number of measurements of each case, the median is reported")
+  ("Threads",             m_iNumThreads,         1, "number of worker threads of the end-to-end decode, and of the threaded encodes of threads-check (4 if 1)")
+  ("SIMD",                m_iSIMDLimit,         -1, "highest SIMD extension used by the kernels\n"
+                                                    "\t-1: all available, 0: none, 1: SSE4.1, 2: AVX2")
+  ;
+
+  po::setDefaults(opts);
+  const list<const Char*>& argv_unhandled = po::scanArgv(opts, argc, (const Char**) argv);
+
+  for (list<const Char*>::const_iterator it = argv_unhandled.begin(); it != argv_unhandled.end(); it++)
+  {
+    fprintf(stderr, "Unhandled argument ignored: `%s'\n", *it);
+  }
+
+  if (do_help)
+  {
+    po::doHelp(cout, opts);
+    return false;
+  }
+
+  /* convert std::string to c string for compatability */
+  m_pchInputFile         = cfg_InputFile.empty()         ? NULL : strdup(cfg_InputFile.c_str());
+  m_pchEncoderConfigFile = cfg_EncoderConfigFile.empty() ? NULL : strdup(cfg_EncoderConfigFile.c_str());
+  m_pchBitstreamFile     = cfg_BitstreamFile.empty()     ? NULL : strdup(cfg_BitstreamFile.c_str());
+  m_pchOutputFile        = cfg_OutputFile.empty()        ? NULL : strdup(cfg_OutputFile.c_str());
+
+  if (m_internalBitDepth == 0)
+  {
+    m_internalBitDepth = m_inputBitDepth;
+  }
+
+  if (!m_pchInputFile)
+  {
+    if (m_iSourceWidth  == 0) m_iSourceWidth  = 832;
+    if (m_iSourceHeight == 0) m_iSourceHeight = 480;
+  }
+
+  if (m_iSourceWidth <= 0 || m_iSourceHeight <= 0 || (m_iSourceWidth & 7) || (m_iSourceHeight & 7))
+  {
+    fprintf(stderr, "Picture size must be a positive multiple of 8, aborting\n");
+    return false;
+  }
+  if (m_iSourceWidth < 128 || m_iSourceHeight < 128)
+  {
+    fprintf(stderr, "Picture size must be at least 128x128, aborting\n");
+    return false;
+  }
+  if (m_internalBitDepth < 8 || m_internalBitDepth > 12 || m_inputBitDepth < 8 || m_inputBitDepth > 16)
+  {
+    fprintf(stderr, "Unsupported bit depth, aborting\n");
+    return false;
+  }
+  if (m_pchEncoderConfigFile && (!m_pchInputFile || !m_pchBitstreamFile))
+  {
+    fprintf(stderr, "The end-to-end encode needs an input file and a bitstream file, aborting\n");
+    return false;
+  }
+  if (m_framesToBeEncoded <= 0 || m_iFrameRate <= 0)
+  {
+    fprintf(stderr, "FramesToBeEncoded and FrameRate must be positive, aborting\n");
+    return false;
+  }
+  if (m_dMinTime <= 0 || m_iRepetitions <= 0)
+  {
+    fprintf(stderr, "MinTime and Repetitions must be positive, aborting\n");
+    return false;
+  }
+  if (m_iNumThreads <= 0)
+  {
+    fprintf(stderr, "Threads must be positive, aborting\n");
+    return false;
+  }
+  if (m_iSIMDLimit < -1 || m_iSIMDLimit >= NUMBER_OF_SIMD_EXTENSIONS)
+  {
+    fprintf(stderr, "SIMD must be in the range -1..%d, aborting\n", NUMBER_OF_SIMD_EXTENSIONS - 1);
+    return false;
+  }
+
+  return true;
+}
+
+//! \}
@@ -0,0 +1,100 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchCfg.h
+    \brief    Benchmark configuration class (header)
+*/
+
+#ifndef __TAPPBENCHCFG__
+#define __TAPPBENCHCFG__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "TLibCommon/CommonDef.h"
+#include <string>
+
+//! \ingroup TAppBenchmark
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// Benchmark configuration class
+class TAppBenchCfg
+{
+protected:
+  Char*         m_pchInputFile;                       ///< raw 4:2:0 YUV file providing the picture data, synthetic data is used if NULL
+  Char*         m_pchEncoderConfigFile;               ///< encoder configuration of the end-to-end encode, skipped if NULL
+  Char*         m_pchBitstreamFile;                   ///< bitstream of the end-to-end decode, written by the end-to-end encode
+  Char*         m_pchOutputFile;                      ///< JSON result file name
+  Int           m_iSourceWidth;                       ///< picture width
+  Int           m_iSourceHeight;                      ///< picture height
+  Int           m_inputBitDepth;                      ///< bit depth of the input file samples
+  Int           m_internalBitDepth;                   ///< bit depth of the kernels
+  Int           m_iFrameRate;                         ///< frame rate of the end-to-end encode
+  Int           m_framesToBeEncoded;                  ///< number of frames of the end-to-end encode
+  std::string   m_kernels;                            ///< comma separated list of the benchmarks to run, or "all"
+  Double        m_dMinTime;                           ///< minimum duration of one measurement in seconds
+  Int           m_iRepetitions;                       ///< number of measurements of each case, the median is reported
+  Int           m_iNumThreads;                        ///< number of worker threads of the end-to-end decode
+  Int           m_iSIMDLimit;                         ///< highest SIMD extension used by the kernels, -1 for all available
+
+public:
+  TAppBenchCfg()
+  : m_pchInputFile(NULL)
+  , m_pchEncoderConfigFile(NULL)
+  , m_pchBitstreamFile(NULL)
+  , m_pchOutputFile(NULL)
+  , m_iSourceWidth(0)
+  , m_iSourceHeight(0)
+  , m_inputBitDepth(8)
+  , m_internalBitDepth(8)
+  , m_iFrameRate(30)
+  , m_framesToBeEncoded(0)
+  , m_dMinTime(0.1)
+  , m_iRepetitions(5)
+  , m_iNumThreads(1)
+  , m_iSIMDLimit(-1)
+  {}
+
+  virtual ~TAppBenchCfg() {}
+
+  Bool  parseCfg        ( Int argc, Char* argv[] );   ///< initialize option class from configuration
+};
+
+//! \}
+
+#endif
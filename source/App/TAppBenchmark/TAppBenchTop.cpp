@@ -0,0 +1,1883 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchTop.cpp
+    \brief    Benchmark application class
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+#include "TAppBenchTop.h"
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComSIMD.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComTU.h"
+#include "TLibCommon/TComChromaFormat.h"
+#include "TLibCommon/TComLoopFilter.h"
+#include "TLibCommon/TComSampleAdaptiveOffset.h"
+#include "TLibCommon/TComBitCounter.h"
+#include "TLibCommon/TComBitStream.h"
+#include "TLibEncoder/TEncBinCoderCABAC.h"
+#include "TLibEncoder/TEncBinCoderCABACCounter.h"
+#include "TLibEncoder/TEncSbac.h"
+#include "TLibDecoder/TDecBinCoderCABAC.h"
+#include "TLibDecoder/AnnexBread.h"
+#include "TLibDecoder/NALread.h"
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+#include "TLibCommon/TComCodingStatistics.h"
+#endif
+#include "TLibVideoIO/TVideoIOYuv.h"
+#include "TAppCommon/program_options_lite.h"
+#include "../TAppEncoder/TAppEncTop.h"
+
+using namespace std;
+
+//! \ingroup TAppBenchmark
+//! \{
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+typedef std::chrono::steady_clock BenchClock;
+
+static inline Double secondsSince( const BenchClock::time_point& cStart )
+{
+  return std::chrono::duration<Double>( BenchClock::now() - cStart ).count();
+}
+
+/// linear congruential generator, the synthetic data is the same on every run
+static inline UInt nextRandom( UInt& ruiState )
+{
+  ruiState = ruiState * 1664525u + 1013904223u;
+  return ruiState >> 8;
+}
+
+/** offsets of blocks spread over the picture, so that the kernels do not only see a single hot block
+    \param iWidth, iHeight  size of the picture component
+    \param iStride          stride of the picture component
+    \param iBlkWidth, iBlkHeight  size of the blocks
+    \param iMargin          distance of the blocks from the picture edges
+ */
+static vector<Int> blockOffsets( Int iWidth, Int iHeight, Int iStride, Int iBlkWidth, Int iBlkHeight, Int iMargin )
+{
+  const Int iNumCols = 8;
+  const Int iNumRows = 8;
+  const Int iRangeX  = iWidth  - iBlkWidth  - 2 * iMargin;
+  const Int iRangeY  = iHeight - iBlkHeight - 2 * iMargin;
+
+  vector<Int> aiOffsets;
+  for ( Int y = 0; y < iNumRows; y++ )
+  {
+    for ( Int x = 0; x < iNumCols; x++ )
+    {
+      const Int iPosX = iMargin + ( iRangeX * x ) / ( iNumCols - 1 );
+      const Int iPosY = iMargin + ( iRangeY * y ) / ( iNumRows - 1 );
+      aiOffsets.push_back( iPosY * iStride + iPosX );
+    }
+  }
+  return aiOffsets;
+}
+
+static string escapeJson( const string& s )
+{
+  string result;
+  for ( size_t i = 0; i < s.size(); i++ )
+  {
+    if ( s[i] == '"' || s[i] == '\\' )
+    {
+      result += '\\';
+    }
+    result += s[i];
+  }
+  return result;
+}
+
+/// synthetic sequence of the encoder checks, CTUs of 32x32 give four CTU rows for the wavefront threads
+static const Int  CHECK_WIDTH       = 160;
+static const Int  CHECK_HEIGHT      = 128;
+static const Int  CHECK_FRAMES      = 8;
+static const Int  CHECK_CUT_FRAME   = 4;                    ///< first frame of the second scene of the scene cut check
+static const Char CHECK_INPUT_FILE[] = "bench_check.yuv";
+
+/** write the 8-bit 4:2:0 sequence of the encoder checks: a smooth pattern moving by fractional offsets over a random
+    texture moving by two samples per frame. From iCutFrame on, another pattern and texture make a scene cut.
+    \param pchFile    name of the raw YUV file
+    \param iCutFrame  first frame of the second scene, CHECK_FRAMES for a single scene
+    \returns whether the file was written
+ */
+static Bool writeCheckSequence( const Char* pchFile, Int iCutFrame )
+{
+  FILE* pFile = fopen( pchFile, "wb" );
+  if ( !pFile )
+  {
+    fprintf( stderr, "failed to open `%s' for writing\n", pchFile );
+    return false;
+  }
+
+  const Int     iTextureWidth = CHECK_WIDTH + 2 * CHECK_FRAMES;
+  vector<UChar> aucTexture[2];
+  UInt          uiState = 1;
+  for ( Int iScene = 0; iScene < 2; iScene++ )
+  {
+    aucTexture[iScene].resize( iTextureWidth * CHECK_HEIGHT );
+    for ( size_t i = 0; i < aucTexture[iScene].size(); i++ )
+    {
+      aucTexture[iScene][i] = UChar( nextRandom( uiState ) );
+    }
+  }
+
+  vector<UChar> aucFrame( CHECK_WIDTH * CHECK_HEIGHT * 3 / 2 );
+  Bool          bWritten = true;
+  for ( Int t = 0; t < CHECK_FRAMES && bWritten; t++ )
+  {
+    const Int    iScene    = t < iCutFrame ? 0 : 1;
+    const UChar* pucTexture = &aucTexture[iScene][2 * t];
+    UChar*       pucDst     = &aucFrame[0];
+
+    for ( Int y = 0; y < CHECK_HEIGHT; y++ )
+    {
+      for ( Int x = 0; x < CHECK_WIDTH; x++ )
+      {
+        const Double dPattern = 40 * sin( 0.2 * ( x + 1.25 * t ) + 2 * iScene ) * cos( 0.15 * ( y + 0.75 * t ) );
+        const Double dValue   = 128 + dPattern + 0.5 * ( pucTexture[y * iTextureWidth + x] - 128 );
+        *pucDst++ = UChar( Clip3( 0, 255, Int( floor( dValue + 0.5 ) ) ) );
+      }
+    }
+    for ( Int c = 0; c < 2; c++ )
+    {
+      for ( Int y = 0; y < CHECK_HEIGHT / 2; y++ )
+      {
+        for ( Int x = 0; x < CHECK_WIDTH / 2; x++ )
+        {
+          const Double dValue = 128 + 24 * sin( 0.3 * ( x + 0.625 * t ) + c + iScene ) * cos( 0.2 * ( y + 0.375 * t ) );
+          *pucDst++ = UChar( Clip3( 0, 255, Int( floor( dValue + 0.5 ) ) ) );
+        }
+      }
+    }
+    bWritten = fwrite( &aucFrame[0], 1, aucFrame.size(), pFile ) == aucFrame.size();
+  }
+
+  fclose( pFile );
+  return bWritten;
+}
+
+/** read a whole file
+    \param pchFile   file name
+    \param raucData  contents of the file
+    \returns whether the file could be read
+ */
+static Bool readFile( const Char* pchFile, vector<UChar>& raucData )
+{
+  raucData.clear();
+  FILE* pFile = fopen( pchFile, "rb" );
+  if ( !pFile )
+  {
+    return false;
+  }
+  UChar  aucBuffer[4096];
+  size_t uiRead;
+  while ( ( uiRead = fread( aucBuffer, 1, sizeof( aucBuffer ), pFile ) ) > 0 )
+  {
+    raucData.insert( raucData.end(), aucBuffer, aucBuffer + uiRead );
+  }
+  fclose( pFile );
+  return true;
+}
+
+/// read an unsigned Exp-Golomb code
+static UInt readUvlc( TComInputBitstream& rcBitstream )
+{
+  UInt uiLength = 0;
+  while ( rcBitstream.read( 1 ) == 0 )
+  {
+    uiLength++;
+  }
+  return ( ( 1 << uiLength ) | ( uiLength ? rcBitstream.read( uiLength ) : 0 ) ) - 1;
+}
+
+/** slice types of the pictures of a bitstream in decoding order, from the slice header of the first slice of each
+    picture. The encoder writes no extra slice header bits, so slice_type follows slice_pic_parameter_set_id.
+    \param pchFile       bitstream file name
+    \param rSliceTypes   slice type of each picture
+    \returns whether the bitstream could be read
+ */
+static Bool readSliceTypes( const Char* pchFile, vector<SliceType>& rSliceTypes )
+{
+  rSliceTypes.clear();
+  InputMappedByteStream bytestream;
+  if ( !bytestream.open( pchFile ) )
+  {
+    return false;
+  }
+
+  vector<uint8_t> nalUnitBuf;
+  while ( !bytestream.eof() )
+  {
+    const uint8_t* nalUnit     = NULL;
+    UInt           nalUnitSize = 0;
+    AnnexBStats    stats       = AnnexBStats();
+    byteStreamNALUnit( bytestream, nalUnit, nalUnitSize, stats );
+    if ( nalUnitSize == 0 )
+    {
+      continue;
+    }
+
+    InputNALUnit nalu;
+    read( nalu, nalUnit, nalUnitSize, nalUnitBuf );
+    TComInputBitstream& bs = *nalu.m_Bitstream;
+    if ( !nalu.isSlice() || !bs.read( 1 ) )                 // first_slice_segment_in_pic_flag
+    {
+      continue;
+    }
+    if ( nalu.m_nalUnitType >= NAL_UNIT_CODED_SLICE_BLA_W_LP && nalu.m_nalUnitType <= NAL_UNIT_RESERVED_IRAP_VCL23 )
+    {
+      bs.read( 1 );                                         // no_output_of_prior_pics_flag
+    }
+    readUvlc( bs );                                         // slice_pic_parameter_set_id
+    rSliceTypes.push_back( SliceType( readUvlc( bs ) ) );
+  }
+  return true;
+}
+
+/** run the encoder application
+    \param args       command line, starting with the program name
+    \param pdSeconds  wall clock time of the encode, if not NULL
+    \param piFrames   number of coded pictures, if not NULL
+    \returns whether the command line was valid
+ */
+static Bool runEncoder( const vector<string>& args, Double* pdSeconds, Int* piFrames )
+{
+  vector<Char*> argv;
+  for ( size_t i = 0; i < args.size(); i++ )
+  {
+    argv.push_back( const_cast<Char*>( args[i].c_str() ) );
+  }
+
+  TAppEncTop cTAppEncTop;
+  cTAppEncTop.create();
+
+  try
+  {
+    if ( !cTAppEncTop.parseCfg( Int( argv.size() ), &argv[0] ) )
+    {
+      cTAppEncTop.destroy();
+      return false;
+    }
+  }
+  catch ( df::program_options_lite::ParseFailure &e )
+  {
+    cerr << "Error parsing option \"" << e.arg << "\" with argument \"" << e.val << "\"." << endl;
+    cTAppEncTop.destroy();
+    return false;
+  }
+
+  const BenchClock::time_point cStart = BenchClock::now();
+  cTAppEncTop.encode();
+  if ( pdSeconds )
+  {
+    *pdSeconds = secondsSince( cStart );
+  }
+  if ( piFrames )
+  {
+    *piFrames = Int( cTAppEncTop.getTEncTop().getNumAllPicCoded() );
+  }
+
+  cTAppEncTop.destroy();
+  return true;
+}
+
+/** set up the CU at the top left of a CTU as a single luma TU of 4x4 to 32x32, split once for 4x4
+    \param pcCU            CU to set up
+    \param iLog2Size       log2 of the TU size
+    \param ePredMode       prediction mode, the 4x4 TU of an intra CU uses the DST
+    \param bTransformSkip  whether the TU skips the transform
+    \param qp              QP of the CU
+    \returns CU depth, the TU is at depth 1 below it for 4x4 and at the CU depth otherwise
+ */
+static Int setUpTransformCU( TComDataCU* pcCU, Int iLog2Size, PredMode ePredMode, Bool bTransformSkip, Int qp )
+{
+  TComSPS*  pcSPS    = pcCU->getSlice()->getSPS();
+  const Int iLog2CU  = max( iLog2Size, pcSPS->getLog2MinCodingBlockSize() );
+  const Int iTrDepth = iLog2CU - iLog2Size;
+  const Int iCUDepth = g_aucConvertToBit[pcSPS->getMaxCUWidth()] + 2 - iLog2CU;
+
+  pcCU->setDepthSubParts             ( iCUDepth, 0 );
+  pcCU->setSizeSubParts              ( 1 << iLog2CU, 1 << iLog2CU, 0, iCUDepth );
+  pcCU->setPartSizeSubParts          ( SIZE_2Nx2N, 0, iCUDepth );
+  pcCU->setPredModeSubParts          ( ePredMode, 0, iCUDepth );
+  pcCU->setCUTransquantBypassSubParts( false, 0, iCUDepth );
+  pcCU->setTransformSkipSubParts     ( bTransformSkip ? 1 : 0, COMPONENT_Y, 0, iCUDepth );
+  pcCU->setTrIdxSubParts             ( iTrDepth, 0, iCUDepth );
+  pcCU->setQPSubParts                ( qp, 0, iCUDepth );
+  pcCU->setIntraDirSubParts          ( CHANNEL_TYPE_LUMA, DC_IDX, 0, iCUDepth );
+  return iCUDepth;
+}
+
+/// gives the benchmark access to the transforms without the quantisation
+class TBenchTrQuant : public TComTrQuant
+{
+public:
+  using TComTrQuant::xT;
+  using TComTrQuant::xIT;
+  using TComTrQuant::xTransformSkip;
+  using TComTrQuant::xITransformSkip;
+};
+
+#if HM_CLEANUP_SAO
+/// gives the benchmark access to the block level SAO filter
+class TBenchSampleAdaptiveOffset : public TComSampleAdaptiveOffset
+{
+public:
+  using TComSampleAdaptiveOffset::offsetBlock;
+};
+#endif
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+TAppBenchTop::TAppBenchTop()
+: m_bRealData(false)
+, m_pcListPic(NULL)
+, m_uiSink(0)
+{
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/**
+ - run the kernels on the picture data of the input file, or on synthetic data
+ - check the encoder on synthetic sequences
+ - encode the input file and decode the bitstream, measuring the frame rates
+ - run the picture level kernels on the decoded pictures
+ - write the results
+ .
+ */
+Void TAppBenchTop::bench()
+{
+  if ( m_iSIMDLimit >= 0 )
+  {
+    setSIMDExtensionLimit( SIMDExtension( m_iSIMDLimit ) );
+  }
+  printf( "SIMD extension: %s\n\n", getSIMDExtensionName( getSIMDExtension() ) );
+
+  // kernels on the picture data, with the tables in TComRom set up for CTUs of 64x64 down to 4x4 partitions
+  initROM();
+  g_uiMaxCUWidth  = 64;
+  g_uiMaxCUHeight = 64;
+  g_uiMaxCUDepth  = 4;
+  g_uiAddCUDepth  = 0;
+  for ( UInt channelType = 0; channelType < MAX_NUM_CHANNEL_TYPE; channelType++ )
+  {
+    g_bitDepth         [channelType] = m_internalBitDepth;
+    g_maxTrDynamicRange[channelType] = 15;
+  }
+  UInt* puiZscanToRaster = &g_auiZscanToRaster[0];
+  initZscanToRaster( g_uiMaxCUDepth + 1, 1, 0, puiZscanToRaster );
+  initRasterToZscan( g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth + 1 );
+  initRasterToPelXY( g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth + 1 );
+  xCreatePictures();
+
+  xBenchRdCost();
+  xBenchInterpolation();
+  xBenchSaoBlock();
+  xBenchCabac();
+  xCheckTransforms();
+  xCheckTrQuant();
+
+  // without a bitstream, the picture level kernels run on synthetic coding data
+  if ( !m_pchBitstreamFile )
+  {
+    xSetUpCodingData();
+    xBenchDeblocking();
+    xBenchSaoPicture();
+    xBenchTrQuant();
+  }
+
+  xDestroyPictures();
+  destroyROM();
+
+  // the encoder checks set up the tables of their encodes
+  xCheckThreads();
+  xCheckSubPelCache();
+  xCheckSceneCut();
+
+  // end-to-end runs, a failed encode leaves the bitstream of a previous run
+  Bool bDecoded = false;
+  if ( m_pchEncoderConfigFile && xUseKernel( "encode" ) )
+  {
+    xEncode();
+  }
+  if ( m_pchBitstreamFile && ( xUseKernel( "decode" ) || xUseKernel( "deblock" ) || xUseKernel( "sao" ) || xUseKernel( "trquant" ) ) )
+  {
+    bDecoded = xDecode();
+  }
+
+  // kernels on the decoded pictures, the transform last as it changes the coding data of a picture
+  if ( bDecoded )
+  {
+    TComRomScope cRomScope( &m_cTDecTop.getRomContext() );
+
+    xBenchDeblocking();
+    xBenchSaoPicture();
+    xBenchTrQuant();
+
+    m_cTDecTop.deletePicBuffer();
+    m_cTDecTop.destroy();
+    m_pcListPic = NULL;
+  }
+  else if ( m_pchBitstreamFile )
+  {
+    static const Char* apchKernels[] = { "deblock", "sao", "trquant" };
+    for ( UInt i = 0; i < sizeof( apchKernels ) / sizeof( apchKernels[0] ); i++ )
+    {
+      if ( xUseKernel( apchKernels[i] ) )
+      {
+        xSkip( apchKernels[i], "picture", "no picture was decoded from the bitstream" );
+      }
+    }
+  }
+
+  xPrintResults();
+  xWriteJson();
+}
+
+Bool TAppBenchTop::getChecksPassed() const
+{
+  for ( size_t i = 0; i < m_checkResults.size(); i++ )
+  {
+    if ( !m_checkResults[i].bPassed )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+Bool TAppBenchTop::xUseKernel( const Char* pchKernel ) const
+{
+  if ( m_kernels == "all" )
+  {
+    return true;
+  }
+
+  istringstream cList( m_kernels );
+  string        name;
+  while ( getline( cList, name, ',' ) )
+  {
+    if ( name == pchKernel )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** time a kernel case, the number of calls is calibrated so that one measurement takes at least m_dMinTime
+    \param pchKernel        kernel name, as used by the Kernels option
+    \param variant          function and block size
+    \param dSamplesPerCall  samples (or bins) processed by one call
+    \param fnCall           one call of the kernel
+ */
+template <typename F>
+Void TAppBenchTop::xMeasure( const Char* pchKernel, const string& variant, Double dSamplesPerCall, F fnCall )
+{
+  UInt64 uiCalls = 1;
+  while ( true )
+  {
+    const BenchClock::time_point cStart = BenchClock::now();
+    for ( UInt64 i = 0; i < uiCalls; i++ )
+    {
+      fnCall();
+    }
+    const Double dSeconds = secondsSince( cStart );
+    if ( dSeconds >= m_dMinTime )
+    {
+      break;
+    }
+    uiCalls *= ( dSeconds < m_dMinTime / 16 ) ? 16 : 2;
+  }
+
+  vector<Double> adNsPerCall;
+  for ( Int iRep = 0; iRep < m_iRepetitions; iRep++ )
+  {
+    const BenchClock::time_point cStart = BenchClock::now();
+    for ( UInt64 i = 0; i < uiCalls; i++ )
+    {
+      fnCall();
+    }
+    adNsPerCall.push_back( secondsSince( cStart ) * 1e9 / Double( uiCalls ) );
+  }
+  sort( adNsPerCall.begin(), adNsPerCall.end() );
+
+  const size_t n = adNsPerCall.size();
+  KernelResult cResult;
+  cResult.kernel          = pchKernel;
+  cResult.variant         = variant;
+  cResult.uiCalls         = uiCalls;
+  cResult.dNsPerCall      = ( n & 1 ) ? adNsPerCall[n / 2] : 0.5 * ( adNsPerCall[n / 2 - 1] + adNsPerCall[n / 2] );
+  cResult.dNsPerCallMin   = adNsPerCall[0];
+  cResult.dSamplesPerCall = dSamplesPerCall;
+  m_kernelResults.push_back( cResult );
+
+  printf( "%-8s %-28s %12.1f ns %10.1f Msamples/s\n", pchKernel, variant.c_str(), cResult.dNsPerCall, 1e3 * dSamplesPerCall / cResult.dNsPerCall );
+  fflush( stdout );
+}
+
+/** read the first two frames of the input file, or synthesise two pictures with some texture and motion between them
+ */
+Void TAppBenchTop::xCreatePictures()
+{
+  m_cPicOrg.create( m_iSourceWidth, m_iSourceHeight, CHROMA_420, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+  m_cPicRef.create( m_iSourceWidth, m_iSourceHeight, CHROMA_420, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+
+  m_bRealData = false;
+  if ( m_pchInputFile )
+  {
+    const Int aiFileBitDepth    [MAX_NUM_CHANNEL_TYPE] = { m_inputBitDepth,    m_inputBitDepth    };
+    const Int aiInternalBitDepth[MAX_NUM_CHANNEL_TYPE] = { m_internalBitDepth, m_internalBitDepth };
+    Int       aiPad[2] = { 0, 0 };
+
+    TVideoIOYuv cInputFile;
+    TComPicYuv  cPicTrueOrg;
+    cPicTrueOrg.create( m_iSourceWidth, m_iSourceHeight, CHROMA_420, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+#if RExt__INPUT_MSB_EXTENSION
+    cInputFile.open( m_pchInputFile, false, aiFileBitDepth, aiFileBitDepth, aiInternalBitDepth );  // read  mode
+#else
+    cInputFile.open( m_pchInputFile, false, aiFileBitDepth, aiInternalBitDepth );  // read  mode
+#endif
+    if ( cInputFile.read( &m_cPicOrg, &cPicTrueOrg, IPCOLOURSPACE_UNCHANGED, aiPad, CHROMA_420 ) )
+    {
+      m_bRealData = true;
+      if ( !cInputFile.read( &m_cPicRef, &cPicTrueOrg, IPCOLOURSPACE_UNCHANGED, aiPad, CHROMA_420 ) )
+      {
+        m_cPicOrg.copyToPic( &m_cPicRef );
+      }
+    }
+    else
+    {
+      fprintf( stderr, "Failed to read `%s', using synthetic data\n", m_pchInputFile );
+    }
+    cInputFile.close();
+    cPicTrueOrg.destroy();
+  }
+
+  if ( !m_bRealData )
+  {
+    const Int iMaxVal = ( 1 << m_internalBitDepth ) - 1;
+    UInt      uiState = 1;
+
+    for ( UInt comp = 0; comp < m_cPicOrg.getNumberValidComponents(); comp++ )
+    {
+      const ComponentID compID  = ComponentID( comp );
+      const Int         iWidth  = m_cPicOrg.getWidth ( compID );
+      const Int         iHeight = m_cPicOrg.getHeight( compID );
+      const Int         iStride = m_cPicOrg.getStride( compID );
+      Pel*              piOrg   = m_cPicOrg.getAddr( compID );
+      Pel*              piRef   = m_cPicRef.getAddr( compID );
+
+      // gradients and ripples, with noise on top
+      for ( Int y = 0; y < iHeight; y++ )
+      {
+        for ( Int x = 0; x < iWidth; x++ )
+        {
+          const Double dValue = 0.5 + 0.25 * sin( x * 0.05 + comp ) * cos( y * 0.07 ) + 0.15 * sin( ( x + y ) * 0.31 );
+          const Int    iNoise = Int( nextRandom( uiState ) % 9 ) - 4;
+          piOrg[y * iStride + x] = Pel( Clip3( 0, iMaxVal, Int( dValue * iMaxVal ) + ( iNoise << ( m_internalBitDepth - 8 ) ) ) );
+        }
+      }
+      // the second picture is moved by (2,1) with new noise
+      for ( Int y = 0; y < iHeight; y++ )
+      {
+        for ( Int x = 0; x < iWidth; x++ )
+        {
+          const Int iNoise = Int( nextRandom( uiState ) % 5 ) - 2;
+          const Int iSrcX  = min( x + 2, iWidth  - 1 );
+          const Int iSrcY  = min( y + 1, iHeight - 1 );
+          piRef[y * iStride + x] = Pel( Clip3( 0, iMaxVal, Int( piOrg[iSrcY * iStride + iSrcX] ) + ( iNoise << ( m_internalBitDepth - 8 ) ) ) );
+        }
+      }
+    }
+  }
+
+  m_cPicOrg.extendPicBorder();
+  m_cPicRef.extendPicBorder();
+
+  // a single slice with the tools of the main profile, the QP is set by each kernel
+  m_cSPS.setChromaFormatIdc             ( CHROMA_420 );
+  m_cSPS.setPicWidthInLumaSamples       ( m_iSourceWidth );
+  m_cSPS.setPicHeightInLumaSamples      ( m_iSourceHeight );
+  m_cSPS.setMaxCUWidth                  ( g_uiMaxCUWidth );
+  m_cSPS.setMaxCUHeight                 ( g_uiMaxCUHeight );
+  m_cSPS.setMaxCUDepth                  ( g_uiMaxCUDepth );
+  m_cSPS.setLog2MinCodingBlockSize      ( 3 );
+  m_cSPS.setLog2DiffMaxMinCodingBlockSize( g_aucConvertToBit[g_uiMaxCUWidth] + 2 - 3 );
+  m_cSPS.setQuadtreeTULog2MaxSize       ( 5 );
+  m_cSPS.setQuadtreeTULog2MinSize       ( 2 );
+  m_cSPS.setMaxTrSize                   ( MAX_TU_SIZE );
+  for ( UInt channelType = 0; channelType < MAX_NUM_CHANNEL_TYPE; channelType++ )
+  {
+    m_cSPS.setBitDepth  ( ChannelType( channelType ), m_internalBitDepth );
+    m_cSPS.setQpBDOffset( ChannelType( channelType ), 6 * ( m_internalBitDepth - 8 ) );
+  }
+
+  Window cWindow;
+  Int    aiNumReorderPics[MAX_TLAYER] = { 0 };
+  m_cPic.create( m_iSourceWidth, m_iSourceHeight, CHROMA_420, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, cWindow, cWindow, aiNumReorderPics, true );
+  m_cPic.getSlice( 0 )->setSPS( &m_cSPS );
+  m_cPic.getSlice( 0 )->setPPS( &m_cPPS );
+  m_cPic.getSlice( 0 )->setSliceType( P_SLICE );
+  m_cPic.getSlice( 0 )->setSliceQp( 32 );
+  m_cPic.getCU( 0 )->initCU( &m_cPic, 0 );
+}
+
+Void TAppBenchTop::xDestroyPictures()
+{
+  m_cPicOrg.destroy();
+  m_cPicRef.destroy();
+  m_cPic.destroy();
+}
+
+/** CUs of 16x16, or of 8x8 at the right and bottom picture edges, cycling through intra with a split TU, inter with a
+    coded residual, inter with other motion and inter without residual, so that every boundary strength occurs, and
+    with the QP varying between neighbouring CUs. The reconstruction is the first picture.
+ */
+Void TAppBenchTop::xSetUpCodingData()
+{
+  const UInt uiNumParts   = m_cPic.getNumPartInCU();
+  const UInt uiNumParts16 = uiNumParts >> ( 2 * 2 );
+
+  for ( UInt uiCUAddr = 0; uiCUAddr < m_cPic.getNumCUsInFrame(); uiCUAddr++ )
+  {
+    TComDataCU* pcCU = m_cPic.getCU( uiCUAddr );
+    pcCU->initCU( &m_cPic, uiCUAddr );
+
+    for ( UInt uiIdx16 = 0; uiIdx16 < uiNumParts; uiIdx16 += uiNumParts16 )
+    {
+      const UInt uiPelX16 = pcCU->getCUPelX() + g_auiRasterToPelX[g_auiZscanToRaster[uiIdx16]];
+      const UInt uiPelY16 = pcCU->getCUPelY() + g_auiRasterToPelY[g_auiZscanToRaster[uiIdx16]];
+      if ( Int( uiPelX16 ) >= m_iSourceWidth || Int( uiPelY16 ) >= m_iSourceHeight )
+      {
+        continue;
+      }
+      const Bool bInside = Int( uiPelX16 ) + 16 <= m_iSourceWidth && Int( uiPelY16 ) + 16 <= m_iSourceHeight;
+      const UInt uiDepth = bInside ? 2 : 3;
+
+      for ( UInt uiAbsPartIdx = uiIdx16; uiAbsPartIdx < uiIdx16 + uiNumParts16; uiAbsPartIdx += uiNumParts >> ( 2 * uiDepth ) )
+      {
+        const UInt     uiBlkX    = ( pcCU->getCUPelX() + g_auiRasterToPelX[g_auiZscanToRaster[uiAbsPartIdx]] ) >> 3;
+        const UInt     uiBlkY    = ( pcCU->getCUPelY() + g_auiRasterToPelY[g_auiZscanToRaster[uiAbsPartIdx]] ) >> 3;
+        const Int      iType     = ( ( uiBlkX >> ( 4 - uiDepth ) ) + 2 * ( uiBlkY >> ( 4 - uiDepth ) ) ) % 4;
+        const Bool     bIntra    = ( iType == 0 );
+        const UInt     uiCbf     = ( iType <= 1 ) ? 3 : 0;    // coded at TU depth 0 and 1
+        const TComMv   cMv       ( iType == 2 ? 16 : 0, iType == 2 ? -8 : 0 );
+        TComMvField    cMvField;
+        cMvField.setMvField( cMv, bIntra ? NOT_VALID : 0 );
+
+        pcCU->setDepthSubParts             ( uiDepth, uiAbsPartIdx );
+        pcCU->setSizeSubParts              ( g_uiMaxCUWidth >> uiDepth, g_uiMaxCUHeight >> uiDepth, uiAbsPartIdx, uiDepth );
+        pcCU->setPartSizeSubParts          ( SIZE_2Nx2N, uiAbsPartIdx, uiDepth );
+        pcCU->setPredModeSubParts          ( bIntra ? MODE_INTRA : MODE_INTER, uiAbsPartIdx, uiDepth );
+        pcCU->setCUTransquantBypassSubParts( false, uiAbsPartIdx, uiDepth );
+        pcCU->setTrIdxSubParts             ( ( bIntra && bInside ) ? 1 : 0, uiAbsPartIdx, uiDepth );
+        pcCU->setQPSubParts                ( 30 + Int( uiBlkX + 3 * uiBlkY ) % 5, uiAbsPartIdx, uiDepth );
+        pcCU->setInterDirSubParts          ( bIntra ? 0 : 1, uiAbsPartIdx, 0, uiDepth );
+        pcCU->getCUMvField( REF_PIC_LIST_0 )->setAllMvField( cMvField, SIZE_2Nx2N, uiAbsPartIdx, uiDepth );
+        for ( UInt comp = 0; comp < MAX_NUM_COMPONENT; comp++ )
+        {
+          pcCU->setCbfSubParts( uiCbf, ComponentID( comp ), uiAbsPartIdx, uiDepth );
+        }
+      }
+    }
+  }
+
+  m_cPicOrg.copyToPic( m_cPic.getPicYuvRec() );
+}
+
+/** report a kernel that could not be run
+    \param pchKernel  kernel name, as used by the Kernels option
+    \param variant    function
+    \param reason     why it was not run
+ */
+Void TAppBenchTop::xSkip( const Char* pchKernel, const string& variant, const string& reason )
+{
+  SkippedResult cResult;
+  cResult.kernel  = pchKernel;
+  cResult.variant = variant;
+  cResult.reason  = reason;
+  m_skippedResults.push_back( cResult );
+
+  fprintf( stderr, "Warning: %s %s skipped, %s\n", pchKernel, variant.c_str(), reason.c_str() );
+}
+
+/** SAD, SSE and Hadamard distortion of square blocks, between the two pictures
+ */
+Void TAppBenchTop::xBenchRdCost()
+{
+  if ( !xUseKernel( "rdcost" ) )
+  {
+    return;
+  }
+
+  TComRdCost cRdCost;
+  cRdCost.init();
+
+  static const struct { DFunc eDFunc; const Char* pchName; } acFuncs[] =
+  {
+    { DF_SAD,  "SAD" },
+    { DF_SSE,  "SSE" },
+    { DF_HADS, "HAD" },
+  };
+
+  const Int iStride = m_cPicOrg.getStride( COMPONENT_Y );
+  Pel*      piOrg   = m_cPicOrg.getAddr( COMPONENT_Y );
+  Pel*      piRef   = m_cPicRef.getAddr( COMPONENT_Y );
+
+  for ( UInt uiFunc = 0; uiFunc < sizeof( acFuncs ) / sizeof( acFuncs[0] ); uiFunc++ )
+  {
+    for ( Int iSize = 4; iSize <= 64; iSize <<= 1 )
+    {
+      const vector<Int> aiOffsets = blockOffsets( m_iSourceWidth, m_iSourceHeight, iStride, iSize, iSize, 0 );
+
+      DistParam cDistParam;
+      cRdCost.setDistParam( iSize, iSize, acFuncs[uiFunc].eDFunc, cDistParam );
+      cDistParam.iStrideOrg   = iStride;
+      cDistParam.iStrideCur   = iStride;
+      cDistParam.iStep        = 1;
+      cDistParam.bitDepth     = m_internalBitDepth;
+      cDistParam.bApplyWeight = false;
+      cDistParam.compIdx      = COMPONENT_Y;
+
+      size_t uiBlk = 0;
+      ostringstream variant;
+      variant << acFuncs[uiFunc].pchName << " " << iSize << "x" << iSize;
+      xMeasure( "rdcost", variant.str(), iSize * iSize, [&]()
+      {
+        const Int iOffset = aiOffsets[uiBlk++ % aiOffsets.size()];
+        cDistParam.pOrg = piOrg + iOffset;
+        cDistParam.pCur = piRef + iOffset;
+        m_uiSink += cDistParam.DistFunc( &cDistParam );
+      } );
+    }
+  }
+}
+
+/** horizontal, vertical and two-dimensional fractional sample interpolation of luma and chroma blocks
+ */
+Void TAppBenchTop::xBenchInterpolation()
+{
+  if ( !xUseKernel( "interp" ) )
+  {
+    return;
+  }
+
+  TComInterpolationFilter cIf;
+  vector<Pel> aiTmp( MAX_CU_SIZE * ( MAX_CU_SIZE + NTAPS_LUMA - 1 ) );
+  vector<Pel> aiDst( MAX_CU_SIZE * MAX_CU_SIZE );
+
+  for ( UInt comp = COMPONENT_Y; comp <= COMPONENT_Cb; comp++ )
+  {
+    const ComponentID compID    = ComponentID( comp );
+    const Bool        bLuma     = isLuma( compID );
+    const Int         iNumTaps  = bLuma ? NTAPS_LUMA : NTAPS_CHROMA;
+    const Int         iHalfTap  = iNumTaps / 2 - 1;
+    const Int         iStride   = m_cPicRef.getStride( compID );
+    Pel*              piRef     = m_cPicRef.getAddr( compID );
+    const Int         iMinSize  = bLuma ? 8 : 4;
+    const Int         iMaxSize  = bLuma ? 64 : 32;
+
+    for ( Int iSize = iMinSize; iSize <= iMaxSize; iSize <<= 1 )
+    {
+      const vector<Int> aiOffsets = blockOffsets( m_cPicRef.getWidth( compID ), m_cPicRef.getHeight( compID ), iStride, iSize, iSize, 0 );
+      size_t            uiBlk     = 0;
+      const string      size      = ( bLuma ? string( "luma " ) : string( "chroma " ) ) + to_string( iSize ) + "x" + to_string( iSize );
+
+      xMeasure( "interp", size + " hor", iSize * iSize, [&]()
+      {
+        Pel* piSrc = piRef + aiOffsets[uiBlk++ % aiOffsets.size()];
+        cIf.filterHor( compID, piSrc, iStride, &aiDst[0], iSize, iSize, iSize, bLuma ? 2 : 3, true, CHROMA_420 );
+        m_uiSink += aiDst[0];
+      } );
+
+      xMeasure( "interp", size + " ver", iSize * iSize, [&]()
+      {
+        Pel* piSrc = piRef + aiOffsets[uiBlk++ % aiOffsets.size()];
+        cIf.filterVer( compID, piSrc, iStride, &aiDst[0], iSize, iSize, iSize, bLuma ? 2 : 3, true, true, CHROMA_420 );
+        m_uiSink += aiDst[0];
+      } );
+
+      xMeasure( "interp", size + " hor+ver", iSize * iSize, [&]()
+      {
+        Pel* piSrc = piRef + aiOffsets[uiBlk++ % aiOffsets.size()];
+        cIf.filterHor( compID, piSrc - iHalfTap * iStride, iStride, &aiTmp[0], iSize, iSize, iSize + iNumTaps - 1, bLuma ? 1 : 5, false, CHROMA_420 );
+        cIf.filterVer( compID, &aiTmp[0] + iHalfTap * iSize, iSize, &aiDst[0], iSize, iSize, iSize, bLuma ? 3 : 3, false, true, CHROMA_420 );
+        m_uiSink += aiDst[0];
+      } );
+    }
+  }
+}
+
+/** SAO edge and band offsets of CTU sized blocks
+ */
+Void TAppBenchTop::xBenchSaoBlock()
+{
+#if HM_CLEANUP_SAO
+  if ( !xUseKernel( "sao" ) )
+  {
+    return;
+  }
+
+  static const struct { Int iTypeIdx; const Char* pchName; } acTypes[] =
+  {
+    { SAO_TYPE_EO_0,   "EO 0"   },
+    { SAO_TYPE_EO_90,  "EO 90"  },
+    { SAO_TYPE_EO_135, "EO 135" },
+    { SAO_TYPE_EO_45,  "EO 45"  },
+    { SAO_TYPE_BO,     "BO"     },
+  };
+
+  TBenchSampleAdaptiveOffset cSao;
+  cSao.create( m_iSourceWidth, m_iSourceHeight, CHROMA_420, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+
+  const Int   iSize   = g_uiMaxCUWidth;
+  const Int   iStride = m_cPicOrg.getStride( COMPONENT_Y );
+  Pel*        piSrc   = m_cPicOrg.getAddr( COMPONENT_Y );
+  vector<Pel> aiDst( iSize * iSize );
+
+  // blocks away from the picture edges, so that all neighbours are available
+  const vector<Int> aiOffsets = blockOffsets( m_iSourceWidth, m_iSourceHeight, iStride, iSize, iSize, 1 );
+
+  Int aiOffset[MAX_NUM_SAO_CLASSES];
+  for ( Int i = 0; i < MAX_NUM_SAO_CLASSES; i++ )
+  {
+    aiOffset[i] = ( i % 5 ) - 2;
+  }
+
+  for ( UInt uiType = 0; uiType < sizeof( acTypes ) / sizeof( acTypes[0] ); uiType++ )
+  {
+    size_t uiBlk = 0;
+    xMeasure( "sao", string( acTypes[uiType].pchName ) + " " + to_string( iSize ) + "x" + to_string( iSize ), iSize * iSize, [&]()
+    {
+      cSao.offsetBlock( COMPONENT_Y, acTypes[uiType].iTypeIdx, aiOffset, piSrc + aiOffsets[uiBlk++ % aiOffsets.size()], &aiDst[0], iStride, iSize, iSize, iSize,
+                        true, true, true, true, true, true, true, true );
+      m_uiSink += aiDst[0];
+    } );
+  }
+
+  cSao.destroy();
+#endif
+}
+
+/** context coded bins with a mix of skewed and balanced probabilities, through the arithmetic coder, the bit counting
+    coder used for rate estimation and the arithmetic decoder
+ */
+Void TAppBenchTop::xBenchCabac()
+{
+  if ( !xUseKernel( "cabac" ) )
+  {
+    return;
+  }
+
+  const Int iNumBins     = 1 << 16;
+  const Int iNumContexts = 16;
+
+  // probability of a one of each context, from balanced to strongly skewed
+  Int aiThreshold[iNumContexts];
+  for ( Int iCtx = 0; iCtx < iNumContexts; iCtx++ )
+  {
+    aiThreshold[iCtx] = 512 + ( 470 * iCtx ) / ( iNumContexts - 1 );
+  }
+
+  vector<UChar> aucBins    ( iNumBins );
+  vector<UChar> aucContexts( iNumBins );
+  UInt          uiState = 1;
+  for ( Int i = 0; i < iNumBins; i++ )
+  {
+    aucContexts[i] = UChar( nextRandom( uiState ) % iNumContexts );
+    aucBins    [i] = UChar( Int( nextRandom( uiState ) % 1024 ) < aiThreshold[aucContexts[i]] ? 1 : 0 );
+  }
+
+  ContextModel acContexts[iNumContexts];
+  auto initContexts = [&]()
+  {
+    for ( Int iCtx = 0; iCtx < iNumContexts; iCtx++ )
+    {
+      acContexts[iCtx].init( 32, 154 );
+    }
+  };
+
+  // arithmetic coder
+  TComOutputBitstream cBitstream;
+  TEncBinCABAC        cEncBin;
+  cEncBin.init( &cBitstream );
+  auto encode = [&]()
+  {
+    cBitstream.clear();
+    initContexts();
+    cEncBin.start();
+    for ( Int i = 0; i < iNumBins; i++ )
+    {
+      cEncBin.encodeBin( aucBins[i], acContexts[aucContexts[i]] );
+    }
+    cEncBin.encodeBinTrm( 1 );
+    cEncBin.finish();
+    cBitstream.write( 1, 1 );
+    cBitstream.writeAlignZero();
+  };
+  xMeasure( "cabac", "encodeBin", iNumBins, [&]()
+  {
+    encode();
+    m_uiSink += cBitstream.getNumberOfWrittenBits();
+  } );
+
+  // bit counting coder of the rate-distortion decisions
+  TComBitCounter        cBitCounter;
+  TEncBinCABACCounter   cCounterBin;
+  cCounterBin.init( &cBitCounter );
+  xMeasure( "cabac", "encodeBin (bit counter)", iNumBins, [&]()
+  {
+    initContexts();
+    cCounterBin.start();
+    for ( Int i = 0; i < iNumBins; i++ )
+    {
+      cCounterBin.encodeBin( aucBins[i], acContexts[aucContexts[i]] );
+    }
+    m_uiSink += cCounterBin.getNumWrittenBits();
+  } );
+
+  // arithmetic decoder, on the output of the coder
+  encode();
+  vector<uint8_t> aucStream = cBitstream.getFIFO();
+  aucStream.resize( aucStream.size() + 4, 0 );
+
+  Bool bMismatch = false;
+  auto decode = [&]( Bool bCheck )
+  {
+    TComInputBitstream cInput( &aucStream );
+    TDecBinCABAC       cDecBin;
+    cDecBin.init( &cInput );
+    initContexts();
+    cDecBin.start();
+    for ( Int i = 0; i < iNumBins; i++ )
+    {
+      UInt uiBin;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+      cDecBin.decodeBin( uiBin, acContexts[aucContexts[i]], TComCodingStatisticsClassType( STATS__CABAC_BITS__SPLIT_FLAG ) );
+#else
+      cDecBin.decodeBin( uiBin, acContexts[aucContexts[i]] );
+#endif
+      m_uiSink += uiBin;
+      bMismatch |= bCheck && uiBin != aucBins[i];
+    }
+  };
+
+  decode( true );
+  if ( bMismatch )
+  {
+    fprintf( stderr, "CABAC decoder output does not match the coded bins\n" );
+  }
+  xMeasure( "cabac", "decodeBin", iNumBins, [&]() { decode( false ); } );
+}
+
+/** record the outcome of a check case and report a mismatch
+    \param pchCheck  check name, as used by the Kernels option
+    \param variant   function and block size
+    \param bPassed   whether the results are identical
+ */
+Void TAppBenchTop::xAddCheckResult( const Char* pchCheck, const string& variant, Bool bPassed )
+{
+  CheckResult cResult;
+  cResult.check   = pchCheck;
+  cResult.variant = variant;
+  cResult.bPassed = bPassed;
+  m_checkResults.push_back( cResult );
+
+  printf( "%-8s %-28s %s\n", pchCheck, variant.c_str(), bPassed ? "ok" : "MISMATCH" );
+  fflush( stdout );
+}
+
+/** forward and inverse transforms of random luma blocks with the SIMD kernels against the plain C ones, comparing the
+    output of xT() and xIT() themselves: the DCT of every square size and of the 4:2:2 chroma sizes, the 4x4 DST and
+    transform skip of every size. The bit depth and the dynamic range of the transforms are swept, up to the 22-bit
+    extended precision range of 16-bit video when built with RExt__HIGH_BIT_DEPTH_SUPPORT.
+ */
+Void TAppBenchTop::xCheckTransforms()
+{
+  if ( !xUseKernel( "trquant-check" ) )
+  {
+    return;
+  }
+
+  static const struct { Int iWidth; Int iHeight; Bool bDST; Bool bTransformSkip; const Char* pchName; } acCases[] =
+  {
+    {  4,  4, false, false, "DCT" },
+    {  8,  8, false, false, "DCT" },
+    { 16, 16, false, false, "DCT" },
+    { 32, 32, false, false, "DCT" },
+    {  4,  8, false, false, "DCT" },
+    {  8, 16, false, false, "DCT" },
+    { 16, 32, false, false, "DCT" },
+    {  4,  4, true,  false, "DST" },
+    {  4,  4, false, true,  "transform skip" },
+    {  8,  8, false, true,  "transform skip" },
+    { 16, 16, false, true,  "transform skip" },
+    { 32, 32, false, true,  "transform skip" },
+  };
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+  static const Int aiBitDepths[] = { 8, 10, 12, 16 };
+#else
+  static const Int aiBitDepths[] = { 8, 10, 12 };
+#endif
+
+  // the transforms select their kernels when they are constructed
+  const SIMDExtension eSIMD = getSIMDExtension();
+  setSIMDExtensionLimit( SIMD_NONE );
+  TBenchTrQuant cTrQuantC;
+  setSIMDExtensionLimit( eSIMD );
+  TBenchTrQuant cTrQuantSIMD;
+  TBenchTrQuant* apcTrQuant[2] = { &cTrQuantC, &cTrQuantSIMD };
+
+  const Int   iBitDepth         = g_bitDepth[CHANNEL_TYPE_LUMA];
+  const Int   iDynamicRange     = g_maxTrDynamicRange[CHANNEL_TYPE_LUMA];
+  const Bool  bExtendedPrecision = m_cSPS.getUseExtendedPrecision();
+  const Int   iNumBlocks        = 64;
+  TComDataCU* pcCU              = m_cPic.getCU( 0 );
+  UInt        uiState           = 1;
+
+  Pel    aiResi [MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff aiCoeff[2][MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff aiLevel[2][MAX_TU_SIZE * MAX_TU_SIZE];
+  Pel    aiRec  [2][MAX_TU_SIZE * MAX_TU_SIZE];
+
+  for ( UInt uiCase = 0; uiCase < sizeof( acCases ) / sizeof( acCases[0] ); uiCase++ )
+  {
+    const Int  iWidth         = acCases[uiCase].iWidth;
+    const Int  iHeight        = acCases[uiCase].iHeight;
+    const Int  iNumPels       = iWidth * iHeight;
+    const Bool bTransformSkip = acCases[uiCase].bTransformSkip;
+
+    // the CU only provides the TU of transform skip
+    const Int iCUDepth = setUpTransformCU( pcCU, g_aucConvertToBit[iWidth] + 2, MODE_INTER, bTransformSkip, 0 );
+    TComTURecurse cTuCU( pcCU, 0, iCUDepth );
+    TComTURecurse cTuSplit( cTuCU, false );
+    TComTU&       rTu = ( iWidth == 4 ) ? (TComTU&) cTuSplit : (TComTU&) cTuCU;
+
+    string forwardMismatch;
+    string inverseMismatch;
+    for ( UInt uiBitDepth = 0; uiBitDepth < sizeof( aiBitDepths ) / sizeof( aiBitDepths[0] ); uiBitDepth++ )
+    {
+      // the dynamic range of the standard, and of extended precision processing
+      const Int aiRanges[2] = { 15, max( 15, aiBitDepths[uiBitDepth] + 6 ) };
+      for ( Int iRange = 0; iRange < 2; iRange++ )
+      {
+        if ( iRange == 1 && aiRanges[1] == aiRanges[0] )
+        {
+          continue;
+        }
+        g_bitDepth        [CHANNEL_TYPE_LUMA] = aiBitDepths[uiBitDepth];
+        g_maxTrDynamicRange[CHANNEL_TYPE_LUMA] = aiRanges[iRange];
+        m_cSPS.setUseExtendedPrecision( iRange == 1 );
+
+        const string config    = " at " + to_string( aiBitDepths[uiBitDepth] ) + "-bit range " + to_string( aiRanges[iRange] );
+        const Int    iMaxResi  = ( 1 << aiBitDepths[uiBitDepth] ) - 1;
+        const Int    iMaxCoeff = ( 1 << aiRanges[iRange] ) - 1;          // the dequantisation clips to -iMaxCoeff-1 .. iMaxCoeff
+
+        for ( Int iBlk = 0; iBlk < iNumBlocks; iBlk++ )
+        {
+          // residual of the full range, of only the extreme values, and of low amplitude
+          const Int iAmplitude = ( iBlk & 1 ) ? iMaxResi : 16;
+          for ( Int i = 0; i < iNumPels; i++ )
+          {
+            const UInt uiRandom = nextRandom( uiState );
+            aiResi[i] = ( iBlk % 4 == 3 ) ? Pel( ( uiRandom & 1 ) ? iMaxResi : -iMaxResi ) : Pel( Int( uiRandom % ( 2 * iAmplitude + 1 ) ) - iAmplitude );
+          }
+
+          for ( Int i = 0; i < 2; i++ )
+          {
+            if ( bTransformSkip )
+            {
+              apcTrQuant[i]->xTransformSkip( aiResi, iWidth, aiCoeff[i], rTu, COMPONENT_Y );
+            }
+            else
+            {
+              apcTrQuant[i]->xT( COMPONENT_Y, acCases[uiCase].bDST, aiResi, iWidth, aiCoeff[i], iWidth, iHeight );
+            }
+          }
+          if ( forwardMismatch.empty() && !equal( aiCoeff[0], aiCoeff[0] + iNumPels, aiCoeff[1] ) )
+          {
+            forwardMismatch = config;
+          }
+
+          // the coefficients of the forward transform, and sparse and dense random coefficients of the full range
+          for ( Int i = 0; i < iNumPels; i++ )
+          {
+            const UInt   uiRandom = nextRandom( uiState );
+            const TCoeff iRandom  = TCoeff( Int( nextRandom( uiState ) % ( 2 * UInt( iMaxCoeff ) + 2 ) ) - iMaxCoeff - 1 );
+            switch ( iBlk % 3 )
+            {
+              case 0:  aiLevel[0][i] = aiCoeff[0][i];                       break;
+              case 1:  aiLevel[0][i] = ( uiRandom & 3 ) ? 0 : iRandom;      break;
+              default: aiLevel[0][i] = ( uiRandom & 7 ) ? iRandom : ( ( uiRandom & 8 ) ? iMaxCoeff : -iMaxCoeff - 1 ); break;
+            }
+            aiLevel[1][i] = aiLevel[0][i];
+          }
+          for ( Int i = 0; i < 2; i++ )
+          {
+            if ( bTransformSkip )
+            {
+              apcTrQuant[i]->xITransformSkip( aiLevel[i], aiRec[i], iWidth, rTu, COMPONENT_Y );
+            }
+            else
+            {
+              apcTrQuant[i]->xIT( COMPONENT_Y, acCases[uiCase].bDST, aiLevel[i], aiRec[i], iWidth, iWidth, iHeight );
+            }
+          }
+          if ( inverseMismatch.empty() && !equal( aiRec[0], aiRec[0] + iNumPels, aiRec[1] ) )
+          {
+            inverseMismatch = config;
+          }
+        }
+      }
+    }
+
+    const string size = string( acCases[uiCase].pchName ) + " " + to_string( iWidth ) + "x" + to_string( iHeight );
+    xAddCheckResult( "trquant-check", "raw forward " + size + forwardMismatch, forwardMismatch.empty() );
+    xAddCheckResult( "trquant-check", "raw inverse " + size + inverseMismatch, inverseMismatch.empty() );
+  }
+
+  g_bitDepth        [CHANNEL_TYPE_LUMA] = iBitDepth;
+  g_maxTrDynamicRange[CHANNEL_TYPE_LUMA] = iDynamicRange;
+  m_cSPS.setUseExtendedPrecision( bExtendedPrecision );
+}
+
+/** forward transform and quantisation, and dequantisation and inverse transform, of random luma blocks with the
+    SIMD kernels against the plain C ones, in addition to xCheckTransforms(): the DCT of every TU size, the 4x4 DST of
+    intra blocks and transform skip.
+    The inverse is also run on random coefficient levels, which reach the clipping of the dequantisation.
+ */
+Void TAppBenchTop::xCheckTrQuant()
+{
+  if ( !xUseKernel( "trquant-check" ) )
+  {
+    return;
+  }
+
+  static const struct { Int iLog2Size; PredMode ePredMode; Bool bTransformSkip; const Char* pchName; } acCases[] =
+  {
+    { 2, MODE_INTER, false, "DCT" },
+    { 3, MODE_INTER, false, "DCT" },
+    { 4, MODE_INTER, false, "DCT" },
+    { 5, MODE_INTER, false, "DCT" },
+    { 2, MODE_INTRA, false, "DST" },
+    { 2, MODE_INTER, true,  "transform skip" },
+  };
+
+  // the transforms select their kernels when they are constructed
+  const SIMDExtension eSIMD = getSIMDExtension();
+  setSIMDExtensionLimit( SIMD_NONE );
+  TComTrQuant cTrQuantC;
+  setSIMDExtensionLimit( eSIMD );
+  TComTrQuant cTrQuantSIMD;
+
+  TComTrQuant* apcTrQuant[2] = { &cTrQuantC, &cTrQuantSIMD };
+  for ( Int i = 0; i < 2; i++ )
+  {
+#if ADAPTIVE_QP_SELECTION
+    apcTrQuant[i]->init( MAX_TU_SIZE, false, false, true, false, false );
+#else
+    apcTrQuant[i]->init( MAX_TU_SIZE, false, false, true, false );
+#endif
+    apcTrQuant[i]->setFlatScalingList( CHROMA_420 );
+    apcTrQuant[i]->setUseScalingList( false );
+  }
+
+  // the lowest QP, so that the quantisation hides as few differences of the transforms as possible
+  const Int   qp        = -m_cSPS.getQpBDOffset( CHANNEL_TYPE_LUMA );
+  const Int   iMaxVal   = ( 1 << m_internalBitDepth ) - 1;
+  const Int   iNumBlocks = 256;
+  TComDataCU* pcCU      = m_cPic.getCU( 0 );
+  UInt        uiState   = 1;
+
+  QpParam cQP;
+  setQPforQuant( cQP, qp, CHANNEL_TYPE_LUMA, m_cSPS.getQpBDOffset( CHANNEL_TYPE_LUMA ), 0, CHROMA_420, false );
+
+  Pel    aiResi [MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff aiCoeff[2][MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff aiLevel[2][MAX_TU_SIZE * MAX_TU_SIZE];
+  Pel    aiRec  [2][MAX_TU_SIZE * MAX_TU_SIZE];
+#if ADAPTIVE_QP_SELECTION
+  TCoeff aiArlCoeff[MAX_TU_SIZE * MAX_TU_SIZE];
+  TCoeff* pcArlCoeff = aiArlCoeff;
+#endif
+
+  for ( UInt uiCase = 0; uiCase < sizeof( acCases ) / sizeof( acCases[0] ); uiCase++ )
+  {
+    const Int iSize    = 1 << acCases[uiCase].iLog2Size;
+    const Int iNumPels = iSize * iSize;
+    const Int iCUDepth = setUpTransformCU( pcCU, acCases[uiCase].iLog2Size, acCases[uiCase].ePredMode, acCases[uiCase].bTransformSkip, qp );
+
+    TComTURecurse cTuCU( pcCU, 0, iCUDepth );
+    TComTURecurse cTuSplit( cTuCU, false );
+    TComTU&       rTu = ( iSize == 4 ) ? (TComTU&) cTuSplit : (TComTU&) cTuCU;
+
+    Bool bForwardPassed = true;
+    Bool bInversePassed = true;
+    for ( Int iBlk = 0; iBlk < iNumBlocks; iBlk++ )
+    {
+      // residual of the full range and of low amplitude
+      const Int iAmplitude = ( iBlk & 1 ) ? iMaxVal : 16;
+      for ( Int i = 0; i < iNumPels; i++ )
+      {
+        aiResi[i] = Pel( Int( nextRandom( uiState ) % ( 2 * iAmplitude + 1 ) ) - iAmplitude );
+      }
+
+      TCoeff auiAbsSum[2];
+      for ( Int i = 0; i < 2; i++ )
+      {
+        apcTrQuant[i]->transformNxN( rTu, COMPONENT_Y, aiResi, iSize, aiCoeff[i],
+#if ADAPTIVE_QP_SELECTION
+                                     pcArlCoeff,
+#endif
+                                     auiAbsSum[i], cQP );
+      }
+      bForwardPassed &= auiAbsSum[0] == auiAbsSum[1] && equal( aiCoeff[0], aiCoeff[0] + iNumPels, aiCoeff[1] );
+
+      // the coefficients of the forward transform, and sparse random levels up to the largest coded value
+      for ( Int i = 0; i < iNumPels; i++ )
+      {
+        const UInt uiRandom = nextRandom( uiState );
+        aiLevel[0][i] = ( iBlk & 1 ) ? ( ( uiRandom & 3 ) ? 0 : TCoeff( Int( ( uiRandom >> 2 ) % 65535 ) - 32767 ) ) : aiCoeff[0][i];
+        aiLevel[1][i] = aiLevel[0][i];
+      }
+      for ( Int i = 0; i < 2; i++ )
+      {
+        Pel* piRec = aiRec[i];
+        apcTrQuant[i]->invTransformNxN( rTu, COMPONENT_Y, piRec, iSize, aiLevel[i], cQP DEBUG_STRING_PASS_INTO( NULL ) );
+      }
+      bInversePassed &= equal( aiRec[0], aiRec[0] + iNumPels, aiRec[1] );
+    }
+
+    const string size = string( acCases[uiCase].pchName ) + " " + to_string( iSize ) + "x" + to_string( iSize );
+    xAddCheckResult( "trquant-check", "forward " + size, bForwardPassed );
+    xAddCheckResult( "trquant-check", "inverse " + size, bInversePassed );
+  }
+}
+
+/** encode the synthetic sequence of the encoder checks, CHECK_INPUT_FILE, with the encoder application. The settings
+    are built in, a low delay B configuration with wavefronts and the decoded picture hash SEI, so that the checks do
+    not depend on an encoder configuration file.
+    \param pchBitstreamFile  bitstream file name
+    \param options           additional encoder options
+    \returns whether the sequence was encoded
+ */
+Bool TAppBenchTop::xEncodeCheck( const Char* pchBitstreamFile, const vector<string>& options )
+{
+  static const Char* apchSettings[] =
+  {
+    "--QP=37", "--IntraPeriod=-1", "--GOPSize=1", "--Frame1=B 1 0 0.4624 0 0 0 2 2 -1 -2 0",
+    "--MaxCUWidth=32", "--MaxCUHeight=32", "--MaxPartitionDepth=3",
+    "--QuadtreeTULog2MaxSize=5", "--QuadtreeTUMaxDepthIntra=3", "--QuadtreeTUMaxDepthInter=3",
+    "--FastSearch=1", "--SearchRange=32", "--FEN=1", "--FDM=1", "--ECU=1", "--SEIDecodedPictureHash=1", "--WaveFrontSynchro=1",
+  };
+
+  vector<string> args;
+  args.push_back( "TAppEncoder" );
+  args.push_back( "-i" );                  args.push_back( CHECK_INPUT_FILE );
+  args.push_back( "-b" );                  args.push_back( pchBitstreamFile );
+  args.push_back( "-wdt" );                args.push_back( to_string( CHECK_WIDTH ) );
+  args.push_back( "-hgt" );                args.push_back( to_string( CHECK_HEIGHT ) );
+  args.push_back( "-fr" );                 args.push_back( "30" );
+  args.push_back( "-f" );                  args.push_back( to_string( CHECK_FRAMES ) );
+  args.push_back( "--InputBitDepth=8" );
+  args.push_back( "--InternalBitDepth=" + to_string( m_internalBitDepth ) );
+  args.insert( args.end(), apchSettings, apchSettings + sizeof( apchSettings ) / sizeof( apchSettings[0] ) );
+  args.insert( args.end(), options.begin(), options.end() );
+
+  return runEncoder( args, NULL, NULL );
+}
+
+/** the bitstream must not depend on the number of worker threads of the encoder, with the default tools and with the
+    tools that share data between the CTU rows or run on separate threads: the sub-pel plane cache, the pyramid motion
+    search and the lookahead
+ */
+Void TAppBenchTop::xCheckThreads()
+{
+  if ( !xUseKernel( "threads-check" ) || !writeCheckSequence( CHECK_INPUT_FILE, CHECK_FRAMES ) )
+  {
+    return;
+  }
+
+  const Int iNumThreads = m_iNumThreads > 1 ? m_iNumThreads : 4;
+
+  for ( Int iTools = 0; iTools < 2; iTools++ )
+  {
+    vector<string> options;
+    if ( iTools )
+    {
+      options.push_back( "--SubPelCache=1" );
+      options.push_back( "--PyramidME=1" );
+      options.push_back( "--Lookahead=1" );
+      options.push_back( "--LookaheadSceneCut=1" );
+    }
+
+    vector<UChar> aucSingle;
+    vector<UChar> aucThreaded;
+    Bool bPassed = xEncodeCheck( "bench_check_1.bin", options ) && readFile( "bench_check_1.bin", aucSingle );
+    options.push_back( "--Threads=" + to_string( iNumThreads ) );
+    bPassed = bPassed && xEncodeCheck( "bench_check_n.bin", options ) && readFile( "bench_check_n.bin", aucThreaded );
+    bPassed = bPassed && !aucSingle.empty() && aucSingle == aucThreaded;
+
+    xAddCheckResult( "threads-check", string( iTools ? "tools " : "default " ) + "Threads=1/" + to_string( iNumThreads ), bPassed );
+    remove( "bench_check_1.bin" );
+    remove( "bench_check_n.bin" );
+  }
+  remove( CHECK_INPUT_FILE );
+}
+
+/** the sub-pel plane cache must not change the bitstream
+ */
+Void TAppBenchTop::xCheckSubPelCache()
+{
+  if ( !xUseKernel( "subpel-check" ) || !writeCheckSequence( CHECK_INPUT_FILE, CHECK_FRAMES ) )
+  {
+    return;
+  }
+
+  vector<UChar> aucPlain;
+  vector<UChar> aucCached;
+  Bool bPassed = xEncodeCheck( "bench_check_0.bin", vector<string>( 1, "--SubPelCache=0" ) ) && readFile( "bench_check_0.bin", aucPlain );
+  bPassed = bPassed && xEncodeCheck( "bench_check_1.bin", vector<string>( 1, "--SubPelCache=1" ) ) && readFile( "bench_check_1.bin", aucCached );
+  bPassed = bPassed && !aucPlain.empty() && aucPlain == aucCached;
+
+  xAddCheckResult( "subpel-check", "SubPelCache=0/1", bPassed );
+  remove( "bench_check_0.bin" );
+  remove( "bench_check_1.bin" );
+  remove( CHECK_INPUT_FILE );
+}
+
+/** the lookahead must detect the cut of the synthetic sequence at CHECK_CUT_FRAME, and only there: with the low delay
+    configuration in input order, the cut picture must be the only I picture after the first one
+ */
+Void TAppBenchTop::xCheckSceneCut()
+{
+  if ( !xUseKernel( "scenecut-check" ) || !writeCheckSequence( CHECK_INPUT_FILE, CHECK_CUT_FRAME ) )
+  {
+    return;
+  }
+
+  vector<string> options;
+  options.push_back( "--Lookahead=1" );
+  options.push_back( "--LookaheadSceneCut=1" );
+
+  vector<SliceType> aeSliceTypes;
+  Bool bPassed = xEncodeCheck( "bench_check.bin", options ) && readSliceTypes( "bench_check.bin", aeSliceTypes );
+  bPassed = bPassed && Int( aeSliceTypes.size() ) == CHECK_FRAMES;
+  for ( Int i = 1; bPassed && i < CHECK_FRAMES; i++ )
+  {
+    bPassed = ( aeSliceTypes[i] == I_SLICE ) == ( i == CHECK_CUT_FRAME );
+  }
+
+  xAddCheckResult( "scenecut-check", "cut at frame " + to_string( CHECK_CUT_FRAME ), bPassed );
+  remove( "bench_check.bin" );
+  remove( CHECK_INPUT_FILE );
+}
+
+/** encode the input file with the encoder application, writing m_pchBitstreamFile
+ */
+Bool TAppBenchTop::xEncode()
+{
+  vector<string> args;
+  args.push_back( "TAppEncoder" );
+  args.push_back( "-c" );                  args.push_back( m_pchEncoderConfigFile );
+  args.push_back( "-i" );                  args.push_back( m_pchInputFile );
+  args.push_back( "-b" );                  args.push_back( m_pchBitstreamFile );
+  args.push_back( "-wdt" );                args.push_back( to_string( m_iSourceWidth ) );
+  args.push_back( "-hgt" );                args.push_back( to_string( m_iSourceHeight ) );
+  args.push_back( "-fr" );                 args.push_back( to_string( m_iFrameRate ) );
+  args.push_back( "-f" );                  args.push_back( to_string( m_framesToBeEncoded ) );
+  args.push_back( "--InputBitDepth="    + to_string( m_inputBitDepth ) );
+  args.push_back( "--InternalBitDepth=" + to_string( m_internalBitDepth ) );
+
+  EndToEndResult cResult;
+  cResult.stage = "encode";
+  if ( !runEncoder( args, &cResult.dSeconds, &cResult.iFrames ) )
+  {
+    return false;
+  }
+  m_endToEndResults.push_back( cResult );
+  return true;
+}
+
+/** decode m_pchBitstreamFile without writing the output, keeping the decoded pictures for the picture level kernels
+ */
+Bool TAppBenchTop::xDecode()
+{
+  InputMappedByteStream bytestream;
+  if ( !bytestream.open( m_pchBitstreamFile ) )
+  {
+    fprintf( stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile );
+    return false;
+  }
+
+  m_cTDecTop.create();
+  m_cTDecTop.init();
+  m_cTDecTop.setDecodedPictureHashSEIEnabled( 1 );
+  m_cTDecTop.setNumThreads( m_iNumThreads );
+
+  Int             iSkipFrame      = 0;
+  Int             iPOCLastDisplay = -MAX_INT;
+  Int             poc             = 0;
+  Int             iNumPictures    = 0;
+  Bool            loopFiltered    = false;
+  const uint8_t*  nalUnit         = NULL;
+  UInt            nalUnitSize     = 0;
+  Bool            pendingNalUnit  = false;
+  vector<uint8_t> nalUnitBuf;
+
+  const BenchClock::time_point cStart = BenchClock::now();
+
+  while ( pendingNalUnit || !bytestream.eof() )
+  {
+    // see TAppDecTop::decode() for the handling of the first slice of a new picture
+    if ( !pendingNalUnit )
+    {
+      AnnexBStats stats = AnnexBStats();
+      byteStreamNALUnit( bytestream, nalUnit, nalUnitSize, stats );
+    }
+    pendingNalUnit = false;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::TComCodingStatisticsData backupStats( TComCodingStatistics::GetStatistics() );
+#endif
+
+    InputNALUnit nalu;
+    Bool         bNewPicture = false;
+    if ( nalUnitSize > 0 )
+    {
+      read( nalu, nalUnit, nalUnitSize, nalUnitBuf );
+      bNewPicture = m_cTDecTop.decode( nalu, iSkipFrame, iPOCLastDisplay );
+      if ( bNewPicture )
+      {
+        pendingNalUnit = true;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+        TComCodingStatistics::SetStatistics( backupStats );
+#endif
+      }
+    }
+    const Bool endOfStream = !pendingNalUnit && bytestream.eof();
+    if ( bNewPicture || endOfStream || nalu.m_nalUnitType == NAL_UNIT_EOS )
+    {
+      if ( !loopFiltered || !endOfStream )
+      {
+        m_cTDecTop.executeLoopFilters( poc, m_pcListPic );
+        if ( m_pcListPic )
+        {
+          iNumPictures++;
+        }
+      }
+      loopFiltered = ( nalu.m_nalUnitType == NAL_UNIT_EOS );
+    }
+  }
+  m_cTDecTop.flushPipeline();
+
+  EndToEndResult cResult;
+  cResult.stage    = "decode";
+  cResult.dSeconds = secondsSince( cStart );
+  cResult.iFrames  = iNumPictures;
+  if ( xUseKernel( "decode" ) )
+  {
+    m_endToEndResults.push_back( cResult );
+  }
+
+  if ( !m_pcListPic )
+  {
+    fprintf( stderr, "No picture was decoded from `%s'\n", m_pchBitstreamFile );
+    m_cTDecTop.deletePicBuffer();
+    m_cTDecTop.destroy();
+    return false;
+  }
+  return true;
+}
+
+/** deblocking of whole decoded pictures, or of the synthetic picture, filtering the reconstruction again
+ */
+Void TAppBenchTop::xBenchDeblocking()
+{
+  if ( !xUseKernel( "deblock" ) )
+  {
+    return;
+  }
+
+  vector<TComPic*> apcPics;
+  if ( !m_pcListPic )
+  {
+    apcPics.push_back( &m_cPic );
+  }
+  else
+  {
+    for ( TComList<TComPic*>::iterator it = m_pcListPic->begin(); it != m_pcListPic->end(); it++ )
+    {
+      if ( (*it)->getReconMark() )
+      {
+        apcPics.push_back( *it );
+      }
+    }
+  }
+  if ( apcPics.empty() )
+  {
+    return;
+  }
+
+  TComSlice*     pcSlice = apcPics[0]->getSlice( 0 );
+  TComSPS*       pcSPS   = pcSlice->getSPS();
+  TComLoopFilter cLoopFilter;
+  cLoopFilter.create( pcSPS->getMaxCUDepth() );
+  cLoopFilter.setCfg( pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag() );
+
+  const Int iWidth  = pcSPS->getPicWidthInLumaSamples();
+  const Int iHeight = pcSPS->getPicHeightInLumaSamples();
+  size_t    uiPic   = 0;
+  xMeasure( "deblock", "picture " + to_string( iWidth ) + "x" + to_string( iHeight ), iWidth * iHeight, [&]()
+  {
+    cLoopFilter.loopFilterPic( apcPics[uiPic++ % apcPics.size()] );
+  } );
+
+  cLoopFilter.destroy();
+}
+
+/** SAO of whole decoded pictures, with the parameters decoded from the bitstream
+ */
+Void TAppBenchTop::xBenchSaoPicture()
+{
+#if HM_CLEANUP_SAO
+  if ( !xUseKernel( "sao" ) )
+  {
+    return;
+  }
+  if ( !m_pcListPic )
+  {
+    xSkip( "sao", "picture", "the SAO parameters come from a bitstream (-b)" );
+    return;
+  }
+
+  vector<TComPic*> apcPics;
+  for ( TComList<TComPic*>::iterator it = m_pcListPic->begin(); it != m_pcListPic->end(); it++ )
+  {
+    if ( (*it)->getReconMark() && (*it)->getSlice( 0 )->getSPS()->getUseSAO() )
+    {
+      apcPics.push_back( *it );
+    }
+  }
+  if ( apcPics.empty() )
+  {
+    return;
+  }
+
+  TComSPS*                 pcSPS   = apcPics[0]->getSlice( 0 )->getSPS();
+  const Int                iWidth  = pcSPS->getPicWidthInLumaSamples();
+  const Int                iHeight = pcSPS->getPicHeightInLumaSamples();
+  TComSampleAdaptiveOffset cSao;
+  cSao.create( iWidth, iHeight, pcSPS->getChromaFormatIdc(), pcSPS->getMaxCUWidth(), pcSPS->getMaxCUHeight(), pcSPS->getMaxCUDepth() );
+
+  // the parameters were reconstructed from the merge candidates when the pictures were decoded
+  size_t uiPic = 0;
+  xMeasure( "sao", "picture " + to_string( iWidth ) + "x" + to_string( iHeight ), iWidth * iHeight, [&]()
+  {
+    cSao.SAOProcess( apcPics[uiPic++ % apcPics.size()] );
+  } );
+
+  cSao.destroy();
+#endif
+}
+
+/** forward transform and quantisation with and without RDOQ, and dequantisation and inverse transform, of square
+    luma blocks of inter residual. The coding data of the first CTU of a decoded picture, or of the synthetic picture,
+    provides the context.
+ */
+Void TAppBenchTop::xBenchTrQuant()
+{
+  if ( !xUseKernel( "trquant" ) )
+  {
+    return;
+  }
+
+  // residual between co-located blocks of the first and the last decoded picture, or of the two synthetic pictures
+  TComPic*    pcPic  = &m_cPic;
+  TComPicYuv* pcPicA = &m_cPicOrg;
+  TComPicYuv* pcPicB = &m_cPicRef;
+  if ( m_pcListPic )
+  {
+    pcPic = NULL;
+    for ( TComList<TComPic*>::iterator it = m_pcListPic->begin(); it != m_pcListPic->end(); it++ )
+    {
+      if ( (*it)->getReconMark() )
+      {
+        pcPic = *it;
+      }
+    }
+    if ( !pcPic )
+    {
+      return;
+    }
+    pcPicA = m_pcListPic->front()->getPicYuvRec();
+    pcPicB = pcPic->getPicYuvRec();
+  }
+
+  TComSlice*         pcSlice    = pcPic->getSlice( 0 );
+  TComSPS*           pcSPS      = pcSlice->getSPS();
+  TComDataCU*        pcCU       = pcPic->getCU( 0 );
+  const ChromaFormat chFmt      = pcPic->getChromaFormat();
+  const Int          qp         = pcSlice->getSliceQp();
+  const Double       dLambda    = 0.57 * pow( 2.0, ( qp - 12 ) / 3.0 );
+  const Int          iLog2MaxCU = g_aucConvertToBit[pcSPS->getMaxCUWidth()] + 2;
+  const Int          iStride    = pcPicA->getStride( COMPONENT_Y );
+
+  TComTrQuant cTrQuant;
+  TComTrQuant cTrQuantRDOQ;
+#if RDOQ_CHROMA_LAMBDA
+  const Double adLambdas[MAX_NUM_COMPONENT] = { dLambda, dLambda, dLambda };
+#endif
+#if ADAPTIVE_QP_SELECTION
+  cTrQuant    .init( pcSPS->getMaxTrSize(), false, false, true, false, false );
+  cTrQuantRDOQ.init( pcSPS->getMaxTrSize(), true,  true,  true, false, false );
+#else
+  cTrQuant    .init( pcSPS->getMaxTrSize(), false, false, true, false );
+  cTrQuantRDOQ.init( pcSPS->getMaxTrSize(), true,  true,  true, false );
+#endif
+  cTrQuant    .setFlatScalingList( chFmt );
+  cTrQuantRDOQ.setFlatScalingList( chFmt );
+  cTrQuant    .setUseScalingList( false );
+  cTrQuantRDOQ.setUseScalingList( false );
+#if RDOQ_CHROMA_LAMBDA
+  cTrQuant    .setLambdas( adLambdas );
+  cTrQuantRDOQ.setLambdas( adLambdas );
+  cTrQuant    .selectLambda( COMPONENT_Y );
+  cTrQuantRDOQ.selectLambda( COMPONENT_Y );
+#else
+  cTrQuant    .setLambda( dLambda );
+  cTrQuantRDOQ.setLambda( dLambda );
+#endif
+
+  // rate estimates of RDOQ, from the initial contexts of the slice
+  TComBitCounter      cBitCounter;
+  TEncBinCABACCounter cBinCounter;
+  TEncSbac            cSbac;
+  cSbac.init( &cBinCounter );
+  cSbac.setBitstream( &cBitCounter );
+  cSbac.setSlice( pcSlice );
+  cSbac.resetEntropy();
+
+  QpParam cQP;
+  setQPforQuant( cQP, qp, CHANNEL_TYPE_LUMA, pcSPS->getQpBDOffset( CHANNEL_TYPE_LUMA ), 0, chFmt, false );
+
+  const Int   iNumBlocks = 16;
+  vector<Pel>    aiResi ( iNumBlocks * MAX_TU_SIZE * MAX_TU_SIZE );
+  vector<TCoeff> aiCoeff( iNumBlocks * MAX_TU_SIZE * MAX_TU_SIZE );
+  vector<Pel>    aiRec  ( MAX_TU_SIZE * MAX_TU_SIZE );
+#if ADAPTIVE_QP_SELECTION
+  vector<TCoeff> aiArlCoeff( MAX_TU_SIZE * MAX_TU_SIZE );
+  TCoeff*        pcArlCoeff = &aiArlCoeff[0];
+#endif
+
+  for ( Int iLog2Size = 2; iLog2Size <= 5; iLog2Size++ )
+  {
+    const Int iSize      = 1 << iLog2Size;
+    const Int iLog2CU    = max( iLog2Size, pcSPS->getLog2MinCodingBlockSize() );
+    const Int iTrDepth   = iLog2CU - iLog2Size;
+    const Int iCUDepth   = iLog2MaxCU - iLog2CU;
+
+    if ( iSize > Int( pcSPS->getMaxTrSize() ) || iLog2Size < Int( pcSPS->getQuadtreeTULog2MinSize() ) || iTrDepth > 1 || iCUDepth < 0 )
+    {
+      continue;
+    }
+
+    // an inter coded CU at the top left of the CTU, with a single TU or split once for 4x4
+    setUpTransformCU( pcCU, iLog2Size, MODE_INTER, false, qp );
+
+    const vector<Int> aiOffsets = blockOffsets( pcPicA->getWidth( COMPONENT_Y ), pcPicA->getHeight( COMPONENT_Y ), iStride, iSize, iSize, 0 );
+    for ( Int iBlk = 0; iBlk < iNumBlocks; iBlk++ )
+    {
+      const Int  iOffset = aiOffsets[( iBlk * 5 ) % aiOffsets.size()];
+      const Pel* piA     = pcPicA->getAddr( COMPONENT_Y ) + iOffset;
+      const Pel* piB     = pcPicB->getAddr( COMPONENT_Y ) + iOffset;
+      Pel*       piResi  = &aiResi[iBlk * iSize * iSize];
+      for ( Int y = 0; y < iSize; y++ )
+      {
+        for ( Int x = 0; x < iSize; x++ )
+        {
+          piResi[y * iSize + x] = piB[y * iStride + x] - piA[y * iStride + x];
+        }
+      }
+    }
+
+    cSbac.estBit( cTrQuantRDOQ.m_pcEstBitsSbac, iSize, iSize, CHANNEL_TYPE_LUMA );
+
+    auto run = [&]( TComTU& rTu )
+    {
+      const string size  = to_string( iSize ) + "x" + to_string( iSize );
+      Int          iBlk  = 0;
+      TCoeff       uiAbsSum;
+
+      xMeasure( "trquant", "forward " + size, iSize * iSize, [&]()
+      {
+        const Int i = iBlk++ % iNumBlocks;
+        cTrQuant.transformNxN( rTu, COMPONENT_Y, &aiResi[i * iSize * iSize], iSize, &aiCoeff[i * iSize * iSize],
+#if ADAPTIVE_QP_SELECTION
+                               pcArlCoeff,
+#endif
+                               uiAbsSum, cQP );
+        m_uiSink += uiAbsSum;
+      } );
+
+      xMeasure( "trquant", "forward RDOQ " + size, iSize * iSize, [&]()
+      {
+        const Int i = iBlk++ % iNumBlocks;
+        cTrQuantRDOQ.transformNxN( rTu, COMPONENT_Y, &aiResi[i * iSize * iSize], iSize, &aiCoeff[i * iSize * iSize],
+#if ADAPTIVE_QP_SELECTION
+                                   pcArlCoeff,
+#endif
+                                   uiAbsSum, cQP );
+        m_uiSink += uiAbsSum;
+      } );
+
+      // the coefficients of the last forward run of each block are dequantised
+      xMeasure( "trquant", "inverse " + size, iSize * iSize, [&]()
+      {
+        const Int i    = iBlk++ % iNumBlocks;
+        Pel*      piRec = &aiRec[0];
+        cTrQuant.invTransformNxN( rTu, COMPONENT_Y, piRec, iSize, &aiCoeff[i * iSize * iSize], cQP DEBUG_STRING_PASS_INTO( NULL ) );
+        m_uiSink += aiRec[0];
+      } );
+    };
+
+    TComTURecurse cTuCU( pcCU, 0, iCUDepth );
+    if ( iTrDepth == 0 )
+    {
+      run( cTuCU );
+    }
+    else
+    {
+      TComTURecurse cTu( cTuCU, false );
+      run( cTu );
+    }
+  }
+}
+
+Void TAppBenchTop::xPrintResults()
+{
+  for ( size_t i = 0; i < m_endToEndResults.size(); i++ )
+  {
+    const EndToEndResult& r = m_endToEndResults[i];
+    printf( "%-8s %d frames in %.3f s, %.2f fps\n", r.stage.c_str(), r.iFrames, r.dSeconds, r.iFrames / r.dSeconds );
+  }
+}
+
+/** results as a JSON object: the environment, one entry per kernel case and one per end-to-end run
+ */
+Void TAppBenchTop::xWriteJson()
+{
+  if ( !m_pchOutputFile )
+  {
+    return;
+  }
+
+  FILE* pFile = fopen( m_pchOutputFile, "w" );
+  if ( !pFile )
+  {
+    fprintf( stderr, "\nfailed to open `%s' for writing\n", m_pchOutputFile );
+    return;
+  }
+
+  fprintf( pFile, "{\n" );
+  fprintf( pFile, "  \"version\": \"%s\",\n", NV_VERSION );
+  fprintf( pFile, "  \"simd\": \"%s\",\n", getSIMDExtensionName( getSIMDExtension() ) );
+  fprintf( pFile, "  \"high_bit_depth_support\": %s,\n", RExt__HIGH_BIT_DEPTH_SUPPORT ? "true" : "false" );
+  fprintf( pFile, "  \"input\": \"%s\",\n", m_bRealData ? escapeJson( m_pchInputFile ).c_str() : "synthetic" );
+  fprintf( pFile, "  \"width\": %d,\n", m_iSourceWidth );
+  fprintf( pFile, "  \"height\": %d,\n", m_iSourceHeight );
+  fprintf( pFile, "  \"bit_depth\": %d,\n", m_internalBitDepth );
+  fprintf( pFile, "  \"bitstream\": %s,\n", m_pchBitstreamFile ? ( "\"" + escapeJson( m_pchBitstreamFile ) + "\"" ).c_str() : "null" );
+
+  fprintf( pFile, "  \"kernels\": [" );
+  for ( size_t i = 0; i < m_kernelResults.size(); i++ )
+  {
+    const KernelResult& r = m_kernelResults[i];
+    fprintf( pFile, "%s\n    { \"kernel\": \"%s\", \"case\": \"%s\", \"calls\": %llu, \"ns_per_call\": %.3f, \"ns_per_call_min\": %.3f, \"msamples_per_s\": %.3f }",
+             i ? "," : "", r.kernel.c_str(), escapeJson( r.variant ).c_str(), (unsigned long long) r.uiCalls, r.dNsPerCall, r.dNsPerCallMin, 1e3 * r.dSamplesPerCall / r.dNsPerCall );
+  }
+  fprintf( pFile, "%s],\n", m_kernelResults.empty() ? "" : "\n  " );
+
+  fprintf( pFile, "  \"checks\": [" );
+  for ( size_t i = 0; i < m_checkResults.size(); i++ )
+  {
+    const CheckResult& r = m_checkResults[i];
+    fprintf( pFile, "%s\n    { \"check\": \"%s\", \"case\": \"%s\", \"passed\": %s }",
+             i ? "," : "", r.check.c_str(), escapeJson( r.variant ).c_str(), r.bPassed ? "true" : "false" );
+  }
+  fprintf( pFile, "%s],\n", m_checkResults.empty() ? "" : "\n  " );
+
+  fprintf( pFile, "  \"skipped\": [" );
+  for ( size_t i = 0; i < m_skippedResults.size(); i++ )
+  {
+    const SkippedResult& r = m_skippedResults[i];
+    fprintf( pFile, "%s\n    { \"kernel\": \"%s\", \"case\": \"%s\", \"reason\": \"%s\" }",
+             i ? "," : "", r.kernel.c_str(), escapeJson( r.variant ).c_str(), escapeJson( r.reason ).c_str() );
+  }
+  fprintf( pFile, "%s],\n", m_skippedResults.empty() ? "" : "\n  " );
+
+  fprintf( pFile, "  \"end_to_end\": [" );
+  for ( size_t i = 0; i < m_endToEndResults.size(); i++ )
+  {
+    const EndToEndResult& r = m_endToEndResults[i];
+    fprintf( pFile, "%s\n    { \"stage\": \"%s\", \"frames\": %d, \"seconds\": %.3f, \"fps\": %.3f }",
+             i ? "," : "", r.stage.c_str(), r.iFrames, r.dSeconds, r.iFrames / r.dSeconds );
+  }
+  fprintf( pFile, "%s]\n", m_endToEndResults.empty() ? "" : "\n  " );
+  fprintf( pFile, "}\n" );
+
+  fclose( pFile );
+}
+
+//! \}
@@ -0,0 +1,168 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppBenchTop.h
+    \brief    Benchmark application class (header)
+*/
+
+#ifndef __TAPPBENCHTOP__
+#define __TAPPBENCHTOP__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <string>
+#include <vector>
+
+#include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComList.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibDecoder/TDecTop.h"
+#include "TAppBenchCfg.h"
+
+//! \ingroup TAppBenchmark
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// benchmark application class
+class TAppBenchTop : public TAppBenchCfg
+{
+private:
+  /// measurement of one kernel case
+  struct KernelResult
+  {
+    std::string              kernel;                        ///< kernel name, as used by the Kernels option
+    std::string              variant;                       ///< function and block size
+    UInt64                   uiCalls;                       ///< number of calls of one measurement
+    Double                   dNsPerCall;                    ///< median time of one call over the measurements
+    Double                   dNsPerCallMin;                 ///< fastest time of one call over the measurements
+    Double                   dSamplesPerCall;               ///< samples (or bins) processed by one call
+  };
+
+  /// measurement of an end-to-end run
+  struct EndToEndResult
+  {
+    std::string              stage;                         ///< "encode" or "decode"
+    Int                      iFrames;                       ///< number of frames
+    Double                   dSeconds;                      ///< wall clock time
+  };
+
+  /// outcome of one case of a check of the SIMD kernels against the plain C ones, or of the encoder
+  struct CheckResult
+  {
+    std::string              check;                         ///< check name, as used by the Kernels option
+    std::string              variant;                       ///< function and block size, or encoder settings
+    Bool                     bPassed;                       ///< the SIMD and C results are identical, or the encodes are as expected
+  };
+
+  /// kernel that could not be run
+  struct SkippedResult
+  {
+    std::string              kernel;                        ///< kernel name, as used by the Kernels option
+    std::string              variant;                       ///< function
+    std::string              reason;                        ///< why it was not run
+  };
+
+  std::vector<KernelResult>   m_kernelResults;
+  std::vector<EndToEndResult> m_endToEndResults;
+  std::vector<CheckResult>    m_checkResults;
+  std::vector<SkippedResult>  m_skippedResults;
+
+  TComPicYuv                 m_cPicOrg;                     ///< picture data of the kernels
+  TComPicYuv                 m_cPicRef;                     ///< second picture, used as prediction / reference
+  Bool                       m_bRealData;                   ///< pictures were read from the input file
+
+  TComSPS                    m_cSPS;                        ///< parameter sets of m_cPic
+  TComPPS                    m_cPPS;
+  TComPic                    m_cPic;                        ///< picture of a single slice, providing the coding data of the kernels that need a CU,
+                                                            ///< and the picture of the picture level kernels without a bitstream
+
+  TDecTop                    m_cTDecTop;                    ///< decoder of the end-to-end decode, holds the decoded pictures
+  TComList<TComPic*>*        m_pcListPic;                   ///< decoded pictures used by the picture level kernels
+
+  UInt64                     m_uiSink;                      ///< accumulates kernel results so that the calls are not optimised out
+
+protected:
+  Bool  xUseKernel        ( const Char* pchKernel ) const;  ///< check whether a benchmark was selected
+  template <typename F>
+  Void  xMeasure          ( const Char* pchKernel, const std::string& variant, Double dSamplesPerCall, F fnCall );
+
+  Void  xCreatePictures   ();                               ///< read or synthesise the picture data
+  Void  xDestroyPictures  ();
+  Void  xSetUpCodingData  ();                               ///< synthesise the coding data of m_cPic for the deblocking
+  Void  xSkip             ( const Char* pchKernel, const std::string& variant, const std::string& reason );
+
+  // kernels on the picture data
+  Void  xBenchRdCost      ();
+  Void  xBenchInterpolation();
+  Void  xBenchSaoBlock    ();
+  Void  xBenchCabac       ();
+
+  // checks of the SIMD kernels against the plain C ones
+  Void  xCheckTransforms  ();
+  Void  xCheckTrQuant     ();
+  Void  xAddCheckResult   ( const Char* pchCheck, const std::string& variant, Bool bPassed );
+
+  // regression checks of the encoder on synthetic sequences
+  Void  xCheckThreads     ();
+  Void  xCheckSubPelCache ();
+  Void  xCheckSceneCut    ();
+  Bool  xEncodeCheck      ( const Char* pchBitstreamFile, const std::vector<std::string>& options );
+
+  // end-to-end runs
+  Bool  xEncode           ();
+  Bool  xDecode           ();
+
+  // kernels on decoded pictures, or on m_cPic without a bitstream
+  Void  xBenchDeblocking  ();
+  Void  xBenchSaoPicture  ();
+  Void  xBenchTrQuant     ();
+
+  Void  xWriteJson        ();                               ///< write the results to m_pchOutputFile
+  Void  xPrintResults     ();                               ///< print the results to stdout
+
+public:
+  TAppBenchTop();
+  virtual ~TAppBenchTop() {}
+
+  Void  bench             ();                               ///< main benchmark function
+  Bool  getChecksPassed   () const;                         ///< no check found a mismatch
+};
+
+//! \}
+
+#endif // __TAPPBENCHTOP__
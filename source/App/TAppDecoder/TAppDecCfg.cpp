@@ -86,6 +86,9 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("SEINoDisplay", m_decodedNoDisplaySEIEnabled, true, "Control handling of decoded no display SEI messages")
   ("TarDecLayerIdSetFile,l", cfg_TargetDecLayerIdSetFile, string(""), "targetDecLayerIdSet file name. The file should include white space separated LayerId values to be decoded. Omitting the option or a value of -1 in the file decodes all layers.")
   ("RespectDefDispWindow,w", m_respectDefDispWindow, 0, "Only output content inside the default display window\n")
+  ("Threads", m_iNumThreads, 1, "Number of worker threads of the decoder, for parallel decoding of WPP CTU rows and independent tiles")
+  ("PipelinedDecoding", m_bPipelinedDecoding, false, "Run in-loop filtering, hash checking and output of a picture on a separate thread, overlapped with decoding of the next pictures")
+  ("AsyncYuvIO", m_asyncYuvIO, 0u, "Number of reconstructed frames written behind by a YUV file I/O thread (0: synchronous I/O)")
   ;
 
   po::setDefaults(opts);
@@ -119,6 +122,12 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
     return false;
   }
 
+  if (m_iNumThreads <= 0)
+  {
+    fprintf(stderr, "Threads must be positive, aborting\n");
+    return false;
+  }
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
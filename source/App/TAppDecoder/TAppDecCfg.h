@@ -67,6 +67,9 @@ protected:
   Bool          m_decodedNoDisplaySEIEnabled;         ///< Enable(true)/disable(false) writing only pictures that get displayed based on the no display SEI message
   std::vector<Int> m_targetDecLayerIdSet;             ///< set of LayerIds to be included in the sub-bitstream extraction process.
   Int           m_respectDefDispWindow;               ///< Only output content inside the default display window 
+  Int           m_iNumThreads;                        ///< number of worker threads of the decoder
+  Bool          m_bPipelinedDecoding;                 ///< filter, check and output pictures on a separate thread
+  UInt          m_asyncYuvIO;                         ///< number of frames buffered by the YUV writer thread (0: synchronous)
   
 public:
   TAppDecCfg()
@@ -78,6 +81,9 @@ public:
   , m_decodedPictureHashSEIEnabled(0)
   , m_decodedNoDisplaySEIEnabled(false)
   , m_respectDefDispWindow(0)
+  , m_iNumThreads(1)
+  , m_bPipelinedDecoding(false)
+  , m_asyncYuvIO(0)
   {
     for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
       m_outputBitDepth[channelTypeIndex] = 0;
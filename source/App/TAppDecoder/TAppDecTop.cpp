@@ -95,15 +95,13 @@ Void TAppDecTop::decode()
   Int                 poc;
   TComList<TComPic*>* pcListPic = NULL;
 
-  ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
-  if (!bitstreamFile)
+  InputMappedByteStream bytestream;
+  if (!bytestream.open(m_pchBitstreamFile))
   {
     fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile);
     exit(EXIT_FAILURE);
   }
 
-  InputByteStream bytestream(bitstreamFile);
-
   // create & initialize internal classes
   xCreateDecLib();
   xInitDecLib  ();
@@ -112,28 +110,32 @@ Void TAppDecTop::decode()
   // main decoder loop
   Bool openedReconFile = false; // reconstruction file not yet opened. (must be performed after SPS is seen)
   Bool loopFiltered = false;
-  
-  while (!!bitstreamFile)
+
+  /* the process of reading a new slice that is the first slice of a new
+   * frame requires the TDecTop::decode() method to be called again with the
+   * same nal unit, which stays available in the mapped bitstream. */
+  const uint8_t* nalUnit = NULL;
+  UInt nalUnitSize = 0;
+  Bool pendingNalUnit = false;
+  vector<uint8_t> nalUnitBuf;
+
+  while (pendingNalUnit || !bytestream.eof())
   {
-    /* location serves to work around a design fault in the decoder, whereby
-     * the process of reading a new slice that is the first slice of a new frame
-     * requires the TDecTop::decode() method to be called again with the same
-     * nal unit. */
+    if (!pendingNalUnit)
+    {
+      AnnexBStats stats = AnnexBStats();
+      byteStreamNALUnit(bytestream, nalUnit, nalUnitSize, stats);
+    }
+    pendingNalUnit = false;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     TComCodingStatistics::TComCodingStatisticsData backupStats(TComCodingStatistics::GetStatistics());
-    streampos location = bitstreamFile.tellg() - streampos(bytestream.GetNumBufferedBytes());
-#else
-    streampos location = bitstreamFile.tellg();
 #endif
-    AnnexBStats stats = AnnexBStats();
 
-    vector<uint8_t> nalUnit;
     InputNALUnit nalu;
-    byteStreamNALUnit(bytestream, nalUnit, stats);
 
     // call actual decoding function
     Bool bNewPicture = false;
-    if (nalUnit.empty())
+    if (nalUnitSize == 0)
     {
       /* this can happen if the following occur:
        *  - empty input file
@@ -144,7 +146,7 @@ Void TAppDecTop::decode()
     }
     else
     {
-      read(nalu, nalUnit);
+      read(nalu, nalUnit, nalUnitSize, nalUnitBuf);
       if( (m_iMaxTemporalLayer >= 0 && nalu.m_temporalId > m_iMaxTemporalLayer) || !isNaluWithinTargetDecLayerIdSet(&nalu)  )
       {
         bNewPicture = false;
@@ -154,25 +156,17 @@ Void TAppDecTop::decode()
         bNewPicture = m_cTDecTop.decode(nalu, m_iSkipFrame, m_iPOCLastDisplay);
         if (bNewPicture)
         {
-          bitstreamFile.clear();
-          /* location points to the current nalunit payload[1] due to the
-           * need for the annexB parser to read three extra bytes.
-           * [1] except for the first NAL unit in the file
-           *     (but bNewPicture doesn't happen then) */
+          pendingNalUnit = true;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-          bitstreamFile.seekg(location);
-          bytestream.reset();
           TComCodingStatistics::SetStatistics(backupStats);
-#else
-          bitstreamFile.seekg(location-streamoff(3));
-          bytestream.reset();
 #endif
         }
       }
     }
-    if (bNewPicture || !bitstreamFile || nalu.m_nalUnitType == NAL_UNIT_EOS)
+    const Bool endOfStream = !pendingNalUnit && bytestream.eof();
+    if (bNewPicture || endOfStream || nalu.m_nalUnitType == NAL_UNIT_EOS)
     {
-      if (!loopFiltered || bitstreamFile)
+      if (!loopFiltered || !endOfStream)
       {
         m_cTDecTop.executeLoopFilters(poc, pcListPic);
       }
@@ -185,13 +179,14 @@ Void TAppDecTop::decode()
       {
         for (UInt channelType = 0; channelType < MAX_NUM_CHANNEL_TYPE; channelType++)
         {
-          if (m_outputBitDepth[channelType] == 0) m_outputBitDepth[channelType] = g_bitDepth[channelType];
+          if (m_outputBitDepth[channelType] == 0) m_outputBitDepth[channelType] = m_cTDecTop.getRomContext().bitDepth[channelType];
         }
 
+        m_cTVideoIOYuvReconFile.setAsyncDepth( m_asyncYuvIO );
 #if RExt__INPUT_MSB_EXTENSION
-        m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, m_outputBitDepth, g_bitDepth ); // write mode
+        m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, m_outputBitDepth, m_cTDecTop.getRomContext().bitDepth ); // write mode
 #else
-        m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, g_bitDepth ); // write mode
+        m_cTVideoIOYuvReconFile.open( m_pchReconFile, true, m_outputBitDepth, m_cTDecTop.getRomContext().bitDepth ); // write mode
 #endif
         openedReconFile = true;
       }
@@ -250,6 +245,8 @@ Void TAppDecTop::xInitDecLib()
   // initialize decoder class
   m_cTDecTop.init();
   m_cTDecTop.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
+  m_cTDecTop.setNumThreads(m_iNumThreads);
+  m_cTDecTop.setPipelined(m_bPipelinedDecoding);
 }
 
 /** \param pcListPic list of pictures to be written to file
@@ -318,12 +315,15 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
 
           if (display)
           {
-            m_cTVideoIOYuvReconFile.write( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
-                                           m_outputColourSpaceConvert,
-                                           conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
-                                           conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
-                                           conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
-                                           conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset(), NUM_CHROMA_FORMAT, isTff );
+            xRunPictureWrite( pcPicTop, pcPicBottom, [=]()
+            {
+              m_cTVideoIOYuvReconFile.write( pcPicTop->getPicYuvRec(), pcPicBottom->getPicYuvRec(),
+                                             m_outputColourSpaceConvert,
+                                             conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                             conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                             conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                             conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset(), NUM_CHROMA_FORMAT, isTff );
+            } );
           }
         }
         
@@ -383,12 +383,15 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
           const Window &conf    = pcPic->getConformanceWindow();
           const Window &defDisp = m_respectDefDispWindow ? pcPic->getDefDisplayWindow() : Window();
 
-          m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(),
-                                         m_outputColourSpaceConvert,
-                                         conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
-                                         conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
-                                         conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
-                                         conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset() );
+          xRunPictureWrite( pcPic, NULL, [=]()
+          {
+            m_cTVideoIOYuvReconFile.write( pcPic->getPicYuvRec(),
+                                           m_outputColourSpaceConvert,
+                                           conf.getWindowLeftOffset() + defDisp.getWindowLeftOffset(),
+                                           conf.getWindowRightOffset() + defDisp.getWindowRightOffset(),
+                                           conf.getWindowTopOffset() + defDisp.getWindowTopOffset(),
+                                           conf.getWindowBottomOffset() + defDisp.getWindowBottomOffset() );
+          } );
         }
       
         // update POC of display order
@@ -423,6 +426,9 @@ Void TAppDecTop::xWriteOutput( TComList<TComPic*>* pcListPic, UInt tId )
  */
 Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
 {
+  // the pictures go back to the picture pool below, so all queued filtering and writing has to be done
+  m_cTDecTop.flushPipeline();
+
   if(!pcListPic || pcListPic->empty())
   {
     return;
@@ -495,23 +501,8 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
         }
         pcPicTop->setOutputMark(false);
         pcPicBottom->setOutputMark(false);
-        
-#if !DYN_REF_FREE
-        if(pcPicTop)
-        {
-          pcPicTop->destroy();
-          delete pcPicTop;
-          pcPicTop = NULL;
-        }
-#endif
       }
     }
-    if(pcPicBottom)
-    {
-      pcPicBottom->destroy();
-      delete pcPicBottom;
-      pcPicBottom = NULL;
-    }
   }
   else //Frame decoding
   {  
@@ -556,21 +547,31 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
         }
         pcPic->setOutputMark(false);
       }
-  #if !DYN_REF_FREE
-      if(pcPic != NULL)
-      {
-        pcPic->destroy();
-        delete pcPic;
-        pcPic = NULL;
-      }
-  #endif    
       iterPic++;
     }
   }
-  pcListPic->clear();
+  m_cTDecTop.releasePicBuffer();
   m_iPOCLastDisplay = -MAX_INT;
 }
 
+/** Write pictures to the reconstruction file. When decoding is pipelined, the write is queued behind
+    the in-loop filtering of the pictures on the decoder's filter thread.
+    \param pcPic0 first picture written
+    \param pcPic1 second picture written for field pairs, or NULL
+    \param cWrite the actual write
+ */
+Void TAppDecTop::xRunPictureWrite( TComPic* pcPic0, TComPic* pcPic1, const std::function<Void()>& cWrite )
+{
+  if (m_cTDecTop.getPipelined())
+  {
+    m_cTDecTop.queuePictureTask( pcPic0, pcPic1, cWrite );
+  }
+  else
+  {
+    cWrite();
+  }
+}
+
 /** \param nalu Input nalu to check whether its LayerId is within targetDecLayerIdSet
  */
 Bool TAppDecTop::isNaluWithinTargetDecLayerIdSet( InputNALUnit* nalu )
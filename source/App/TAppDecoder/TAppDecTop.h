@@ -81,6 +81,7 @@ protected:
   
   Void  xWriteOutput      ( TComList<TComPic*>* pcListPic , UInt tId); ///< write YUV to file
   Void  xFlushOutput      ( TComList<TComPic*>* pcListPic ); ///< flush all remaining decoded pictures to file
+  Void  xRunPictureWrite  ( TComPic* pcPic0, TComPic* pcPic1, const std::function<Void()>& cWrite ); ///< write pictures, deferred when decoding is pipelined
   Bool  isNaluWithinTargetDecLayerIdSet ( InputNALUnit* nalu ); ///< check whether given Nalu is within targetDecLayerIdSet
 };
 
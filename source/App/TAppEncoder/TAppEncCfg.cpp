@@ -361,6 +361,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("FrameRate,-fr",         m_iFrameRate,                                0, "Frame rate")
   ("FrameSkip,-fs",         m_FrameSkip,                                0u, "Number of frames to skip at start of input YUV")
   ("FramesToBeEncoded,f",   m_framesToBeEncoded,                         0, "Number of frames to be encoded (default=all)")
+  ("AsyncYuvIO",            m_asyncYuvIO,                               0u, "Number of frames read ahead and written behind by YUV file I/O threads; input files are memory mapped when possible (0: synchronous I/O)")
 
   //Field coding parameters
   ("FieldCoding", m_isField, false, "Signals if it's a field based coding")
@@ -399,6 +400,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("FastSearch",              m_iFastSearch,                1, "0:Full search  1:Diamond  2:PMVFAST")
   ("SearchRange,-sr",         m_iSearchRange,              96, "Motion search range")
   ("BipredSearchRange",       m_bipredSearchRange,          4, "Motion search range for bipred refinement")
+  ("HashME",                  m_useHashME,              false, "Look up integer motion vectors of exactly matching blocks in a hash index of each reference picture before the motion search")
+  ("SubPelCache",             m_useSubPelCache,         false, "Interpolate the luma sub-pel planes of each reference picture once, a CTU row at a time on first use, for the fractional motion search")
+  ("PyramidME",               m_usePyramidME,           false, "Coarse motion search of each CTU on quarter and sixteenth resolution pictures, used as an additional start of a narrower TZ search")
   ("HadamardME",              m_bUseHADME,               true, "Hadamard ME for fractional-pel")
   ("ASR",                     m_bUseASR,                false, "Adaptive motion search range")
 
@@ -427,6 +431,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 
   ("AdaptiveQP,-aq",                m_bUseAdaptiveQP,           false, "QP adaptation based on a psycho-visual model")
   ("MaxQPAdaptationRange,-aqr",     m_iQPAdaptationRange,           6, "QP adaptation range")
+  ("Lookahead",                     m_useLookahead,             false, "Analyse the received pictures on a separate thread ahead of coding: adaptive QP activity, picture pyramid, low resolution intra/inter costs per CTU and scene cuts")
+  ("LookaheadSceneCut",             m_useLookaheadSceneCut,     false, "Code the pictures that the lookahead detects as scene cuts with I slices at the intra QP, without making them random access points")
+  ("LookaheadIntraPruning",         m_useLookaheadIntraPruning, false, "Do not test intra modes in inter pictures for CTUs whose lookahead inter cost is well below their intra cost")
   ("dQPFile,m",                     cfg_dQPFile,           string(""), "dQP file name")
   ("RDOQ",                          m_useRDOQ,                  true )
   ("RDOQTS",                        m_useRDOQTS,                true )
@@ -445,6 +452,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   // Coding tools
   ("AMP",                     m_enableAMP,               true,  "Enable asymmetric motion partitions")
   ("IntraBlockCopyEnabled",   m_useIntraBlockCopy,  false, "Enable the use of intra block copying vectors (not valid in V1 profiles)")
+  ("IntraBlockCopyHashSearch", m_useIntraBlockCopyHashSearch, false, "Look up 8x8 and 16x16 IntraBC candidates in a hash table of the coded blocks before the SAD search")
 #if RExt__O0202_CROSS_COMPONENT_DECORRELATION
   ("CrossComponentDecorrelation",     m_useCrossComponentDecorrelation,  false, "Enable the use of cross-component decorrelation (not valid in V1 profiles)")
   ("ReconBasedDecorrelationEstimate", m_reconBasedDecorrelationEstimate, false, "When determining the alpha value for cross-component decorrelation, use the decoded residual rather than the pre-transform encoder-side residual")
@@ -507,6 +515,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("RowHeightArray",              cfg_RowHeight,                   string(""), "Array containing RowHeight values in units of LCU")
   ("LFCrossTileBoundaryFlag",      m_bLFCrossTileBoundaryFlag,             true,          "1: cross-tile-boundary loop filtering. 0:non-cross-tile-boundary loop filtering")
   ("WaveFrontSynchro",            m_iWaveFrontSynchro,             0,          "0: no synchro; 1 synchro with TR; 2 TRR etc")
+  ("Threads",                     m_iNumThreads,                   1,          "Number of worker threads of the encoder; CTU rows are compressed in parallel with WaveFrontSynchro")
+  ("ParallelIntraPeriods",        m_iParallelIntraPeriods,         1,          "Number of intra periods encoded at the same time by separate encoders, each period starting with an IDR picture (1: sequential)")
+  ("LowLatencyOutput",            m_bLowLatencyOutput,             false,      "Write each NAL unit as soon as it is coded; without picture reordering, code each picture as soon as it is read")
   ("ScalingList",                 m_useScalingListId,              0,          "0: no scaling list, 1: default scaling lists, 2: scaling lists specified in ScalingListFile")
   ("ScalingListFile",             cfg_ScalingListFile,             string(""), "Scaling list file name")
   ("SignHideFlag,-SBH",                m_signHideFlag, 1)
@@ -1042,6 +1053,7 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_crQpOffset >  12,   "Max. Chroma Cr QP Offset is  12" );
 
   xConfirmPara( m_iQPAdaptationRange <= 0,                                                  "QP Adaptation Range must be more than 0" );
+  xConfirmPara( ( m_useLookaheadSceneCut || m_useLookaheadIntraPruning ) && !m_useLookahead, "LookaheadSceneCut and LookaheadIntraPruning require Lookahead" );
   if (m_iDecodingRefreshType == 2)
   {
     xConfirmPara( m_iIntraPeriod > 0 && m_iIntraPeriod <= m_iGOPSize ,                      "Intra period must be larger than GOP size for periodic IDR pictures");
@@ -1517,6 +1529,11 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iWaveFrontSynchro < 0, "WaveFrontSynchro cannot be negative" );
   xConfirmPara( m_iWaveFrontSubstreams <= 0, "WaveFrontSubstreams must be positive" );
   xConfirmPara( m_iWaveFrontSubstreams > 1 && !m_iWaveFrontSynchro, "Must have WaveFrontSynchro > 0 in order to have WaveFrontSubstreams > 1" );
+  xConfirmPara( m_iNumThreads <= 0, "Threads must be positive" );
+  xConfirmPara( m_iParallelIntraPeriods <= 0, "ParallelIntraPeriods must be positive" );
+  xConfirmPara( m_iParallelIntraPeriods > 1 && m_iIntraPeriod <= 0, "ParallelIntraPeriods > 1 requires IntraPeriod > 0" );
+  xConfirmPara( m_iParallelIntraPeriods > 1 && m_isField, "ParallelIntraPeriods > 1 is not supported with field coding" );
+  xConfirmPara( m_iParallelIntraPeriods > 1 && m_bLowLatencyOutput, "LowLatencyOutput is not supported with ParallelIntraPeriods > 1" );
 
   xConfirmPara( m_decodedPictureHashSEIEnabled<0 || m_decodedPictureHashSEIEnabled>3, "this hash type is not correct!\n");
 
@@ -1639,6 +1656,9 @@ Void TAppEncCfg::xPrintParameter()
   printf("Max RQT depth intra             : %d\n", m_uiQuadtreeTUMaxDepthIntra);
   printf("Min PCM size                    : %d\n", 1 << m_uiPCMLog2MinSize);
   printf("Motion search range             : %d\n", m_iSearchRange );
+  printf("Hash motion search              : %s\n", (m_useHashME ? "Enabled" : "Disabled") );
+  printf("Sub-pel plane cache             : %s\n", (m_useSubPelCache ? "Enabled" : "Disabled") );
+  printf("Pyramid motion search           : %s\n", (m_usePyramidME ? "Enabled" : "Disabled") );
   printf("Intra period                    : %d\n", m_iIntraPeriod );
   printf("Decoding refresh type           : %d\n", m_iDecodingRefreshType );
   printf("QP                              : %5.2f\n", m_fQP );
@@ -1648,6 +1668,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("Cr QP Offset                    : %d\n", m_crQpOffset);
 
   printf("QP adaptation                   : %d (range=%d)\n", m_bUseAdaptiveQP, (m_bUseAdaptiveQP ? m_iQPAdaptationRange : 0) );
+  printf("Lookahead                       : %s (scene cuts=%d, intra pruning=%d)\n", (m_useLookahead ? "Enabled" : "Disabled"), m_useLookaheadSceneCut, m_useLookaheadIntraPruning );
   printf("GOP size                        : %d\n", m_iGOPSize );
   printf("Input bit depth                 : (Y:%d, C:%d)\n", m_inputBitDepth[CHANNEL_TYPE_LUMA], m_inputBitDepth[CHANNEL_TYPE_CHROMA] );
 #if RExt__INPUT_MSB_EXTENSION
@@ -1666,7 +1687,7 @@ Void TAppEncCfg::xPrintParameter()
   printf("Inter residual DPCM             : %s\n", (m_useResidualDPCM[MODE_INTER]            ? "Enabled" : "Disabled") );
 #endif
 #endif
-  printf("Intra Block Copying             : %s\n", (m_useIntraBlockCopy                      ? "Enabled" : "Disabled") );
+  printf("Intra Block Copying             : %s\n", (m_useIntraBlockCopy                      ? (m_useIntraBlockCopyHashSearch ? "Enabled (hash search)" : "Enabled") : "Disabled") );
 #if RExt__NRCE2_RESIDUAL_ROTATION
   printf("Residual rotation               : %s\n", (m_useResidualRotation                    ? "Enabled" : "Disabled") );
 #endif
@@ -1756,8 +1777,8 @@ Void TAppEncCfg::xPrintParameter()
   printf("WPP:%d ", (Int)m_useWeightedPred);
   printf("WPB:%d ", (Int)m_useWeightedBiPred);
   printf("PME:%d ", m_log2ParallelMergeLevel);
-  printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d",
-          m_iWaveFrontSynchro, m_iWaveFrontSubstreams);
+  printf(" WaveFrontSynchro:%d WaveFrontSubstreams:%d Threads:%d ParallelIntraPeriods:%d LowLatencyOutput:%d",
+          m_iWaveFrontSynchro, m_iWaveFrontSubstreams, m_iNumThreads, m_iParallelIntraPeriods, m_bLowLatencyOutput);
   printf(" ScalingList:%d ", m_useScalingListId );
   printf("TMVPMode:%d ", m_TMVPModeId     );
 #if ADAPTIVE_QP_SELECTION
@@ -57,6 +57,7 @@ protected:
   Char*     m_pchInputFile;                                   ///< source file name
   Char*     m_pchBitstreamFile;                               ///< output bitstream file
   Char*     m_pchReconFile;                                   ///< output reconstruction file
+  UInt      m_asyncYuvIO;                                     ///< number of frames buffered by the YUV file I/O threads (0: synchronous)
   Double    m_adLambdaModifier[ MAX_TLAYER ];                 ///< Lambda modifier array for each temporal layer
   // source specification
   Int       m_iFrameRate;                                     ///< source frame-rates (Hz)
@@ -140,6 +141,9 @@ protected:
 
   Bool      m_bUseAdaptiveQP;                                 ///< Flag for enabling QP adaptation based on a psycho-visual model
   Int       m_iQPAdaptationRange;                             ///< dQP range by QP adaptation
+  Bool      m_useLookahead;                                   ///< analyse the received pictures on a lookahead thread
+  Bool      m_useLookaheadSceneCut;                           ///< code the scene cuts found by the lookahead with I slices
+  Bool      m_useLookaheadIntraPruning;                       ///< skip intra modes in CTUs that the lookahead found well predicted
   
   Int       m_maxTempLayer;                                  ///< Max temporal layer
 
@@ -164,6 +168,7 @@ protected:
   Int       m_internalBitDepth[MAX_NUM_CHANNEL_TYPE];         ///< bit-depth codec operates at (input/output files will be converted)
   Bool      m_useExtendedPrecision;
   Bool      m_useIntraBlockCopy;
+  Bool      m_useIntraBlockCopyHashSearch;                    ///< find IntraBC vectors by hash lookup before the SAD search
 #if RExt__O0235_HIGH_PRECISION_PREDICTION_WEIGHTING
   Bool      m_useHighPrecisionPredictionWeighting;
 #endif
@@ -209,6 +214,9 @@ protected:
   Int       m_iFastSearch;                                    ///< ME mode, 0 = full, 1 = diamond, 2 = PMVFAST
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
+  Bool      m_useHashME;                                      ///< look up exactly matching blocks in the reference pictures first
+  Bool      m_useSubPelCache;                                 ///< interpolate the sub-pel planes of the reference pictures once
+  Bool      m_usePyramidME;                                   ///< coarse motion search on picture pyramids for the start of the TZ search
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost 
@@ -233,6 +241,9 @@ protected:
   Int       m_iWaveFrontSynchro; //< 0: no WPP. >= 1: WPP is enabled, the "Top right" from which inheritance occurs is this LCU offset in the line above the current.
   Int       m_iWaveFrontFlush; //< enable(1)/disable(0) the CABAC flush at the end of each line of LCUs.
   Int       m_iWaveFrontSubstreams; //< If iWaveFrontSynchro, this is the number of substreams per frame (dependent tiles) or per tile (independent tiles).
+  Int       m_iNumThreads;                                    ///< number of worker threads of the encoder
+  Int       m_iParallelIntraPeriods;                          ///< number of intra periods encoded at the same time by separate encoders
+  Bool      m_bLowLatencyOutput;                              ///< write the NAL units as soon as they are coded
 
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   
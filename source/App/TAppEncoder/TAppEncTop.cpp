@@ -42,6 +42,8 @@
 #include <fcntl.h>
 #include <assert.h>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
 
 #include "TAppEncTop.h"
 #include "TLibEncoder/AnnexBwrite.h"
@@ -60,13 +62,18 @@ TAppEncTop::TAppEncTop()
   m_iFrameRcvd = 0;
   m_totalBytes = 0;
   m_essentialBytes = 0;
+  m_dSumLatency = 0.0;
+  m_dMaxLatency = 0.0;
+  m_uiNumLatencyPics = 0;
+  m_iNextIntraPeriod = 0;
+  m_iNumIntraPeriodsWritten = 0;
 }
 
 TAppEncTop::~TAppEncTop()
 {
 }
 
-Void TAppEncTop::xInitLibCfg()
+Void TAppEncTop::xInitLibCfg( TEncTop& rcTEncTop )
 {
   TComVPS vps;
   
@@ -81,72 +88,75 @@ Void TAppEncTop::xInitLibCfg()
     vps.setNumReorderPics                 ( m_numReorderPics[i], i );
     vps.setMaxDecPicBuffering             ( m_maxDecPicBuffering[i], i );
   }
-  m_cTEncTop.setVPS(&vps);
-
-  m_cTEncTop.setProfile(m_profile);
-  m_cTEncTop.setLevel(m_levelTier, m_level);
-  m_cTEncTop.setProgressiveSourceFlag(m_progressiveSourceFlag);
-  m_cTEncTop.setInterlacedSourceFlag(m_interlacedSourceFlag);
-  m_cTEncTop.setNonPackedConstraintFlag(m_nonPackedConstraintFlag);
-  m_cTEncTop.setFrameOnlyConstraintFlag(m_frameOnlyConstraintFlag);
-
-  m_cTEncTop.setPrintMSEBasedSequencePSNR(m_printMSEBasedSequencePSNR);
-
-  m_cTEncTop.setFrameRate                    ( m_iFrameRate );
-  m_cTEncTop.setFrameSkip                    ( m_FrameSkip );
-  m_cTEncTop.setSourceWidth                  ( m_iSourceWidth );
-  m_cTEncTop.setSourceHeight                 ( m_iSourceHeight );
-  m_cTEncTop.setConformanceWindow            ( m_confLeft, m_confRight, m_confTop, m_confBottom );
-  m_cTEncTop.setFramesToBeEncoded            ( m_framesToBeEncoded );
+  rcTEncTop.setVPS(&vps);
+
+  rcTEncTop.setProfile(m_profile);
+  rcTEncTop.setLevel(m_levelTier, m_level);
+  rcTEncTop.setProgressiveSourceFlag(m_progressiveSourceFlag);
+  rcTEncTop.setInterlacedSourceFlag(m_interlacedSourceFlag);
+  rcTEncTop.setNonPackedConstraintFlag(m_nonPackedConstraintFlag);
+  rcTEncTop.setFrameOnlyConstraintFlag(m_frameOnlyConstraintFlag);
+
+  rcTEncTop.setPrintMSEBasedSequencePSNR(m_printMSEBasedSequencePSNR);
+
+  rcTEncTop.setFrameRate                    ( m_iFrameRate );
+  rcTEncTop.setFrameSkip                    ( m_FrameSkip );
+  rcTEncTop.setSourceWidth                  ( m_iSourceWidth );
+  rcTEncTop.setSourceHeight                 ( m_iSourceHeight );
+  rcTEncTop.setConformanceWindow            ( m_confLeft, m_confRight, m_confTop, m_confBottom );
+  rcTEncTop.setFramesToBeEncoded            ( m_framesToBeEncoded );
   
   //====== Coding Structure ========
-  m_cTEncTop.setIntraPeriod                  ( m_iIntraPeriod );
-  m_cTEncTop.setDecodingRefreshType          ( m_iDecodingRefreshType );
-  m_cTEncTop.setGOPSize                      ( m_iGOPSize );
-  m_cTEncTop.setGopList                      ( m_GOPList );
-  m_cTEncTop.setExtraRPSs                    ( m_extraRPSs );
+  rcTEncTop.setIntraPeriod                  ( m_iIntraPeriod );
+  rcTEncTop.setDecodingRefreshType          ( m_iDecodingRefreshType );
+  rcTEncTop.setGOPSize                      ( m_iGOPSize );
+  rcTEncTop.setGopList                      ( m_GOPList );
+  rcTEncTop.setExtraRPSs                    ( m_extraRPSs );
   for(Int i = 0; i < MAX_TLAYER; i++)
   {
-    m_cTEncTop.setNumReorderPics             ( m_numReorderPics[i], i );
-    m_cTEncTop.setMaxDecPicBuffering         ( m_maxDecPicBuffering[i], i );
+    rcTEncTop.setNumReorderPics             ( m_numReorderPics[i], i );
+    rcTEncTop.setMaxDecPicBuffering         ( m_maxDecPicBuffering[i], i );
   }
   for( UInt uiLoop = 0; uiLoop < MAX_TLAYER; ++uiLoop )
   {
-    m_cTEncTop.setLambdaModifier( uiLoop, m_adLambdaModifier[ uiLoop ] );
+    rcTEncTop.setLambdaModifier( uiLoop, m_adLambdaModifier[ uiLoop ] );
   }
-  m_cTEncTop.setQP                           ( m_iQP );
+  rcTEncTop.setQP                           ( m_iQP );
   
-  m_cTEncTop.setPad                          ( m_aiPad );
+  rcTEncTop.setPad                          ( m_aiPad );
     
-  m_cTEncTop.setMaxTempLayer                 ( m_maxTempLayer );
-  m_cTEncTop.setUseAMP( m_enableAMP );
+  rcTEncTop.setMaxTempLayer                 ( m_maxTempLayer );
+  rcTEncTop.setUseAMP( m_enableAMP );
   
   //===== Slice ========
   
   //====== Loop/Deblock Filter ========
-  m_cTEncTop.setLoopFilterDisable            ( m_bLoopFilterDisable       );
-  m_cTEncTop.setLoopFilterOffsetInPPS        ( m_loopFilterOffsetInPPS );
-  m_cTEncTop.setLoopFilterBetaOffset         ( m_loopFilterBetaOffsetDiv2  );
-  m_cTEncTop.setLoopFilterTcOffset           ( m_loopFilterTcOffsetDiv2    );
-  m_cTEncTop.setDeblockingFilterControlPresent( m_DeblockingFilterControlPresent);
-  m_cTEncTop.setDeblockingFilterMetric       ( m_DeblockingFilterMetric );
+  rcTEncTop.setLoopFilterDisable            ( m_bLoopFilterDisable       );
+  rcTEncTop.setLoopFilterOffsetInPPS        ( m_loopFilterOffsetInPPS );
+  rcTEncTop.setLoopFilterBetaOffset         ( m_loopFilterBetaOffsetDiv2  );
+  rcTEncTop.setLoopFilterTcOffset           ( m_loopFilterTcOffsetDiv2    );
+  rcTEncTop.setDeblockingFilterControlPresent( m_DeblockingFilterControlPresent);
+  rcTEncTop.setDeblockingFilterMetric       ( m_DeblockingFilterMetric );
 
   //====== Motion search ========
-  m_cTEncTop.setFastSearch                   ( m_iFastSearch  );
-  m_cTEncTop.setSearchRange                  ( m_iSearchRange );
-  m_cTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
+  rcTEncTop.setFastSearch                   ( m_iFastSearch  );
+  rcTEncTop.setSearchRange                  ( m_iSearchRange );
+  rcTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
+  rcTEncTop.setUseHashME                    ( m_useHashME );
+  rcTEncTop.setUseSubPelCache               ( m_useSubPelCache );
+  rcTEncTop.setUsePyramidME                 ( m_usePyramidME );
 
   //====== Quality control ========
-  m_cTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
-  m_cTEncTop.setMaxCuDQPDepth                ( m_iMaxCuDQPDepth  );
+  rcTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
+  rcTEncTop.setMaxCuDQPDepth                ( m_iMaxCuDQPDepth  );
 
-  m_cTEncTop.setChromaCbQpOffset             ( m_cbQpOffset     );
-  m_cTEncTop.setChromaCrQpOffset             ( m_crQpOffset  );
+  rcTEncTop.setChromaCbQpOffset             ( m_cbQpOffset     );
+  rcTEncTop.setChromaCrQpOffset             ( m_crQpOffset  );
 
-  m_cTEncTop.setChromaFormatIdc              ( m_chromaFormatIDC  );
+  rcTEncTop.setChromaFormatIdc              ( m_chromaFormatIDC  );
 
 #if ADAPTIVE_QP_SELECTION
-  m_cTEncTop.setUseAdaptQpSelect             ( m_bUseAdaptQpSelect   );
+  rcTEncTop.setUseAdaptQpSelect             ( m_bUseAdaptQpSelect   );
 #endif
 
 #if RExt__BACKWARDS_COMPATIBILITY_HM_TRANSQUANTBYPASS
@@ -158,227 +168,235 @@ Void TAppEncTop::xInitLibCfg()
     m_bUseAdaptiveQP = false;
   }
 #endif
-  m_cTEncTop.setUseAdaptiveQP                ( m_bUseAdaptiveQP  );
-  m_cTEncTop.setQPAdaptationRange            ( m_iQPAdaptationRange );
-  m_cTEncTop.setUseExtendedPrecision         ( m_useExtendedPrecision );
-  m_cTEncTop.setUseIntraBlockCopy            ( m_useIntraBlockCopy );
+  rcTEncTop.setUseAdaptiveQP                ( m_bUseAdaptiveQP  );
+  rcTEncTop.setQPAdaptationRange            ( m_iQPAdaptationRange );
+  rcTEncTop.setUseLookahead                 ( m_useLookahead );
+  rcTEncTop.setUseLookaheadSceneCut         ( m_useLookaheadSceneCut );
+  rcTEncTop.setUseLookaheadIntraPruning     ( m_useLookaheadIntraPruning );
+  rcTEncTop.setUseExtendedPrecision         ( m_useExtendedPrecision );
+  rcTEncTop.setUseIntraBlockCopy            ( m_useIntraBlockCopy );
+  rcTEncTop.setUseIntraBlockCopyHashSearch  ( m_useIntraBlockCopyHashSearch );
 #if RExt__O0235_HIGH_PRECISION_PREDICTION_WEIGHTING
-  m_cTEncTop.setUseHighPrecisionPredictionWeighting( m_useHighPrecisionPredictionWeighting );
+  rcTEncTop.setUseHighPrecisionPredictionWeighting( m_useHighPrecisionPredictionWeighting );
 #endif
   //====== Tool list ========
-  m_cTEncTop.setUseSBACRD                    ( m_bUseSBACRD   );
-  m_cTEncTop.setDeltaQpRD                    ( m_uiDeltaQpRD  );
-  m_cTEncTop.setUseASR                       ( m_bUseASR      );
-  m_cTEncTop.setUseHADME                     ( m_bUseHADME    );
+  rcTEncTop.setUseSBACRD                    ( m_bUseSBACRD   );
+  rcTEncTop.setDeltaQpRD                    ( m_uiDeltaQpRD  );
+  rcTEncTop.setUseASR                       ( m_bUseASR      );
+  rcTEncTop.setUseHADME                     ( m_bUseHADME    );
 #if RExt__BACKWARDS_COMPATIBILITY_HM_TRANSQUANTBYPASS
-  m_cTEncTop.setUseLossless                  ( m_useLossless );
+  rcTEncTop.setUseLossless                  ( m_useLossless );
 #endif
-  m_cTEncTop.setdQPs                         ( m_aidQP        );
-  m_cTEncTop.setUseRDOQ                      ( m_useRDOQ     );
-  m_cTEncTop.setUseRDOQTS                    ( m_useRDOQTS   );
-  m_cTEncTop.setRDpenalty                    ( m_rdPenalty );
-  m_cTEncTop.setQuadtreeTULog2MaxSize        ( m_uiQuadtreeTULog2MaxSize );
-  m_cTEncTop.setQuadtreeTULog2MinSize        ( m_uiQuadtreeTULog2MinSize );
-  m_cTEncTop.setQuadtreeTUMaxDepthInter      ( m_uiQuadtreeTUMaxDepthInter );
-  m_cTEncTop.setQuadtreeTUMaxDepthIntra      ( m_uiQuadtreeTUMaxDepthIntra );
-  m_cTEncTop.setUseFastEnc                   ( m_bUseFastEnc  );
-  m_cTEncTop.setUseEarlyCU                   ( m_bUseEarlyCU  ); 
-  m_cTEncTop.setUseFastDecisionForMerge      ( m_useFastDecisionForMerge  );
-  m_cTEncTop.setUseCbfFastMode            ( m_bUseCbfFastMode  );
-  m_cTEncTop.setUseEarlySkipDetection            ( m_useEarlySkipDetection );
+  rcTEncTop.setdQPs                         ( m_aidQP        );
+  rcTEncTop.setUseRDOQ                      ( m_useRDOQ     );
+  rcTEncTop.setUseRDOQTS                    ( m_useRDOQTS   );
+  rcTEncTop.setRDpenalty                    ( m_rdPenalty );
+  rcTEncTop.setQuadtreeTULog2MaxSize        ( m_uiQuadtreeTULog2MaxSize );
+  rcTEncTop.setQuadtreeTULog2MinSize        ( m_uiQuadtreeTULog2MinSize );
+  rcTEncTop.setQuadtreeTUMaxDepthInter      ( m_uiQuadtreeTUMaxDepthInter );
+  rcTEncTop.setQuadtreeTUMaxDepthIntra      ( m_uiQuadtreeTUMaxDepthIntra );
+  rcTEncTop.setUseFastEnc                   ( m_bUseFastEnc  );
+  rcTEncTop.setUseEarlyCU                   ( m_bUseEarlyCU  ); 
+  rcTEncTop.setUseFastDecisionForMerge      ( m_useFastDecisionForMerge  );
+  rcTEncTop.setUseCbfFastMode            ( m_bUseCbfFastMode  );
+  rcTEncTop.setUseEarlySkipDetection            ( m_useEarlySkipDetection );
 
 #if RExt__O0202_CROSS_COMPONENT_DECORRELATION
-  m_cTEncTop.setUseCrossComponentDecorrelation( m_useCrossComponentDecorrelation );
-  m_cTEncTop.setUseReconBasedDecorrelationEstimate( m_reconBasedDecorrelationEstimate );
+  rcTEncTop.setUseCrossComponentDecorrelation( m_useCrossComponentDecorrelation );
+  rcTEncTop.setUseReconBasedDecorrelationEstimate( m_reconBasedDecorrelationEstimate );
 #endif
-  m_cTEncTop.setUseTransformSkip             ( m_useTransformSkip      );
-  m_cTEncTop.setUseTransformSkipFast         ( m_useTransformSkipFast  );
+  rcTEncTop.setUseTransformSkip             ( m_useTransformSkip      );
+  rcTEncTop.setUseTransformSkipFast         ( m_useTransformSkipFast  );
 #if RExt__NRCE2_RESIDUAL_ROTATION
-  m_cTEncTop.setUseResidualRotation          ( m_useResidualRotation   );
+  rcTEncTop.setUseResidualRotation          ( m_useResidualRotation   );
 #endif
-  m_cTEncTop.setUseSingleSignificanceMapContext( m_useSingleSignificanceMapContext   );
+  rcTEncTop.setUseSingleSignificanceMapContext( m_useSingleSignificanceMapContext   );
 #if RExt__ORCE2_A1_GOLOMB_RICE_GROUP_ADAPTATION
-  m_cTEncTop.setUseGolombRiceGroupAdaptation ( m_useGolombRiceGroupAdaptation );
+  rcTEncTop.setUseGolombRiceGroupAdaptation ( m_useGolombRiceGroupAdaptation );
 #endif
-  m_cTEncTop.setTransformSkipLog2MaxSize     ( m_transformSkipLog2MaxSize  );
+  rcTEncTop.setTransformSkipLog2MaxSize     ( m_transformSkipLog2MaxSize  );
 #if RExt__NRCE2_RESIDUAL_DPCM
 #if RExt__O0185_RESIDUAL_DPCM_FLAGS
   for (UInt signallingModeIndex = 0; signallingModeIndex < NUMBER_OF_RDPCM_SIGNALLING_MODES; signallingModeIndex++)
   {
-    m_cTEncTop.setUseResidualDPCM(RDPCMSignallingMode(signallingModeIndex), m_useResidualDPCM[signallingModeIndex]);
+    rcTEncTop.setUseResidualDPCM(RDPCMSignallingMode(signallingModeIndex), m_useResidualDPCM[signallingModeIndex]);
   }
 #else
   for (UInt predictionModeIndex = 0; predictionModeIndex < NUMBER_OF_PREDICTION_MODES; predictionModeIndex++)
   {
-    m_cTEncTop.setUseResidualDPCM(PredMode(predictionModeIndex), m_useResidualDPCM[predictionModeIndex]);
+    rcTEncTop.setUseResidualDPCM(PredMode(predictionModeIndex), m_useResidualDPCM[predictionModeIndex]);
   }
 #endif
 #endif
-  m_cTEncTop.setUseConstrainedIntraPred      ( m_bUseConstrainedIntraPred );
-  m_cTEncTop.setPCMLog2MinSize          ( m_uiPCMLog2MinSize);
-  m_cTEncTop.setUsePCM                       ( m_usePCM );
-  m_cTEncTop.setPCMLog2MaxSize               ( m_pcmLog2MaxSize);
-  m_cTEncTop.setMaxNumMergeCand              ( m_maxNumMergeCand );
+  rcTEncTop.setUseConstrainedIntraPred      ( m_bUseConstrainedIntraPred );
+  rcTEncTop.setPCMLog2MinSize          ( m_uiPCMLog2MinSize);
+  rcTEncTop.setUsePCM                       ( m_usePCM );
+  rcTEncTop.setPCMLog2MaxSize               ( m_pcmLog2MaxSize);
+  rcTEncTop.setMaxNumMergeCand              ( m_maxNumMergeCand );
   
 
   //====== Weighted Prediction ========
-  m_cTEncTop.setUseWP                   ( m_useWeightedPred      );
-  m_cTEncTop.setWPBiPred                ( m_useWeightedBiPred   );
+  rcTEncTop.setUseWP                   ( m_useWeightedPred      );
+  rcTEncTop.setWPBiPred                ( m_useWeightedBiPred   );
   //====== Parallel Merge Estimation ========
-  m_cTEncTop.setLog2ParallelMergeLevelMinus2 ( m_log2ParallelMergeLevel - 2 );
+  rcTEncTop.setLog2ParallelMergeLevelMinus2 ( m_log2ParallelMergeLevel - 2 );
 
   //====== Slice ========
-  m_cTEncTop.setSliceMode               ( m_sliceMode                );
-  m_cTEncTop.setSliceArgument           ( m_sliceArgument            );
+  rcTEncTop.setSliceMode               ( m_sliceMode                );
+  rcTEncTop.setSliceArgument           ( m_sliceArgument            );
 
   //====== Dependent Slice ========
-  m_cTEncTop.setSliceSegmentMode        ( m_sliceSegmentMode         );
-  m_cTEncTop.setSliceSegmentArgument    ( m_sliceSegmentArgument     );
+  rcTEncTop.setSliceSegmentMode        ( m_sliceSegmentMode         );
+  rcTEncTop.setSliceSegmentArgument    ( m_sliceSegmentArgument     );
   Int iNumPartInCU = 1<<(m_uiMaxCUDepth<<1);
   if(m_sliceSegmentMode==FIXED_NUMBER_OF_LCU)
   {
-    m_cTEncTop.setSliceSegmentArgument ( m_sliceSegmentArgument * iNumPartInCU );
+    rcTEncTop.setSliceSegmentArgument ( m_sliceSegmentArgument * iNumPartInCU );
   }
   if(m_sliceMode==FIXED_NUMBER_OF_LCU)
   {
-    m_cTEncTop.setSliceArgument ( m_sliceArgument * iNumPartInCU );
+    rcTEncTop.setSliceArgument ( m_sliceArgument * iNumPartInCU );
   }
   if(m_sliceMode==FIXED_NUMBER_OF_TILES)
   {
-    m_cTEncTop.setSliceArgument ( m_sliceArgument );
+    rcTEncTop.setSliceArgument ( m_sliceArgument );
   }
   
   if(m_sliceMode == 0 )
   {
     m_bLFCrossSliceBoundaryFlag = true;
   }
-  m_cTEncTop.setLFCrossSliceBoundaryFlag( m_bLFCrossSliceBoundaryFlag );
-  m_cTEncTop.setUseSAO ( m_bUseSAO );
-  m_cTEncTop.setMaxNumOffsetsPerPic (m_maxNumOffsetsPerPic);
+  rcTEncTop.setLFCrossSliceBoundaryFlag( m_bLFCrossSliceBoundaryFlag );
+  rcTEncTop.setUseSAO ( m_bUseSAO );
+  rcTEncTop.setMaxNumOffsetsPerPic (m_maxNumOffsetsPerPic);
 
-  m_cTEncTop.setSaoLcuBoundary (m_saoLcuBoundary);
+  rcTEncTop.setSaoLcuBoundary (m_saoLcuBoundary);
 #if !HM_CLEANUP_SAO
-  m_cTEncTop.setSaoLcuBasedOptimization (m_saoLcuBasedOptimization);
+  rcTEncTop.setSaoLcuBasedOptimization (m_saoLcuBasedOptimization);
 #endif
-  m_cTEncTop.setPCMInputBitDepthFlag  ( m_bPCMInputBitDepthFlag);
-  m_cTEncTop.setPCMFilterDisableFlag  ( m_bPCMFilterDisableFlag);
-
-  m_cTEncTop.setDisableIntraReferenceSmoothing            (!m_enableIntraReferenceSmoothing);
-  m_cTEncTop.setDecodedPictureHashSEIEnabled              (m_decodedPictureHashSEIEnabled);
-  m_cTEncTop.setRecoveryPointSEIEnabled                   ( m_recoveryPointSEIEnabled );
-  m_cTEncTop.setBufferingPeriodSEIEnabled                 ( m_bufferingPeriodSEIEnabled );
-  m_cTEncTop.setPictureTimingSEIEnabled                   ( m_pictureTimingSEIEnabled );
-  m_cTEncTop.setToneMappingInfoSEIEnabled                 ( m_toneMappingInfoSEIEnabled );
-  m_cTEncTop.setTMISEIToneMapId                           ( m_toneMapId );
-  m_cTEncTop.setTMISEIToneMapCancelFlag                   ( m_toneMapCancelFlag );
-  m_cTEncTop.setTMISEIToneMapPersistenceFlag              ( m_toneMapPersistenceFlag );
-  m_cTEncTop.setTMISEICodedDataBitDepth                   ( m_toneMapCodedDataBitDepth );
-  m_cTEncTop.setTMISEITargetBitDepth                      ( m_toneMapTargetBitDepth );
-  m_cTEncTop.setTMISEIModelID                             ( m_toneMapModelId );
-  m_cTEncTop.setTMISEIMinValue                            ( m_toneMapMinValue );
-  m_cTEncTop.setTMISEIMaxValue                            ( m_toneMapMaxValue );
-  m_cTEncTop.setTMISEISigmoidMidpoint                     ( m_sigmoidMidpoint );
-  m_cTEncTop.setTMISEISigmoidWidth                        ( m_sigmoidWidth );
-  m_cTEncTop.setTMISEIStartOfCodedInterva                 ( m_startOfCodedInterval );
-  m_cTEncTop.setTMISEINumPivots                           ( m_numPivots );
-  m_cTEncTop.setTMISEICodedPivotValue                     ( m_codedPivotValue );
-  m_cTEncTop.setTMISEITargetPivotValue                    ( m_targetPivotValue );
-  m_cTEncTop.setTMISEICameraIsoSpeedIdc                   ( m_cameraIsoSpeedIdc );
-  m_cTEncTop.setTMISEICameraIsoSpeedValue                 ( m_cameraIsoSpeedValue );
-  m_cTEncTop.setTMISEIExposureCompensationValueSignFlag   ( m_exposureCompensationValueSignFlag );
-  m_cTEncTop.setTMISEIExposureCompensationValueNumerator  ( m_exposureCompensationValueNumerator );
-  m_cTEncTop.setTMISEIExposureCompensationValueDenomIdc   ( m_exposureCompensationValueDenomIdc );
-  m_cTEncTop.setTMISEIRefScreenLuminanceWhite             ( m_refScreenLuminanceWhite );
-  m_cTEncTop.setTMISEIExtendedRangeWhiteLevel             ( m_extendedRangeWhiteLevel );
-  m_cTEncTop.setTMISEINominalBlackLevelLumaCodeValue      ( m_nominalBlackLevelLumaCodeValue );
-  m_cTEncTop.setTMISEINominalWhiteLevelLumaCodeValue      ( m_nominalWhiteLevelLumaCodeValue );
-  m_cTEncTop.setTMISEIExtendedWhiteLevelLumaCodeValue     ( m_extendedWhiteLevelLumaCodeValue );
-  m_cTEncTop.setFramePackingArrangementSEIEnabled( m_framePackingSEIEnabled );
-  m_cTEncTop.setFramePackingArrangementSEIType( m_framePackingSEIType );
-  m_cTEncTop.setFramePackingArrangementSEIId( m_framePackingSEIId );
-  m_cTEncTop.setFramePackingArrangementSEIQuincunx( m_framePackingSEIQuincunx );
-  m_cTEncTop.setFramePackingArrangementSEIInterpretation( m_framePackingSEIInterpretation );
-  m_cTEncTop.setDisplayOrientationSEIAngle( m_displayOrientationSEIAngle );
-  m_cTEncTop.setTemporalLevel0IndexSEIEnabled( m_temporalLevel0IndexSEIEnabled );
-  m_cTEncTop.setGradualDecodingRefreshInfoEnabled( m_gradualDecodingRefreshInfoEnabled );
-  m_cTEncTop.setNoDisplaySEITLayer( m_noDisplaySEITLayer );
-  m_cTEncTop.setDecodingUnitInfoSEIEnabled( m_decodingUnitInfoSEIEnabled );
-  m_cTEncTop.setSOPDescriptionSEIEnabled( m_SOPDescriptionSEIEnabled );
-  m_cTEncTop.setScalableNestingSEIEnabled( m_scalableNestingSEIEnabled );
-  m_cTEncTop.setUniformSpacingIdr          ( m_iUniformSpacingIdr );
-  m_cTEncTop.setNumColumnsMinus1           ( m_iNumColumnsMinus1 );
-  m_cTEncTop.setNumRowsMinus1              ( m_iNumRowsMinus1 );
+  rcTEncTop.setPCMInputBitDepthFlag  ( m_bPCMInputBitDepthFlag);
+  rcTEncTop.setPCMFilterDisableFlag  ( m_bPCMFilterDisableFlag);
+
+  rcTEncTop.setDisableIntraReferenceSmoothing            (!m_enableIntraReferenceSmoothing);
+  rcTEncTop.setDecodedPictureHashSEIEnabled              (m_decodedPictureHashSEIEnabled);
+  rcTEncTop.setRecoveryPointSEIEnabled                   ( m_recoveryPointSEIEnabled );
+  rcTEncTop.setBufferingPeriodSEIEnabled                 ( m_bufferingPeriodSEIEnabled );
+  rcTEncTop.setPictureTimingSEIEnabled                   ( m_pictureTimingSEIEnabled );
+  rcTEncTop.setToneMappingInfoSEIEnabled                 ( m_toneMappingInfoSEIEnabled );
+  rcTEncTop.setTMISEIToneMapId                           ( m_toneMapId );
+  rcTEncTop.setTMISEIToneMapCancelFlag                   ( m_toneMapCancelFlag );
+  rcTEncTop.setTMISEIToneMapPersistenceFlag              ( m_toneMapPersistenceFlag );
+  rcTEncTop.setTMISEICodedDataBitDepth                   ( m_toneMapCodedDataBitDepth );
+  rcTEncTop.setTMISEITargetBitDepth                      ( m_toneMapTargetBitDepth );
+  rcTEncTop.setTMISEIModelID                             ( m_toneMapModelId );
+  rcTEncTop.setTMISEIMinValue                            ( m_toneMapMinValue );
+  rcTEncTop.setTMISEIMaxValue                            ( m_toneMapMaxValue );
+  rcTEncTop.setTMISEISigmoidMidpoint                     ( m_sigmoidMidpoint );
+  rcTEncTop.setTMISEISigmoidWidth                        ( m_sigmoidWidth );
+  rcTEncTop.setTMISEIStartOfCodedInterva                 ( m_startOfCodedInterval );
+  rcTEncTop.setTMISEINumPivots                           ( m_numPivots );
+  rcTEncTop.setTMISEICodedPivotValue                     ( m_codedPivotValue );
+  rcTEncTop.setTMISEITargetPivotValue                    ( m_targetPivotValue );
+  rcTEncTop.setTMISEICameraIsoSpeedIdc                   ( m_cameraIsoSpeedIdc );
+  rcTEncTop.setTMISEICameraIsoSpeedValue                 ( m_cameraIsoSpeedValue );
+  rcTEncTop.setTMISEIExposureCompensationValueSignFlag   ( m_exposureCompensationValueSignFlag );
+  rcTEncTop.setTMISEIExposureCompensationValueNumerator  ( m_exposureCompensationValueNumerator );
+  rcTEncTop.setTMISEIExposureCompensationValueDenomIdc   ( m_exposureCompensationValueDenomIdc );
+  rcTEncTop.setTMISEIRefScreenLuminanceWhite             ( m_refScreenLuminanceWhite );
+  rcTEncTop.setTMISEIExtendedRangeWhiteLevel             ( m_extendedRangeWhiteLevel );
+  rcTEncTop.setTMISEINominalBlackLevelLumaCodeValue      ( m_nominalBlackLevelLumaCodeValue );
+  rcTEncTop.setTMISEINominalWhiteLevelLumaCodeValue      ( m_nominalWhiteLevelLumaCodeValue );
+  rcTEncTop.setTMISEIExtendedWhiteLevelLumaCodeValue     ( m_extendedWhiteLevelLumaCodeValue );
+  rcTEncTop.setFramePackingArrangementSEIEnabled( m_framePackingSEIEnabled );
+  rcTEncTop.setFramePackingArrangementSEIType( m_framePackingSEIType );
+  rcTEncTop.setFramePackingArrangementSEIId( m_framePackingSEIId );
+  rcTEncTop.setFramePackingArrangementSEIQuincunx( m_framePackingSEIQuincunx );
+  rcTEncTop.setFramePackingArrangementSEIInterpretation( m_framePackingSEIInterpretation );
+  rcTEncTop.setDisplayOrientationSEIAngle( m_displayOrientationSEIAngle );
+  rcTEncTop.setTemporalLevel0IndexSEIEnabled( m_temporalLevel0IndexSEIEnabled );
+  rcTEncTop.setGradualDecodingRefreshInfoEnabled( m_gradualDecodingRefreshInfoEnabled );
+  rcTEncTop.setNoDisplaySEITLayer( m_noDisplaySEITLayer );
+  rcTEncTop.setDecodingUnitInfoSEIEnabled( m_decodingUnitInfoSEIEnabled );
+  rcTEncTop.setSOPDescriptionSEIEnabled( m_SOPDescriptionSEIEnabled );
+  rcTEncTop.setScalableNestingSEIEnabled( m_scalableNestingSEIEnabled );
+  rcTEncTop.setUniformSpacingIdr          ( m_iUniformSpacingIdr );
+  rcTEncTop.setNumColumnsMinus1           ( m_iNumColumnsMinus1 );
+  rcTEncTop.setNumRowsMinus1              ( m_iNumRowsMinus1 );
   if(m_iUniformSpacingIdr==0)
   {
-    m_cTEncTop.setColumnWidth              ( m_pColumnWidth );
-    m_cTEncTop.setRowHeight                ( m_pRowHeight );
+    rcTEncTop.setColumnWidth              ( m_pColumnWidth );
+    rcTEncTop.setRowHeight                ( m_pRowHeight );
   }
-  m_cTEncTop.xCheckGSParameters();
+  rcTEncTop.xCheckGSParameters();
   Int uiTilesCount          = (m_iNumRowsMinus1+1) * (m_iNumColumnsMinus1+1);
   if(uiTilesCount == 1)
   {
     m_bLFCrossTileBoundaryFlag = true; 
   }
-  m_cTEncTop.setLFCrossTileBoundaryFlag( m_bLFCrossTileBoundaryFlag );
-  m_cTEncTop.setWaveFrontSynchro           ( m_iWaveFrontSynchro );
-  m_cTEncTop.setWaveFrontSubstreams        ( m_iWaveFrontSubstreams );
-  m_cTEncTop.setTMVPModeId ( m_TMVPModeId );
-  m_cTEncTop.setUseScalingListId           ( m_useScalingListId  );
-  m_cTEncTop.setScalingListFile            ( m_scalingListFile   );
-  m_cTEncTop.setSignHideFlag(m_signHideFlag);
-  m_cTEncTop.setUseRateCtrl         ( m_RCEnableRateControl );
-  m_cTEncTop.setTargetBitrate       ( m_RCTargetBitrate );
-  m_cTEncTop.setKeepHierBit         ( m_RCKeepHierarchicalBit );
-  m_cTEncTop.setLCULevelRC          ( m_RCLCULevelRC );
-  m_cTEncTop.setUseLCUSeparateModel ( m_RCUseLCUSeparateModel );
-  m_cTEncTop.setInitialQP           ( m_RCInitialQP );
-  m_cTEncTop.setForceIntraQP        ( m_RCForceIntraQP );
-  m_cTEncTop.setTransquantBypassEnableFlag(m_TransquantBypassEnableFlag);
+  rcTEncTop.setLFCrossTileBoundaryFlag( m_bLFCrossTileBoundaryFlag );
+  rcTEncTop.setWaveFrontSynchro           ( m_iWaveFrontSynchro );
+  rcTEncTop.setWaveFrontSubstreams        ( m_iWaveFrontSubstreams );
+  rcTEncTop.setNumThreads                 ( m_iNumThreads );
+  rcTEncTop.setLowLatencyOutput           ( m_bLowLatencyOutput );
+  rcTEncTop.setTMVPModeId ( m_TMVPModeId );
+  rcTEncTop.setUseScalingListId           ( m_useScalingListId  );
+  rcTEncTop.setScalingListFile            ( m_scalingListFile   );
+  rcTEncTop.setSignHideFlag(m_signHideFlag);
+  rcTEncTop.setUseRateCtrl         ( m_RCEnableRateControl );
+  rcTEncTop.setTargetBitrate       ( m_RCTargetBitrate );
+  rcTEncTop.setKeepHierBit         ( m_RCKeepHierarchicalBit );
+  rcTEncTop.setLCULevelRC          ( m_RCLCULevelRC );
+  rcTEncTop.setUseLCUSeparateModel ( m_RCUseLCUSeparateModel );
+  rcTEncTop.setInitialQP           ( m_RCInitialQP );
+  rcTEncTop.setForceIntraQP        ( m_RCForceIntraQP );
+  rcTEncTop.setTransquantBypassEnableFlag(m_TransquantBypassEnableFlag);
 #if RExt__BACKWARDS_COMPATIBILITY_HM_TRANSQUANTBYPASS
-  m_cTEncTop.setCUTransquantBypassFlagValue(m_CUTransquantBypassFlagValue);
+  rcTEncTop.setCUTransquantBypassFlagValue(m_CUTransquantBypassFlagValue);
 #else
-  m_cTEncTop.setCUTransquantBypassFlagForceValue(m_CUTransquantBypassFlagForce);
+  rcTEncTop.setCUTransquantBypassFlagForceValue(m_CUTransquantBypassFlagForce);
 #endif
 #if RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION
-  m_cTEncTop.setCostMode(m_costMode);
+  rcTEncTop.setCostMode(m_costMode);
 #endif
-  m_cTEncTop.setUseRecalculateQPAccordingToLambda( m_recalculateQPAccordingToLambda );
-  m_cTEncTop.setUseStrongIntraSmoothing( m_useStrongIntraSmoothing );
-  m_cTEncTop.setActiveParameterSetsSEIEnabled ( m_activeParameterSetsSEIEnabled ); 
-  m_cTEncTop.setVuiParametersPresentFlag( m_vuiParametersPresentFlag );
-  m_cTEncTop.setAspectRatioIdc( m_aspectRatioIdc );
-  m_cTEncTop.setSarWidth( m_sarWidth );
-  m_cTEncTop.setSarHeight( m_sarHeight );
-  m_cTEncTop.setOverscanInfoPresentFlag( m_overscanInfoPresentFlag );
-  m_cTEncTop.setOverscanAppropriateFlag( m_overscanAppropriateFlag );
-  m_cTEncTop.setVideoSignalTypePresentFlag( m_videoSignalTypePresentFlag );
-  m_cTEncTop.setVideoFormat( m_videoFormat );
-  m_cTEncTop.setVideoFullRangeFlag( m_videoFullRangeFlag );
-  m_cTEncTop.setColourDescriptionPresentFlag( m_colourDescriptionPresentFlag );
-  m_cTEncTop.setColourPrimaries( m_colourPrimaries );
-  m_cTEncTop.setTransferCharacteristics( m_transferCharacteristics );
-  m_cTEncTop.setMatrixCoefficients( m_matrixCoefficients );
-  m_cTEncTop.setChromaLocInfoPresentFlag( m_chromaLocInfoPresentFlag );
-  m_cTEncTop.setChromaSampleLocTypeTopField( m_chromaSampleLocTypeTopField );
-  m_cTEncTop.setChromaSampleLocTypeBottomField( m_chromaSampleLocTypeBottomField );
-  m_cTEncTop.setNeutralChromaIndicationFlag( m_neutralChromaIndicationFlag );
-  m_cTEncTop.setDefaultDisplayWindow( m_defDispWinLeftOffset, m_defDispWinRightOffset, m_defDispWinTopOffset, m_defDispWinBottomOffset );
-  m_cTEncTop.setFrameFieldInfoPresentFlag( m_frameFieldInfoPresentFlag );
-  m_cTEncTop.setPocProportionalToTimingFlag( m_pocProportionalToTimingFlag );
-  m_cTEncTop.setNumTicksPocDiffOneMinus1   ( m_numTicksPocDiffOneMinus1    );
-  m_cTEncTop.setBitstreamRestrictionFlag( m_bitstreamRestrictionFlag );
-  m_cTEncTop.setTilesFixedStructureFlag( m_tilesFixedStructureFlag );
-  m_cTEncTop.setMotionVectorsOverPicBoundariesFlag( m_motionVectorsOverPicBoundariesFlag );
-  m_cTEncTop.setMinSpatialSegmentationIdc( m_minSpatialSegmentationIdc );
-  m_cTEncTop.setMaxBytesPerPicDenom( m_maxBytesPerPicDenom );
-  m_cTEncTop.setMaxBitsPerMinCuDenom( m_maxBitsPerMinCuDenom );
-  m_cTEncTop.setLog2MaxMvLengthHorizontal( m_log2MaxMvLengthHorizontal );
-  m_cTEncTop.setLog2MaxMvLengthVertical( m_log2MaxMvLengthVertical );
+  rcTEncTop.setUseRecalculateQPAccordingToLambda( m_recalculateQPAccordingToLambda );
+  rcTEncTop.setUseStrongIntraSmoothing( m_useStrongIntraSmoothing );
+  rcTEncTop.setActiveParameterSetsSEIEnabled ( m_activeParameterSetsSEIEnabled ); 
+  rcTEncTop.setVuiParametersPresentFlag( m_vuiParametersPresentFlag );
+  rcTEncTop.setAspectRatioIdc( m_aspectRatioIdc );
+  rcTEncTop.setSarWidth( m_sarWidth );
+  rcTEncTop.setSarHeight( m_sarHeight );
+  rcTEncTop.setOverscanInfoPresentFlag( m_overscanInfoPresentFlag );
+  rcTEncTop.setOverscanAppropriateFlag( m_overscanAppropriateFlag );
+  rcTEncTop.setVideoSignalTypePresentFlag( m_videoSignalTypePresentFlag );
+  rcTEncTop.setVideoFormat( m_videoFormat );
+  rcTEncTop.setVideoFullRangeFlag( m_videoFullRangeFlag );
+  rcTEncTop.setColourDescriptionPresentFlag( m_colourDescriptionPresentFlag );
+  rcTEncTop.setColourPrimaries( m_colourPrimaries );
+  rcTEncTop.setTransferCharacteristics( m_transferCharacteristics );
+  rcTEncTop.setMatrixCoefficients( m_matrixCoefficients );
+  rcTEncTop.setChromaLocInfoPresentFlag( m_chromaLocInfoPresentFlag );
+  rcTEncTop.setChromaSampleLocTypeTopField( m_chromaSampleLocTypeTopField );
+  rcTEncTop.setChromaSampleLocTypeBottomField( m_chromaSampleLocTypeBottomField );
+  rcTEncTop.setNeutralChromaIndicationFlag( m_neutralChromaIndicationFlag );
+  rcTEncTop.setDefaultDisplayWindow( m_defDispWinLeftOffset, m_defDispWinRightOffset, m_defDispWinTopOffset, m_defDispWinBottomOffset );
+  rcTEncTop.setFrameFieldInfoPresentFlag( m_frameFieldInfoPresentFlag );
+  rcTEncTop.setPocProportionalToTimingFlag( m_pocProportionalToTimingFlag );
+  rcTEncTop.setNumTicksPocDiffOneMinus1   ( m_numTicksPocDiffOneMinus1    );
+  rcTEncTop.setBitstreamRestrictionFlag( m_bitstreamRestrictionFlag );
+  rcTEncTop.setTilesFixedStructureFlag( m_tilesFixedStructureFlag );
+  rcTEncTop.setMotionVectorsOverPicBoundariesFlag( m_motionVectorsOverPicBoundariesFlag );
+  rcTEncTop.setMinSpatialSegmentationIdc( m_minSpatialSegmentationIdc );
+  rcTEncTop.setMaxBytesPerPicDenom( m_maxBytesPerPicDenom );
+  rcTEncTop.setMaxBitsPerMinCuDenom( m_maxBitsPerMinCuDenom );
+  rcTEncTop.setLog2MaxMvLengthHorizontal( m_log2MaxMvLengthHorizontal );
+  rcTEncTop.setLog2MaxMvLengthVertical( m_log2MaxMvLengthVertical );
 }
 
 Void TAppEncTop::xCreateLib()
 {
   // Video I/O
+  m_cTVideoIOYuvInputFile.setAsyncDepth( m_asyncYuvIO );
+  m_cTVideoIOYuvReconFile.setAsyncDepth( m_asyncYuvIO );
 #if RExt__INPUT_MSB_EXTENSION
   m_cTVideoIOYuvInputFile.open( m_pchInputFile,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
 #else
@@ -439,12 +457,34 @@ Void TAppEncTop::encode()
   TComPicYuv*       pcPicYuvRec = NULL;
   
   // initialize internal class & member variables
-  xInitLibCfg();
+  xInitLibCfg(m_cTEncTop);
   xCreateLib();
   xInitLib(m_isField);
 
   printChromaFormat();
+
+  if ( m_iParallelIntraPeriods > 1 )
+  {
+    // the periods are encoded by encoders of their own, m_cTEncTop only collects their statistics
+    xEncodeIntraPeriods( bitstreamFile );
+
+    m_cTEncTop.printSummary(m_isField);
+
+    delete pcPicYuvOrg;
+    m_cTEncTop.deletePicBuffer();
+    xDestroyLib();
+
+    printRateSummary();
+
+    return;
+  }
   
+  if ( m_bLowLatencyOutput )
+  {
+    m_cTEncTop.setNalUnitCallback( [&]( const NALUnitEBSP& rcNalu ) { xWriteNalUnit( bitstreamFile, rcNalu ); } );
+    m_cTEncTop.setAccessUnitCallback( [this]( Int, const AccessUnit& rcAccessUnit, Double dLatency ) { xAccessUnitDone( rcAccessUnit, dLatency ); } );
+  }
+
   // main encoder loop
   Int   iNumEncoded = 0;
   Bool  bEos = false;
@@ -534,13 +574,18 @@ Void TAppEncTop::encode()
  .
  */
 Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
+{
+  xGetBuffer( m_cListPicYuvRec, rpcPicYuvRec );
+}
+
+Void TAppEncTop::xGetBuffer( TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec )
 {
   assert( m_iGOPSize > 0 );
   
   // org. buffer
-  if ( m_cListPicYuvRec.size() >= (UInt)m_iGOPSize ) // buffer will be 1 element longer when using field coding, to maintain first field whilst processing second.
+  if ( rcListPicYuvRec.size() >= (UInt)m_iGOPSize ) // buffer will be 1 element longer when using field coding, to maintain first field whilst processing second.
   {
-    rpcPicYuvRec = m_cListPicYuvRec.popFront();
+    rpcPicYuvRec = rcListPicYuvRec.popFront();
 
   }
   else
@@ -550,14 +595,19 @@ Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
     rpcPicYuvRec->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
 
   }
-  m_cListPicYuvRec.pushBack( rpcPicYuvRec );
+  rcListPicYuvRec.pushBack( rpcPicYuvRec );
 }
 
 Void TAppEncTop::xDeleteBuffer( )
 {
-  TComList<TComPicYuv*>::iterator iterPicYuvRec  = m_cListPicYuvRec.begin();
+  xDeleteBuffer( m_cListPicYuvRec );
+}
+
+Void TAppEncTop::xDeleteBuffer( TComList<TComPicYuv*>& rcListPicYuvRec )
+{
+  TComList<TComPicYuv*>::iterator iterPicYuvRec  = rcListPicYuvRec.begin();
   
-  Int iSize = Int( m_cListPicYuvRec.size() );
+  Int iSize = Int( rcListPicYuvRec.size() );
   
   for ( Int i = 0; i < iSize; i++ )
   {
@@ -565,7 +615,208 @@ Void TAppEncTop::xDeleteBuffer( )
     pcPicYuvRec->destroy();
     delete pcPicYuvRec; pcPicYuvRec = NULL;
   }
-  
+  rcListPicYuvRec.clear();
+}
+
+/**
+ - the sequence is split into intra periods that are encoded by separate encoders, each period starting with an IDR picture
+ - up to m_iParallelIntraPeriods periods are encoded at the same time, while the calling thread writes the finished
+   periods out in order
+ .
+ */
+Void TAppEncTop::xEncodeIntraPeriods( std::ostream& bitstreamFile )
+{
+  const Int iNumPeriods = ( m_framesToBeEncoded + m_iIntraPeriod - 1 ) / m_iIntraPeriod;
+  const Int iNumThreads = std::min( m_iParallelIntraPeriods, iNumPeriods );
+
+  m_apcIntraPeriods.assign( iNumPeriods, NULL );
+  m_iNextIntraPeriod        = 0;
+  m_iNumIntraPeriodsWritten = 0;
+
+  std::vector<std::thread> acThreads;
+  for ( Int i = 0; i < iNumThreads; i++ )
+  {
+    acThreads.push_back( std::thread( &TAppEncTop::xIntraPeriodThread, this ) );
+  }
+
+  for ( Int iPeriod = 0; iPeriod < iNumPeriods; iPeriod++ )
+  {
+    IntraPeriod* pcIntraPeriod;
+    {
+      std::unique_lock<std::mutex> cLock( m_cIntraPeriodMutex );
+      m_cIntraPeriodChanged.wait( cLock, [&]() { return m_apcIntraPeriods[iPeriod] != NULL && m_apcIntraPeriods[iPeriod]->bDone; } );
+      pcIntraPeriod = m_apcIntraPeriods[iPeriod];
+    }
+
+    xWriteIntraPeriod( bitstreamFile, *pcIntraPeriod );
+
+    m_cTEncTop.addSummary( *pcIntraPeriod->pcEncTop );
+    m_iFrameRcvd += pcIntraPeriod->iNumFrames;
+    delete pcIntraPeriod->pcEncTop;
+    delete pcIntraPeriod;
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cIntraPeriodMutex );
+      m_apcIntraPeriods[iPeriod] = NULL;
+      m_iNumIntraPeriodsWritten++;
+    }
+    m_cIntraPeriodChanged.notify_all();
+  }
+
+  for ( Int i = 0; i < iNumThreads; i++ )
+  {
+    acThreads[i].join();
+  }
+}
+
+/** the encoders of the periods bind contexts of their own, the thread only reads the configuration of the default one
+ */
+Void TAppEncTop::xIntraPeriodThread()
+{
+  // bound the number of periods that are encoded but not yet written out
+  const Int iMaxPending = 2 * m_iParallelIntraPeriods;
+  const Int iNumPeriods = Int( m_apcIntraPeriods.size() );
+
+  while ( true )
+  {
+    Int          iPeriod;
+    IntraPeriod* pcIntraPeriod;
+    {
+      std::unique_lock<std::mutex> cLock( m_cIntraPeriodMutex );
+      m_cIntraPeriodChanged.wait( cLock, [&]() { return m_iNextIntraPeriod == iNumPeriods || m_iNextIntraPeriod - m_iNumIntraPeriodsWritten < iMaxPending; } );
+      if ( m_iNextIntraPeriod == iNumPeriods )
+      {
+        break;
+      }
+      iPeriod       = m_iNextIntraPeriod++;
+      pcIntraPeriod = new IntraPeriod;
+      pcIntraPeriod->pcEncTop   = NULL;
+      pcIntraPeriod->iNumFrames = 0;
+      pcIntraPeriod->bDone      = false;
+      m_apcIntraPeriods[iPeriod] = pcIntraPeriod;
+    }
+
+    xEncodeIntraPeriod( iPeriod, *pcIntraPeriod );
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cIntraPeriodMutex );
+      pcIntraPeriod->bDone = true;
+    }
+    m_cIntraPeriodChanged.notify_all();
+  }
+}
+
+/** \param iPeriod        index of the period in the sequence
+    \param rcIntraPeriod  receives the access units, the reconstruction and the encoder of the period
+ */
+Void TAppEncTop::xEncodeIntraPeriod( Int iPeriod, IntraPeriod& rcIntraPeriod )
+{
+  const Int iFirstFrame = iPeriod * m_iIntraPeriod;
+  const Int iNumFrames  = std::min( m_iIntraPeriod, m_framesToBeEncoded - iFirstFrame );
+
+  TEncTop* pcEncTop = new TEncTop;
+  {
+    // the configuration may adjust a few settings of the application
+    std::lock_guard<std::mutex> cLock( m_cIntraPeriodMutex );
+    xInitLibCfg( *pcEncTop );
+  }
+  pcEncTop->setFramesToBeEncoded( iNumFrames );
+  pcEncTop->create();
+  pcEncTop->init( false );
+
+  TVideoIOYuv cTVideoIOYuvInputFile;
+  cTVideoIOYuvInputFile.setAsyncDepth( m_asyncYuvIO );
+#if RExt__INPUT_MSB_EXTENSION
+  cTVideoIOYuvInputFile.open( m_pchInputFile, false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
+#else
+  cTVideoIOYuvInputFile.open( m_pchInputFile, false, m_inputBitDepth, m_internalBitDepth );  // read  mode
+#endif
+  cTVideoIOYuvInputFile.skipFrames( m_FrameSkip + iFirstFrame, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC );
+
+  const InputColourSpaceConversion ipCSC  =  m_inputColourSpaceConvert;
+  const InputColourSpaceConversion snrCSC = (!m_snrInternalColourSpace) ? m_inputColourSpaceConvert : IPCOLOURSPACE_UNCHANGED;
+
+  TComPicYuv cPicYuvOrg;
+  TComPicYuv cPicYuvTrueOrg;
+  cPicYuvOrg.create    ( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+  cPicYuvTrueOrg.create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+
+  TComList<TComPicYuv*> cListPicYuvRec;
+  std::list<AccessUnit> outputAccessUnits;
+  Int                   iNumEncoded = 0;
+  Int                   iFrameRcvd  = 0;
+  Bool                  bEos        = false;
+
+  while ( !bEos )
+  {
+    TComPicYuv* pcPicYuvRec = NULL;
+    xGetBuffer( cListPicYuvRec, pcPicYuvRec );
+
+    cTVideoIOYuvInputFile.read( &cPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_aiPad, m_InputChromaFormatIDC );
+
+    iFrameRcvd++;
+    bEos = ( iFrameRcvd == iNumFrames );
+
+    Bool flush = false;
+    if ( cTVideoIOYuvInputFile.isEof() )
+    {
+      flush = true;
+      bEos  = true;
+      iFrameRcvd--;
+      pcEncTop->setFramesToBeEncoded( iFrameRcvd );
+    }
+
+    pcEncTop->encode( bEos, flush ? 0 : &cPicYuvOrg, flush ? 0 : &cPicYuvTrueOrg, snrCSC, cListPicYuvRec, outputAccessUnits, iNumEncoded );
+
+    if ( iNumEncoded > 0 )
+    {
+      // keep a copy of the reconstruction, the buffers are reused by the following GOPs
+      if ( m_pchReconFile )
+      {
+        TComList<TComPicYuv*>::iterator iterPicYuvRec = cListPicYuvRec.end();
+        for ( Int i = 0; i < iNumEncoded; i++ )
+        {
+          --iterPicYuvRec;
+        }
+        for ( Int i = 0; i < iNumEncoded; i++ )
+        {
+          TComPicYuv* pcPicYuvCopy = new TComPicYuv;
+          pcPicYuvCopy->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
+          (*(iterPicYuvRec++))->copyToPic( pcPicYuvCopy );
+          rcIntraPeriod.reconPictures.pushBack( pcPicYuvCopy );
+        }
+      }
+      rcIntraPeriod.accessUnits.splice( rcIntraPeriod.accessUnits.end(), outputAccessUnits );
+    }
+  }
+
+  pcEncTop->deletePicBuffer();
+  pcEncTop->destroy();
+
+  cPicYuvOrg.destroy();
+  cPicYuvTrueOrg.destroy();
+  xDeleteBuffer( cListPicYuvRec );
+  cTVideoIOYuvInputFile.close();
+
+  rcIntraPeriod.pcEncTop   = pcEncTop;
+  rcIntraPeriod.iNumFrames = iFrameRcvd;
+}
+
+Void TAppEncTop::xWriteIntraPeriod( std::ostream& bitstreamFile, IntraPeriod& rcIntraPeriod )
+{
+  const InputColourSpaceConversion ipCSC = (!m_outputInternalColourSpace) ? m_inputColourSpaceConvert : IPCOLOURSPACE_UNCHANGED;
+
+  for ( TComList<TComPicYuv*>::iterator iterPicYuvRec = rcIntraPeriod.reconPictures.begin(); iterPicYuvRec != rcIntraPeriod.reconPictures.end(); iterPicYuvRec++ )
+  {
+    m_cTVideoIOYuvReconFile.write( *iterPicYuvRec, ipCSC, m_confLeft, m_confRight, m_confTop, m_confBottom );
+  }
+  xDeleteBuffer( rcIntraPeriod.reconPictures );
+
+  for ( list<AccessUnit>::const_iterator iterBitstream = rcIntraPeriod.accessUnits.begin(); iterBitstream != rcIntraPeriod.accessUnits.end(); iterBitstream++ )
+  {
+    const vector<UInt>& stats = writeAnnexB( bitstreamFile, *iterBitstream );
+    rateStatsAccum( *iterBitstream, stats );
+  }
 }
 
 /** \param iNumEncoded  number of encoded frames
@@ -596,6 +847,11 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
         m_cTVideoIOYuvReconFile.write( pcPicYuvRecTop, pcPicYuvRecBottom, ipCSC, m_confLeft, m_confRight, m_confTop, m_confBottom, NUM_CHROMA_FORMAT, m_isTopFieldFirst );
       }
       
+      if (m_bLowLatencyOutput)
+      {
+        continue; // already written by xWriteNalUnit()
+      }
+
       const AccessUnit& auTop = *(iterBitstream++);
       const vector<UInt>& statsTop = writeAnnexB(bitstreamFile, auTop);
       rateStatsAccum(auTop, statsTop);
@@ -625,6 +881,11 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
         m_cTVideoIOYuvReconFile.write( pcPicYuvRec, ipCSC, m_confLeft, m_confRight, m_confTop, m_confBottom );
       }
 
+      if (m_bLowLatencyOutput)
+      {
+        continue; // already written by xWriteNalUnit()
+      }
+
       const AccessUnit& au = *(iterBitstream++);
       const vector<UInt>& stats = writeAnnexB(bitstreamFile, au);
       rateStatsAccum(au, stats);
@@ -632,6 +893,22 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
   }
 }
 
+Void TAppEncTop::xWriteNalUnit(std::ostream& bitstreamFile, const NALUnitEBSP& rcNalu)
+{
+  m_auiAnnexBSizes.push_back(writeAnnexB(bitstreamFile, rcNalu, m_auiAnnexBSizes.empty()));
+  bitstreamFile.flush();
+}
+
+Void TAppEncTop::xAccessUnitDone(const AccessUnit& rcAccessUnit, Double dLatency)
+{
+  rateStatsAccum(rcAccessUnit, m_auiAnnexBSizes);
+  m_auiAnnexBSizes.clear();
+
+  m_dSumLatency += dLatency;
+  m_dMaxLatency  = std::max(m_dMaxLatency, dLatency);
+  m_uiNumLatencyPics++;
+}
+
 /**
  *
  */
@@ -680,6 +957,10 @@ void TAppEncTop::printRateSummary()
 #if VERBOSE_RATE
   printf("Bytes for SPS/PPS/Slice (Incl. Annex B): %u (%.3f kbps)\n", m_essentialBytes, 0.008 * m_essentialBytes / time);
 #endif
+  if (m_uiNumLatencyPics > 0)
+  {
+    printf("Picture encode latency: %.3f ms average, %.3f ms maximum\n", 1000.0 * m_dSumLatency / m_uiNumLatencyPics, 1000.0 * m_dMaxLatency);
+  }
 }
 
 void TAppEncTop::printChromaFormat()
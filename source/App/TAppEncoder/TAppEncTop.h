@@ -40,6 +40,9 @@
 
 #include <list>
 #include <ostream>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
 
 #include "TLibEncoder/TEncTop.h"
 #include "TLibVideoIO/TVideoIOYuv.h"
@@ -69,21 +72,53 @@ private:
   UInt m_essentialBytes;
   UInt m_totalBytes;
 
+  // low-latency output
+  std::vector<UInt>          m_auiAnnexBSizes;              ///< sizes of the NAL units of the current access unit written so far
+  Double                     m_dSumLatency;                 ///< sum of the encode latencies of the pictures, in seconds
+  Double                     m_dMaxLatency;                 ///< maximum encode latency of a picture, in seconds
+  UInt                       m_uiNumLatencyPics;            ///< number of pictures in m_dSumLatency
+
+  /// intra period encoded by a separate encoder instance, kept until it has been written out
+  struct IntraPeriod
+  {
+    std::list<AccessUnit>    accessUnits;                   ///< access units in decoding order
+    TComList<TComPicYuv*>    reconPictures;                 ///< reconstructed pictures in output order (when writing a reconstruction file)
+    TEncTop*                 pcEncTop;                      ///< encoder of the period, destroyed, holding the statistics for the summary
+    Int                      iNumFrames;                    ///< number of frames read from the input file
+    Bool                     bDone;                         ///< set once the period has been encoded
+  };
+
+  std::vector<IntraPeriod*>  m_apcIntraPeriods;             ///< intra periods being encoded or waiting to be written, indexed by period
+  Int                        m_iNextIntraPeriod;            ///< next period to be encoded
+  Int                        m_iNumIntraPeriodsWritten;     ///< number of periods written out
+  std::mutex                 m_cIntraPeriodMutex;           ///< protects the members above
+  std::condition_variable    m_cIntraPeriodChanged;         ///< signalled when a period has been encoded or written out
+
 protected:
   // initialization
   Void  xCreateLib        ();                               ///< create files & encoder class
-  Void  xInitLibCfg       ();                               ///< initialize internal variables
+  Void  xInitLibCfg       ( TEncTop& rcTEncTop );           ///< initialize internal variables
   Void  xInitLib          (Bool isFieldCoding);             ///< initialize encoder class
   Void  xDestroyLib       ();                               ///< destroy encoder class
   
   /// obtain required buffers
   Void xGetBuffer(TComPicYuv*& rpcPicYuvRec);
+  Void xGetBuffer(TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec);
   
   /// delete allocated buffers
   Void  xDeleteBuffer     ();
+  Void  xDeleteBuffer     ( TComList<TComPicYuv*>& rcListPicYuvRec );
+
+  // encoding of intra periods by separate encoders
+  Void  xEncodeIntraPeriods      ( std::ostream& bitstreamFile );                              ///< encode all periods and write them out in order
+  Void  xIntraPeriodThread       ();                                                           ///< encode periods until there are none left
+  Void  xEncodeIntraPeriod       ( Int iPeriod, IntraPeriod& rcIntraPeriod );                  ///< encode one period with a new encoder
+  Void  xWriteIntraPeriod        ( std::ostream& bitstreamFile, IntraPeriod& rcIntraPeriod );  ///< write out an encoded period
   
   // file I/O
   Void xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits); ///< write bitstream to file
+  Void xWriteNalUnit(std::ostream& bitstreamFile, const NALUnitEBSP& rcNalu);       ///< write a NAL unit as soon as it is coded (LowLatencyOutput)
+  Void xAccessUnitDone(const AccessUnit& rcAccessUnit, Double dLatency);            ///< account for an access unit written by xWriteNalUnit()
   void rateStatsAccum(const AccessUnit& au, const std::vector<UInt>& stats);
   void printRateSummary();
   void printChromaFormat();
@@ -132,11 +132,8 @@
 // Macro functions
 // ====================================================================================================================
 
-extern Int g_bitDepth[MAX_NUM_CHANNEL_TYPE];
-
 template <typename T> inline T Clip3 (const T minVal, const T maxVal, const T a) { return std::min<T> (std::max<T> (minVal, a) , maxVal); }  ///< general min/max clip
 template <typename T> inline T ClipBD(const T x, const Int bitDepth)             { return Clip3(T(0), T((1 << bitDepth)-1), x);           }
-template <typename T> inline T Clip  (const T x, const ChannelType type)         { return ClipBD(x, g_bitDepth[type]);                    }
 
 template <typename T> inline void Check3( T minVal, T maxVal, T a)
 {
@@ -36,6 +36,7 @@
 */
 
 #include <algorithm>
+#include <mutex>
 
 #include "ContextModel.h"
 
@@ -90,16 +91,24 @@ const UChar ContextModel::m_aucNextStateLPS[ ContextModel::m_totalStates ] =
 
 #if FAST_BIT_EST
 UChar ContextModel::m_nextState[ ContextModel::m_totalStates ][2 /*MPS = [0|1]*/];
+UInt  ContextModel::m_estBitsAndNextState[ ContextModel::m_totalStates ][2 /*bin value*/];
 
 Void ContextModel::buildNextStateTable()
 {
-  for (Int i = 0; i < ContextModel::m_totalStates; i++)
+  // the table is shared by all encoder instances, which may be created while others are running
+  static std::once_flag cBuilt;
+
+  std::call_once( cBuilt, []()
   {
-    for (Int j = 0; j < 2; j++)
+    for (Int i = 0; i < ContextModel::m_totalStates; i++)
     {
-      m_nextState[i][j] = ((i&1) == j) ? m_aucNextStateMPS[i] : m_aucNextStateLPS[i];
+      for (Int j = 0; j < 2; j++)
+      {
+        m_nextState[i][j] = ((i&1) == j) ? m_aucNextStateMPS[i] : m_aucNextStateLPS[i];
+        m_estBitsAndNextState[i][j] = ( UInt( m_entropyBits[i ^ j] ) << 8 ) | m_nextState[i][j];
+      }
     }
-  }
+  } );
 }
 #endif
 
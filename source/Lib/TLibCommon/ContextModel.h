@@ -75,6 +75,13 @@ public:
   {
     m_ucState = m_aucNextStateMPS[ m_ucState ];
   }
+
+  Void updateLPSOrMPS ( UInt isLPS ) ///< update after a LPS (isLPS = 1) or MPS (isLPS = 0), without a branch
+  {
+    const UChar ucLPSState = m_aucNextStateLPS[ m_ucState ];
+    const UChar ucMPSState = m_aucNextStateMPS[ m_ucState ];
+    m_ucState = isLPS ? ucLPSState : ucMPSState;
+  }
   
   Int getEntropyBits(Short val) { return m_entropyBits[m_ucState ^ val]; }
     
@@ -83,6 +90,12 @@ public:
   {
     m_ucState = m_nextState[m_ucState][binVal];
   }
+  Int estimateBitsAndUpdate( UInt binVal ) ///< fractional bits for coding binVal, followed by the state update, using one table lookup
+  {
+    const UInt entry = m_estBitsAndNextState[m_ucState][binVal];
+    m_ucState = UChar( entry );
+    return Int( entry >> 8 );
+  }
   static Void buildNextStateTable();
   static Int getEntropyBitsTrm( Int val ) { return m_entropyBits[126 ^ val]; }
 #endif
@@ -98,6 +111,7 @@ private:
   static const  Int   m_entropyBits    [m_totalStates];
 #if FAST_BIT_EST
   static UChar m_nextState[m_totalStates][2 /*MPS = [0|1]*/];
+  static UInt  m_estBitsAndNextState[m_totalStates][2 /*bin value*/];     ///< entropy bits << 8 | next state
 #endif
   UInt          m_binsCoded;
 };
@@ -49,6 +49,7 @@
 // ====================================================================================================================
 
 #define MAX_NUM_CTX_MOD             512       ///< maximum number of supported contexts
+#define CONTEXT_CHUNK_LOG2_SIZE       6       ///< log2 of the size in bytes of the blocks in which encoder RD context snapshots are shared
 
 #define NUM_SPLIT_FLAG_CTX            3       ///< number of context models for split flag
 #define NUM_SKIP_FLAG_CTX             3       ///< number of context models for skip flag
@@ -177,6 +177,8 @@ Void printRExtMacroSettings()
   PRINT_CONSTANT(RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION,           settingNameWidth, settingValueWidth);
   PRINT_CONSTANT(RExt__HIGH_BIT_DEPTH_SUPPORT,                                   settingNameWidth, settingValueWidth);
   PRINT_CONSTANT(RExt__HIGH_PRECISION_FORWARD_TRANSFORM,                         settingNameWidth, settingValueWidth);
+  PRINT_CONSTANT(SIMD_X86,                                                       settingNameWidth, settingValueWidth);
+  PRINT_CONSTANT(SIMD_SELF_CHECK,                                                settingNameWidth, settingValueWidth);
 
   PRINT_CONSTANT(RExt__NRCE2_RESIDUAL_DPCM,                                      settingNameWidth, settingValueWidth);
   PRINT_CONSTANT(RExt__NRCE2_RESIDUAL_ROTATION,                                  settingNameWidth, settingValueWidth);
@@ -202,6 +202,8 @@ public:
   UChar getHeldBits  ()          { return m_held_bits;          }
   TComOutputBitstream& operator= (const TComOutputBitstream& src);
   UInt  getByteLocation              ( )                     { return m_fifo_idx                    ; }
+  Void  setByteLocation              ( UInt uiByteLocation ) { assert( m_num_held_bits == 0 && uiByteLocation <= m_fifo->size() ); m_fifo_idx = uiByteLocation; } ///< used by decoders reading ahead of the bitstream position
+  std::vector<uint8_t>& getFIFO      ( )                     { return *m_fifo                       ; }
 
   // Peek at bits in word-storage. Used in determining if we have completed reading of current bitstream and therefore slice in LCEC.
   UInt        peekBits (UInt uiBits) { UInt tmp; pseudoRead(uiBits, tmp); return tmp; }
@@ -43,10 +43,6 @@
 //! \ingroup TLibCommon
 //! \{
 
-#if ADAPTIVE_QP_SELECTION
-  TCoeff * TComDataCU::m_pcGlbArlCoeff[MAX_NUM_COMPONENT] = { NULL, NULL, NULL };
-#endif
-
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -190,9 +186,10 @@ Void TComDataCU::create( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt
 #if ADAPTIVE_QP_SELECTION
       if( bGlobalRMARLBuffer )
       {
-        if (m_pcGlbArlCoeff[compID] == NULL) m_pcGlbArlCoeff[compID] = (TCoeff*)xMalloc(TCoeff, totalSize);
+        TCoeff*& rpcGlbArlCoeff = g_pcRomContext->pcGlbArlCoeff[compID];
+        if (rpcGlbArlCoeff == NULL) rpcGlbArlCoeff = (TCoeff*)xMalloc(TCoeff, totalSize);
 
-        m_pcArlCoeff[compID] = m_pcGlbArlCoeff[compID];
+        m_pcArlCoeff[compID] = rpcGlbArlCoeff;
         m_ArlCoeffIsAliasedAllocation = true;
       }
       else
@@ -280,7 +277,8 @@ Void TComDataCU::destroy()
         if ( m_pcArlCoeff[comp]     ) { xFree(m_pcArlCoeff[comp]);      m_pcArlCoeff[comp]    = NULL; }
       }
 
-      if ( m_pcGlbArlCoeff[comp]  ) { xFree(m_pcGlbArlCoeff[comp]);   m_pcGlbArlCoeff[comp] = NULL; }
+      TCoeff*& rpcGlbArlCoeff = g_pcRomContext->pcGlbArlCoeff[comp];
+      if ( rpcGlbArlCoeff         ) { xFree(rpcGlbArlCoeff);          rpcGlbArlCoeff        = NULL; }
 #endif
 
       if ( m_pcIPCMSample[comp]   ) { xFree(m_pcIPCMSample[comp]);    m_pcIPCMSample[comp]  = NULL; }
@@ -3733,6 +3731,8 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
                                                     ,Bool bTopTileBoundary, Bool bDownTileBoundary, Bool bLeftTileBoundary, Bool bRightTileBoundary
                                                     ,Bool bIndependentTileBoundaryEnabled)
 {
+  const UInt* auiZscanToRaster = g_auiZscanToRaster;
+  const UInt* auiRasterToZscan = g_auiRasterToZscan;
   UInt numSUInLCU = numSUInLCUWidth*numSUInLCUHeight;
   Int* pSliceIDMapLCU = m_piSliceSUMap;
   Bool onlyOneSliceInPic = ((Int)LFCrossSliceBoundary.size() == 1);
@@ -3763,8 +3763,8 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
     uiTPelY = rSGU.posY;
     width   = rSGU.width;
     height  = rSGU.height;
-    rTLSU     = g_auiZscanToRaster[ rSGU.startSU ];
-    rBRSU     = g_auiZscanToRaster[ rSGU.endSU   ];
+    rTLSU     = auiZscanToRaster[ rSGU.startSU ];
+    rBRSU     = auiZscanToRaster[ rSGU.endSU   ];
     widthSU   = rSGU.widthSU;
     heightSU  = rSGU.heightSU;
 
@@ -3796,12 +3796,12 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       if(bLCULBoundary)
       {
         rLRefSU     = rTLSU + numSUInLCUWidth -1;
-        zRefSU      = g_auiRasterToZscan[rLRefSU];
+        zRefSU      = auiRasterToZscan[rLRefSU];
         pRefMapLCU = pLRefMapLCU= (pSliceIDMapLCU - numSUInLCU);
       }
       else
       {
-        zRefSU   = g_auiRasterToZscan[rTLSU - 1];
+        zRefSU   = auiRasterToZscan[rTLSU - 1];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3824,12 +3824,12 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       if(bLCURBoundary)
       {
         rRRefSU      = rTLSU + widthSU - numSUInLCUWidth;
-        zRefSU       = g_auiRasterToZscan[rRRefSU];
+        zRefSU       = auiRasterToZscan[rRRefSU];
         pRefMapLCU  = pRRefMapLCU= (pSliceIDMapLCU + numSUInLCU);
       }
       else
       {
-        zRefSU       = g_auiRasterToZscan[rTLSU + widthSU];
+        zRefSU       = auiRasterToZscan[rTLSU + widthSU];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3852,12 +3852,12 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       if(bLCUTBoundary)
       {
         rTRefSU      = numSUInLCU - (numSUInLCUWidth - rTLSU);
-        zRefSU       = g_auiRasterToZscan[rTRefSU];
+        zRefSU       = auiRasterToZscan[rTRefSU];
         pRefMapLCU  = pTRefMapLCU= (pSliceIDMapLCU - (numLCUInPicWidth*numSUInLCU));
       }
       else
       {
-        zRefSU       = g_auiRasterToZscan[rTLSU - numSUInLCUWidth];
+        zRefSU       = auiRasterToZscan[rTLSU - numSUInLCUWidth];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3880,12 +3880,12 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       if(bLCUBBoundary)
       {
         rBRefSU      = rTLSU % numSUInLCUWidth;
-        zRefSU       = g_auiRasterToZscan[rBRefSU];
+        zRefSU       = auiRasterToZscan[rBRefSU];
         pRefMapLCU  = pBRefMapLCU= (pSliceIDMapLCU + (numLCUInPicWidth*numSUInLCU));
       }
       else
       {
-        zRefSU       = g_auiRasterToZscan[rTLSU + (heightSU*numSUInLCUWidth)];
+        zRefSU       = auiRasterToZscan[rTLSU + (heightSU*numSUInLCUWidth)];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3911,17 +3911,17 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       }
       else if(bLCUTBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rTRefSU- 1];
+        zRefSU       = auiRasterToZscan[ rTRefSU- 1];
         pRefMapLCU  = pTRefMapLCU;
       }
       else if(bLCULBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rLRefSU- numSUInLCUWidth ];
+        zRefSU       = auiRasterToZscan[ rLRefSU- numSUInLCUWidth ];
         pRefMapLCU  = pLRefMapLCU;
       }
       else //inside LCU
       {
-        zRefSU       = g_auiRasterToZscan[ rTLSU - numSUInLCUWidth -1];
+        zRefSU       = auiRasterToZscan[ rTLSU - numSUInLCUWidth -1];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3942,22 +3942,22 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
     {
       if(bLCUTBoundary && bLCURBoundary)
       {
-        zRefSU      = g_auiRasterToZscan[numSUInLCU - numSUInLCUWidth];
+        zRefSU      = auiRasterToZscan[numSUInLCU - numSUInLCUWidth];
         pRefMapLCU  = pSliceIDMapLCU - ( (numLCUInPicWidth-1)*numSUInLCU);
       }
       else if(bLCUTBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rTRefSU+ widthSU];
+        zRefSU       = auiRasterToZscan[ rTRefSU+ widthSU];
         pRefMapLCU  = pTRefMapLCU;
       }
       else if(bLCURBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rRRefSU- numSUInLCUWidth ];
+        zRefSU       = auiRasterToZscan[ rRRefSU- numSUInLCUWidth ];
         pRefMapLCU  = pRRefMapLCU;
       }
       else //inside LCU
       {
-        zRefSU       = g_auiRasterToZscan[ rTLSU - numSUInLCUWidth +widthSU];
+        zRefSU       = auiRasterToZscan[ rTLSU - numSUInLCUWidth +widthSU];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -3978,22 +3978,22 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
     {
       if(bLCUBBoundary && bLCULBoundary)
       {
-        zRefSU      = g_auiRasterToZscan[numSUInLCUWidth - 1];
+        zRefSU      = auiRasterToZscan[numSUInLCUWidth - 1];
         pRefMapLCU  = pSliceIDMapLCU + ( (numLCUInPicWidth-1)*numSUInLCU);
       }
       else if(bLCUBBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rBRefSU - 1];
+        zRefSU       = auiRasterToZscan[ rBRefSU - 1];
         pRefMapLCU  = pBRefMapLCU;
       }
       else if(bLCULBoundary)
       {
-        zRefSU       = g_auiRasterToZscan[ rLRefSU+ heightSU*numSUInLCUWidth ];
+        zRefSU       = auiRasterToZscan[ rLRefSU+ heightSU*numSUInLCUWidth ];
         pRefMapLCU  = pLRefMapLCU;
       }
       else //inside LCU
       {
-        zRefSU       = g_auiRasterToZscan[ rTLSU + heightSU*numSUInLCUWidth -1];
+        zRefSU       = auiRasterToZscan[ rTLSU + heightSU*numSUInLCUWidth -1];
         pRefMapLCU  = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -4019,17 +4019,17 @@ Void TComDataCU::setNDBFilterBlockBorderAvailability(UInt numLCUInPicWidth, UInt
       }
       else if(bLCUBBoundary)
       {
-        zRefSU      = g_auiRasterToZscan[ rBRefSU + widthSU];
+        zRefSU      = auiRasterToZscan[ rBRefSU + widthSU];
         pRefMapLCU = pBRefMapLCU;
       }
       else if(bLCURBoundary)
       {
-        zRefSU      = g_auiRasterToZscan[ rRRefSU + (heightSU*numSUInLCUWidth)];
+        zRefSU      = auiRasterToZscan[ rRRefSU + (heightSU*numSUInLCUWidth)];
         pRefMapLCU = pRRefMapLCU;
       }
       else //inside LCU
       {
-        zRefSU      = g_auiRasterToZscan[ rTLSU + (heightSU*numSUInLCUWidth)+ widthSU];
+        zRefSU      = auiRasterToZscan[ rTLSU + (heightSU*numSUInLCUWidth)+ widthSU];
         pRefMapLCU = pSliceIDMapLCU;
       }
       pRefID = pRefMapLCU + zRefSU;
@@ -150,7 +150,6 @@ private:
   TCoeff*        m_pcTrCoeff[MAX_NUM_COMPONENT];       ///< array of transform coefficient buffers (0->Y, 1->Cb, 2->Cr)
 #if ADAPTIVE_QP_SELECTION
   TCoeff*        m_pcArlCoeff[MAX_NUM_COMPONENT];  // ARL coefficient buffer (0->Y, 1->Cb, 2->Cr)
-  static TCoeff* m_pcGlbArlCoeff[MAX_NUM_COMPONENT]; // global ARL buffer
   Bool           m_ArlCoeffIsAliasedAllocation;  ///< ARL coefficient buffer is an alias of the global buffer and must not be free()'d
 #endif
 
@@ -259,6 +258,7 @@ public:
   TComPic*        getPic              ()                        { return m_pcPic;           }
   const TComPic*  getPic              ()   const                { return m_pcPic;           }
   TComSlice*    getSlice              ()                        { return m_pcSlice;         }
+  Void          setSlice              ( TComSlice* pcSlice )    { m_pcSlice = pcSlice;      }
   UInt&         getAddr               ()                        { return m_uiCUAddr;        }
   UInt&         getZorderIdxInCU      ()                        { return m_uiAbsIdxInLCU; }
   UInt          getSCUAddr            ();
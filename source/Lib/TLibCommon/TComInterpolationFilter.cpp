@@ -78,6 +78,27 @@ const TFilterCoeff TComInterpolationFilter::m_chromaFilter[CHROMA_INTERPOLATION_
 // Private member functions
 // ====================================================================================================================
 
+#if SIMD_SELF_CHECK
+/**
+ * \brief Compare a block produced with the SIMD kernels against the plain C result and abort on mismatch
+ */
+Void TComInterpolationFilter::xSelfCheck(const Char *name, const Pel *dst, Int dstStride, Int width, Int height, const std::vector<Pel> &reference)
+{
+  for (Int row = 0; row < height; row++)
+  {
+    for (Int col = 0; col < width; col++)
+    {
+      if (dst[row * dstStride + col] != reference[row * width + col])
+      {
+        std::cerr << "ERROR: SIMD self-check failed for " << name << " (" << width << "x" << height << ") at ("
+                  << col << "," << row << "): SIMD=" << dst[row * dstStride + col] << " reference=" << reference[row * width + col] << std::endl;
+        exit(1);
+      }
+    }
+  }
+}
+#endif
+
 /**
  * \brief Apply unit FIR filter to a block of samples
  *
@@ -93,6 +114,16 @@ const TFilterCoeff TComInterpolationFilter::m_chromaFilter[CHROMA_INTERPOLATION_
  */
 Void TComInterpolationFilter::filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast)
 {
+#if SIMD_X86
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    const Int done = filterCopyAVX2(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast);
+    src   += done;
+    dst   += done;
+    width -= done;
+  }
+#endif
+
   Int row, col;
   
   if ( isFirst == isLast )
@@ -267,6 +298,16 @@ Void TComInterpolationFilter::filter(Int bitDepth, Pel const *src, Int srcStride
 template<Int N>
 Void TComInterpolationFilter::filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isLast, TFilterCoeff const *coeff)
 {
+#if SIMD_X86
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    const Int done = filterHorAVX2<N>(bitDepth, src, srcStride, dst, dstStride, width, height, isLast, coeff);
+    src   += done;
+    dst   += done;
+    width -= done;
+  }
+#endif
+
   if ( isLast )
   {
     filter<N, false, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
@@ -294,6 +335,16 @@ Void TComInterpolationFilter::filterHor(Int bitDepth, Pel *src, Int srcStride, P
 template<Int N>
 Void TComInterpolationFilter::filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff)
 {
+#if SIMD_X86
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    const Int done = filterVerAVX2<N>(bitDepth, src, srcStride, dst, dstStride, width, height, isFirst, isLast, coeff);
+    src   += done;
+    dst   += done;
+    width -= done;
+  }
+#endif
+
   if ( isFirst && isLast )
   {
     filter<N, true, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
@@ -345,6 +396,18 @@ Void TComInterpolationFilter::filterHor(const ComponentID compID, Pel *src, Int
     assert(frac >=0 && csx<2 && (frac<<(1-csx)) < CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
     filterHor<NTAPS_CHROMA>(g_bitDepth[toChannelType(compID)], src, srcStride, dst, dstStride, width, height, isLast, m_chromaFilter[frac<<(1-csx)]);
   }
+
+#if SIMD_SELF_CHECK
+  if ( m_simdExtension != SIMD_NONE )
+  {
+    std::vector<Pel> reference(width * height);
+    const SIMDExtension simdExtension = m_simdExtension;
+    m_simdExtension = SIMD_NONE;
+    filterHor(compID, src, srcStride, &reference[0], width, width, height, frac, isLast, fmt);
+    m_simdExtension = simdExtension;
+    xSelfCheck("filterHor", dst, dstStride, width, height, reference);
+  }
+#endif
 }
 
 
@@ -378,6 +441,18 @@ Void TComInterpolationFilter::filterVer(const ComponentID compID, Pel *src, Int
     assert(frac >=0 && csy<2 && (frac<<(1-csy)) < CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS);
     filterVer<NTAPS_CHROMA>(g_bitDepth[toChannelType(compID)], src, srcStride, dst, dstStride, width, height, isFirst, isLast, m_chromaFilter[frac<<(1-csy)]);
   }
+
+#if SIMD_SELF_CHECK
+  if ( m_simdExtension != SIMD_NONE )
+  {
+    std::vector<Pel> reference(width * height);
+    const SIMDExtension simdExtension = m_simdExtension;
+    m_simdExtension = SIMD_NONE;
+    filterVer(compID, src, srcStride, &reference[0], width, width, height, frac, isFirst, isLast, fmt);
+    m_simdExtension = simdExtension;
+    xSelfCheck("filterVer", dst, dstStride, width, height, reference);
+  }
+#endif
 }
 
 //! \}
@@ -40,6 +40,7 @@
 #define __TCOMINTERPOLATIONFILTER__
 
 #include "TypeDef.h"
+#include "TComSIMD.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -58,18 +59,34 @@ class TComInterpolationFilter
   static const TFilterCoeff m_lumaFilter[LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_LUMA];     ///< Luma filter taps
   static const TFilterCoeff m_chromaFilter[CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][NTAPS_CHROMA]; ///< Chroma filter taps
   
-  static Void filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+  SIMDExtension m_simdExtension; ///< extension used for the AVX2 kernels below (SIMD_NONE = plain C only)
+
+  Void filterCopy(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
   
   template<Int N, Bool isVertical, Bool isFirst, Bool isLast>
   static Void filter(Int bitDepth, Pel const *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, TFilterCoeff const *coeff);
 
   template<Int N>
-  static Void filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height,               Bool isLast, TFilterCoeff const *coeff);
+  Void filterHor(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height,               Bool isLast, TFilterCoeff const *coeff);
+  template<Int N>
+  Void filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff);
+
+#if SIMD_X86
+  // AVX2 kernels (TComInterpolationFilterSIMD.cpp). Each one processes the leading multiple-of-8 columns of the
+  // block and returns their number; the remaining columns are left to the plain C functions above.
+  static Int filterCopyAVX2(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast);
+
   template<Int N>
-  static Void filterVer(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff);
+  static Int filterHorAVX2(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height,               Bool isLast, TFilterCoeff const *coeff);
+  template<Int N>
+  static Int filterVerAVX2(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff);
+#endif
+#if SIMD_SELF_CHECK
+  static Void xSelfCheck(const Char *name, const Pel *dst, Int dstStride, Int width, Int height, const std::vector<Pel> &reference);
+#endif
 
 public:
-  TComInterpolationFilter() {}
+  TComInterpolationFilter() : m_simdExtension( getSIMDExtension() ) {}
   ~TComInterpolationFilter() {}
 
   Void filterHor(const ComponentID compID, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Int frac,               Bool isLast, const ChromaFormat fmt );
@@ -0,0 +1,284 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComInterpolationFilterSIMD.cpp
+    \brief    AVX2 kernels for TComInterpolationFilter
+    \note     The kernels handle the leading multiple-of-8 columns of a block and leave the remaining columns to the
+              plain C filters. Tap products are accumulated in 32-bit lanes (pairs of taps via madd) with the same
+              offset and arithmetic shift as TComInterpolationFilter::filter(), so the results are bit-exact with it.
+              The rounded values always fit in a Pel for sample / intermediate inputs, hence the saturating packs.
+*/
+
+#include "TComInterpolationFilter.h"
+
+#if SIMD_X86
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+/// packs two neighbouring filter taps into a 32-bit value, so that madd on (src[k], src[k+1]) pairs applies both
+static inline Int xCoeffPair( TFilterCoeff c0, TFilterCoeff c1 )
+{
+  return Int( UInt( UShort( c0 ) ) | ( UInt( UShort( c1 ) ) << 16 ) );
+}
+
+/**
+ * \brief AVX2 version of TComInterpolationFilter::filter()
+ *
+ * \returns number of columns processed (width rounded down to a multiple of 8)
+ */
+template<Int N, Bool isVertical, Bool isFirst, Bool isLast>
+static SIMD_TARGET_AVX2 Int xFilterAVX2( Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, const TFilterCoeff *coeff )
+{
+  const Int cols = width & ~7;
+  if ( cols == 0 )
+  {
+    return 0;
+  }
+
+  const Int cStride = ( isVertical ) ? srcStride : 1;
+  src -= ( N/2 - 1 ) * cStride;
+
+  Int offset;
+  Int maxVal;
+  Int headRoom = std::max<Int>(2, (IF_INTERNAL_PREC - bitDepth));
+  Int shift    = IF_FILTER_PREC;
+
+  if ( isLast )
+  {
+    shift += (isFirst) ? 0 : headRoom;
+    offset = 1 << (shift - 1);
+    offset += (isFirst) ? 0 : IF_INTERNAL_OFFS << IF_FILTER_PREC;
+    maxVal = (1 << bitDepth) - 1;
+  }
+  else
+  {
+    shift -= (isFirst) ? headRoom : 0;
+    offset = (isFirst) ? -IF_INTERNAL_OFFS << shift : 0;
+    maxVal = 0;
+  }
+
+  __m256i coeffPair[N/2];
+  for ( Int k = 0; k < N/2; k++ )
+  {
+    coeffPair[k] = _mm256_set1_epi32( xCoeffPair( coeff[2*k], coeff[2*k + 1] ) );
+  }
+
+  const __m256i vOffset  = _mm256_set1_epi32( offset );
+  const __m256i vMaxVal  = _mm256_set1_epi16( Short( maxVal ) );
+  const __m128i vShift   = _mm_cvtsi32_si128( shift );
+
+  for ( Int row = 0; row < height; row++ )
+  {
+    Int col = 0;
+
+    for ( ; col + 16 <= cols; col += 16 )
+    {
+      __m256i sumLo = vOffset;
+      __m256i sumHi = vOffset;
+
+      for ( Int k = 0; k < N; k += 2 )
+      {
+        const __m256i a = _mm256_loadu_si256( (const __m256i*)( src + col + (k + 0) * cStride ) );
+        const __m256i b = _mm256_loadu_si256( (const __m256i*)( src + col + (k + 1) * cStride ) );
+        sumLo = _mm256_add_epi32( sumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), coeffPair[k >> 1] ) );
+        sumHi = _mm256_add_epi32( sumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), coeffPair[k >> 1] ) );
+      }
+
+      // unpacklo/hi split each 128-bit lane in halves; packs puts them back in order
+      __m256i val = _mm256_packs_epi32( _mm256_sra_epi32( sumLo, vShift ), _mm256_sra_epi32( sumHi, vShift ) );
+      if ( isLast )
+      {
+        val = _mm256_min_epi16( _mm256_max_epi16( val, _mm256_setzero_si256() ), vMaxVal );
+      }
+      _mm256_storeu_si256( (__m256i*)( dst + col ), val );
+    }
+
+    if ( col < cols )
+    {
+      __m128i sumLo = _mm256_castsi256_si128( vOffset );
+      __m128i sumHi = _mm256_castsi256_si128( vOffset );
+
+      for ( Int k = 0; k < N; k += 2 )
+      {
+        const __m128i a = _mm_loadu_si128( (const __m128i*)( src + col + (k + 0) * cStride ) );
+        const __m128i b = _mm_loadu_si128( (const __m128i*)( src + col + (k + 1) * cStride ) );
+        sumLo = _mm_add_epi32( sumLo, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), _mm256_castsi256_si128( coeffPair[k >> 1] ) ) );
+        sumHi = _mm_add_epi32( sumHi, _mm_madd_epi16( _mm_unpackhi_epi16( a, b ), _mm256_castsi256_si128( coeffPair[k >> 1] ) ) );
+      }
+
+      __m128i val = _mm_packs_epi32( _mm_sra_epi32( sumLo, vShift ), _mm_sra_epi32( sumHi, vShift ) );
+      if ( isLast )
+      {
+        val = _mm_min_epi16( _mm_max_epi16( val, _mm_setzero_si128() ), _mm256_castsi256_si128( vMaxVal ) );
+      }
+      _mm_storeu_si128( (__m128i*)( dst + col ), val );
+    }
+
+    src += srcStride;
+    dst += dstStride;
+  }
+
+  return cols;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/**
+ * \brief AVX2 version of filterCopy()
+ *
+ * \returns number of columns processed (width rounded down to a multiple of 8)
+ */
+SIMD_TARGET_AVX2 Int TComInterpolationFilter::filterCopyAVX2(Int bitDepth, const Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast)
+{
+  const Int cols = width & ~7;
+  if ( cols == 0 )
+  {
+    return 0;
+  }
+
+  const Int     shift   = std::max<Int>(2, (IF_INTERNAL_PREC - bitDepth));
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m256i vOffset = isFirst ? _mm256_set1_epi16( Short( IF_INTERNAL_OFFS ) ) : _mm256_set1_epi32( IF_INTERNAL_OFFS + ( 1 << (shift - 1) ) );
+  const __m256i vMaxVal = _mm256_set1_epi16( Short( (1 << bitDepth) - 1 ) );
+
+  for ( Int row = 0; row < height; row++ )
+  {
+    for ( Int col = 0; col < cols; col += 8 )
+    {
+      __m256i val;
+      if ( col + 16 <= cols )
+      {
+        val = _mm256_loadu_si256( (const __m256i*)( src + col ) );
+      }
+      else
+      {
+        val = _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i*)( src + col ) ) );
+      }
+
+      if ( isFirst == isLast )
+      {
+        // plain copy
+      }
+      else if ( isFirst )
+      {
+        // the C code wraps to Pel after the shift and after the subtraction, as do the 16-bit lanes
+        val = _mm256_sub_epi16( _mm256_sll_epi16( val, vShift ), vOffset );
+      }
+      else
+      {
+        // sign extend to 32 bits for the rounding offset, as the C code does
+        const __m256i sign = _mm256_srai_epi16( val, 15 );
+        const __m256i lo   = _mm256_sra_epi32( _mm256_add_epi32( _mm256_unpacklo_epi16( val, sign ), vOffset ), vShift );
+        const __m256i hi   = _mm256_sra_epi32( _mm256_add_epi32( _mm256_unpackhi_epi16( val, sign ), vOffset ), vShift );
+        val = _mm256_min_epi16( _mm256_max_epi16( _mm256_packs_epi32( lo, hi ), _mm256_setzero_si256() ), vMaxVal );
+      }
+
+      if ( col + 16 <= cols )
+      {
+        _mm256_storeu_si256( (__m256i*)( dst + col ), val );
+        col += 8;
+      }
+      else
+      {
+        _mm_storeu_si128( (__m128i*)( dst + col ), _mm256_castsi256_si128( val ) );
+      }
+    }
+
+    src += srcStride;
+    dst += dstStride;
+  }
+
+  return cols;
+}
+
+/**
+ * \brief AVX2 version of filterHor<N>()
+ *
+ * \returns number of columns processed (width rounded down to a multiple of 8)
+ */
+template<Int N>
+Int TComInterpolationFilter::filterHorAVX2(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isLast, TFilterCoeff const *coeff)
+{
+  if ( isLast )
+  {
+    return xFilterAVX2<N, false, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+  else
+  {
+    return xFilterAVX2<N, false, true, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+}
+
+/**
+ * \brief AVX2 version of filterVer<N>()
+ *
+ * \returns number of columns processed (width rounded down to a multiple of 8)
+ */
+template<Int N>
+Int TComInterpolationFilter::filterVerAVX2(Int bitDepth, Pel *src, Int srcStride, Pel *dst, Int dstStride, Int width, Int height, Bool isFirst, Bool isLast, TFilterCoeff const *coeff)
+{
+  if ( isFirst && isLast )
+  {
+    return xFilterAVX2<N, true, true, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+  else if ( isFirst && !isLast )
+  {
+    return xFilterAVX2<N, true, true, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+  else if ( !isFirst && isLast )
+  {
+    return xFilterAVX2<N, true, false, true>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+  else
+  {
+    return xFilterAVX2<N, true, false, false>(bitDepth, src, srcStride, dst, dstStride, width, height, coeff);
+  }
+}
+
+template Int TComInterpolationFilter::filterHorAVX2<NTAPS_LUMA  >(Int, Pel*, Int, Pel*, Int, Int, Int, Bool, TFilterCoeff const*);
+template Int TComInterpolationFilter::filterHorAVX2<NTAPS_CHROMA>(Int, Pel*, Int, Pel*, Int, Int, Int, Bool, TFilterCoeff const*);
+template Int TComInterpolationFilter::filterVerAVX2<NTAPS_LUMA  >(Int, Pel*, Int, Pel*, Int, Int, Int, Bool, Bool, TFilterCoeff const*);
+template Int TComInterpolationFilter::filterVerAVX2<NTAPS_CHROMA>(Int, Pel*, Int, Pel*, Int, Int, Int, Bool, Bool, TFilterCoeff const*);
+
+//! \}
+
+#endif // SIMD_X86
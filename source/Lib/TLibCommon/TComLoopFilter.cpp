@@ -39,6 +39,10 @@
 #include "TComSlice.h"
 #include "TComMv.h"
 #include "TComTU.h"
+#if SIMD_SELF_CHECK
+#include <vector>
+#include <iostream>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -72,12 +76,17 @@ const UChar TComLoopFilter::sm_betaTable[MAX_QP + 1] =
 
 TComLoopFilter::TComLoopFilter()
 : m_uiNumPartitions(0)
+, m_uiMapWidthInCUs(0)
+, m_fpFilterLumaEdge(xFilterLumaEdge)
+, m_fpFilterChromaEdge(xFilterChromaEdge)
 , m_bLFCrossTileBoundary(true)
 {
   for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
-    m_aapucBS       [edgeDir] = NULL;
-    m_aapbEdgeFilter[edgeDir] = NULL;
+    m_aapucBSMap       [edgeDir] = NULL;
+    m_aapbEdgeFilterMap[edgeDir] = NULL;
+    m_aapucBS          [edgeDir] = NULL;
+    m_aapbEdgeFilter   [edgeDir] = NULL;
   }
 }
 
@@ -97,60 +106,96 @@ Void TComLoopFilter::create( UInt uiMaxCUDepth )
 {
   destroy();
   m_uiNumPartitions = 1 << ( uiMaxCUDepth<<1 );
-  for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
-  {
-    m_aapucBS       [edgeDir] = new UChar[m_uiNumPartitions];
-    m_aapbEdgeFilter[edgeDir] = new Bool [m_uiNumPartitions];
-  }
+
+  m_fpFilterLumaEdge   = xFilterLumaEdge;
+  m_fpFilterChromaEdge = xFilterChromaEdge;
+#if SIMD_X86
+  xInitSIMD( getSIMDExtension() );
+#endif
 }
 
 Void TComLoopFilter::destroy()
 {
   for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
-    if (m_aapucBS[edgeDir] != NULL)
+    if (m_aapucBSMap[edgeDir] != NULL)
     {
-      delete [] m_aapucBS[edgeDir];
-      m_aapucBS[edgeDir] = NULL;
+      delete [] m_aapucBSMap[edgeDir];
+      m_aapucBSMap[edgeDir] = NULL;
     }
 
-    if (m_aapbEdgeFilter[edgeDir])
+    if (m_aapbEdgeFilterMap[edgeDir])
     {
-      delete [] m_aapbEdgeFilter[edgeDir];
-      m_aapbEdgeFilter[edgeDir] = NULL;
+      delete [] m_aapbEdgeFilterMap[edgeDir];
+      m_aapbEdgeFilterMap[edgeDir] = NULL;
     }
+    m_aapucBS       [edgeDir] = NULL;
+    m_aapbEdgeFilter[edgeDir] = NULL;
   }
+  m_uiMapWidthInCUs = 0;
 }
 
 /**
- - call deblocking function for every CU
+ - call deblocking function for every CTU row
  .
+ The picture is deblocked one CTU row at a time, the vertical edges of a row before its horizontal edges. This gives
+ the same result as filtering all vertical edges of the picture before all horizontal ones, since the horizontal edges
+ at the top of a row only modify the three lines above it, which no edge of the row above reads.
+ loopFilterCTURow() can therefore run in a pipeline behind the reconstruction, provided that the rows are processed in
+ order and each row only once the row below it has been reconstructed (its intra prediction and the Bs of the
+ horizontal edges at the top of the row below use the unfiltered row).
  \param  pcPic   picture class (TComPic) pointer
  */
 Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 {
-  // Horizontal filtering
-  for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
+  for ( UInt uiCTURow = 0; uiCTURow < pcPic->getFrameHeightInCU(); uiCTURow++ )
   {
-    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    loopFilterCTURow( pcPic, uiCTURow );
+  }
+}
 
-    ::memset( m_aapucBS       [EDGE_VER], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_VER], 0, sizeof( Bool  ) * m_uiNumPartitions );
+/**
+ - derive the Bs and edge maps of a whole CTU row, then filter its edges
+ .
+ \param  pcPic     picture class (TComPic) pointer
+ \param  uiCTURow  CTU row to be deblocked
+ */
+Void TComLoopFilter::loopFilterCTURow( TComPic* pcPic, UInt uiCTURow )
+{
+  const UInt uiWidthInCUs = pcPic->getFrameWidthInCU();
 
-    // CU-based deblocking
-    xDeblockCU( pcCU, 0, 0, EDGE_VER );
+  if ( uiWidthInCUs > m_uiMapWidthInCUs )
+  {
+    for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
+    {
+      delete [] m_aapucBSMap       [edgeDir];
+      delete [] m_aapbEdgeFilterMap[edgeDir];
+      m_aapucBSMap       [edgeDir] = new UChar[uiWidthInCUs * m_uiNumPartitions];
+      m_aapbEdgeFilterMap[edgeDir] = new Bool [uiWidthInCUs * m_uiNumPartitions];
+    }
+    m_uiMapWidthInCUs = uiWidthInCUs;
   }
 
-  // Vertical filtering
-  for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
+  // the Bs and edge maps do not depend on the samples, so both directions are derived in one pass over the CTUs
+  for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
   {
-    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    ::memset( m_aapucBSMap       [edgeDir], 0, sizeof( UChar ) * uiWidthInCUs * m_uiNumPartitions );
+    ::memset( m_aapbEdgeFilterMap[edgeDir], 0, sizeof( Bool  ) * uiWidthInCUs * m_uiNumPartitions );
+  }
 
-    ::memset( m_aapucBS       [EDGE_HOR], 0, sizeof( UChar ) * m_uiNumPartitions );
-    ::memset( m_aapbEdgeFilter[EDGE_HOR], 0, sizeof( Bool  ) * m_uiNumPartitions );
+  for ( UInt uiCTUInRow = 0; uiCTUInRow < uiWidthInCUs; uiCTUInRow++ )
+  {
+    xSelectCTUMaps( uiCTUInRow );
+    xSetBoundaryStrengthCU( pcPic->getCU( uiCTURow * uiWidthInCUs + uiCTUInRow ), 0, 0 );
+  }
 
-    // CU-based deblocking
-    xDeblockCU( pcCU, 0, 0, EDGE_HOR );
+  for ( Int iDir = EDGE_VER; iDir <= EDGE_HOR; iDir++ )
+  {
+    for ( UInt uiCTUInRow = 0; uiCTUInRow < uiWidthInCUs; uiCTUInRow++ )
+    {
+      xSelectCTUMaps( uiCTUInRow );
+      xEdgeFilterCTU( pcPic->getCU( uiCTURow * uiWidthInCUs + uiCTUInRow ), DeblockEdgeDir( iDir ) );
+    }
   }
 }
 
@@ -159,12 +204,24 @@ Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
 // Protected member functions
 // ====================================================================================================================
 
+/// point the maps of the current CTU at the entries of a CTU of the row
+Void TComLoopFilter::xSelectCTUMaps( UInt uiCTUInRow )
+{
+  for( Int edgeDir = 0; edgeDir < NUM_EDGE_DIR; edgeDir++ )
+  {
+    m_aapucBS       [edgeDir] = m_aapucBSMap       [edgeDir] + uiCTUInRow * m_uiNumPartitions;
+    m_aapbEdgeFilter[edgeDir] = m_aapbEdgeFilterMap[edgeDir] + uiCTUInRow * m_uiNumPartitions;
+  }
+}
+
 /**
- - Deblocking filter process in CU-based (the same function as conventional's)
+ - Derivation of the edges and their Bs in CU-based (the same function as conventional's), for both edge directions
  .
- \param Edge          the direction of the edge in block boundary (horizonta/vertical), which is added newly
+ \param pcCU            CTU
+ \param uiAbsZorderIdx  z-order index of the CU within the CTU
+ \param uiDepth         depth of the CU
 */
-Void TComLoopFilter::xDeblockCU( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir )
+Void TComLoopFilter::xSetBoundaryStrengthCU( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth )
 {
   if(pcCU->getPic()==0||pcCU->getPartitionSize(uiAbsZorderIdx)==NUMBER_OF_PART_SIZES)
   {
@@ -182,7 +239,7 @@ Void TComLoopFilter::xDeblockCU( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiD
       UInt uiTPelY   = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[uiAbsZorderIdx] ];
       if( ( uiLPelX < pcCU->getSlice()->getSPS()->getPicWidthInLumaSamples() ) && ( uiTPelY < pcCU->getSlice()->getSPS()->getPicHeightInLumaSamples() ) )
       {
-        xDeblockCU( pcCU, uiAbsZorderIdx, uiDepth+1, edgeDir );
+        xSetBoundaryStrengthCU( pcCU, uiAbsZorderIdx, uiDepth+1 );
       }
     }
     return;
@@ -193,36 +250,61 @@ Void TComLoopFilter::xDeblockCU( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiD
   xSetEdgefilterTU   ( tuRecurse );
   xSetEdgefilterPU   ( pcCU, uiAbsZorderIdx );
 
-  for( UInt uiPartIdx = uiAbsZorderIdx; uiPartIdx < uiAbsZorderIdx + uiCurNumParts; uiPartIdx++ )
+  const Bool bMinSize4 = ( (g_uiMaxCUWidth >> g_uiMaxCUDepth) == 4 );
+  for ( Int iDir = EDGE_VER; iDir <= EDGE_HOR; iDir++ )
   {
-    UInt uiBSCheck;
-    if( (g_uiMaxCUWidth >> g_uiMaxCUDepth) == 4 )
+    const DeblockEdgeDir edgeDir = DeblockEdgeDir( iDir );
+    for( UInt uiPartIdx = uiAbsZorderIdx; uiPartIdx < uiAbsZorderIdx + uiCurNumParts; uiPartIdx++ )
     {
-      uiBSCheck = (edgeDir == EDGE_VER && uiPartIdx%2 == 0) || (edgeDir == EDGE_HOR && (uiPartIdx-((uiPartIdx>>2)<<2))/2 == 0);
-    }
-    else
-    {
-      uiBSCheck = 1;
-    }
+      UInt uiBSCheck;
+      if( bMinSize4 )
+      {
+        uiBSCheck = (edgeDir == EDGE_VER && uiPartIdx%2 == 0) || (edgeDir == EDGE_HOR && (uiPartIdx-((uiPartIdx>>2)<<2))/2 == 0);
+      }
+      else
+      {
+        uiBSCheck = 1;
+      }
 
-    if ( m_aapbEdgeFilter[edgeDir][uiPartIdx] && uiBSCheck )
-    {
-      xGetBoundaryStrengthSingle ( pcCU, edgeDir, uiPartIdx );
+      if ( m_aapbEdgeFilter[edgeDir][uiPartIdx] && uiBSCheck )
+      {
+        xGetBoundaryStrengthSingle ( pcCU, edgeDir, uiPartIdx );
+      }
     }
   }
+}
 
-  UInt uiPelsInPart = g_uiMaxCUWidth >> g_uiMaxCUDepth;
-  UInt PartIdxIncr = DEBLOCK_SMALLEST_BLOCK / uiPelsInPart ? DEBLOCK_SMALLEST_BLOCK / uiPelsInPart : 1 ;
+/**
+ - Filtering of the edges of a CTU whose Bs have been derived by xSetBoundaryStrengthCU()
+ .
+ Edges lie on the 8x8 luma grid, or on the partition grid when partitions are larger. xEdgeFilterChroma() selects
+ the chroma edges among them.
+ \param pcCU     CTU
+ \param edgeDir  direction of the edges to be filtered
+*/
+Void TComLoopFilter::xEdgeFilterCTU( TComDataCU* pcCU, DeblockEdgeDir edgeDir )
+{
+  if ( pcCU->getPic() == 0 || pcCU->getPartitionSize( 0 ) == NUMBER_OF_PART_SIZES )
+  {
+    return;
+  }
+  TComSPS*       pcSPS  = pcCU->getSlice()->getSPS();
+  const UInt uiWidth    = std::min<UInt>( g_uiMaxCUWidth,  pcSPS->getPicWidthInLumaSamples () - pcCU->getCUPelX() );
+  const UInt uiHeight   = std::min<UInt>( g_uiMaxCUHeight, pcSPS->getPicHeightInLumaSamples() - pcCU->getCUPelY() );
+  const UInt uiPelsInPart = g_uiMaxCUWidth >> g_uiMaxCUDepth;
+  const UInt uiEdgeStep = std::max<UInt>( DEBLOCK_SMALLEST_BLOCK, uiPelsInPart );
 
-  UInt uiSizeInPU = pcPic->getNumPartInWidth()>>(uiDepth);
-  const ChromaFormat chFmt=pcCU->getPic()->getChromaFormat();
-  const Bool bAlwaysDoChroma=chFmt==CHROMA_444;
-  for ( Int iEdge = 0; iEdge < uiSizeInPU ; iEdge+=PartIdxIncr)
+  const Bool bChroma    = pcCU->getPic()->getChromaFormat() != CHROMA_400;
+
+  const UInt uiEdgeEnd  = ( edgeDir == EDGE_VER ) ? uiWidth  : uiHeight;
+  const UInt uiLength   = ( edgeDir == EDGE_VER ) ? uiHeight : uiWidth;
+
+  for ( UInt uiEdge = 0; uiEdge < uiEdgeEnd; uiEdge += uiEdgeStep )
   {
-    xEdgeFilterLuma     ( pcCU, uiAbsZorderIdx, uiDepth, edgeDir, iEdge );
-    if ( chFmt!=CHROMA_400 && (bAlwaysDoChroma || (uiPelsInPart>DEBLOCK_SMALLEST_BLOCK) || (iEdge % ( (DEBLOCK_SMALLEST_BLOCK<<1)/uiPelsInPart ) ) == 0 ) )
+    xEdgeFilterLuma( pcCU, edgeDir, uiEdge, uiLength );
+    if ( bChroma )
     {
-      xEdgeFilterChroma   ( pcCU, uiAbsZorderIdx, uiDepth, edgeDir, iEdge );
+      xEdgeFilterChroma( pcCU, edgeDir, uiEdge, uiLength );
     }
   }
 }
@@ -531,10 +613,18 @@ Void TComLoopFilter::xGetBoundaryStrengthSingle ( TComDataCU* pcLCU, DeblockEdge
 }
 
 
-Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir, Int iEdge  )
+/**
+ - Derive the filter decisions of the lines of a luma edge of a CTU, then filter them
+ .
+ \param pcCU      CTU
+ \param edgeDir   direction of the edge
+ \param uiEdge    position of the edge within the CTU, in luma samples
+ \param uiLength  number of lines of the edge within the picture
+*/
+Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, DeblockEdgeDir edgeDir, UInt uiEdge, UInt uiLength )
 {
   TComPicYuv* pcPicYuvRec = pcCU->getPic()->getPicYuvRec();
-  Pel* piSrc    = pcPicYuvRec->getAddr(COMPONENT_Y, pcCU->getAddr(), uiAbsZorderIdx );
+  Pel* piSrc    = pcPicYuvRec->getAddr(COMPONENT_Y, pcCU->getAddr());
   Pel* piTmpSrc = piSrc;
 
   const Bool lfCrossSliceBoundaryFlag=pcCU->getSlice()->getLFCrossSliceBoundaryFlag();
@@ -543,9 +633,9 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
   Int iQP = 0;
   Int iQP_P = 0;
   Int iQP_Q = 0;
-  UInt uiNumParts = pcCU->getPic()->getNumPartInWidth()>>uiDepth;
 
   UInt  uiPelsInPart = g_uiMaxCUWidth >> g_uiMaxCUDepth;
+  UInt  uiNumParts = uiLength / uiPelsInPart;
   UInt  uiBsAbsIdx = 0, uiBs = 0;
   Int   iOffset, iSrcStep;
 
@@ -559,22 +649,25 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
   Int  betaOffsetDiv2 = pcCUQ->getSlice()->getDeblockingFilterBetaOffsetDiv2();
   Int  tcOffsetDiv2 = pcCUQ->getSlice()->getDeblockingFilterTcOffsetDiv2();
 
+  LFEdgeLines& rcLines = m_cLumaLines;
+  Bool  bFilterEdge = false;
+
   if (edgeDir == EDGE_VER)
   {
     iOffset = 1;
     iSrcStep = iStride;
-    piTmpSrc += iEdge*uiPelsInPart;
+    piTmpSrc += uiEdge;
   }
   else  // (edgeDir == EDGE_HOR)
   {
     iOffset = iStride;
     iSrcStep = 1;
-    piTmpSrc += iEdge*uiPelsInPart*iStride;
+    piTmpSrc += uiEdge*iStride;
   }
 
   for ( UInt iIdx = 0; iIdx < uiNumParts; iIdx++ )
   {
-    uiBsAbsIdx = xCalcBsIdx( pcCU, uiAbsZorderIdx, edgeDir, iEdge, iIdx);
+    uiBsAbsIdx = xCalcBsIdx( pcCU, 0, edgeDir, uiEdge / uiPelsInPart, iIdx);
     uiBs = m_aapucBS[edgeDir][uiBsAbsIdx];
     if ( uiBs )
     {
@@ -600,16 +693,16 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
       Int iTc =  sm_tcTable[iIndexTC]*iBitdepthScale;
       Int iBeta = sm_betaTable[iIndexB]*iBitdepthScale;
       Int iSideThreshold = (iBeta+(iBeta>>1))>>3;
-      Int iThrCut = iTc*10;
 
 
       UInt  uiBlocksInPart = uiPelsInPart / 4 ? uiPelsInPart / 4 : 1;
       for (UInt iBlkIdx = 0; iBlkIdx<uiBlocksInPart; iBlkIdx ++)
       {
-        Int dp0 = xCalcDP( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0), iOffset);
-        Int dq0 = xCalcDQ( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0), iOffset);
-        Int dp3 = xCalcDP( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+3), iOffset);
-        Int dq3 = xCalcDQ( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+3), iOffset);
+        const UInt uiLine = iIdx*uiPelsInPart+iBlkIdx*4;
+        Int dp0 = xCalcDP( piTmpSrc+iSrcStep*(uiLine+0), iOffset);
+        Int dq0 = xCalcDQ( piTmpSrc+iSrcStep*(uiLine+0), iOffset);
+        Int dp3 = xCalcDP( piTmpSrc+iSrcStep*(uiLine+3), iOffset);
+        Int dq3 = xCalcDQ( piTmpSrc+iSrcStep*(uiLine+3), iOffset);
         Int d0 = dp0 + dq0;
         Int d3 = dp3 + dq3;
 
@@ -633,38 +726,64 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
           Bool bFilterP = (dp < iSideThreshold);
           Bool bFilterQ = (dq < iSideThreshold);
 
-          Bool sw =  xUseStrongFiltering( iOffset, 2*d0, iBeta, iTc, piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0))
-          && xUseStrongFiltering( iOffset, 2*d3, iBeta, iTc, piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+3));
+          Bool sw =  xUseStrongFiltering( iOffset, 2*d0, iBeta, iTc, piTmpSrc+iSrcStep*(uiLine+0))
+          && xUseStrongFiltering( iOffset, 2*d3, iBeta, iTc, piTmpSrc+iSrcStep*(uiLine+3));
 
           for ( Int i = 0; i < DEBLOCK_SMALLEST_BLOCK/2; i++)
           {
-            xPelFilterLuma( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+i), iOffset, iTc, sw, bPartPNoFilter, bPartQNoFilter, iThrCut, bFilterP, bFilterQ);
+            rcLines.tc      [uiLine+i] = iTc;
+            rcLines.strong  [uiLine+i] = sw              ? -1 : 0;
+            rcLines.filterP [uiLine+i] = bPartPNoFilter  ? 0 : -1;
+            rcLines.filterQ [uiLine+i] = bPartQNoFilter  ? 0 : -1;
+            rcLines.filterP1[uiLine+i] = bFilterP        ? -1 : 0;
+            rcLines.filterQ1[uiLine+i] = bFilterQ        ? -1 : 0;
           }
+          bFilterEdge = bFilterEdge || iTc != 0;
+        }
+        else
+        {
+          ::memset( rcLines.tc + uiLine, 0, sizeof( Short ) * DEBLOCK_SMALLEST_BLOCK/2 );
         }
       }
     }
+    else
+    {
+      ::memset( rcLines.tc + iIdx*uiPelsInPart, 0, sizeof( Short ) * uiPelsInPart );
+    }
+  }
+
+  if ( bFilterEdge )
+  {
+    xFilterEdge( m_fpFilterLumaEdge, xFilterLumaEdge, "luma edge", piTmpSrc, iOffset, iSrcStep, &rcLines, uiLength, (1 << g_bitDepth[CHANNEL_TYPE_LUMA]) - 1 );
   }
 }
 
 
-Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir, Int iEdge )
+/**
+ - Derive the filter decisions of the lines of a chroma edge of a CTU, then filter them
+ .
+ \param pcCU      CTU
+ \param edgeDir   direction of the edge
+ \param uiEdge    position of the edge within the CTU, in luma samples
+ \param uiLength  number of luma lines of the edge within the picture
+*/
+Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, DeblockEdgeDir edgeDir, UInt uiEdge, UInt uiLength )
 {
   TComPicYuv* pcPicYuvRec = pcCU->getPic()->getPicYuvRec();
   Int         iStride     = pcPicYuvRec->getStride(COMPONENT_Cb);
-  Pel*        piSrcCb     = pcPicYuvRec->getAddr( COMPONENT_Cb, pcCU->getAddr(), uiAbsZorderIdx );
-  Pel*        piSrcCr     = pcPicYuvRec->getAddr( COMPONENT_Cr, pcCU->getAddr(), uiAbsZorderIdx );
+  Pel*        piSrcCb     = pcPicYuvRec->getAddr( COMPONENT_Cb, pcCU->getAddr() );
+  Pel*        piSrcCr     = pcPicYuvRec->getAddr( COMPONENT_Cr, pcCU->getAddr() );
   Int iQP = 0;
   Int iQP_P = 0;
   Int iQP_Q = 0;
 
+  UInt  uiPelsInPart        = g_uiMaxCUWidth >> g_uiMaxCUDepth;
   UInt  uiPelsInPartChromaH = g_uiMaxCUWidth >> (g_uiMaxCUDepth+pcPicYuvRec->getComponentScaleX(COMPONENT_Cb));
   UInt  uiPelsInPartChromaV = g_uiMaxCUWidth >> (g_uiMaxCUDepth+pcPicYuvRec->getComponentScaleY(COMPONENT_Cb));
 
   Int   iOffset, iSrcStep;
   UInt  uiLoopLength;
 
-  const UInt uiLCUWidthInBaseUnits = pcCU->getPic()->getNumPartInWidth();
-
   Bool  bPCMFilter = (pcCU->getSlice()->getSPS()->getUsePCM() && pcCU->getSlice()->getSPS()->getPCMFilterDisableFlag())? true : false;
   Bool  bPartPNoFilter = false;
   Bool  bPartQNoFilter = false;
@@ -672,8 +791,8 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
   Int tcOffsetDiv2 = pcCU->getSlice()->getDeblockingFilterTcOffsetDiv2();
 
   // Vertical Position
-  UInt uiEdgeNumInLCUVert = g_auiZscanToRaster[uiAbsZorderIdx]%uiLCUWidthInBaseUnits + iEdge;
-  UInt uiEdgeNumInLCUHor = g_auiZscanToRaster[uiAbsZorderIdx]/uiLCUWidthInBaseUnits + iEdge;
+  UInt uiEdgeNumInLCUVert = uiEdge / uiPelsInPart;
+  UInt uiEdgeNumInLCUHor  = uiEdge / uiPelsInPart;
 
   if ( (uiPelsInPartChromaH < DEBLOCK_SMALLEST_BLOCK) && (uiPelsInPartChromaV < DEBLOCK_SMALLEST_BLOCK) &&
        (
@@ -685,10 +804,13 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
     return;
   }
 
+  // Unless the partitions are larger than 8x8, or the format is 4:4:4, chroma is only filtered on the edges that are a
+  // multiple of 16 luma samples from the origin of the CU holding the Q samples.
+  const Bool bAlwaysDoChroma = pcCU->getPic()->getChromaFormat() == CHROMA_444 || uiPelsInPart > DEBLOCK_SMALLEST_BLOCK;
 
   const Bool lfCrossSliceBoundaryFlag=pcCU->getSlice()->getLFCrossSliceBoundaryFlag();
 
-  UInt  uiNumParts = pcCU->getPic()->getNumPartInWidth()>>uiDepth;
+  UInt  uiNumParts = uiLength / uiPelsInPart;
 
   UInt  uiBsAbsIdx;
   UChar ucBs;
@@ -700,25 +822,30 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
   {
     iOffset   = 1;
     iSrcStep  = iStride;
-    piTmpSrcCb += iEdge*uiPelsInPartChromaH;
-    piTmpSrcCr += iEdge*uiPelsInPartChromaH;
+    piTmpSrcCb += uiEdgeNumInLCUVert*uiPelsInPartChromaH;
+    piTmpSrcCr += uiEdgeNumInLCUVert*uiPelsInPartChromaH;
     uiLoopLength=uiPelsInPartChromaV;
   }
   else  // (edgeDir == EDGE_HOR)
   {
     iOffset   = iStride;
     iSrcStep  = 1;
-    piTmpSrcCb += iEdge*iStride*uiPelsInPartChromaV;
-    piTmpSrcCr += iEdge*iStride*uiPelsInPartChromaV;
+    piTmpSrcCb += uiEdgeNumInLCUHor*iStride*uiPelsInPartChromaV;
+    piTmpSrcCr += uiEdgeNumInLCUHor*iStride*uiPelsInPartChromaV;
     uiLoopLength=uiPelsInPartChromaH;
   }
 
+  Bool bFilterEdge = false;
+
   for ( UInt iIdx = 0; iIdx < uiNumParts; iIdx++ )
   {
-    uiBsAbsIdx = xCalcBsIdx( pcCU, uiAbsZorderIdx, edgeDir, iEdge, iIdx);
+    uiBsAbsIdx = xCalcBsIdx( pcCU, 0, edgeDir, uiEdge / uiPelsInPart, iIdx);
     ucBs = m_aapucBS[edgeDir][uiBsAbsIdx];
 
-    if ( ucBs > 1)
+    const UInt uiCUSize = g_uiMaxCUWidth >> pcCU->getDepth( uiBsAbsIdx );
+    const UInt uiEdgeInCU = ( uiEdge & ( uiCUSize - 1 ) ) / uiPelsInPart;
+
+    if ( ucBs > 1 && ( bAlwaysDoChroma || ( uiEdgeInCU % ( (DEBLOCK_SMALLEST_BLOCK<<1)/uiPelsInPart ) ) == 0 ) )
     {
       iQP_Q = pcCU->getQP( uiBsAbsIdx );
       UInt  uiPartQIdx = uiBsAbsIdx;
@@ -751,7 +878,7 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
       for ( UInt chromaIdx = 0; chromaIdx < 2; chromaIdx++ )
       {
         Int chromaQPOffset  = pcCU->getSlice()->getPPS()->getQpOffset(ComponentID(chromaIdx + 1));
-        Pel* piTmpSrcChroma = (chromaIdx == 0) ? piTmpSrcCb : piTmpSrcCr;
+        LFEdgeLines& rcLines = m_acChromaLines[chromaIdx];
 
         iQP = ((iQP_P + iQP_Q + 1) >> 1) + chromaQPOffset;
         if      (iQP >= chromaQPMappingTableSize) iQP -=6;
@@ -764,10 +891,120 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
 
         for ( UInt uiStep = 0; uiStep < uiLoopLength; uiStep++ )
         {
-          xPelFilterChroma( piTmpSrcChroma + iSrcStep*(uiStep+iIdx*uiLoopLength), iOffset, iTc , bPartPNoFilter, bPartQNoFilter);
+          rcLines.tc     [uiStep+iIdx*uiLoopLength] = iTc;
+          rcLines.filterP[uiStep+iIdx*uiLoopLength] = bPartPNoFilter ? 0 : -1;
+          rcLines.filterQ[uiStep+iIdx*uiLoopLength] = bPartQNoFilter ? 0 : -1;
+        }
+        bFilterEdge = bFilterEdge || iTc != 0;
+      }
+    }
+    else
+    {
+      ::memset( m_acChromaLines[0].tc + iIdx*uiLoopLength, 0, sizeof( Short ) * uiLoopLength );
+      ::memset( m_acChromaLines[1].tc + iIdx*uiLoopLength, 0, sizeof( Short ) * uiLoopLength );
+    }
+  }
+
+  if ( bFilterEdge )
+  {
+    const Int iMaxVal = (1 << g_bitDepth[CHANNEL_TYPE_CHROMA]) - 1;
+    xFilterEdge( m_fpFilterChromaEdge, xFilterChromaEdge, "Cb edge", piTmpSrcCb, iOffset, iSrcStep, &m_acChromaLines[0], uiNumParts*uiLoopLength, iMaxVal );
+    xFilterEdge( m_fpFilterChromaEdge, xFilterChromaEdge, "Cr edge", piTmpSrcCr, iOffset, iSrcStep, &m_acChromaLines[1], uiNumParts*uiLoopLength, iMaxVal );
+  }
+}
+
+/**
+ - Filter the lines of an edge with the selected kernel
+ .
+ With SIMD_SELF_CHECK, the result is compared with the one of the plain C kernel.
+ \param fpFilter     kernel used for the edge
+ \param fpReference  plain C version of the kernel
+ \param name         name of the kernel, for the self-check report
+ \param piSrc        first sample of the Q side of the first line
+ \param iOffset      distance between the samples of a line
+ \param iSrcStep     distance between the lines
+ \param pcLines      decisions of the lines
+ \param uiNumLines   number of lines
+ \param iMaxVal      maximum sample value
+ */
+Void TComLoopFilter::xFilterEdge( FpEdgeFunc fpFilter, FpEdgeFunc fpReference, const Char* name, Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiNumLines, Int iMaxVal )
+{
+#if SIMD_SELF_CHECK
+  if ( fpFilter != fpReference )
+  {
+    // save the 8 samples across the edge of every line, filter with the reference, then with fpFilter
+    std::vector<Pel> original( uiNumLines * 8 ), reference( uiNumLines * 8 );
+    for ( UInt uiLine = 0; uiLine < uiNumLines; uiLine++ )
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        original[uiLine * 8 + k] = piSrc[Int( uiLine ) * iSrcStep + (k - 4) * iOffset];
+      }
+    }
+    fpReference( piSrc, iOffset, iSrcStep, pcLines, 0, uiNumLines, iMaxVal );
+    for ( UInt uiLine = 0; uiLine < uiNumLines; uiLine++ )
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        reference[uiLine * 8 + k] = piSrc[Int( uiLine ) * iSrcStep + (k - 4) * iOffset];
+        piSrc[Int( uiLine ) * iSrcStep + (k - 4) * iOffset] = original[uiLine * 8 + k];
+      }
+    }
+    fpFilter( piSrc, iOffset, iSrcStep, pcLines, 0, uiNumLines, iMaxVal );
+    for ( UInt uiLine = 0; uiLine < uiNumLines; uiLine++ )
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        if ( piSrc[Int( uiLine ) * iSrcStep + (k - 4) * iOffset] != reference[uiLine * 8 + k] )
+        {
+          std::cerr << "ERROR: SIMD self-check failed for " << name << " at line " << uiLine << ", sample " << (k - 4)
+                    << ": SIMD=" << piSrc[Int( uiLine ) * iSrcStep + (k - 4) * iOffset] << " reference=" << reference[uiLine * 8 + k] << std::endl;
+          exit(1);
         }
       }
     }
+    return;
+  }
+#endif
+  fpFilter( piSrc, iOffset, iSrcStep, pcLines, 0, uiNumLines, iMaxVal );
+}
+
+/**
+ - Plain C filtering of the lines [uiStartLine, uiEndLine) of a luma edge
+ .
+ \param piSrc        first sample of the Q side of line 0
+ \param iOffset      distance between the samples of a line
+ \param iSrcStep     distance between the lines
+ \param pcLines      decisions of the lines
+ \param uiStartLine  first line to be filtered
+ \param uiEndLine    end of the lines to be filtered
+ \param iMaxVal      maximum sample value (the plain C filters clip to the bit depth of the channel)
+ */
+Void TComLoopFilter::xFilterLumaEdge( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal )
+{
+  for ( UInt uiLine = uiStartLine; uiLine < uiEndLine; uiLine++ )
+  {
+    const Int iTc = pcLines->tc[uiLine];
+    if ( iTc )
+    {
+      xPelFilterLuma( piSrc + iSrcStep * uiLine, iOffset, iTc, pcLines->strong[uiLine] != 0, pcLines->filterP[uiLine] == 0, pcLines->filterQ[uiLine] == 0,
+                      iTc * 10, pcLines->filterP1[uiLine] != 0, pcLines->filterQ1[uiLine] != 0 );
+    }
+  }
+}
+
+/**
+ - Plain C filtering of the lines [uiStartLine, uiEndLine) of a chroma edge, see xFilterLumaEdge()
+ */
+Void TComLoopFilter::xFilterChromaEdge( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal )
+{
+  for ( UInt uiLine = uiStartLine; uiLine < uiEndLine; uiLine++ )
+  {
+    const Int iTc = pcLines->tc[uiLine];
+    if ( iTc )
+    {
+      xPelFilterChroma( piSrc + iSrcStep * uiLine, iOffset, iTc, pcLines->filterP[uiLine] == 0, pcLines->filterQ[uiLine] == 0 );
+    }
   }
 }
 
@@ -40,11 +40,24 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComSIMD.h"
 
 //! \ingroup TLibCommon
 //! \{
 
 #define DEBLOCK_SMALLEST_BLOCK  8
+#define DEBLOCK_MAX_EDGE_LENGTH (1<<MAX_CU_DEPTH)  ///< maximum number of lines of an edge within one CTU
+
+/// filter decisions for each line of one edge within a CTU. Flags are masks (0 / -1), so the SIMD kernels can load them directly.
+struct LFEdgeLines
+{
+  Short tc      [DEBLOCK_MAX_EDGE_LENGTH];  ///< tc of the line, 0 if the line is not filtered
+  Short strong  [DEBLOCK_MAX_EDGE_LENGTH];  ///< luma: strong filter
+  Short filterP [DEBLOCK_MAX_EDGE_LENGTH];  ///< samples on the P side may be modified (neither PCM with loop filter disabled nor lossless)
+  Short filterQ [DEBLOCK_MAX_EDGE_LENGTH];  ///< samples on the Q side may be modified
+  Short filterP1[DEBLOCK_MAX_EDGE_LENGTH];  ///< luma: the weak filter also modifies p1
+  Short filterQ1[DEBLOCK_MAX_EDGE_LENGTH];  ///< luma: the weak filter also modifies q1
+};
 
 // ====================================================================================================================
 // Class definition
@@ -55,16 +68,29 @@ class TComLoopFilter
 {
 private:
 
+  typedef Void (*FpEdgeFunc)( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal );
+
   UInt      m_uiNumPartitions;
-  UChar*    m_aapucBS[NUM_EDGE_DIR];         ///< Bs for [Ver/Hor][Y/U/V][Blk_Idx]
-  Bool*     m_aapbEdgeFilter[NUM_EDGE_DIR];
+  UInt      m_uiMapWidthInCUs;               ///< number of CTUs covered by the maps below
+  UChar*    m_aapucBSMap[NUM_EDGE_DIR];      ///< Bs of a CTU row, [Ver/Hor][CTU * m_uiNumPartitions + Blk_Idx]
+  Bool*     m_aapbEdgeFilterMap[NUM_EDGE_DIR];
+  UChar*    m_aapucBS[NUM_EDGE_DIR];         ///< Bs of the current CTU, points into m_aapucBSMap
+  Bool*     m_aapbEdgeFilter[NUM_EDGE_DIR];  ///< edge flags of the current CTU, points into m_aapbEdgeFilterMap
   LFCUParam m_stLFCUParam;                   ///< status structure
+  LFEdgeLines m_cLumaLines;                  ///< decisions of the luma edge being filtered
+  LFEdgeLines m_acChromaLines[2];            ///< decisions of the Cb / Cr edge being filtered
+
+  FpEdgeFunc m_fpFilterLumaEdge;             ///< filters the lines of a luma edge
+  FpEdgeFunc m_fpFilterChromaEdge;           ///< filters the lines of a chroma edge
   
   Bool      m_bLFCrossTileBoundary;
 
 protected:
-  /// CU-level deblocking function
-  Void xDeblockCU                 ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir );
+  /// CU-level boundary strength and edge flag derivation
+  Void xSetBoundaryStrengthCU     ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth );
+  /// CTU-level filtering of the edges recorded in the maps
+  Void xEdgeFilterCTU             ( TComDataCU* pcCU, DeblockEdgeDir edgeDir );
+  Void xSelectCTUMaps             ( UInt uiCTUInRow );
 
   // set / get functions
   Void xSetLoopfilterParam        ( TComDataCU* pcCU, UInt uiAbsZorderIdx );
@@ -104,11 +130,24 @@ protected:
                                const TComRectangle *rect = 0
                                );
   
-  Void xEdgeFilterLuma            ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir, Int iEdge );
-  Void xEdgeFilterChroma          ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, DeblockEdgeDir edgeDir, Int iEdge );
-  
-  __inline Void xPelFilterLuma( Pel* piSrc, Int iOffset, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ);
-  __inline Void xPelFilterChroma( Pel* piSrc, Int iOffset, Int tc, Bool bPartPNoFilter, Bool bPartQNoFilter);
+  Void xEdgeFilterLuma            ( TComDataCU* pcCU, DeblockEdgeDir edgeDir, UInt uiEdge, UInt uiLength );
+  Void xEdgeFilterChroma          ( TComDataCU* pcCU, DeblockEdgeDir edgeDir, UInt uiEdge, UInt uiLength );
+  Void xFilterEdge                ( FpEdgeFunc fpFilter, FpEdgeFunc fpReference, const Char* name, Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiNumLines, Int iMaxVal );
+
+  static Void xFilterLumaEdge     ( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal );
+  static Void xFilterChromaEdge   ( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal );
+
+  static __inline Void xPelFilterLuma( Pel* piSrc, Int iOffset, Int tc, Bool sw, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iThrCut, Bool bFilterSecondP, Bool bFilterSecondQ);
+  static __inline Void xPelFilterChroma( Pel* piSrc, Int iOffset, Int tc, Bool bPartPNoFilter, Bool bPartQNoFilter);
+
+#if SIMD_X86
+  // SSE4.1 kernels (TComLoopFilterSIMD.cpp), filtering 8 lines of an edge at a time. The plain C functions above
+  // remain the reference implementation.
+  Void xInitSIMD( SIMDExtension eExt );
+
+  static Void xFilterLumaEdge_SSE41   ( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal );
+  static Void xFilterChromaEdge_SSE41 ( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal );
+#endif
   
 
   __inline Bool xUseStrongFiltering( Int offset, Int d, Int beta, Int tc, Pel* piSrc);
@@ -131,6 +170,9 @@ public:
   /// picture-level deblocking filter
   Void loopFilterPic( TComPic* pcPic );
 
+  /// deblocking of one CTU row, see loopFilterPic() for the order constraints
+  Void loopFilterCTURow( TComPic* pcPic, UInt uiCTURow );
+
   static Int getBeta( Int qp )
   {
     Int indexB = Clip3( 0, MAX_QP, qp );
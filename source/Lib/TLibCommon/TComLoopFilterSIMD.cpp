@@ -0,0 +1,321 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComLoopFilterSIMD.cpp
+    \brief    SSE4.1 deblocking filter kernels for TComLoopFilter
+    \note     Each kernel filters 8 lines of an edge at a time, with the decisions of TComLoopFilter::xEdgeFilterLuma()
+              / xEdgeFilterChroma() loaded as per-lane values and masks. The lines of a vertical edge are transposed
+              into registers holding one sample position each. Strong and weak luma filters are both evaluated and
+              the results selected per lane. Sums are evaluated in 16-bit lanes, which cannot overflow for bit depths
+              up to 12; larger bit depths and the lines left over at the end of an edge use the plain C kernels, so
+              all results are bit-exact with them.
+*/
+
+#include "TComLoopFilter.h"
+
+#if SIMD_X86
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+/// transpose of an 8x8 block of 16-bit samples, in place
+static inline SIMD_TARGET_SSE41 Void xTranspose8x8( __m128i m[8] )
+{
+  const __m128i a0 = _mm_unpacklo_epi16( m[0], m[1] );
+  const __m128i a1 = _mm_unpackhi_epi16( m[0], m[1] );
+  const __m128i a2 = _mm_unpacklo_epi16( m[2], m[3] );
+  const __m128i a3 = _mm_unpackhi_epi16( m[2], m[3] );
+  const __m128i a4 = _mm_unpacklo_epi16( m[4], m[5] );
+  const __m128i a5 = _mm_unpackhi_epi16( m[4], m[5] );
+  const __m128i a6 = _mm_unpacklo_epi16( m[6], m[7] );
+  const __m128i a7 = _mm_unpackhi_epi16( m[6], m[7] );
+
+  const __m128i b0 = _mm_unpacklo_epi32( a0, a2 );
+  const __m128i b1 = _mm_unpackhi_epi32( a0, a2 );
+  const __m128i b2 = _mm_unpacklo_epi32( a1, a3 );
+  const __m128i b3 = _mm_unpackhi_epi32( a1, a3 );
+  const __m128i b4 = _mm_unpacklo_epi32( a4, a6 );
+  const __m128i b5 = _mm_unpackhi_epi32( a4, a6 );
+  const __m128i b6 = _mm_unpacklo_epi32( a5, a7 );
+  const __m128i b7 = _mm_unpackhi_epi32( a5, a7 );
+
+  m[0] = _mm_unpacklo_epi64( b0, b4 );
+  m[1] = _mm_unpackhi_epi64( b0, b4 );
+  m[2] = _mm_unpacklo_epi64( b1, b5 );
+  m[3] = _mm_unpackhi_epi64( b1, b5 );
+  m[4] = _mm_unpacklo_epi64( b2, b6 );
+  m[5] = _mm_unpackhi_epi64( b2, b6 );
+  m[6] = _mm_unpacklo_epi64( b3, b7 );
+  m[7] = _mm_unpackhi_epi64( b3, b7 );
+}
+
+static inline SIMD_TARGET_SSE41 __m128i xClip3( __m128i v, __m128i lo, __m128i hi )
+{
+  return _mm_min_epi16( _mm_max_epi16( v, lo ), hi );
+}
+
+static inline SIMD_TARGET_SSE41 __m128i xLoad( const Short* p )
+{
+  return _mm_loadu_si128( (const __m128i*)p );
+}
+
+// ====================================================================================================================
+// Kernels
+// ====================================================================================================================
+
+/// SSE4.1 version of TComLoopFilter::xFilterLumaEdge()
+Void SIMD_TARGET_SSE41 TComLoopFilter::xFilterLumaEdge_SSE41( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal )
+{
+  if ( iMaxVal >= ( 1 << 12 ) )
+  {
+    xFilterLumaEdge( piSrc, iOffset, iSrcStep, pcLines, uiStartLine, uiEndLine, iMaxVal );
+    return;
+  }
+
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMax    = _mm_set1_epi16( Short( iMaxVal ) );
+  const __m128i vTen    = _mm_set1_epi16( 10 );
+  const __m128i vFour   = _mm_set1_epi16( 4 );
+  const __m128i vTwo    = _mm_set1_epi16( 2 );
+  const __m128i vEight  = _mm_set1_epi32( 8 );
+  const __m128i vWeak   = _mm_set1_epi32( ( Int( UShort( -3 ) ) << 16 ) | 9 );   // 9 * (q0 - p0) - 3 * (q1 - p1)
+
+  UInt uiLine = uiStartLine;
+  for ( ; uiLine + 8 <= uiEndLine; uiLine += 8 )
+  {
+    const __m128i tc = xLoad( pcLines->tc + uiLine );
+    if ( _mm_testz_si128( tc, tc ) )
+    {
+      continue;
+    }
+
+    Pel* piLine = piSrc + uiLine * iSrcStep;
+    __m128i m[8];   // p3, p2, p1, p0, q0, q1, q2, q3
+    if ( iOffset == 1 )
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        m[k] = _mm_loadu_si128( (const __m128i*)( piLine + k * iSrcStep - 4 ) );
+      }
+      xTranspose8x8( m );
+    }
+    else
+    {
+      for ( Int k = 0; k < 8; k++ )
+      {
+        m[k] = _mm_loadu_si128( (const __m128i*)( piLine + ( k - 4 ) * iOffset ) );
+      }
+    }
+
+    const __m128i p3 = m[0], p2 = m[1], p1 = m[2], p0 = m[3];
+    const __m128i q0 = m[4], q1 = m[5], q2 = m[6], q3 = m[7];
+
+    const __m128i strong   = xLoad( pcLines->strong   + uiLine );
+    const __m128i filterP  = xLoad( pcLines->filterP  + uiLine );
+    const __m128i filterQ  = xLoad( pcLines->filterQ  + uiLine );
+    const __m128i filterP1 = xLoad( pcLines->filterP1 + uiLine );
+    const __m128i filterQ1 = xLoad( pcLines->filterQ1 + uiLine );
+
+    // strong filter, each output clipped to +-2tc around its input
+    const __m128i tc2     = _mm_add_epi16( tc, tc );
+    const __m128i p0q0    = _mm_add_epi16( p0, q0 );
+    const __m128i p1p0q0  = _mm_add_epi16( p1, p0q0 );
+    const __m128i p0q0q1  = _mm_add_epi16( p0q0, q1 );
+
+    const __m128i sP0 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( p1p0q0, p1p0q0 ), _mm_add_epi16( p2, q1 ) ), vFour ), 3 );
+    const __m128i sQ0 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( p0q0q1, p0q0q1 ), _mm_add_epi16( p1, q2 ) ), vFour ), 3 );
+    const __m128i sP1 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( p1p0q0, p2 ), vTwo ), 2 );
+    const __m128i sQ1 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( p0q0q1, q2 ), vTwo ), 2 );
+    const __m128i sP2 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( p3, p3 ), _mm_add_epi16( _mm_add_epi16( p2, p2 ), p2 ) ), p1p0q0 ), vFour ), 3 );
+    const __m128i sQ2 = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( _mm_add_epi16( q3, q3 ), _mm_add_epi16( _mm_add_epi16( q2, q2 ), q2 ) ), p0q0q1 ), vFour ), 3 );
+
+    const __m128i strongP0 = xClip3( sP0, _mm_sub_epi16( p0, tc2 ), _mm_add_epi16( p0, tc2 ) );
+    const __m128i strongQ0 = xClip3( sQ0, _mm_sub_epi16( q0, tc2 ), _mm_add_epi16( q0, tc2 ) );
+    const __m128i strongP1 = xClip3( sP1, _mm_sub_epi16( p1, tc2 ), _mm_add_epi16( p1, tc2 ) );
+    const __m128i strongQ1 = xClip3( sQ1, _mm_sub_epi16( q1, tc2 ), _mm_add_epi16( q1, tc2 ) );
+    const __m128i strongP2 = xClip3( sP2, _mm_sub_epi16( p2, tc2 ), _mm_add_epi16( p2, tc2 ) );
+    const __m128i strongQ2 = xClip3( sQ2, _mm_sub_epi16( q2, tc2 ), _mm_add_epi16( q2, tc2 ) );
+
+    // weak filter, delta evaluated in 32-bit lanes
+    const __m128i dQ0P0 = _mm_sub_epi16( q0, p0 );
+    const __m128i dQ1P1 = _mm_sub_epi16( q1, p1 );
+    const __m128i deltaLo = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( dQ0P0, dQ1P1 ), vWeak ), vEight ), 4 );
+    const __m128i deltaHi = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( dQ0P0, dQ1P1 ), vWeak ), vEight ), 4 );
+    const __m128i delta   = _mm_packs_epi32( deltaLo, deltaHi );
+
+    const __m128i weak    = _mm_andnot_si128( strong, _mm_cmplt_epi16( _mm_abs_epi16( delta ), _mm_mullo_epi16( tc, vTen ) ) );
+    const __m128i deltaC  = xClip3( delta, _mm_sub_epi16( vZero, tc ), tc );
+
+    const __m128i weakP0  = xClip3( _mm_add_epi16( p0, deltaC ), vZero, vMax );
+    const __m128i weakQ0  = xClip3( _mm_sub_epi16( q0, deltaC ), vZero, vMax );
+
+    const __m128i tcHalf  = _mm_srai_epi16( tc, 1 );
+    const __m128i tcHalfN = _mm_sub_epi16( vZero, tcHalf );
+    const __m128i delta1  = xClip3( _mm_srai_epi16( _mm_add_epi16( _mm_sub_epi16( _mm_avg_epu16( p2, p0 ), p1 ), deltaC ), 1 ), tcHalfN, tcHalf );
+    const __m128i delta2  = xClip3( _mm_srai_epi16( _mm_sub_epi16( _mm_sub_epi16( _mm_avg_epu16( q2, q0 ), q1 ), deltaC ), 1 ), tcHalfN, tcHalf );
+    const __m128i weakP1  = xClip3( _mm_add_epi16( p1, delta1 ), vZero, vMax );
+    const __m128i weakQ1  = xClip3( _mm_add_epi16( q1, delta2 ), vZero, vMax );
+
+    // selection: strong, weak or unfiltered, then the P / Q sides that may not be modified are restored
+    m[3] = _mm_blendv_epi8( p0, _mm_blendv_epi8( _mm_blendv_epi8( p0, weakP0, weak ), strongP0, strong ), filterP );
+    m[4] = _mm_blendv_epi8( q0, _mm_blendv_epi8( _mm_blendv_epi8( q0, weakQ0, weak ), strongQ0, strong ), filterQ );
+    m[2] = _mm_blendv_epi8( p1, _mm_blendv_epi8( _mm_blendv_epi8( p1, weakP1, _mm_and_si128( weak, filterP1 ) ), strongP1, strong ), filterP );
+    m[5] = _mm_blendv_epi8( q1, _mm_blendv_epi8( _mm_blendv_epi8( q1, weakQ1, _mm_and_si128( weak, filterQ1 ) ), strongQ1, strong ), filterQ );
+    m[1] = _mm_blendv_epi8( p2, strongP2, _mm_and_si128( strong, filterP ) );
+    m[6] = _mm_blendv_epi8( q2, strongQ2, _mm_and_si128( strong, filterQ ) );
+
+    if ( iOffset == 1 )
+    {
+      xTranspose8x8( m );
+      for ( Int k = 0; k < 8; k++ )
+      {
+        _mm_storeu_si128( (__m128i*)( piLine + k * iSrcStep - 4 ), m[k] );
+      }
+    }
+    else
+    {
+      for ( Int k = 1; k < 7; k++ )
+      {
+        _mm_storeu_si128( (__m128i*)( piLine + ( k - 4 ) * iOffset ), m[k] );
+      }
+    }
+  }
+
+  xFilterLumaEdge( piSrc, iOffset, iSrcStep, pcLines, uiLine, uiEndLine, iMaxVal );
+}
+
+/// SSE4.1 version of TComLoopFilter::xFilterChromaEdge()
+Void SIMD_TARGET_SSE41 TComLoopFilter::xFilterChromaEdge_SSE41( Pel* piSrc, Int iOffset, Int iSrcStep, const LFEdgeLines* pcLines, UInt uiStartLine, UInt uiEndLine, Int iMaxVal )
+{
+  if ( iMaxVal >= ( 1 << 12 ) )
+  {
+    xFilterChromaEdge( piSrc, iOffset, iSrcStep, pcLines, uiStartLine, uiEndLine, iMaxVal );
+    return;
+  }
+
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vMax  = _mm_set1_epi16( Short( iMaxVal ) );
+  const __m128i vFour = _mm_set1_epi16( 4 );
+
+  UInt uiLine = uiStartLine;
+  for ( ; uiLine + 8 <= uiEndLine; uiLine += 8 )
+  {
+    const __m128i tc = xLoad( pcLines->tc + uiLine );
+    if ( _mm_testz_si128( tc, tc ) )
+    {
+      continue;
+    }
+
+    Pel* piLine = piSrc + uiLine * iSrcStep;
+    __m128i p1, p0, q0, q1;
+    if ( iOffset == 1 )
+    {
+      // 8 lines of 4 samples (p1, p0, q0, q1) transposed into 4 registers
+      __m128i r[8];
+      for ( Int k = 0; k < 8; k++ )
+      {
+        r[k] = _mm_loadl_epi64( (const __m128i*)( piLine + k * iSrcStep - 2 ) );
+      }
+      const __m128i b0 = _mm_unpacklo_epi32( _mm_unpacklo_epi16( r[0], r[1] ), _mm_unpacklo_epi16( r[2], r[3] ) );
+      const __m128i b1 = _mm_unpackhi_epi32( _mm_unpacklo_epi16( r[0], r[1] ), _mm_unpacklo_epi16( r[2], r[3] ) );
+      const __m128i b2 = _mm_unpacklo_epi32( _mm_unpacklo_epi16( r[4], r[5] ), _mm_unpacklo_epi16( r[6], r[7] ) );
+      const __m128i b3 = _mm_unpackhi_epi32( _mm_unpacklo_epi16( r[4], r[5] ), _mm_unpacklo_epi16( r[6], r[7] ) );
+      p1 = _mm_unpacklo_epi64( b0, b2 );
+      p0 = _mm_unpackhi_epi64( b0, b2 );
+      q0 = _mm_unpacklo_epi64( b1, b3 );
+      q1 = _mm_unpackhi_epi64( b1, b3 );
+    }
+    else
+    {
+      p1 = _mm_loadu_si128( (const __m128i*)( piLine - 2 * iOffset ) );
+      p0 = _mm_loadu_si128( (const __m128i*)( piLine -     iOffset ) );
+      q0 = _mm_loadu_si128( (const __m128i*)( piLine               ) );
+      q1 = _mm_loadu_si128( (const __m128i*)( piLine +     iOffset ) );
+    }
+
+    const __m128i delta = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( _mm_sub_epi16( q0, p0 ), 2 ), _mm_sub_epi16( p1, q1 ) ), vFour ), 3 );
+    const __m128i deltaC = xClip3( delta, _mm_sub_epi16( vZero, tc ), tc );
+
+    const __m128i newP0 = _mm_blendv_epi8( p0, xClip3( _mm_add_epi16( p0, deltaC ), vZero, vMax ), xLoad( pcLines->filterP + uiLine ) );
+    const __m128i newQ0 = _mm_blendv_epi8( q0, xClip3( _mm_sub_epi16( q0, deltaC ), vZero, vMax ), xLoad( pcLines->filterQ + uiLine ) );
+
+    if ( iOffset == 1 )
+    {
+      const __m128i d0 = _mm_unpacklo_epi16( p1, newP0 );
+      const __m128i d1 = _mm_unpacklo_epi16( newQ0, q1 );
+      const __m128i d2 = _mm_unpackhi_epi16( p1, newP0 );
+      const __m128i d3 = _mm_unpackhi_epi16( newQ0, q1 );
+      const __m128i r01 = _mm_unpacklo_epi32( d0, d1 );
+      const __m128i r23 = _mm_unpackhi_epi32( d0, d1 );
+      const __m128i r45 = _mm_unpacklo_epi32( d2, d3 );
+      const __m128i r67 = _mm_unpackhi_epi32( d2, d3 );
+      _mm_storel_epi64( (__m128i*)( piLine + 0 * iSrcStep - 2 ), r01 );
+      _mm_storel_epi64( (__m128i*)( piLine + 1 * iSrcStep - 2 ), _mm_unpackhi_epi64( r01, r01 ) );
+      _mm_storel_epi64( (__m128i*)( piLine + 2 * iSrcStep - 2 ), r23 );
+      _mm_storel_epi64( (__m128i*)( piLine + 3 * iSrcStep - 2 ), _mm_unpackhi_epi64( r23, r23 ) );
+      _mm_storel_epi64( (__m128i*)( piLine + 4 * iSrcStep - 2 ), r45 );
+      _mm_storel_epi64( (__m128i*)( piLine + 5 * iSrcStep - 2 ), _mm_unpackhi_epi64( r45, r45 ) );
+      _mm_storel_epi64( (__m128i*)( piLine + 6 * iSrcStep - 2 ), r67 );
+      _mm_storel_epi64( (__m128i*)( piLine + 7 * iSrcStep - 2 ), _mm_unpackhi_epi64( r67, r67 ) );
+    }
+    else
+    {
+      _mm_storeu_si128( (__m128i*)( piLine - iOffset ), newP0 );
+      _mm_storeu_si128( (__m128i*)( piLine           ), newQ0 );
+    }
+  }
+
+  xFilterChromaEdge( piSrc, iOffset, iSrcStep, pcLines, uiLine, uiEndLine, iMaxVal );
+}
+
+/** replace the plain C kernels with the SIMD kernels available for eExt
+ * \param eExt  SIMD extension supported by the CPU
+ */
+Void TComLoopFilter::xInitSIMD( SIMDExtension eExt )
+{
+  if ( eExt >= SIMD_SSE41 )
+  {
+    m_fpFilterLumaEdge   = xFilterLumaEdge_SSE41;
+    m_fpFilterChromaEdge = xFilterChromaEdge_SSE41;
+  }
+}
+
+//! \}
+
+#endif // SIMD_X86
@@ -86,6 +86,13 @@ Void TComPic::create( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UIn
   }
   m_apcPicYuv[PIC_YUV_REC]  = new TComPicYuv;  m_apcPicYuv[PIC_YUV_REC]->create( iWidth, iHeight, chromaFormatIDC, uiMaxWidth, uiMaxHeight, uiMaxDepth );
 
+  reinit( conformanceWindow, defaultDisplayWindow, numReorderPics );
+
+  return;
+}
+
+Void TComPic::reinit( Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics )
+{
   // there are no SEI messages associated with this picture initially
   if (m_SEIs.size() > 0)
   {
@@ -102,7 +109,27 @@ Void TComPic::create( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UIn
   /* store number of reorder pics with picture */
   memcpy(m_numReorderPics, numReorderPics, MAX_TLAYER*sizeof(Int));
 
-  return;
+  // the reconstruction has to be extended again
+  m_apcPicYuv[PIC_YUV_REC]->setBorderExtension(false);
+
+  // CTUs without a slice are not yet coded, the slices of the previous picture are no longer valid
+  for (UInt uiCUAddr = 0; uiCUAddr < m_apcPicSym->getNumberOfCUsInFrame(); uiCUAddr++)
+  {
+    m_apcPicSym->getCU(uiCUAddr)->setSlice(NULL);
+  }
+}
+
+Bool TComPic::isFormat( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth ) const
+{
+  const TComPicYuv* pcPicYuvRec = m_apcPicYuv[PIC_YUV_REC];
+
+  return m_apcPicSym != NULL
+      && pcPicYuvRec->getWidth(COMPONENT_Y)  == iWidth
+      && pcPicYuvRec->getHeight(COMPONENT_Y) == iHeight
+      && pcPicYuvRec->getChromaFormat()      == chromaFormatIDC
+      && getMinCUWidth()  * getNumPartInWidth()  == uiMaxWidth
+      && getMinCUHeight() * getNumPartInHeight() == uiMaxHeight
+      && getNumPartInCU() == ( 1u << ( uiMaxDepth << 1 ) );
 }
 
 Void TComPic::destroy()
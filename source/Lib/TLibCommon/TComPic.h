@@ -102,6 +102,11 @@ public:
 
   virtual Void  destroy();
 
+  /// prepare a picture that is no longer used for a new one of the same format, without reallocating its buffers
+  Void          reinit( Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics );
+  /// whether the picture has been created with the given format
+  Bool          isFormat( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth ) const;
+
   UInt          getTLayer() const               { return m_uiTLayer;   }
   Void          setTLayer( UInt uiTLayer ) { m_uiTLayer = uiTLayer; }
 
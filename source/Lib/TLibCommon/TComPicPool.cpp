@@ -0,0 +1,115 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPicPool.cpp
+    \brief    pool of picture buffers indexed by POC
+*/
+
+#include "TComPicPool.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+TComPicPool::TComPicPool()
+{
+}
+
+TComPicPool::~TComPicPool()
+{
+  destroy();
+}
+
+/** \param pcPic  created picture, free until it is acquired
+ */
+Void TComPicPool::addPic( TComPic* pcPic )
+{
+  m_apcPics.push_back( pcPic );
+  m_apcFreePics.push_back( pcPic );
+}
+
+Void TComPicPool::destroy()
+{
+  for ( UInt ui = 0; ui < m_apcPics.size(); ui++ )
+  {
+    m_apcPics[ui]->destroy();
+    delete m_apcPics[ui];
+  }
+  m_apcPics.clear();
+  m_apcFreePics.clear();
+  m_cPicsByPOC.clear();
+}
+
+/** The picture that was released last is handed out first, as its memory is the most likely to be cached.
+ * \param iPOC  POC the picture is going to hold
+ * \returns free picture, or NULL
+ */
+TComPic* TComPicPool::acquire( Int iPOC )
+{
+  if ( m_apcFreePics.empty() )
+  {
+    return NULL;
+  }
+  TComPic* pcPic = m_apcFreePics.back();
+  m_apcFreePics.pop_back();
+  m_cPicsByPOC.insert( std::make_pair( iPOC, pcPic ) );
+  return pcPic;
+}
+
+/** \param pcPic  acquired picture
+ */
+Void TComPicPool::release( TComPic* pcPic )
+{
+  typedef std::unordered_multimap<Int, TComPic*>::iterator Iterator;
+  const std::pair<Iterator, Iterator> cRange = m_cPicsByPOC.equal_range( pcPic->getPOC() );
+  for ( Iterator it = cRange.first; it != cRange.second; it++ )
+  {
+    if ( it->second == pcPic )
+    {
+      m_cPicsByPOC.erase( it );
+      m_apcFreePics.push_back( pcPic );
+      return;
+    }
+  }
+  assert( 0 );
+}
+
+/** \param iPOC  POC of the picture
+ * \returns picture acquired for iPOC, or NULL
+ */
+TComPic* TComPicPool::getPic( Int iPOC ) const
+{
+  const std::unordered_multimap<Int, TComPic*>::const_iterator it = m_cPicsByPOC.find( iPOC );
+  return it == m_cPicsByPOC.end() ? NULL : it->second;
+}
+
+//! \}
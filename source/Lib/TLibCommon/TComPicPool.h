@@ -0,0 +1,91 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComPicPool.h
+    \brief    pool of picture buffers indexed by POC (header)
+*/
+
+#ifndef __TCOMPICPOOL__
+#define __TCOMPICPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonDef.h"
+#include "TComPic.h"
+
+#include <vector>
+#include <unordered_map>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// pool of picture buffers. The owner creates the pictures, since encoder and decoder create them differently, and
+/// hands them over with addPic(). A picture is acquired for the POC it is going to hold and released once it is
+/// neither needed for reference nor for output. Acquiring, releasing and looking up a picture by POC take constant
+/// time; the pool does not change the picture list of the owner.
+class TComPicPool
+{
+private:
+  std::vector<TComPic*>                 m_apcPics;          ///< all pictures, owned by the pool
+  std::vector<TComPic*>                 m_apcFreePics;      ///< pictures not holding a POC, used as a stack
+  std::unordered_multimap<Int, TComPic*> m_cPicsByPOC;      ///< pictures holding a POC; a POC may repeat after an IDR picture
+
+public:
+  TComPicPool();
+  virtual ~TComPicPool();
+
+  /// hand a picture over to the pool, which deletes it in destroy()
+  Void      addPic              ( TComPic* pcPic );
+  /// destroy and delete all pictures
+  Void      destroy             ();
+
+  /// take a free picture to hold iPOC; returns NULL when all pictures are in use
+  TComPic*  acquire             ( Int iPOC );
+  /// return a picture; its POC has to be the one it was acquired for
+  Void      release             ( TComPic* pcPic );
+  /// picture holding iPOC, NULL if there is none
+  TComPic*  getPic              ( Int iPOC ) const;
+
+  UInt      getNumPics          () const                    { return (UInt)m_apcPics.size();     }
+  UInt      getNumFreePics      () const                    { return (UInt)m_apcFreePics.size(); }
+};
+
+//! \}
+
+#endif // __TCOMPICPOOL__
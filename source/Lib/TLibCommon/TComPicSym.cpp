@@ -63,6 +63,7 @@ TComPicSym::TComPicSym()
 ,m_iNumColumnsMinus1 (0)
 ,m_iNumRowsMinus1(0)
 ,m_apcTComTile(NULL)
+,m_uiNumAllocatedTiles(0)
 ,m_puiCUOrderMap(0)
 ,m_puiTileIdxMap(NULL)
 ,m_puiInverseCUOrderMap(NULL)
@@ -153,13 +154,14 @@ Void TComPicSym::destroy()
   delete [] m_apcTComDataCU;
   m_apcTComDataCU = NULL;
 
-  for(Int i = 0; i < (m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1); i++ )
+  for(UInt i = 0; i < m_uiNumAllocatedTiles; i++ )
   {
     delete m_apcTComTile[i];
   }
   delete [] m_apcTComTile;
 
   m_apcTComTile = NULL;
+  m_uiNumAllocatedTiles = 0;
 
   delete [] m_puiCUOrderMap;
   m_puiCUOrderMap = NULL;
@@ -215,13 +217,29 @@ UInt TComPicSym::getPicSCUAddr( UInt SCUEncOrder )
   return getCUOrderMap(SCUEncOrder/m_uiNumPartitions)*m_uiNumPartitions + SCUEncOrder%m_uiNumPartitions;
 }
 
+/** (re)create the tile array for m_iNumColumnsMinus1 / m_iNumRowsMinus1, keeping the existing one when the number of
+ * tiles is unchanged, as the tiles are set up again for every picture
+ */
 Void TComPicSym::xCreateTComTileArray()
 {
-  m_apcTComTile = new TComTile*[(m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1)];
-  for( UInt i=0; i<(m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1); i++ )
+  const UInt uiNumTiles = (m_iNumColumnsMinus1+1)*(m_iNumRowsMinus1+1);
+  if (uiNumTiles == m_uiNumAllocatedTiles)
+  {
+    return;
+  }
+
+  for( UInt i=0; i<m_uiNumAllocatedTiles; i++ )
+  {
+    delete m_apcTComTile[i];
+  }
+  delete [] m_apcTComTile;
+
+  m_apcTComTile = new TComTile*[uiNumTiles];
+  for( UInt i=0; i<uiNumTiles; i++ )
   {
     m_apcTComTile[i] = new TComTile;
   }
+  m_uiNumAllocatedTiles = uiNumTiles;
 }
 
 Void TComPicSym::xInitTiles()
@@ -102,6 +102,7 @@ private:
   Int           m_iNumColumnsMinus1; 
   Int           m_iNumRowsMinus1;
   TComTile**    m_apcTComTile;
+  UInt          m_uiNumAllocatedTiles;                ///< number of tiles in m_apcTComTile
   UInt*         m_puiCUOrderMap;       //the map of LCU raster scan address relative to LCU encoding order 
   UInt*         m_puiTileIdxMap;       //the map of the tile index relative to LCU raster scan address 
   UInt*         m_puiInverseCUOrderMap;
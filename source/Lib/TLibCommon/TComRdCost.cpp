@@ -342,6 +342,10 @@ Void TComRdCost::init()
   m_afpDistortFunc[DF_HADS64 ] = TComRdCost::xGetHADs;
   m_afpDistortFunc[DF_HADS16N] = TComRdCost::xGetHADs;
 
+#if SIMD_X86
+  xInitSIMD( getSIMDExtension() );
+#endif
+
 #if RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION
   m_costMode                = COST_STANDARD_LOSSY;
 #endif
@@ -520,47 +524,12 @@ Void TComRdCost::setDistParam( DistParam& rcDP, Int bitDepth, Pel* p1, Int iStri
 
 Distortion TComRdCost::calcHAD( Int bitDepth, Pel* pi0, Int iStride0, Pel* pi1, Int iStride1, Int iWidth, Int iHeight )
 {
-  Distortion uiSum = 0;
-  Int x, y;
-  
-  if ( ( (iWidth % 8) == 0 ) && ( (iHeight % 8) == 0 ) )
-  {
-    for ( y=0; y<iHeight; y+= 8 )
-    {
-      for ( x=0; x<iWidth; x+= 8 )
-      {
-        uiSum += xCalcHADs8x8( &pi0[x], &pi1[x], iStride0, iStride1, 1 );
-      }
-      pi0 += iStride0*8;
-      pi1 += iStride1*8;
-    }
-  }
-  else if ( ( (iWidth % 4) == 0 ) && ( (iHeight % 4) == 0 ) )
-  {
-    for ( y=0; y<iHeight; y+= 4 )
-    {
-      for ( x=0; x<iWidth; x+= 4 )
-      {
-        uiSum += xCalcHADs4x4( &pi0[x], &pi1[x], iStride0, iStride1, 1 );
-      }
-      pi0 += iStride0*4;
-      pi1 += iStride1*4;
-    }
-  }
-  else
-  {
-    for ( y=0; y<iHeight; y+= 2 )
-    {
-      for ( x=0; x<iWidth; x+= 2 )
-      {
-        uiSum += xCalcHADs2x2( &pi0[x], &pi1[x], iStride0, iStride1, 1 );
-      }
-      pi0 += iStride0*2;
-      pi1 += iStride1*2;
-    }
-  }
-  
-  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(bitDepth-8) );
+  DistParam cDtParam;
+  setDistParam( cDtParam, bitDepth, pi0, iStride0, pi1, iStride1, iWidth, iHeight );
+  cDtParam.bApplyWeight = false;
+
+  // xGetHADs uses the same 8x8 / 4x4 / 2x2 partitioning as the original calcHAD loop
+  return m_afpDistortFunc[DF_HADS]( &cDtParam );
 }
 
 Distortion TComRdCost::getDistPart( Int bitDepth, Pel* piCur, Int iCurStride,  Pel* piOrg, Int iOrgStride, UInt uiBlkWidth, UInt uiBlkHeight, const ComponentID compID, DFunc eDFunc )
@@ -45,6 +45,7 @@
 
 #include "TComSlice.h"
 #include "TComRdCostWeightPrediction.h"
+#include "TComSIMD.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -278,6 +279,31 @@ private:
   static Distortion xCalcHADs4x4      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static Distortion xCalcHADs8x8      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
 
+#if SIMD_X86
+  // SIMD kernels (TComRdCostSIMD.cpp). The plain C functions above remain the reference implementation.
+  Void xInitSIMD( SIMDExtension eExt );
+
+  static Distortion xGetSSE_SSE41     ( DistParam* pcDtParam );
+  static Distortion xGetSSE16N_SSE41  ( DistParam* pcDtParam );
+  static Distortion xGetSAD_SSE41     ( DistParam* pcDtParam );
+  static Distortion xGetSAD16N_SSE41  ( DistParam* pcDtParam );
+  static Distortion xGetHADs_SSE41    ( DistParam* pcDtParam );
+  template<Int iWidth> static Distortion xGetSSEN_SSE41( DistParam* pcDtParam );
+  template<Int iWidth> static Distortion xGetSADN_SSE41( DistParam* pcDtParam );
+
+  static Distortion xGetSSE16N_AVX2   ( DistParam* pcDtParam );
+  static Distortion xGetSAD16N_AVX2   ( DistParam* pcDtParam );
+  static Distortion xGetHADs_AVX2     ( DistParam* pcDtParam );
+  template<Int iWidth> static Distortion xGetSSEN_AVX2 ( DistParam* pcDtParam );
+  template<Int iWidth> static Distortion xGetSADN_AVX2 ( DistParam* pcDtParam );
+
+#if SIMD_SELF_CHECK
+  static FpDistFunc m_afpReferenceDistortFunc[DF_TOTAL_FUNCTIONS];
+  static FpDistFunc m_afpSIMDDistortFunc     [DF_TOTAL_FUNCTIONS];
+  template<Int eDFunc> static Distortion xSelfCheck( DistParam* pcDtParam );
+#endif
+#endif
+  
   
 public:
   
@@ -0,0 +1,694 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComRdCostSIMD.cpp
+    \brief    SSE4.1 / AVX2 distortion kernels for TComRdCost
+    \note     All kernels are bit-exact with the plain C versions in TComRdCost.cpp. Sums are accumulated
+              in 32-bit lanes, which wrap in the same way as the 32-bit Distortion used by the C code.
+*/
+
+#include "TComRdCost.h"
+
+#if SIMD_X86
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+static inline SIMD_TARGET_SSE41 UInt xHorizontalSum( __m128i sum )
+{
+  sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, 0x4E ) );
+  sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, 0xB1 ) );
+  return UInt( _mm_cvtsi128_si32( sum ) );
+}
+
+static inline SIMD_TARGET_AVX2 UInt xHorizontalSum( __m256i sum )
+{
+  return xHorizontalSum( _mm_add_epi32( _mm256_castsi256_si128( sum ), _mm256_extracti128_si256( sum, 1 ) ) );
+}
+
+/// |org - cur| for 8 samples, widened to 4 32-bit partial sums
+static inline SIMD_TARGET_SSE41 __m128i xAbsDiff8( const Pel* piOrg, const Pel* piCur )
+{
+  const __m128i diff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)piOrg ), _mm_loadu_si128( (const __m128i*)piCur ) );
+  return _mm_madd_epi16( _mm_abs_epi16( diff ), _mm_set1_epi16( 1 ) );
+}
+
+static inline SIMD_TARGET_SSE41 __m128i xAbsDiff4( const Pel* piOrg, const Pel* piCur )
+{
+  const __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)piOrg ), _mm_loadl_epi64( (const __m128i*)piCur ) );
+  return _mm_madd_epi16( _mm_abs_epi16( diff ), _mm_set1_epi16( 1 ) );
+}
+
+static inline SIMD_TARGET_AVX2 __m256i xAbsDiff16( const Pel* piOrg, const Pel* piCur )
+{
+  const __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)piOrg ), _mm256_loadu_si256( (const __m256i*)piCur ) );
+  return _mm256_madd_epi16( _mm256_abs_epi16( diff ), _mm256_set1_epi16( 1 ) );
+}
+
+/// (org - cur)^2 >> uiShift for 8 samples, as 4 32-bit partial sums
+static inline SIMD_TARGET_SSE41 __m128i xSqrDiff8( __m128i diff, const UInt uiShift )
+{
+  if( uiShift == 0 )
+  {
+    return _mm_madd_epi16( diff, diff );
+  }
+  const __m128i lo = _mm_unpacklo_epi16( diff, _mm_setzero_si128() );
+  const __m128i hi = _mm_unpackhi_epi16( diff, _mm_setzero_si128() );
+  const __m128i sh = _mm_cvtsi32_si128( uiShift );
+  return _mm_add_epi32( _mm_srl_epi32( _mm_madd_epi16( lo, lo ), sh ), _mm_srl_epi32( _mm_madd_epi16( hi, hi ), sh ) );
+}
+
+static inline SIMD_TARGET_AVX2 __m256i xSqrDiff16( __m256i diff, const UInt uiShift )
+{
+  if( uiShift == 0 )
+  {
+    return _mm256_madd_epi16( diff, diff );
+  }
+  const __m256i lo = _mm256_unpacklo_epi16( diff, _mm256_setzero_si256() );
+  const __m256i hi = _mm256_unpackhi_epi16( diff, _mm256_setzero_si256() );
+  const __m128i sh = _mm_cvtsi32_si128( uiShift );
+  return _mm256_add_epi32( _mm256_srl_epi32( _mm256_madd_epi16( lo, lo ), sh ), _mm256_srl_epi32( _mm256_madd_epi16( hi, hi ), sh ) );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Row loops. iFixedCols is the block width for the fixed-size kernels (so that the column loops unroll), or 0 to use
+// the run-time width iVarCols.
+// --------------------------------------------------------------------------------------------------------------------
+
+template<Int iFixedCols>
+static inline SIMD_TARGET_SSE41 UInt xSADRows_SSE41( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, const Int iVarCols, Int iRowStep )
+{
+  const Int iCols = iFixedCols ? iFixedCols : iVarCols;
+  __m128i sum = _mm_setzero_si128();
+  UInt    uiTail = 0;
+
+  for( ; iRows > 0; iRows -= iRowStep )
+  {
+    Int n = 0;
+    for( ; n + 8 <= iCols; n += 8 )
+    {
+      sum = _mm_add_epi32( sum, xAbsDiff8( piOrg + n, piCur + n ) );
+    }
+    if( n + 4 <= iCols )
+    {
+      sum = _mm_add_epi32( sum, xAbsDiff4( piOrg + n, piCur + n ) );
+      n += 4;
+    }
+    for( ; n < iCols; n++ )
+    {
+      uiTail += abs( piOrg[n] - piCur[n] );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorizontalSum( sum ) + uiTail;
+}
+
+template<Int iFixedCols>
+static inline SIMD_TARGET_AVX2 UInt xSADRows_AVX2( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, const Int iVarCols, Int iRowStep )
+{
+  const Int iCols = iFixedCols ? iFixedCols : iVarCols;
+  __m256i sum    = _mm256_setzero_si256();
+  __m128i sum128 = _mm_setzero_si128();
+
+  for( ; iRows > 0; iRows -= iRowStep )
+  {
+    Int n = 0;
+    for( ; n + 16 <= iCols; n += 16 )
+    {
+      sum = _mm256_add_epi32( sum, xAbsDiff16( piOrg + n, piCur + n ) );
+    }
+    if( n + 8 <= iCols )
+    {
+      sum128 = _mm_add_epi32( sum128, xAbsDiff8( piOrg + n, piCur + n ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorizontalSum( sum ) + xHorizontalSum( sum128 );
+}
+
+template<Int iFixedCols>
+static inline SIMD_TARGET_SSE41 UInt xSSERows_SSE41( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, const Int iVarCols, const UInt uiShift )
+{
+  const Int iCols = iFixedCols ? iFixedCols : iVarCols;
+  __m128i sum    = _mm_setzero_si128();
+  UInt    uiTail = 0;
+
+  for( ; iRows != 0; iRows-- )
+  {
+    Int n = 0;
+    for( ; n + 8 <= iCols; n += 8 )
+    {
+      const __m128i diff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( piOrg + n ) ), _mm_loadu_si128( (const __m128i*)( piCur + n ) ) );
+      sum = _mm_add_epi32( sum, xSqrDiff8( diff, uiShift ) );
+    }
+    if( n + 4 <= iCols )
+    {
+      // upper four lanes are zero and contribute nothing
+      const __m128i diff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)( piOrg + n ) ), _mm_loadl_epi64( (const __m128i*)( piCur + n ) ) );
+      sum = _mm_add_epi32( sum, xSqrDiff8( diff, uiShift ) );
+      n += 4;
+    }
+    for( ; n < iCols; n++ )
+    {
+      const Intermediate_Int iTemp = piOrg[n] - piCur[n];
+      uiTail += Distortion( ( iTemp * iTemp ) >> uiShift );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorizontalSum( sum ) + uiTail;
+}
+
+template<Int iFixedCols>
+static inline SIMD_TARGET_AVX2 UInt xSSERows_AVX2( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, const Int iVarCols, const UInt uiShift )
+{
+  const Int iCols = iFixedCols ? iFixedCols : iVarCols;
+  __m256i sum = _mm256_setzero_si256();
+
+  for( ; iRows != 0; iRows-- )
+  {
+    for( Int n = 0; n < iCols; n += 16 )
+    {
+      const __m256i diff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)( piOrg + n ) ), _mm256_loadu_si256( (const __m256i*)( piCur + n ) ) );
+      sum = _mm256_add_epi32( sum, xSqrDiff16( diff, uiShift ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  return xHorizontalSum( sum );
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Hadamard. The butterflies are applied in place with shuffles and blends instead of a transpose; the
+// resulting coefficients differ from the C code only in order and sign, which the sum of absolute values
+// does not see.
+// --------------------------------------------------------------------------------------------------------------------
+
+static inline SIMD_TARGET_SSE41 __m128i xLoadDiff4( const Pel* piOrg, const Pel* piCur )
+{
+  return _mm_sub_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piOrg ) ), _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piCur ) ) );
+}
+
+/// 4-point butterflies across the four 32-bit lanes of a register
+static inline SIMD_TARGET_SSE41 __m128i xHadamardLanes4( __m128i v )
+{
+  __m128i t = _mm_shuffle_epi32( v, 0x4E );
+  v = _mm_blend_epi16( _mm_add_epi32( v, t ), _mm_sub_epi32( v, t ), 0xF0 );
+  t = _mm_shuffle_epi32( v, 0xB1 );
+  return _mm_blend_epi16( _mm_add_epi32( v, t ), _mm_sub_epi32( v, t ), 0xCC );
+}
+
+static SIMD_TARGET_SSE41 Distortion xCalcHADs4x4_SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i r0 = xLoadDiff4( piOrg                 , piCur                 );
+  __m128i r1 = xLoadDiff4( piOrg +     iStrideOrg, piCur +     iStrideCur );
+  __m128i r2 = xLoadDiff4( piOrg + 2 * iStrideOrg, piCur + 2 * iStrideCur );
+  __m128i r3 = xLoadDiff4( piOrg + 3 * iStrideOrg, piCur + 3 * iStrideCur );
+
+  // vertical
+  __m128i m0 = _mm_add_epi32( r0, r2 );
+  __m128i m1 = _mm_add_epi32( r1, r3 );
+  __m128i m2 = _mm_sub_epi32( r0, r2 );
+  __m128i m3 = _mm_sub_epi32( r1, r3 );
+  r0 = _mm_add_epi32( m0, m1 );
+  r1 = _mm_sub_epi32( m0, m1 );
+  r2 = _mm_add_epi32( m2, m3 );
+  r3 = _mm_sub_epi32( m2, m3 );
+
+  // horizontal
+  __m128i sum = _mm_abs_epi32( xHadamardLanes4( r0 ) );
+  sum = _mm_add_epi32( sum, _mm_abs_epi32( xHadamardLanes4( r1 ) ) );
+  sum = _mm_add_epi32( sum, _mm_abs_epi32( xHadamardLanes4( r2 ) ) );
+  sum = _mm_add_epi32( sum, _mm_abs_epi32( xHadamardLanes4( r3 ) ) );
+
+  return ( xHorizontalSum( sum ) + 1 ) >> 1;
+}
+
+static SIMD_TARGET_SSE41 Distortion xCalcHADs8x8_SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i lo[8], hi[8], t[8];
+
+  for( Int k = 0; k < 8; k++ )
+  {
+    lo[k] = xLoadDiff4( piOrg    , piCur     );
+    hi[k] = xLoadDiff4( piOrg + 4, piCur + 4 );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  // vertical, on each half
+  for( Int h = 0; h < 2; h++ )
+  {
+    __m128i* r = ( h == 0 ) ? lo : hi;
+    for( Int k = 0; k < 4; k++ )
+    {
+      t[k    ] = _mm_add_epi32( r[k], r[k + 4] );
+      t[k + 4] = _mm_sub_epi32( r[k], r[k + 4] );
+    }
+    for( Int k = 0; k < 8; k += 4 )
+    {
+      r[k    ] = _mm_add_epi32( t[k    ], t[k + 2] );
+      r[k + 1] = _mm_add_epi32( t[k + 1], t[k + 3] );
+      r[k + 2] = _mm_sub_epi32( t[k    ], t[k + 2] );
+      r[k + 3] = _mm_sub_epi32( t[k + 1], t[k + 3] );
+    }
+    for( Int k = 0; k < 8; k += 2 )
+    {
+      t[k    ] = _mm_add_epi32( r[k], r[k + 1] );
+      t[k + 1] = _mm_sub_epi32( r[k], r[k + 1] );
+    }
+    for( Int k = 0; k < 8; k++ )
+    {
+      r[k] = t[k];
+    }
+  }
+
+  // horizontal: the first stage pairs the two halves, the remaining two stay within a register
+  __m128i sum = _mm_setzero_si128();
+  for( Int k = 0; k < 8; k++ )
+  {
+    sum = _mm_add_epi32( sum, _mm_abs_epi32( xHadamardLanes4( _mm_add_epi32( lo[k], hi[k] ) ) ) );
+    sum = _mm_add_epi32( sum, _mm_abs_epi32( xHadamardLanes4( _mm_sub_epi32( lo[k], hi[k] ) ) ) );
+  }
+
+  return ( xHorizontalSum( sum ) + 2 ) >> 2;
+}
+
+static SIMD_TARGET_AVX2 Distortion xCalcHADs8x8_AVX2( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m256i r[8], t[8];
+
+  for( Int k = 0; k < 8; k++ )
+  {
+    r[k] = _mm256_sub_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)piOrg ) ), _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)piCur ) ) );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+
+  // vertical
+  for( Int k = 0; k < 4; k++ )
+  {
+    t[k    ] = _mm256_add_epi32( r[k], r[k + 4] );
+    t[k + 4] = _mm256_sub_epi32( r[k], r[k + 4] );
+  }
+  for( Int k = 0; k < 8; k += 4 )
+  {
+    r[k    ] = _mm256_add_epi32( t[k    ], t[k + 2] );
+    r[k + 1] = _mm256_add_epi32( t[k + 1], t[k + 3] );
+    r[k + 2] = _mm256_sub_epi32( t[k    ], t[k + 2] );
+    r[k + 3] = _mm256_sub_epi32( t[k + 1], t[k + 3] );
+  }
+  for( Int k = 0; k < 8; k += 2 )
+  {
+    t[k    ] = _mm256_add_epi32( r[k], r[k + 1] );
+    t[k + 1] = _mm256_sub_epi32( r[k], r[k + 1] );
+  }
+
+  // horizontal
+  __m256i sum = _mm256_setzero_si256();
+  for( Int k = 0; k < 8; k++ )
+  {
+    __m256i v = t[k];
+    __m256i s = _mm256_permute2x128_si256( v, v, 0x01 );
+    v = _mm256_blend_epi32( _mm256_add_epi32( v, s ), _mm256_sub_epi32( v, s ), 0xF0 );
+    s = _mm256_shuffle_epi32( v, 0x4E );
+    v = _mm256_blend_epi32( _mm256_add_epi32( v, s ), _mm256_sub_epi32( v, s ), 0xCC );
+    s = _mm256_shuffle_epi32( v, 0xB1 );
+    v = _mm256_blend_epi32( _mm256_add_epi32( v, s ), _mm256_sub_epi32( v, s ), 0xAA );
+    sum = _mm256_add_epi32( sum, _mm256_abs_epi32( v ) );
+  }
+
+  return ( xHorizontalSum( sum ) + 2 ) >> 2;
+}
+
+// ====================================================================================================================
+// SSE4.1 kernels
+// ====================================================================================================================
+
+Distortion TComRdCost::xGetSAD_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+  const Distortion uiSum = xSADRows_SSE41<0>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, pcDtParam->iCols, 1 );
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+template<Int iWidth>
+Distortion TComRdCost::xGetSADN_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+  const Int iSubShift = pcDtParam->iSubShift;
+  const Int iSubStep  = ( 1 << iSubShift );
+  Distortion uiSum = xSADRows_SSE41<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg*iSubStep, pcDtParam->pCur, pcDtParam->iStrideCur*iSubStep, pcDtParam->iRows, iWidth, iSubStep );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+Distortion TComRdCost::xGetSAD16N_SSE41( DistParam* pcDtParam )
+{
+  const Int iSubShift = pcDtParam->iSubShift;
+  const Int iSubStep  = ( 1 << iSubShift );
+  Distortion uiSum = xSADRows_SSE41<0>( pcDtParam->pOrg, pcDtParam->iStrideOrg*iSubStep, pcDtParam->pCur, pcDtParam->iStrideCur*iSubStep, pcDtParam->iRows, pcDtParam->iCols, iSubStep );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+Distortion TComRdCost::xGetSSE_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetSSEw( pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return xSSERows_SSE41<0>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, pcDtParam->iCols, uiShift );
+}
+
+template<Int iWidth>
+Distortion TComRdCost::xGetSSEN_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    assert( pcDtParam->iCols == iWidth );
+    return xGetSSEw( pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return xSSERows_SSE41<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, iWidth, uiShift );
+}
+
+Distortion TComRdCost::xGetSSE16N_SSE41( DistParam* pcDtParam )
+{
+  return xGetSSE_SSE41( pcDtParam );
+}
+
+Distortion TComRdCost::xGetHADs_SSE41( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetHADsw( pcDtParam );
+  }
+  if ( pcDtParam->iStep != 1 )
+  {
+    return xGetHADs( pcDtParam );
+  }
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+
+  Distortion uiSum = 0;
+
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    for ( Int y=0; y<iRows; y+= 8 )
+    {
+      for ( Int x=0; x<iCols; x+= 8 )
+      {
+        uiSum += xCalcHADs8x8_SSE41( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<3;
+      piCur += iStrideCur<<3;
+    }
+  }
+  else if( ( iRows % 4 == 0) && (iCols % 4 == 0) )
+  {
+    for ( Int y=0; y<iRows; y+= 4 )
+    {
+      for ( Int x=0; x<iCols; x+= 4 )
+      {
+        uiSum += xCalcHADs4x4_SSE41( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<2;
+      piCur += iStrideCur<<2;
+    }
+  }
+  else
+  {
+    return xGetHADs( pcDtParam );
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+// ====================================================================================================================
+// AVX2 kernels (blocks narrower than 16 use the SSE4.1 versions)
+// ====================================================================================================================
+
+template<Int iWidth>
+Distortion TComRdCost::xGetSADN_AVX2( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+  const Int iSubShift = pcDtParam->iSubShift;
+  const Int iSubStep  = ( 1 << iSubShift );
+  Distortion uiSum = xSADRows_AVX2<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg*iSubStep, pcDtParam->pCur, pcDtParam->iStrideCur*iSubStep, pcDtParam->iRows, iWidth, iSubStep );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+Distortion TComRdCost::xGetSAD16N_AVX2( DistParam* pcDtParam )
+{
+  const Int iSubShift = pcDtParam->iSubShift;
+  const Int iSubStep  = ( 1 << iSubShift );
+  Distortion uiSum = xSADRows_AVX2<0>( pcDtParam->pOrg, pcDtParam->iStrideOrg*iSubStep, pcDtParam->pCur, pcDtParam->iStrideCur*iSubStep, pcDtParam->iRows, pcDtParam->iCols, iSubStep );
+  uiSum <<= iSubShift;
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+template<Int iWidth>
+Distortion TComRdCost::xGetSSEN_AVX2( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    assert( pcDtParam->iCols == iWidth );
+    return xGetSSEw( pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return xSSERows_AVX2<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, iWidth, uiShift );
+}
+
+Distortion TComRdCost::xGetSSE16N_AVX2( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetSSEw( pcDtParam );
+  }
+  const UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+  return xSSERows_AVX2<0>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, pcDtParam->iCols, uiShift );
+}
+
+Distortion TComRdCost::xGetHADs_AVX2( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetHADsw( pcDtParam );
+  }
+  Pel* piOrg      = pcDtParam->pOrg;
+  Pel* piCur      = pcDtParam->pCur;
+  Int  iRows      = pcDtParam->iRows;
+  Int  iCols      = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+
+  if( ( iRows % 8 != 0) || (iCols % 8 != 0) || pcDtParam->iStep != 1 )
+  {
+    return xGetHADs_SSE41( pcDtParam );
+  }
+
+  Distortion uiSum = 0;
+  for ( Int y=0; y<iRows; y+= 8 )
+  {
+    for ( Int x=0; x<iCols; x+= 8 )
+    {
+      uiSum += xCalcHADs8x8_AVX2( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+    }
+    piOrg += iStrideOrg<<3;
+    piCur += iStrideCur<<3;
+  }
+
+  return ( uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8) );
+}
+
+// ====================================================================================================================
+// Dispatch
+// ====================================================================================================================
+
+#if SIMD_SELF_CHECK
+FpDistFunc TComRdCost::m_afpReferenceDistortFunc[DF_TOTAL_FUNCTIONS];
+FpDistFunc TComRdCost::m_afpSIMDDistortFunc     [DF_TOTAL_FUNCTIONS];
+
+template<Int eDFunc>
+Distortion TComRdCost::xSelfCheck( DistParam* pcDtParam )
+{
+  const Distortion uiSIMD      = m_afpSIMDDistortFunc     [eDFunc]( pcDtParam );
+  const Distortion uiReference = m_afpReferenceDistortFunc[eDFunc]( pcDtParam );
+  if( uiSIMD != uiReference )
+  {
+    std::cerr << "ERROR: SIMD self-check failed for distortion function " << eDFunc << " (" << pcDtParam->iCols << "x" << pcDtParam->iRows
+              << "): SIMD=" << uiSIMD << " reference=" << uiReference << std::endl;
+    assert(false);
+    exit(1);
+  }
+  return uiReference;
+}
+
+#define SET_SIMD_DISTORT_FUNC(idx, func)                \
+{                                                       \
+  m_afpSIMDDistortFunc[idx] = func;                     \
+  m_afpDistortFunc    [idx] = xSelfCheck<idx>;          \
+}
+#else
+#define SET_SIMD_DISTORT_FUNC(idx, func)                \
+{                                                       \
+  m_afpDistortFunc[idx] = func;                         \
+}
+#endif
+
+/** replace the plain C entries of m_afpDistortFunc with the best kernels available for eExt
+ * \param eExt  SIMD extension supported by the CPU
+ */
+Void TComRdCost::xInitSIMD( SIMDExtension eExt )
+{
+#if SIMD_SELF_CHECK
+  for( Int i = 0; i < DF_TOTAL_FUNCTIONS; i++ )
+  {
+    m_afpReferenceDistortFunc[i] = m_afpDistortFunc[i];
+  }
+#endif
+
+  if( eExt >= SIMD_SSE41 )
+  {
+    SET_SIMD_DISTORT_FUNC( DF_SSE    , xGetSSE_SSE41      );
+    SET_SIMD_DISTORT_FUNC( DF_SSE4   , xGetSSEN_SSE41<4>  );
+    SET_SIMD_DISTORT_FUNC( DF_SSE8   , xGetSSEN_SSE41<8>  );
+    SET_SIMD_DISTORT_FUNC( DF_SSE16  , xGetSSEN_SSE41<16> );
+    SET_SIMD_DISTORT_FUNC( DF_SSE32  , xGetSSEN_SSE41<32> );
+    SET_SIMD_DISTORT_FUNC( DF_SSE64  , xGetSSEN_SSE41<64> );
+    SET_SIMD_DISTORT_FUNC( DF_SSE16N , xGetSSE16N_SSE41   );
+
+    SET_SIMD_DISTORT_FUNC( DF_SAD    , xGetSAD_SSE41      );
+    SET_SIMD_DISTORT_FUNC( DF_SAD4   , xGetSADN_SSE41<4>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD8   , xGetSADN_SSE41<8>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD16  , xGetSADN_SSE41<16> );
+    SET_SIMD_DISTORT_FUNC( DF_SAD32  , xGetSADN_SSE41<32> );
+    SET_SIMD_DISTORT_FUNC( DF_SAD64  , xGetSADN_SSE41<64> );
+    SET_SIMD_DISTORT_FUNC( DF_SAD16N , xGetSAD16N_SSE41   );
+
+    SET_SIMD_DISTORT_FUNC( DF_SADS   , xGetSAD_SSE41      );
+    SET_SIMD_DISTORT_FUNC( DF_SADS4  , xGetSADN_SSE41<4>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS8  , xGetSADN_SSE41<8>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS16 , xGetSADN_SSE41<16> );
+    SET_SIMD_DISTORT_FUNC( DF_SADS32 , xGetSADN_SSE41<32> );
+    SET_SIMD_DISTORT_FUNC( DF_SADS64 , xGetSADN_SSE41<64> );
+    SET_SIMD_DISTORT_FUNC( DF_SADS16N, xGetSAD16N_SSE41   );
+
+#if AMP_SAD
+    SET_SIMD_DISTORT_FUNC( DF_SAD12  , xGetSADN_SSE41<12> );
+    SET_SIMD_DISTORT_FUNC( DF_SAD24  , xGetSADN_SSE41<24> );
+    SET_SIMD_DISTORT_FUNC( DF_SAD48  , xGetSADN_SSE41<48> );
+
+    SET_SIMD_DISTORT_FUNC( DF_SADS12 , xGetSADN_SSE41<12> );
+    SET_SIMD_DISTORT_FUNC( DF_SADS24 , xGetSADN_SSE41<24> );
+    SET_SIMD_DISTORT_FUNC( DF_SADS48 , xGetSADN_SSE41<48> );
+#endif
+
+    SET_SIMD_DISTORT_FUNC( DF_HADS   , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS4  , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS8  , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS16 , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS32 , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS64 , xGetHADs_SSE41     );
+    SET_SIMD_DISTORT_FUNC( DF_HADS16N, xGetHADs_SSE41     );
+  }
+
+  if( eExt >= SIMD_AVX2 )
+  {
+    SET_SIMD_DISTORT_FUNC( DF_SSE16  , xGetSSEN_AVX2<16>  );
+    SET_SIMD_DISTORT_FUNC( DF_SSE32  , xGetSSEN_AVX2<32>  );
+    SET_SIMD_DISTORT_FUNC( DF_SSE64  , xGetSSEN_AVX2<64>  );
+    SET_SIMD_DISTORT_FUNC( DF_SSE16N , xGetSSE16N_AVX2    );
+
+    SET_SIMD_DISTORT_FUNC( DF_SAD16  , xGetSADN_AVX2<16>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD32  , xGetSADN_AVX2<32>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD64  , xGetSADN_AVX2<64>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD16N , xGetSAD16N_AVX2    );
+
+    SET_SIMD_DISTORT_FUNC( DF_SADS16 , xGetSADN_AVX2<16>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS32 , xGetSADN_AVX2<32>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS64 , xGetSADN_AVX2<64>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS16N, xGetSAD16N_AVX2    );
+
+#if AMP_SAD
+    SET_SIMD_DISTORT_FUNC( DF_SAD24  , xGetSADN_AVX2<24>  );
+    SET_SIMD_DISTORT_FUNC( DF_SAD48  , xGetSADN_AVX2<48>  );
+
+    SET_SIMD_DISTORT_FUNC( DF_SADS24 , xGetSADN_AVX2<24>  );
+    SET_SIMD_DISTORT_FUNC( DF_SADS48 , xGetSADN_AVX2<48>  );
+#endif
+
+    SET_SIMD_DISTORT_FUNC( DF_HADS   , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS4  , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS8  , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS16 , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS32 , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS64 , xGetHADs_AVX2      );
+    SET_SIMD_DISTORT_FUNC( DF_HADS16N, xGetHADs_AVX2      );
+  }
+}
+
+#undef SET_SIMD_DISTORT_FUNC
+
+//! \}
+
+#endif // SIMD_X86
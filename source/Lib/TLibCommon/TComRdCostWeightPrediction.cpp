@@ -40,12 +40,6 @@
 #include "TComRdCost.h"
 #include "TComRdCostWeightPrediction.h"
 
-Int   TComRdCostWeightPrediction::m_w0        = 0;
-Int   TComRdCostWeightPrediction::m_w1        = 0;
-Int   TComRdCostWeightPrediction::m_shift     = 0;
-Int   TComRdCostWeightPrediction::m_offset    = 0;
-Int   TComRdCostWeightPrediction::m_round     = 0;
-Bool  TComRdCostWeightPrediction::m_xSetDone  = false;
 
 // ====================================================================================================================
 // Distortion functions
@@ -162,23 +156,23 @@ Distortion TComRdCostWeightPrediction::xGetSSEw( DistParam* pcDtParam )
  * \param iStrideOrg
  * \param iStrideCur
  * \param iStep
+ * \param wpCur  weighted prediction parameters applied to piCur
  * \returns Distortion
  */
-Distortion TComRdCostWeightPrediction::xCalcHADs2x2w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+Distortion TComRdCostWeightPrediction::xCalcHADs2x2w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep, const wpScalingParam &wpCur )
 {
   Distortion satd = 0;
   TCoeff diff[4], m[4];
 
-  assert( m_xSetDone );
   Pel   pred;
 
-  pred    = ( (m_w0*piCur[0*iStep             ] + m_round) >> m_shift ) + m_offset ;
+  pred    = ( (wpCur.w*piCur[0*iStep             ] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
   diff[0] = piOrg[0             ] - pred;
-  pred    = ( (m_w0*piCur[1*iStep             ] + m_round) >> m_shift ) + m_offset ;
+  pred    = ( (wpCur.w*piCur[1*iStep             ] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
   diff[1] = piOrg[1             ] - pred;
-  pred    = ( (m_w0*piCur[0*iStep + iStrideCur] + m_round) >> m_shift ) + m_offset ;
+  pred    = ( (wpCur.w*piCur[0*iStep + iStrideCur] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
   diff[2] = piOrg[iStrideOrg    ] - pred;
-  pred    = ( (m_w0*piCur[1*iStep + iStrideCur] + m_round) >> m_shift ) + m_offset ;
+  pred    = ( (wpCur.w*piCur[1*iStep + iStrideCur] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
   diff[3] = piOrg[iStrideOrg + 1] - pred;
 
   m[0] = diff[0] + diff[2];
@@ -200,26 +194,26 @@ Distortion TComRdCostWeightPrediction::xCalcHADs2x2w( const Pel *piOrg, const Pe
  * \param iStrideOrg
  * \param iStrideCur
  * \param iStep
+ * \param wpCur  weighted prediction parameters applied to piCur
  * \returns Distortion
  */
-Distortion TComRdCostWeightPrediction::xCalcHADs4x4w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+Distortion TComRdCostWeightPrediction::xCalcHADs4x4w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep, const wpScalingParam &wpCur )
 {
   Int k;
   Distortion satd = 0;
   TCoeff diff[16], m[16], d[16];
 
-  assert( m_xSetDone );
   Pel   pred;
 
   for( k = 0; k < 16; k+=4 )
   {
-    pred      = ( (m_w0*piCur[0*iStep] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[0*iStep] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+0] = piOrg[0] - pred;
-    pred      = ( (m_w0*piCur[1*iStep] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[1*iStep] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+1] = piOrg[1] - pred;
-    pred      = ( (m_w0*piCur[2*iStep] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[2*iStep] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+2] = piOrg[2] - pred;
-    pred      = ( (m_w0*piCur[3*iStep] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[3*iStep] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+3] = piOrg[3] - pred;
 
     piCur += iStrideCur;
@@ -310,9 +304,10 @@ Distortion TComRdCostWeightPrediction::xCalcHADs4x4w( const Pel *piOrg, const Pe
  * \param iStrideOrg
  * \param iStrideCur
  * \param iStep
+ * \param wpCur  weighted prediction parameters applied to piCur
  * \returns Distortion
  */
-Distortion TComRdCostWeightPrediction::xCalcHADs8x8w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep )
+Distortion TComRdCostWeightPrediction::xCalcHADs8x8w( const Pel *piOrg, const Pel *piCur, Int iStrideOrg, Int iStrideCur, Int iStep, const wpScalingParam &wpCur )
 {
   Int k, i, j, jj;
   Distortion sad=0;
@@ -324,26 +319,25 @@ Distortion TComRdCostWeightPrediction::xCalcHADs8x8w( const Pel *piOrg, const Pe
   Int iStep6 = iStep5 + iStep;
   Int iStep7 = iStep6 + iStep;
 
-  assert( m_xSetDone );
   Pel   pred;
 
   for( k = 0; k < 64; k+=8 )
   {
-    pred      = ( (m_w0*piCur[     0] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[     0] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+0] = piOrg[0] - pred;
-    pred      = ( (m_w0*piCur[iStep ] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep ] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+1] = piOrg[1] - pred;
-    pred      = ( (m_w0*piCur[iStep2] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep2] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+2] = piOrg[2] - pred;
-    pred      = ( (m_w0*piCur[iStep3] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep3] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+3] = piOrg[3] - pred;
-    pred      = ( (m_w0*piCur[iStep4] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep4] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+4] = piOrg[4] - pred;
-    pred      = ( (m_w0*piCur[iStep5] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep5] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+5] = piOrg[5] - pred;
-    pred      = ( (m_w0*piCur[iStep6] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep6] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+6] = piOrg[6] - pred;
-    pred      = ( (m_w0*piCur[iStep7] + m_round) >> m_shift ) + m_offset ;
+    pred      = ( (wpCur.w*piCur[iStep7] + wpCur.round) >> wpCur.shift ) + wpCur.offset ;
     diff[k+7] = piOrg[7] - pred;
 
     piCur += iStrideCur;
@@ -438,6 +432,7 @@ Distortion TComRdCostWeightPrediction::xGetHADs4w( DistParam* pcDtParam )
   Int  iStrideCur = pcDtParam->iStrideCur;
   Int  iStrideOrg = pcDtParam->iStrideOrg;
   Int  iStep  = pcDtParam->iStep;
+  const wpScalingParam *wpCur = &(pcDtParam->wpCur[pcDtParam->compIdx]);
   Int  y;
   Int  iOffsetOrg = iStrideOrg<<2;
   Int  iOffsetCur = iStrideCur<<2;
@@ -446,7 +441,7 @@ Distortion TComRdCostWeightPrediction::xGetHADs4w( DistParam* pcDtParam )
 
   for ( y=0; y<iRows; y+= 4 )
   {
-    uiSum += xCalcHADs4x4w( piOrg, piCur, iStrideOrg, iStrideCur, iStep );
+    uiSum += xCalcHADs4x4w( piOrg, piCur, iStrideOrg, iStrideCur, iStep, *wpCur );
     piOrg += iOffsetOrg;
     piCur += iOffsetCur;
   }
@@ -466,14 +461,15 @@ Distortion TComRdCostWeightPrediction::xGetHADs8w( DistParam* pcDtParam )
   Int  iStrideCur = pcDtParam->iStrideCur;
   Int  iStrideOrg = pcDtParam->iStrideOrg;
   Int  iStep  = pcDtParam->iStep;
+  const wpScalingParam *wpCur = &(pcDtParam->wpCur[pcDtParam->compIdx]);
   Int  y;
 
   Distortion uiSum = 0;
 
   if ( iRows == 4 )
   {
-    uiSum += xCalcHADs4x4w( piOrg+0, piCur        , iStrideOrg, iStrideCur, iStep );
-    uiSum += xCalcHADs4x4w( piOrg+4, piCur+4*iStep, iStrideOrg, iStrideCur, iStep );
+    uiSum += xCalcHADs4x4w( piOrg+0, piCur        , iStrideOrg, iStrideCur, iStep, *wpCur );
+    uiSum += xCalcHADs4x4w( piOrg+4, piCur+4*iStep, iStrideOrg, iStrideCur, iStep, *wpCur );
   }
   else
   {
@@ -481,7 +477,7 @@ Distortion TComRdCostWeightPrediction::xGetHADs8w( DistParam* pcDtParam )
     Int  iOffsetCur = iStrideCur<<3;
     for ( y=0; y<iRows; y+= 8 )
     {
-      uiSum += xCalcHADs8x8w( piOrg, piCur, iStrideOrg, iStrideCur, iStep );
+      uiSum += xCalcHADs8x8w( piOrg, piCur, iStrideOrg, iStrideCur, iStep, *wpCur );
       piOrg += iOffsetOrg;
       piCur += iOffsetCur;
     }
@@ -510,8 +506,6 @@ Distortion TComRdCostWeightPrediction::xGetHADsw( DistParam* pcDtParam )
   assert(compIdx<MAX_NUM_COMPONENT);
   wpScalingParam  *wpCur    = &(pcDtParam->wpCur[compIdx]);
 
-  xSetWPscale(wpCur->w, 0, wpCur->shift, wpCur->offset, wpCur->round);
-
   Distortion uiSum = 0;
 
   if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
@@ -522,7 +516,7 @@ Distortion TComRdCostWeightPrediction::xGetHADsw( DistParam* pcDtParam )
     {
       for ( x=0; x<iCols; x+= 8 )
       {
-        uiSum += xCalcHADs8x8w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+        uiSum += xCalcHADs8x8w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep, *wpCur );
       }
       piOrg += iOffsetOrg;
       piCur += iOffsetCur;
@@ -537,7 +531,7 @@ Distortion TComRdCostWeightPrediction::xGetHADsw( DistParam* pcDtParam )
     {
       for ( x=0; x<iCols; x+= 4 )
       {
-        uiSum += xCalcHADs4x4w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+        uiSum += xCalcHADs4x4w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep, *wpCur );
       }
       piOrg += iOffsetOrg;
       piCur += iOffsetCur;
@@ -549,14 +543,12 @@ Distortion TComRdCostWeightPrediction::xGetHADsw( DistParam* pcDtParam )
     {
       for ( x=0; x<iCols; x+=2 )
       {
-        uiSum += xCalcHADs2x2w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep );
+        uiSum += xCalcHADs2x2w( &piOrg[x], &piCur[x*iStep], iStrideOrg, iStrideCur, iStep, *wpCur );
       }
       piOrg += iStrideOrg;
       piCur += iStrideCur;
     }
   }
 
-  m_xSetDone  = false;
-
   return uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
 }
@@ -41,6 +41,7 @@
 #include <stdio.h>
 #include <iomanip>
 #include <assert.h>
+#include <mutex>
 #include "TComDataCU.h"
 #include "Debug.h"
 // ====================================================================================================================
@@ -136,9 +137,19 @@ public:
   }
 };
 
+static std::mutex s_cROMMutex;
+static Int        s_iROMRefCount = 0;
+
 // initialize ROM variables
+// The tables set up here do not depend on the coding configuration and are shared by all instances in the process.
 Void initROM()
 {
+  std::lock_guard<std::mutex> cLock(s_cROMMutex);
+  if (s_iROMRefCount++ > 0)
+  {
+    return;
+  }
+
   Int i, c;
 
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
@@ -223,6 +234,12 @@ Void initROM()
 
 Void destroyROM()
 {
+  std::lock_guard<std::mutex> cLock(s_cROMMutex);
+  if (--s_iROMRefCount > 0)
+  {
+    return;
+  }
+
   for(UInt groupTypeIndex = 0; groupTypeIndex < SCAN_NUMBER_OF_GROUP_TYPES; groupTypeIndex++)
   {
     for (UInt scanOrderIndex = 0; scanOrderIndex < SCAN_NUMBER_OF_TYPES; scanOrderIndex++)
@@ -238,18 +255,61 @@ Void destroyROM()
   }
 }
 
+// ====================================================================================================================
+// Per-instance context
+// ====================================================================================================================
+
+TComRomContext::TComRomContext()
+: uiMaxCUWidth (MAX_CU_SIZE)
+, uiMaxCUHeight(MAX_CU_SIZE)
+, uiMaxCUDepth (MAX_CU_DEPTH)
+, uiAddCUDepth (0)
+#if ENC_DEC_TRACE
+, hTrace        (stdout) // Set to NULL to open up a file. Set to stdout to use the current output
+, bJustDoIt     (false)
+, HLSTraceEnable(true)
+, nSymbolCounter(0)
+#endif
+{
+  ::memset( auiZscanToRaster, 0, sizeof(auiZscanToRaster) );
+  ::memset( auiRasterToZscan, 0, sizeof(auiRasterToZscan) );
+  ::memset( auiRasterToPelX,  0, sizeof(auiRasterToPelX)  );
+  ::memset( auiRasterToPelY,  0, sizeof(auiRasterToPelY)  );
+  for (UInt channelType = 0; channelType < MAX_NUM_CHANNEL_TYPE; channelType++)
+  {
+    bitDepth         [channelType] = 8;
+    PCMBitDepth      [channelType] = 8;
+    maxTrDynamicRange[channelType] = 0;
+  }
+  for (UInt comp = 0; comp < MAX_NUM_COMPONENT; comp++)
+  {
+    saoMaxOffsetQVal[comp] = 0;
+    pcGlbArlCoeff   [comp] = NULL;
+  }
+}
+
+Void TComRomContext::copyConfiguration( const TComRomContext& rcContext )
+{
+  uiMaxCUWidth  = rcContext.uiMaxCUWidth;
+  uiMaxCUHeight = rcContext.uiMaxCUHeight;
+  uiMaxCUDepth  = rcContext.uiMaxCUDepth;
+  uiAddCUDepth  = rcContext.uiAddCUDepth;
+  for (UInt channelType = 0; channelType < MAX_NUM_CHANNEL_TYPE; channelType++)
+  {
+    bitDepth         [channelType] = rcContext.bitDepth         [channelType];
+    PCMBitDepth      [channelType] = rcContext.PCMBitDepth      [channelType];
+    maxTrDynamicRange[channelType] = rcContext.maxTrDynamicRange[channelType];
+  }
+}
+
+static TComRomContext s_cDefaultRomContext;
+
+thread_local TComRomContext* g_pcRomContext = &s_cDefaultRomContext;
+
 // ====================================================================================================================
 // Data structure related table & variable
 // ====================================================================================================================
 
-UInt g_uiMaxCUWidth  = MAX_CU_SIZE;
-UInt g_uiMaxCUHeight = MAX_CU_SIZE;
-UInt g_uiMaxCUDepth  = MAX_CU_DEPTH;
-UInt g_uiAddCUDepth  = 0;
-UInt g_auiZscanToRaster [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToZscan [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToPelX  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToPelY  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
 
 UInt g_auiPUOffset[NUMBER_OF_PART_SIZES] = { 0, 8, 4, 4, 2, 10, 1, 5};
 
@@ -316,7 +376,6 @@ Void initRasterToPelXY ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth
   }
 }
 
-Int g_maxTrDynamicRange[MAX_NUM_CHANNEL_TYPE];
 
 Int g_quantScales[SCALING_LIST_REM_NUM] =
 {
@@ -535,13 +594,6 @@ const UChar g_chroma422IntraAngleMappingTable[NUM_INTRA_MODE] =
   //0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, DM
   { 0, 1, 2, 2, 2, 2, 3, 5, 7, 8, 10, 12, 13, 15, 17, 18, 19, 20, 21, 22, 23, 23, 24, 24, 25, 25, 26, 27, 27, 28, 28, 29, 29, 30, 31, DM_CHROMA_IDX};
 
-// ====================================================================================================================
-// Bit-depth
-// ====================================================================================================================
-
-Int g_bitDepth   [MAX_NUM_CHANNEL_TYPE] = {8, 8};
-Int g_PCMBitDepth[MAX_NUM_CHANNEL_TYPE] = {8, 8};    // PCM bit-depth
-
 // ====================================================================================================================
 // Misc.
 // ====================================================================================================================
@@ -549,12 +601,8 @@ Int g_PCMBitDepth[MAX_NUM_CHANNEL_TYPE] = {8, 8};    // PCM bit-depth
 Char  g_aucConvertToBit  [ MAX_CU_SIZE+1 ];
 
 #if ENC_DEC_TRACE
-FILE*  g_hTrace = stdout; // Set to NULL to open up a file. Set to stdout to use the current output
 const Bool g_bEncDecTraceEnable  = true;
 const Bool g_bEncDecTraceDisable = false;
-Bool   g_HLSTraceEnable = true;
-Bool   g_bJustDoIt = false;
-UInt64 g_nSymbolCounter = 0;
 #endif
 // ====================================================================================================================
 // Scanning order & context model mapping
@@ -66,38 +66,91 @@
 Void         initROM();
 Void         destroyROM();
 
+// ====================================================================================================================
+// Per-instance context
+// ====================================================================================================================
+
+/// State that depends on the coding configuration of an encoder or decoder instance: CTU geometry, bit depths and
+/// the tables derived from them. Every thread works on the context bound to it, which is a process wide default
+/// unless a TComRomScope binds another one. TEncTop and TDecTop own a context each and bind it in their entry points,
+/// so several instances with different configurations can run in one process. Threads started by the library
+/// inherit the context of the thread that starts them. Inner loops should read the values into locals once, as every
+/// use of one of the g_ names below loads the thread's context.
+struct TComRomContext
+{
+  UInt    uiMaxCUWidth;                                     ///< CTU width
+  UInt    uiMaxCUHeight;                                    ///< CTU height
+  UInt    uiMaxCUDepth;                                     ///< max. CU depth, including the additional depth for TUs
+  UInt    uiAddCUDepth;                                     ///< additional CU depth for TUs smaller than the min. CU
+  UInt    auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt    auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt    auiRasterToPelX [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt    auiRasterToPelY [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  Int     bitDepth         [MAX_NUM_CHANNEL_TYPE];
+  Int     PCMBitDepth      [MAX_NUM_CHANNEL_TYPE];
+  Int     maxTrDynamicRange[MAX_NUM_CHANNEL_TYPE];
+  UInt    saoMaxOffsetQVal [MAX_NUM_COMPONENT];
+  TCoeff* pcGlbArlCoeff    [MAX_NUM_COMPONENT];             ///< reconstruction level buffer shared by the CTUs of a picture
+#if ENC_DEC_TRACE
+  FILE*   hTrace;
+  Bool    bJustDoIt;
+  Bool    HLSTraceEnable;
+  UInt64  nSymbolCounter;
+#endif
+
+  TComRomContext();
+
+  /// copy the CTU geometry and bit depths of another context, but none of its tables and buffers
+  Void    copyConfiguration( const TComRomContext& rcContext );
+};
+
+extern thread_local TComRomContext* g_pcRomContext;        ///< context bound to the calling thread
+
+/// binds a context to the calling thread for the lifetime of the object
+class TComRomScope
+{
+private:
+  TComRomContext* m_pcPrevContext;
+
+public:
+  TComRomScope( TComRomContext* pcContext ) : m_pcPrevContext(g_pcRomContext) { g_pcRomContext = pcContext; }
+  ~TComRomScope()                                                              { g_pcRomContext = m_pcPrevContext; }
+};
+
+#define g_uiMaxCUWidth       (g_pcRomContext->uiMaxCUWidth)
+#define g_uiMaxCUHeight      (g_pcRomContext->uiMaxCUHeight)
+#define g_uiMaxCUDepth       (g_pcRomContext->uiMaxCUDepth)
+#define g_uiAddCUDepth       (g_pcRomContext->uiAddCUDepth)
+#define g_auiZscanToRaster   (g_pcRomContext->auiZscanToRaster)
+#define g_auiRasterToZscan   (g_pcRomContext->auiRasterToZscan)
+#define g_auiRasterToPelX    (g_pcRomContext->auiRasterToPelX)
+#define g_auiRasterToPelY    (g_pcRomContext->auiRasterToPelY)
+#define g_bitDepth           (g_pcRomContext->bitDepth)
+#define g_PCMBitDepth        (g_pcRomContext->PCMBitDepth)
+#define g_maxTrDynamicRange  (g_pcRomContext->maxTrDynamicRange)
+#define g_saoMaxOffsetQVal   (g_pcRomContext->saoMaxOffsetQVal)
+
+template <typename T> inline T Clip  (const T x, const ChannelType type)         { return ClipBD(x, g_bitDepth[type]);                    }
+
 // ====================================================================================================================
 // Data structure related table & variable
 // ====================================================================================================================
 
 // flexible conversion from relative to absolute index
-extern       UInt   g_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
-extern       UInt   g_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 extern       UInt*  g_scanOrder[SCAN_NUMBER_OF_GROUP_TYPES][SCAN_NUMBER_OF_TYPES][ MAX_CU_DEPTH ][ MAX_CU_DEPTH ];
 
 Void         initZscanToRaster ( Int iMaxDepth, Int iDepth, UInt uiStartVal, UInt*& rpuiCurrIdx );
 Void         initRasterToZscan ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth         );
 
 // conversion of partition index to picture pel position
-extern       UInt   g_auiRasterToPelX[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
-extern       UInt   g_auiRasterToPelY[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
-
 Void         initRasterToPelXY ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth );
 
-// global variable (LCU width/height, max. CU depth)
-extern       UInt g_uiMaxCUWidth;
-extern       UInt g_uiMaxCUHeight;
-extern       UInt g_uiMaxCUDepth;
-extern       UInt g_uiAddCUDepth;
-
 extern       UInt g_auiPUOffset[NUMBER_OF_PART_SIZES];
 
 #define QUANT_SHIFT                14 // Q(4) = 2^14
 #define IQUANT_SHIFT                6
 #define SCALE_BITS                 15 // Inherited from TMuC, pressumably for fractional bit estimates in RDOQ
 
-extern Int g_maxTrDynamicRange[MAX_NUM_CHANNEL_TYPE];
-
 #define SQRT2                      11585
 #define SQRT2_SHIFT                13
 #define INVSQRT2                   11585
@@ -153,13 +206,6 @@ extern const UChar  g_aucIntraModeNumFast[MAX_CU_DEPTH];
 
 extern const UChar  g_chroma422IntraAngleMappingTable[NUM_INTRA_MODE];
 
-// ====================================================================================================================
-// Bit-depth
-// ====================================================================================================================
-
-extern        Int g_bitDepth   [MAX_NUM_CHANNEL_TYPE];
-extern        Int g_PCMBitDepth[MAX_NUM_CHANNEL_TYPE];
-
 // ====================================================================================================================
 // Mode-Dependent DST Matrices
 // ====================================================================================================================
@@ -178,12 +224,12 @@ extern       Char   g_aucConvertToBit  [ MAX_CU_SIZE+1 ];   // from width to log
 
 
 #if ENC_DEC_TRACE
-extern FILE*  g_hTrace;
-extern Bool   g_bJustDoIt;
+#define g_hTrace             (g_pcRomContext->hTrace)
+#define g_bJustDoIt          (g_pcRomContext->bJustDoIt)
+#define g_HLSTraceEnable     (g_pcRomContext->HLSTraceEnable)
+#define g_nSymbolCounter     (g_pcRomContext->nSymbolCounter)
 extern const Bool g_bEncDecTraceEnable;
 extern const Bool g_bEncDecTraceDisable;
-extern Bool   g_HLSTraceEnable;
-extern UInt64 g_nSymbolCounter;
 
 #define COUNTER_START    1
 #define COUNTER_END      0 //( UInt64(1) << 63 )
@@ -0,0 +1,140 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComSIMD.cpp
+    \brief    run-time detection of x86 SIMD extensions used by the optimised kernels
+*/
+
+#include "TComSIMD.h"
+
+#if SIMD_X86_TARGET
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+static SIMDExtension s_simdExtensionLimit = SIMD_AVX2;
+
+#if SIMD_X86_TARGET
+static Void xCpuid( UInt leaf, UInt subLeaf, UInt regs[4] )
+{
+#ifdef _MSC_VER
+  Int info[4];
+  __cpuidex( info, leaf, subLeaf );
+  for( Int i = 0; i < 4; i++ )
+  {
+    regs[i] = UInt(info[i]);
+  }
+#else
+  __cpuid_count( leaf, subLeaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+}
+
+/// returns the OS-enabled state components (XCR0); only valid when CPUID reports OSXSAVE
+static UInt64 xGetXCR0()
+{
+#ifdef _MSC_VER
+  return _xgetbv( 0 );
+#else
+  UInt eax, edx;
+  __asm__ __volatile__ ( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+  return ( UInt64(edx) << 32 ) | eax;
+#endif
+}
+
+static SIMDExtension xDetectSIMDExtension()
+{
+  UInt regs[4];
+  xCpuid( 0, 0, regs );
+  const UInt maxLeaf = regs[0];
+  if( maxLeaf < 1 )
+  {
+    return SIMD_NONE;
+  }
+
+  xCpuid( 1, 0, regs );
+  const Bool sse41   = ( regs[2] & ( 1 << 19 ) ) != 0;
+  const Bool osxsave = ( regs[2] & ( 1 << 27 ) ) != 0;
+  const Bool avx     = ( regs[2] & ( 1 << 28 ) ) != 0;
+
+  if( !sse41 )
+  {
+    return SIMD_NONE;
+  }
+
+  // AVX2 needs the OS to preserve the upper halves of the ymm registers (XCR0 bits 1 and 2)
+  if( osxsave && avx && maxLeaf >= 7 && ( xGetXCR0() & 0x6 ) == 0x6 )
+  {
+    xCpuid( 7, 0, regs );
+    if( regs[1] & ( 1 << 5 ) )
+    {
+      return SIMD_AVX2;
+    }
+  }
+
+  return SIMD_SSE41;
+}
+#endif
+
+SIMDExtension getSIMDExtension()
+{
+#if SIMD_X86_TARGET
+  static const SIMDExtension detected = xDetectSIMDExtension();
+  return std::min( detected, s_simdExtensionLimit );
+#else
+  return SIMD_NONE;
+#endif
+}
+
+Void setSIMDExtensionLimit( SIMDExtension limit )
+{
+  s_simdExtensionLimit = limit;
+}
+
+const Char* getSIMDExtensionName( SIMDExtension ext )
+{
+  switch( ext )
+  {
+    case SIMD_SSE41: return "SSE4.1";
+    case SIMD_AVX2:  return "AVX2";
+    default:         return "none";
+  }
+}
+
+//! \}
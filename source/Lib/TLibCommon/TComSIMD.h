@@ -0,0 +1,85 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TComSIMD.h
+    \brief    run-time detection of x86 SIMD extensions used by the optimised kernels (header)
+*/
+
+#ifndef __TCOMSIMD__
+#define __TCOMSIMD__
+
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Constants
+// ====================================================================================================================
+
+/// SIMD instruction set extensions, in increasing order of capability
+enum SIMDExtension
+{
+  SIMD_NONE               = 0,     ///< plain C kernels only
+  SIMD_SSE41              = 1,     ///< SSE2 .. SSE4.1
+  SIMD_AVX2               = 2,     ///< AVX2 (implies SSE4.1)
+  NUMBER_OF_SIMD_EXTENSIONS = 3
+};
+
+#if SIMD_X86_TARGET
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_TARGET_SSE41   __attribute__((target("sse4.1")))
+#define SIMD_TARGET_AVX2    __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_SSE41
+#define SIMD_TARGET_AVX2
+#endif
+#endif
+
+// ====================================================================================================================
+// Function declarations
+// ====================================================================================================================
+
+/// highest extension supported by both the CPU and the operating system, capped by setSIMDExtensionLimit()
+SIMDExtension getSIMDExtension();
+
+/// cap the extension reported by getSIMDExtension(). Kernel tables are populated when the owning
+/// objects are initialised, so this must be called before the encoder/decoder is created.
+Void          setSIMDExtensionLimit( SIMDExtension limit );
+
+const Char*   getSIMDExtensionName( SIMDExtension ext );
+
+//! \}
+
+#endif // __TCOMSIMD__
@@ -44,8 +44,6 @@
 //! \ingroup TLibCommon
 //! \{
 #if HM_CLEANUP_SAO
-UInt g_saoMaxOffsetQVal[MAX_NUM_COMPONENT]; 
-
 SAOOffset::SAOOffset()
 { 
   reset();
@@ -106,25 +104,17 @@ const SAOBlkParam& SAOBlkParam::operator= (const SAOBlkParam& src)
 TComSampleAdaptiveOffset::TComSampleAdaptiveOffset()
 {
   m_tempPicYuv = NULL;
-  for(Int compIdx=0; compIdx < MAX_NUM_COMPONENT; compIdx++)
-  {
-    m_offsetClipTable[compIdx] = NULL;
-  }
-  m_signTable = NULL; 
 
-  
-  m_lineBufWidth = 0;
-  m_signLineBuf1 = NULL;
-  m_signLineBuf2 = NULL;
+  m_offsetEOBlk = offsetEOBlk;
+  m_offsetBOBlk = offsetBOBlk;
+  m_statsEOBlk  = statsEOBlk;
+  m_statsBOBlk  = statsBOBlk;
 }
 
 
 TComSampleAdaptiveOffset::~TComSampleAdaptiveOffset()
 {
   destroy();
-  
-  if (m_signLineBuf1) delete[] m_signLineBuf1; m_signLineBuf1 = NULL;
-  if (m_signLineBuf2) delete[] m_signLineBuf2; m_signLineBuf2 = NULL;
 }
 
 Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat format, UInt maxCUWidth, UInt maxCUHeight, UInt maxCUDepth )
@@ -156,40 +146,14 @@ Void TComSampleAdaptiveOffset::create( Int picWidth, Int picHeight, ChromaFormat
     g_saoMaxOffsetQVal[compIdx] = (1<<(min(bitDepthSample,MAX_SAO_TRUNCATED_BITDEPTH)-5))-1; //Table 9-32, inclusive
   }
 
-  //look-up table for clipping
-  for(Int compIdx = 0; compIdx < MAX_NUM_COMPONENT; compIdx++)
-  {
-    Int bitDepthSample = g_bitDepth[toChannelType(ComponentID(compIdx))]; //exclusive
-    Int maxSampleValue = (1<< bitDepthSample); //exclusive
-    Int maxOffsetValue = (g_saoMaxOffsetQVal[compIdx] << m_offsetStepLog2[compIdx]); 
-
-    m_offsetClipTable[compIdx] = new Int[(maxSampleValue + maxOffsetValue -1)+ (maxOffsetValue)+1 ]; //positive & negative range plus 0
-    m_offsetClip[compIdx] = &(m_offsetClipTable[compIdx][maxOffsetValue]);
-
-    //assign clipped values 
-    Int* offsetClipPtr = m_offsetClip[compIdx];
-    for(Int k=0; k< maxSampleValue; k++)
-    {
-      *(offsetClipPtr + k) = k;
-    }
-    for(Int k=0; k< maxOffsetValue; k++ )
-    {
-      *(offsetClipPtr + maxSampleValue+ k) = maxSampleValue-1;
-      *(offsetClipPtr -k -1 )              = 0;
-    }
-    if(compIdx == COMPONENT_Y) //g_bitDepthY is always larger than or equal to g_bitDepthC
-    {
-      m_signTable = new Short[ 2*(maxSampleValue-1) + 1 ];
-      m_sign = &(m_signTable[maxSampleValue-1]);
-
-      m_sign[0] = 0;
-      for(Int k=1; k< maxSampleValue; k++)
-      {
-        m_sign[k] = 1;
-        m_sign[-k]= -1;
-      }
-    }
-  }  
+  //kernels
+  m_offsetEOBlk = offsetEOBlk;
+  m_offsetBOBlk = offsetBOBlk;
+  m_statsEOBlk  = statsEOBlk;
+  m_statsBOBlk  = statsBOBlk;
+#if SIMD_X86
+  initSIMD(getSIMDExtension());
+#endif
 }
 
 Void TComSampleAdaptiveOffset::destroy()
@@ -200,18 +164,6 @@ Void TComSampleAdaptiveOffset::destroy()
     delete m_tempPicYuv;
     m_tempPicYuv = NULL;
   }
-
-  for(Int compIdx=0; compIdx < MAX_NUM_COMPONENT; compIdx++)
-  {
-    if(m_offsetClipTable[compIdx])
-    {
-      delete[] m_offsetClipTable[compIdx]; m_offsetClipTable[compIdx] = NULL;
-    }
-  }
-  if( m_signTable )
-  {
-    delete[] m_signTable; m_signTable = NULL;
-  }
 }
 
 Void TComSampleAdaptiveOffset::invertQuantOffsets(ComponentID compIdx, Int typeIdc, Int typeAuxInfo, Int* dstOffsets, Int* srcOffsets)
@@ -360,227 +312,207 @@ Void TComSampleAdaptiveOffset::reconstructBlkSAOParams(TComPic* pic, SAOBlkParam
 }
 
 
-Void TComSampleAdaptiveOffset::offsetBlock(ComponentID compIdx, Int typeIdx, Int* offset  
-                                          , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
-                                          , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
+static inline Int getSign(Int x)
+{
+  return (x > 0) - (x < 0);
+}
+
+/** edge classes of a line of samples
+ * Along the horizontal direction (dy = 0, dx = 1), the sign towards the right neighbour of a sample is reused for the
+ * next sample. Along the other directions (dy = 1), the signs towards nbrA are read from signUp, filled by the
+ * previous line, and those of the next line are written to signDown.
+ */
+static inline Void getEdgeClassLine(const Pel* srcLine, Int srcStride, Int width, Int dx, Int dy, const Char* signUp, Char* signDown, UChar* edgeClass)
+{
+  if (dy == 0)
+  {
+    Int signLeft = getSign(srcLine[0] - srcLine[-1]);
+    for (Int x=0; x< width; x++)
+    {
+      const Int signRight = getSign(srcLine[x] - srcLine[x+1]);
+      edgeClass[x] = (UChar)(signLeft + signRight + 2);
+      signLeft     = -signRight;
+    }
+  }
+  else
+  {
+    const Pel* srcLineBelow = srcLine + srcStride;
+    for (Int x=0; x< width; x++)
+    {
+      const Int signBelow = getSign(srcLine[x] - srcLineBelow[x+dx]);
+      edgeClass[x]    = (UChar)(signUp[x] + signBelow + 2);
+      signDown[x+dx]  = (Char)(-signBelow);
+    }
+    if (dx != 0 && width > 0)
+    {
+      // the sample of the next line whose nbrA is not in this line
+      const Int x = (dx > 0) ? 0 : (width - 1);
+      signDown[x] = (Char)getSign(srcLineBelow[x] - srcLine[x-dx]);
+    }
+  }
+}
+
+/** signs towards nbrA of the first line of a block, for the directions with dy = 1
+ */
+static inline Void initEdgeSignLine(const Pel* srcLine, Int srcStride, Int width, Int dx, Char* signUp)
 {
-  if(m_lineBufWidth != m_maxCUWidth)
+  const Pel* srcLineAbove = srcLine - srcStride;
+  for (Int x=0; x< width; x++)
   {
-    m_lineBufWidth = m_maxCUWidth;
-    
-    if (m_signLineBuf1) delete[] m_signLineBuf1; m_signLineBuf1 = NULL;
-    m_signLineBuf1 = new Char[m_lineBufWidth+1];
-    
-    if (m_signLineBuf2) delete[] m_signLineBuf2; m_signLineBuf2 = NULL;
-    m_signLineBuf2 = new Char[m_lineBufWidth+1];
+    signUp[x] = (Char)getSign(srcLine[x] - srcLineAbove[x-dx]);
   }
+}
 
-  Int* offsetClip = m_offsetClip[compIdx];
+Void TComSampleAdaptiveOffset::offsetEOBlk(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int dx, Int dy, const Int* offset, Int maxVal)
+{
+  assert(width <= MAX_CU_SIZE);
+  Char signBuf[2][MAX_CU_SIZE+2];
+  UChar edgeClass[MAX_CU_SIZE];
+  Char* signUp   = signBuf[0] + 1;
+  Char* signDown = signBuf[1] + 1;
 
-  Int x,y, startX, startY, endX, endY, edgeType;
-  Int firstLineStartX, firstLineEndX, lastLineStartX, lastLineEndX;
-  Char signLeft, signRight, signDown;
+  if (dy != 0)
+  {
+    initEdgeSignLine(srcBlk, srcStride, width, dx, signUp);
+  }
+  for (Int y=0; y< height; y++)
+  {
+    getEdgeClassLine(srcBlk, srcStride, width, dx, dy, signUp, signDown, edgeClass);
+    for (Int x=0; x< width; x++)
+    {
+      resBlk[x] = Clip3<Int>(0, maxVal, srcBlk[x] + offset[edgeClass[x]]);
+    }
+    std::swap(signUp, signDown);
+    srcBlk += srcStride;
+    resBlk += resStride;
+  }
+}
+
+Void TComSampleAdaptiveOffset::offsetBOBlk(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, Int maxVal)
+{
+  for (Int y=0; y< height; y++)
+  {
+    for (Int x=0; x< width; x++)
+    {
+      resBlk[x] = Clip3<Int>(0, maxVal, srcBlk[x] + offset[srcBlk[x] >> shiftBits]);
+    }
+    srcBlk += srcStride;
+    resBlk += resStride;
+  }
+}
+
+Void TComSampleAdaptiveOffset::statsEOBlk(const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int dx, Int dy, Int64* diff, Int64* count)
+{
+  assert(width <= MAX_CU_SIZE);
+  Char signBuf[2][MAX_CU_SIZE+2];
+  UChar edgeClass[MAX_CU_SIZE];
+  Char* signUp   = signBuf[0] + 1;
+  Char* signDown = signBuf[1] + 1;
+
+  if (dy != 0)
+  {
+    initEdgeSignLine(srcBlk, srcStride, width, dx, signUp);
+  }
+  for (Int y=0; y< height; y++)
+  {
+    getEdgeClassLine(srcBlk, srcStride, width, dx, dy, signUp, signDown, edgeClass);
+    for (Int x=0; x< width; x++)
+    {
+      diff [edgeClass[x]] += (orgBlk[x] - srcBlk[x]);
+      count[edgeClass[x]] ++;
+    }
+    std::swap(signUp, signDown);
+    srcBlk += srcStride;
+    orgBlk += orgStride;
+  }
+}
+
+Void TComSampleAdaptiveOffset::statsBOBlk(const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int shiftBits, Int64* diff, Int64* count)
+{
+  for (Int y=0; y< height; y++)
+  {
+    for (Int x=0; x< width; x++)
+    {
+      const Int bandIdx = srcBlk[x] >> shiftBits;
+      diff [bandIdx] += (orgBlk[x] - srcBlk[x]);
+      count[bandIdx] ++;
+    }
+    srcBlk += srcStride;
+    orgBlk += orgStride;
+  }
+}
 
-  Pel* srcLine = srcBlk;
-  Pel* resLine = resBlk;
+/** apply the offsets of a block
+ * Samples whose neighbours are not available keep their value. The first and last lines of the diagonal classes have
+ * their own ranges, as they depend on the availability of the corner neighbours.
+ */
+Void TComSampleAdaptiveOffset::offsetBlock(ComponentID compIdx, Int typeIdx, Int* offset  
+                                          , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
+                                          , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
+{
+  const Int maxVal = (1 << g_bitDepth[toChannelType(compIdx)]) - 1;
+
+  Int startX, startY, endX, endY;
+  Int firstLineStartX, firstLineEndX, lastLineStartX, lastLineEndX;
 
   switch(typeIdx)
   {
   case SAO_TYPE_EO_0:
     {
-      offset += 2;
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
-      for (y=0; y< height; y++)
-      {
-        signLeft = (Char)m_sign[srcLine[startX] - srcLine[startX-1]];
-        for (x=startX; x< endX; x++)
-        {
-          signRight = (Char)m_sign[srcLine[x] - srcLine[x+1]]; 
-          edgeType =  signRight + signLeft;
-          signLeft  = -signRight;
-
-          resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-        }
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
-
+      m_offsetEOBlk(srcBlk + startX, resBlk + startX, srcStride, resStride, endX - startX, height, 1, 0, offset, maxVal);
     }
     break;
   case SAO_TYPE_EO_90:
     {
-      offset += 2;
-      Char *signUpLine = m_signLineBuf1;
-
       startY = isAboveAvail ? 0 : 1;
       endY   = isBelowAvail ? height : height-1;
-      if (!isAboveAvail)
-      {
-        srcLine += srcStride;
-        resLine += resStride;
-      }
-
-      Pel* srcLineAbove= srcLine- srcStride;
-      for (x=0; x< width; x++)
-      {
-        signUpLine[x] = (Char)m_sign[srcLine[x] - srcLineAbove[x]];
-      }
-
-      Pel* srcLineBelow;
-      for (y=startY; y<endY; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=0; x< width; x++)
-        {
-          signDown  = (Char)m_sign[srcLine[x] - srcLineBelow[x]]; 
-          edgeType = signDown + signUpLine[x];
-          signUpLine[x]= -signDown;
-
-          resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-        }
-        srcLine += srcStride;
-        resLine += resStride;
-      }
-
+      m_offsetEOBlk(srcBlk + startY*srcStride, resBlk + startY*resStride, srcStride, resStride, width, endY - startY, 0, 1, offset, maxVal);
     }
     break;
   case SAO_TYPE_EO_135:
     {
-      offset += 2;
-      Char *signUpLine, *signDownLine, *signTmpLine;
-
-      signUpLine  = m_signLineBuf1;
-      signDownLine= m_signLineBuf2;
-
       startX = isLeftAvail ? 0 : 1 ;
       endX   = isRightAvail ? width : (width-1);
 
-      //prepare 2nd line's upper sign
-      Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX; x< endX+1; x++)
-      {
-        signUpLine[x] = (Char)m_sign[srcLineBelow[x] - srcLine[x- 1]];
-      }
-
       //1st line
-      Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveLeftAvail ? 0 : 1;
       firstLineEndX   = isAboveAvail? endX: 1;
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType  =  m_sign[srcLine[x] - srcLineAbove[x- 1]] - signUpLine[x+1];
-        resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-      }
-      srcLine  += srcStride;
-      resLine  += resStride;
-
+      m_offsetEOBlk(srcBlk + firstLineStartX, resBlk + firstLineStartX, srcStride, resStride, firstLineEndX - firstLineStartX, 1, 1, 1, offset, maxVal);
 
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for (x=startX; x<endX; x++)
-        {
-          signDown =  (Char)m_sign[srcLine[x] - srcLineBelow[x+ 1]] ;
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-
-          signDownLine[x+1] = -signDown; 
-        }
-        signDownLine[startX] = (Char)m_sign[srcLineBelow[startX] - srcLine[startX-1]];
-
-        signTmpLine  = signUpLine;
-        signUpLine   = signDownLine;
-        signDownLine = signTmpLine;
-
-        srcLine += srcStride;
-        resLine += resStride;
-      }
+      m_offsetEOBlk(srcBlk + srcStride + startX, resBlk + resStride + startX, srcStride, resStride, endX - startX, height - 2, 1, 1, offset, maxVal);
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowAvail ? startX : (width -1);
       lastLineEndX   = isBelowRightAvail ? width : (width -1);
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType =  m_sign[srcLine[x] - srcLineBelow[x+ 1]] + signUpLine[x];
-        resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-
-      }
+      m_offsetEOBlk(srcBlk + (height-1)*srcStride + lastLineStartX, resBlk + (height-1)*resStride + lastLineStartX, srcStride, resStride, lastLineEndX - lastLineStartX, 1, 1, 1, offset, maxVal);
     }
     break;
   case SAO_TYPE_EO_45:
     {
-      offset += 2;
-      Char *signUpLine = m_signLineBuf1+1;
-
       startX = isLeftAvail ? 0 : 1;
       endX   = isRightAvail ? width : (width -1);
 
-      //prepare 2nd line upper sign
-      Pel* srcLineBelow= srcLine+ srcStride;
-      for (x=startX-1; x< endX; x++)
-      {
-        signUpLine[x] = (Char)m_sign[srcLineBelow[x] - srcLine[x+1]];
-      }
-
-
       //first line
-      Pel* srcLineAbove= srcLine- srcStride;
       firstLineStartX = isAboveAvail ? startX : (width -1 );
       firstLineEndX   = isAboveRightAvail ? width : (width-1);
-      for(x= firstLineStartX; x< firstLineEndX; x++)
-      {
-        edgeType = m_sign[srcLine[x] - srcLineAbove[x+1]] -signUpLine[x-1];
-        resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-      }
-      srcLine += srcStride;
-      resLine += resStride;
+      m_offsetEOBlk(srcBlk + firstLineStartX, resBlk + firstLineStartX, srcStride, resStride, firstLineEndX - firstLineStartX, 1, -1, 1, offset, maxVal);
 
       //middle lines
-      for (y= 1; y< height-1; y++)
-      {
-        srcLineBelow= srcLine+ srcStride;
-
-        for(x= startX; x< endX; x++)
-        {
-          signDown =  (Char)m_sign[srcLine[x] - srcLineBelow[x-1]] ;
-          edgeType =  signDown + signUpLine[x];
-          resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-          signUpLine[x-1] = -signDown; 
-        }
-        signUpLine[endX-1] = (Char)m_sign[srcLineBelow[endX-1] - srcLine[endX]];
-        srcLine  += srcStride;
-        resLine += resStride;
-      }
+      m_offsetEOBlk(srcBlk + srcStride + startX, resBlk + resStride + startX, srcStride, resStride, endX - startX, height - 2, -1, 1, offset, maxVal);
 
       //last line
-      srcLineBelow= srcLine+ srcStride;
       lastLineStartX = isBelowLeftAvail ? 0 : 1;
       lastLineEndX   = isBelowAvail ? endX : 1;
-      for(x= lastLineStartX; x< lastLineEndX; x++)
-      {
-        edgeType = m_sign[srcLine[x] - srcLineBelow[x-1]] + signUpLine[x];
-        resLine[x] = offsetClip[srcLine[x] + offset[edgeType]];
-
-      }
+      m_offsetEOBlk(srcBlk + (height-1)*srcStride + lastLineStartX, resBlk + (height-1)*resStride + lastLineStartX, srcStride, resStride, lastLineEndX - lastLineStartX, 1, -1, 1, offset, maxVal);
     }
     break;
   case SAO_TYPE_BO:
     {
       Int shiftBits = g_bitDepth[toChannelType(compIdx)] - NUM_SAO_BO_CLASSES_LOG2;
-      for (y=0; y< height; y++)
-      {
-        for (x=0; x< width; x++)
-        {
-          resLine[x] = offsetClip[ srcLine[x] + offset[srcLine[x] >> shiftBits] ];
-        }
-        srcLine += srcStride;
-        resLine += resStride;
-      }
+      m_offsetBOBlk(srcBlk, resBlk, srcStride, resStride, width, height, shiftBits, offset, maxVal);
     }
     break;
   default:
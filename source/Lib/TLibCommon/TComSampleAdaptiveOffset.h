@@ -40,6 +40,7 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#include "TComSIMD.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -55,11 +56,18 @@
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
-extern UInt g_saoMaxOffsetQVal[MAX_NUM_COMPONENT]; 
 
 class TComSampleAdaptiveOffset
 {
 public:
+  // Block kernels, shared by the application of the offsets and the encoder statistics. The edge class of a sample
+  // is sign(cur - nbrA) + sign(cur - nbrB) + 2, with the neighbours nbrA at (-dx,-dy) and nbrB at (dx,dy) from the
+  // sample. The offsets, differences and counts are indexed by edge class or band.
+  typedef Void (*OffsetEOFunc)(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int dx, Int dy, const Int* offset, Int maxVal);
+  typedef Void (*OffsetBOFunc)(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, Int maxVal);
+  typedef Void (*StatsEOFunc) (const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int dx, Int dy, Int64* diff, Int64* count);
+  typedef Void (*StatsBOFunc) (const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int shiftBits, Int64* diff, Int64* count);
+
   TComSampleAdaptiveOffset();
   virtual ~TComSampleAdaptiveOffset();
   Void SAOProcess(TComPic* pDecPic);
@@ -77,10 +85,26 @@ protected:
   Void xPCMRestoration(TComPic* pcPic);
   Void xPCMCURestoration ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth );
   Void xPCMSampleRestoration (TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, ComponentID component);
+
+  static Void offsetEOBlk(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int dx, Int dy, const Int* offset, Int maxVal);
+  static Void offsetBOBlk(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, Int maxVal);
+  static Void statsEOBlk (const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int dx, Int dy, Int64* diff, Int64* count);
+  static Void statsBOBlk (const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int shiftBits, Int64* diff, Int64* count);
+#if SIMD_X86
+  // SSE4.1 kernels (TComSampleAdaptiveOffsetSIMD.cpp), 8 samples at a time. The band statistics remain plain C: a
+  // 32-bin histogram does not vectorise.
+  Void initSIMD(SIMDExtension ext);
+
+  static Void offsetEOBlk_SSE41(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int dx, Int dy, const Int* offset, Int maxVal);
+  static Void offsetBOBlk_SSE41(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, Int maxVal);
+  static Void statsEOBlk_SSE41 (const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int dx, Int dy, Int64* diff, Int64* count);
+#endif
 protected:
   UInt m_offsetStepLog2[MAX_NUM_COMPONENT]; //offset step  
-  Int* m_offsetClip[MAX_NUM_COMPONENT]; //clip table for fast operation
-  Short* m_sign; //sign table for fast operation
+  OffsetEOFunc m_offsetEOBlk; //kernels
+  OffsetBOFunc m_offsetBOBlk;
+  StatsEOFunc  m_statsEOBlk;
+  StatsBOFunc  m_statsBOBlk;
   TComPicYuv*   m_tempPicYuv; //temporary buffer
   Int m_picWidth;
   Int m_picHeight;
@@ -90,15 +114,9 @@ protected:
   Int m_numCTUInHeight;
   Int m_numCTUsPic;
   
-  
-  Int m_lineBufWidth;
-  Char* m_signLineBuf1;
-  Char* m_signLineBuf2;
   ChromaFormat m_chromaFormatIDC;
 private:
   Bool m_picSAOEnabled[MAX_NUM_COMPONENT];
-  Int*   m_offsetClipTable[MAX_NUM_COMPONENT];
-  Short* m_signTable;
 };
 #else
 
@@ -0,0 +1,235 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComSampleAdaptiveOffsetSIMD.cpp
+    \brief    SSE4.1 kernels of the sample adaptive offset class
+    \note     The edge classes of 8 samples are derived with packed compares and shared by the application of the
+              offsets and the encoder statistics. Offsets are looked up with byte shuffles of tables of 16-bit
+              offsets. The columns left over at the right of a block use the plain C kernels.
+*/
+
+#include "TComSampleAdaptiveOffset.h"
+
+#if HM_CLEANUP_SAO && SIMD_X86
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+/** edge classes of 8 samples, sign(cur - nbrA) + sign(cur - nbrB) + 2
+ */
+static inline SIMD_TARGET_SSE41 __m128i getEdgeClass8(const Pel* cur, Int nbrA, Int nbrB)
+{
+  const __m128i c = _mm_loadu_si128((const __m128i*)cur);
+  const __m128i a = _mm_loadu_si128((const __m128i*)(cur + nbrA));
+  const __m128i b = _mm_loadu_si128((const __m128i*)(cur + nbrB));
+
+  const __m128i signA = _mm_sub_epi16(_mm_cmpgt_epi16(a, c), _mm_cmpgt_epi16(c, a));
+  const __m128i signB = _mm_sub_epi16(_mm_cmpgt_epi16(b, c), _mm_cmpgt_epi16(c, b));
+  return _mm_add_epi16(_mm_add_epi16(signA, signB), _mm_set1_epi16(2));
+}
+
+/** shuffle control selecting the 16-bit entries idx (0 to 7) of a table
+ */
+static inline SIMD_TARGET_SSE41 __m128i getLookupControl(__m128i idx)
+{
+  return _mm_add_epi16(_mm_mullo_epi16(idx, _mm_set1_epi16(0x0202)), _mm_set1_epi16(0x0100));
+}
+
+static inline SIMD_TARGET_SSE41 __m128i applyOffset(__m128i src, __m128i offset, __m128i maxVal)
+{
+  return _mm_min_epi16(_mm_max_epi16(_mm_adds_epi16(src, offset), _mm_setzero_si128()), maxVal);
+}
+
+/// sum of the two 64-bit lanes
+static inline SIMD_TARGET_SSE41 Int64 getSum64(__m128i v)
+{
+  return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+/// 4 32-bit lanes added to 2 64-bit lanes
+static inline SIMD_TARGET_SSE41 __m128i addTo64(__m128i acc, __m128i v)
+{
+  return _mm_add_epi64(acc, _mm_add_epi64(_mm_cvtepi32_epi64(v), _mm_cvtepi32_epi64(_mm_srli_si128(v, 8))));
+}
+
+Void SIMD_TARGET_SSE41 TComSampleAdaptiveOffset::offsetEOBlk_SSE41(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int dx, Int dy, const Int* offset, Int maxVal)
+{
+  const Int     nbrB    = dy * srcStride + dx;
+  const Int     nbrA    = -nbrB;
+  const Int     width8  = (width > 0) ? (width & ~7) : 0;
+  const __m128i table   = _mm_setr_epi16(Short(offset[0]), Short(offset[1]), Short(offset[2]), Short(offset[3]), Short(offset[4]), 0, 0, 0);
+  const __m128i maxVec  = _mm_set1_epi16(Short(maxVal));
+
+  const Pel* srcLine = srcBlk;
+  Pel*       resLine = resBlk;
+  for (Int y=0; y< height; y++)
+  {
+    for (Int x=0; x< width8; x+=8)
+    {
+      const __m128i src = _mm_loadu_si128((const __m128i*)(srcLine + x));
+      const __m128i off = _mm_shuffle_epi8(table, getLookupControl(getEdgeClass8(srcLine + x, nbrA, nbrB)));
+      _mm_storeu_si128((__m128i*)(resLine + x), applyOffset(src, off, maxVec));
+    }
+    srcLine += srcStride;
+    resLine += resStride;
+  }
+
+  if (width8 < width)
+  {
+    offsetEOBlk(srcBlk + width8, resBlk + width8, srcStride, resStride, width - width8, height, dx, dy, offset, maxVal);
+  }
+}
+
+Void SIMD_TARGET_SSE41 TComSampleAdaptiveOffset::offsetBOBlk_SSE41(const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height, Int shiftBits, const Int* offset, Int maxVal)
+{
+  const Int     width8  = (width > 0) ? (width & ~7) : 0;
+  const __m128i maxVec  = _mm_set1_epi16(Short(maxVal));
+  const __m128i shift   = _mm_cvtsi32_si128(shiftBits);
+  const __m128i seven   = _mm_set1_epi16(7);
+  const __m128i eight   = _mm_set1_epi16(8);
+  const __m128i sixteen = _mm_set1_epi16(16);
+
+  // the 32 band offsets, 8 per table
+  __m128i table[NUM_SAO_BO_CLASSES / 8];
+  for (Int i=0; i< NUM_SAO_BO_CLASSES / 8; i++)
+  {
+    const Int* o = offset + 8*i;
+    table[i] = _mm_setr_epi16(Short(o[0]), Short(o[1]), Short(o[2]), Short(o[3]), Short(o[4]), Short(o[5]), Short(o[6]), Short(o[7]));
+  }
+
+  const Pel* srcLine = srcBlk;
+  Pel*       resLine = resBlk;
+  for (Int y=0; y< height; y++)
+  {
+    for (Int x=0; x< width8; x+=8)
+    {
+      const __m128i src     = _mm_loadu_si128((const __m128i*)(srcLine + x));
+      const __m128i band    = _mm_srl_epi16(src, shift);
+      const __m128i control = getLookupControl(_mm_and_si128(band, seven));
+      const __m128i bit3    = _mm_cmpeq_epi16(_mm_and_si128(band, eight), eight);
+      const __m128i off01   = _mm_blendv_epi8(_mm_shuffle_epi8(table[0], control), _mm_shuffle_epi8(table[1], control), bit3);
+      const __m128i off23   = _mm_blendv_epi8(_mm_shuffle_epi8(table[2], control), _mm_shuffle_epi8(table[3], control), bit3);
+      const __m128i off     = _mm_blendv_epi8(off01, off23, _mm_cmpeq_epi16(_mm_and_si128(band, sixteen), sixteen));
+      _mm_storeu_si128((__m128i*)(resLine + x), applyOffset(src, off, maxVec));
+    }
+    srcLine += srcStride;
+    resLine += resStride;
+  }
+
+  if (width8 < width)
+  {
+    offsetBOBlk(srcBlk + width8, resBlk + width8, srcStride, resStride, width - width8, height, shiftBits, offset, maxVal);
+  }
+}
+
+Void SIMD_TARGET_SSE41 TComSampleAdaptiveOffset::statsEOBlk_SSE41(const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Int dx, Int dy, Int64* diff, Int64* count)
+{
+  static const Int numClasses = NUM_SAO_EO_CLASSES;
+
+  const Int     nbrB   = dy * srcStride + dx;
+  const Int     nbrA   = -nbrB;
+  const Int     width8 = (width > 0) ? (width & ~7) : 0;
+  const __m128i ones   = _mm_set1_epi16(1);
+
+  // per row, the counts are gathered in 16-bit lanes and the differences in 32-bit lanes, then added to 64-bit lanes
+  __m128i diffSum [numClasses];
+  __m128i countSum[numClasses];
+  for (Int k=0; k< numClasses; k++)
+  {
+    diffSum [k] = _mm_setzero_si128();
+    countSum[k] = _mm_setzero_si128();
+  }
+
+  const Pel* srcLine = srcBlk;
+  const Pel* orgLine = orgBlk;
+  for (Int y=0; y< height && width8 > 0; y++)
+  {
+    __m128i diffRow [numClasses];
+    __m128i countRow[numClasses];
+    for (Int k=0; k< numClasses; k++)
+    {
+      diffRow [k] = _mm_setzero_si128();
+      countRow[k] = _mm_setzero_si128();
+    }
+
+    for (Int x=0; x< width8; x+=8)
+    {
+      const __m128i edgeClass = getEdgeClass8(srcLine + x, nbrA, nbrB);
+      const __m128i d         = _mm_sub_epi16(_mm_loadu_si128((const __m128i*)(orgLine + x)), _mm_loadu_si128((const __m128i*)(srcLine + x)));
+      for (Int k=0; k< numClasses; k++)
+      {
+        const __m128i mask = _mm_cmpeq_epi16(edgeClass, _mm_set1_epi16(Short(k)));
+        countRow[k] = _mm_sub_epi16(countRow[k], mask);
+        diffRow [k] = _mm_add_epi32(diffRow[k], _mm_madd_epi16(_mm_and_si128(mask, d), ones));
+      }
+    }
+
+    for (Int k=0; k< numClasses; k++)
+    {
+      diffSum [k] = addTo64(diffSum [k], diffRow[k]);
+      countSum[k] = addTo64(countSum[k], _mm_madd_epi16(countRow[k], ones));
+    }
+    srcLine += srcStride;
+    orgLine += orgStride;
+  }
+
+  for (Int k=0; k< numClasses; k++)
+  {
+    diff [k] += getSum64(diffSum [k]);
+    count[k] += getSum64(countSum[k]);
+  }
+
+  if (width8 < width)
+  {
+    statsEOBlk(srcBlk + width8, orgBlk + width8, srcStride, orgStride, width - width8, height, dx, dy, diff, count);
+  }
+}
+
+/** replace the plain C kernels with the SIMD kernels available for ext
+ * \param ext  SIMD extension supported by the CPU
+ */
+Void TComSampleAdaptiveOffset::initSIMD(SIMDExtension ext)
+{
+  if (ext >= SIMD_SSE41)
+  {
+    m_offsetEOBlk = offsetEOBlk_SSE41;
+    m_offsetBOBlk = offsetBOBlk_SSE41;
+    m_statsEOBlk  = statsEOBlk_SSE41;
+  }
+}
+
+//! \}
+
+#endif // HM_CLEANUP_SAO && SIMD_X86
@@ -750,7 +750,7 @@ Void TComSlice::copySliceInfo(TComSlice *pSrc)
 }
 
 
-Int TComSlice::m_prevTid0POC = 0;
+thread_local Int TComSlice::m_prevTid0POC = 0;
 
 /** Function for setting the slice's temporal layer ID and corresponding temporal_layer_switching_point_flag.
  * \param uiTLayer Temporal layer ID of the current slice
@@ -1188,7 +1188,7 @@ private:
   Int         m_iLastIDR;
   Int         m_iAssociatedIRAP;
   NalUnitType m_iAssociatedIRAPType;
-  static Int  m_prevTid0POC;
+  static thread_local Int m_prevTid0POC; ///< per thread, so that encoders running on separate threads do not interfere
   TComReferencePictureSet *m_pcRPS;
   TComReferencePictureSet m_LocalRPS;
   Int         m_iBDidx; 
@@ -0,0 +1,359 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    work-stealing thread pool and task graph
+*/
+
+#include "TComThreadPool.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// TComTaskGraph
+// ====================================================================================================================
+
+TComTaskGraph::TComTaskGraph()
+: m_iNumUnfinished( 0 )
+{
+}
+
+/** \param cTask  task body
+ * \returns index of the task
+ */
+Int TComTaskGraph::addTask( const Task& cTask )
+{
+  m_acNodes.emplace_back();
+  Node& rcNode = m_acNodes.back();
+  rcNode.cRun              = cTask;
+  rcNode.iNumPrerequisites = 0;
+  rcNode.iPending          = 0;
+  return (Int)m_acNodes.size() - 1;
+}
+
+/** A task can only wait for one that has been added before it, which keeps the graph free of cycles.
+ * \param iTask          index of the waiting task
+ * \param iPrerequisite  index of the task to be waited for
+ */
+Void TComTaskGraph::addDependency( Int iTask, Int iPrerequisite )
+{
+  assert( iPrerequisite >= 0 && iPrerequisite < iTask && iTask < getNumTasks() );
+  m_acNodes[iPrerequisite].aiSuccessors.push_back( iTask );
+  m_acNodes[iTask].iNumPrerequisites++;
+}
+
+// ====================================================================================================================
+// TComThreadPool
+// ====================================================================================================================
+
+TComThreadPool::TComThreadPool()
+: m_pcGraph     ( NULL )
+, m_pcRomContext( NULL )
+, m_iNumReady   ( 0 )
+, m_iNumSleeping( 0 )
+, m_bExit       ( false )
+{
+  m_apcWorkers.push_back( new Worker );
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+  delete m_apcWorkers[0];
+}
+
+/** \param iNumThreads  number of workers, including the thread that calls run()
+ */
+Void TComThreadPool::create( Int iNumThreads )
+{
+  assert( m_acThreads.empty() );
+
+  for (Int i = 1; i < iNumThreads; i++)
+  {
+    m_apcWorkers.push_back( new Worker );
+  }
+  for (Int i = 1; i < iNumThreads; i++)
+  {
+    m_acThreads.push_back( std::thread( &TComThreadPool::xWorkerThread, this, i ) );
+  }
+}
+
+Void TComThreadPool::destroy()
+{
+  {
+    std::lock_guard<std::mutex> cLock( m_cMutex );
+    m_bExit = true;
+  }
+  m_cWakeUp.notify_all();
+  for (size_t i = 0; i < m_acThreads.size(); i++)
+  {
+    m_acThreads[i].join();
+  }
+  m_acThreads.clear();
+  m_bExit = false;
+
+  for (size_t i = 1; i < m_apcWorkers.size(); i++)
+  {
+    delete m_apcWorkers[i];
+  }
+  m_apcWorkers.resize( 1 );
+}
+
+/** The tasks without prerequisites are handed to worker 0 in the order they were added, and every other task to the
+ * worker that finishes its last prerequisite, which then runs it next unless it is stolen.
+ * \param rcGraph  task graph
+ */
+Void TComThreadPool::run( TComTaskGraph& rcGraph )
+{
+  std::lock_guard<std::mutex> cRunLock( m_cRunMutex );
+  const Int iNumTasks = rcGraph.getNumTasks();
+
+  if ( iNumTasks == 0 )
+  {
+    return;
+  }
+
+  // the workers may still be on their way to sleep after the previous graph; the deques are reset once they are
+  {
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    while ( m_iNumSleeping < (Int)m_acThreads.size() )
+    {
+      m_cAsleep.wait( cLock );
+    }
+  }
+
+  m_pcGraph      = &rcGraph;
+  m_pcRomContext = g_pcRomContext;
+  for (size_t i = 0; i < m_apcWorkers.size(); i++)
+  {
+    Worker* pcWorker = m_apcWorkers[i];
+    if ( pcWorker->iCapacity < iNumTasks )
+    {
+      delete[] pcWorker->piTasks;
+      pcWorker->piTasks   = new std::atomic<Int>[iNumTasks];
+      pcWorker->iCapacity = iNumTasks;
+    }
+    pcWorker->iTop    = 0;
+    pcWorker->iBottom = 0;
+  }
+  for (Int i = 0; i < iNumTasks; i++)
+  {
+    rcGraph.m_acNodes[i].iPending = rcGraph.m_acNodes[i].iNumPrerequisites;
+  }
+  rcGraph.m_iNumUnfinished = iNumTasks;
+
+  // pushed in reverse order, so that worker 0 takes the first one and the other workers steal the last ones
+  for (Int i = iNumTasks-1; i >= 0; i--)
+  {
+    if ( rcGraph.m_acNodes[i].iNumPrerequisites == 0 )
+    {
+      xPush( 0, i );
+    }
+  }
+
+  while ( rcGraph.m_iNumUnfinished > 0 )
+  {
+    const Int iTask = xGetTask( 0 );
+    if ( iTask >= 0 )
+    {
+      xRunTask( 0, iTask );
+      continue;
+    }
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    m_iNumSleeping++;
+    while ( m_iNumReady <= 0 && rcGraph.m_iNumUnfinished > 0 )
+    {
+      m_cWakeUp.wait( cLock );
+    }
+    m_iNumSleeping--;
+  }
+  m_pcGraph = NULL;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Push a ready task to the bottom of the deque of a worker; only called by the owner of the deque.
+ * \param iWorkerIdx  worker index
+ * \param iTask       task index
+ */
+Void TComThreadPool::xPush( Int iWorkerIdx, Int iTask )
+{
+  Worker*   pcWorker = m_apcWorkers[iWorkerIdx];
+  const Int iBottom  = pcWorker->iBottom;
+
+  pcWorker->piTasks[iBottom] = iTask;
+  pcWorker->iBottom          = iBottom + 1;
+  m_iNumReady++;
+
+  if ( m_iNumSleeping > 0 )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+    }
+    m_cWakeUp.notify_one();
+  }
+}
+
+/** Take the task pushed last from the deque of a worker; only called by the owner of the deque.
+ * \param iWorkerIdx  worker index
+ * \returns task index, or -1 if the deque is empty or its last task has been stolen meanwhile
+ */
+Int TComThreadPool::xPop( Int iWorkerIdx )
+{
+  Worker*   pcWorker = m_apcWorkers[iWorkerIdx];
+  const Int iBottom  = pcWorker->iBottom - 1;
+
+  pcWorker->iBottom = iBottom;
+  Int iTop = pcWorker->iTop;
+  if ( iTop > iBottom )
+  {
+    pcWorker->iBottom = iBottom + 1;
+    return -1;
+  }
+
+  Int iTask = pcWorker->piTasks[iBottom];
+  if ( iTop == iBottom )
+  {
+    // the last task: race the thieves for it
+    if ( !pcWorker->iTop.compare_exchange_strong( iTop, iTop + 1 ) )
+    {
+      iTask = -1;
+    }
+    pcWorker->iBottom = iBottom + 1;
+  }
+  return iTask;
+}
+
+/** Take the task pushed first from the deque of another worker.
+ * \param iWorkerIdx  index of the worker owning the deque
+ * \returns task index, or -1 if the deque is empty or another thread has taken the task meanwhile
+ */
+Int TComThreadPool::xSteal( Int iWorkerIdx )
+{
+  Worker* pcWorker = m_apcWorkers[iWorkerIdx];
+  Int     iTop     = pcWorker->iTop;
+
+  if ( iTop >= pcWorker->iBottom )
+  {
+    return -1;
+  }
+  const Int iTask = pcWorker->piTasks[iTop];
+  if ( !pcWorker->iTop.compare_exchange_strong( iTop, iTop + 1 ) )
+  {
+    return -1;
+  }
+  return iTask;
+}
+
+/** \param iWorkerIdx  worker index
+ * \returns task index taken from the own deque or stolen from another one, or -1 if none is ready
+ */
+Int TComThreadPool::xGetTask( Int iWorkerIdx )
+{
+  const Int iNumWorkers = (Int)m_apcWorkers.size();
+
+  for (Int i = 0; i < iNumWorkers; i++)
+  {
+    const Int iVictim = ( iWorkerIdx + i ) % iNumWorkers;
+    const Int iTask   = iVictim == iWorkerIdx ? xPop( iWorkerIdx ) : xSteal( iVictim );
+    if ( iTask >= 0 )
+    {
+      m_iNumReady--;
+      return iTask;
+    }
+  }
+  return -1;
+}
+
+/** Run a task, then make ready the tasks that were only waiting for it.
+ * \param iWorkerIdx  worker index
+ * \param iTask       task index
+ */
+Void TComThreadPool::xRunTask( Int iWorkerIdx, Int iTask )
+{
+  TComTaskGraph::Node& rcNode = m_pcGraph->m_acNodes[iTask];
+  {
+    TComRomScope cRomScope( m_pcRomContext );
+    rcNode.cRun( iWorkerIdx );
+  }
+
+  for (size_t i = 0; i < rcNode.aiSuccessors.size(); i++)
+  {
+    const Int iSuccessor = rcNode.aiSuccessors[i];
+    if ( --m_pcGraph->m_acNodes[iSuccessor].iPending == 0 )
+    {
+      xPush( iWorkerIdx, iSuccessor );
+    }
+  }
+
+  if ( --m_pcGraph->m_iNumUnfinished == 0 )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+    }
+    m_cWakeUp.notify_all();
+  }
+}
+
+/** \param iWorkerIdx  worker index
+ */
+Void TComThreadPool::xWorkerThread( Int iWorkerIdx )
+{
+  for (;;)
+  {
+    const Int iTask = xGetTask( iWorkerIdx );
+    if ( iTask >= 0 )
+    {
+      xRunTask( iWorkerIdx, iTask );
+      continue;
+    }
+
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    m_iNumSleeping++;
+    m_cAsleep.notify_all();
+    while ( m_iNumReady <= 0 && !m_bExit )
+    {
+      m_cWakeUp.wait( cLock );
+    }
+    m_iNumSleeping--;
+    if ( m_bExit )
+    {
+      return;
+    }
+  }
+}
+
+//! \}
@@ -0,0 +1,152 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    work-stealing thread pool and task graph (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonDef.h"
+#include "TComRom.h"
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// set of tasks and the dependencies between them, e.g. the CTUs of a wavefront, the substreams of a slice or the
+/// planes of a picture; run by TComThreadPool::run
+class TComTaskGraph
+{
+public:
+  typedef std::function<Void( Int iWorkerIdx )> Task;       ///< task body, given the index of the worker running it
+
+private:
+  struct Node
+  {
+    Task                  cRun;
+    std::vector<Int>      aiSuccessors;                     ///< tasks waiting for this one
+    Int                   iNumPrerequisites;                ///< number of tasks this one waits for
+    std::atomic<Int>      iPending;                         ///< prerequisites not yet finished while running
+  };
+
+  std::deque<Node>        m_acNodes;
+  std::atomic<Int>        m_iNumUnfinished;                 ///< tasks not yet finished while running
+
+  friend class TComThreadPool;
+
+public:
+  TComTaskGraph();
+  virtual ~TComTaskGraph() {}
+
+  /// add a task; returns its index, by which dependencies refer to it
+  Int       addTask             ( const Task& cTask );
+  /// let task iTask start only when task iPrerequisite has finished
+  Void      addDependency       ( Int iTask, Int iPrerequisite );
+  Int       getNumTasks         () const                    { return (Int)m_acNodes.size(); }
+  Void      clear               ()                          { m_acNodes.clear(); }
+};
+
+/// pool of worker threads running task graphs. Each worker has a deque of ready tasks: it takes the task it made ready
+/// last from its own deque, and steals the oldest one from another deque when its own is empty. The thread calling
+/// run() is worker 0 until the graph has finished, and the other workers run with the TComRomContext of that thread.
+class TComThreadPool
+{
+private:
+  /// ready tasks of one worker, as a lock-free work-stealing deque (Chase and Lev); its capacity is the number of
+  /// tasks of the graph, since every task is pushed once
+  struct Worker
+  {
+    std::atomic<Int>*     piTasks;
+    Int                   iCapacity;
+    std::atomic<Int>      iTop;                             ///< next task to be stolen
+    std::atomic<Int>      iBottom;                          ///< next free slot of the owner
+
+    Worker() : piTasks( NULL ), iCapacity( 0 ), iTop( 0 ), iBottom( 0 ) {}
+    ~Worker()                                               { delete[] piTasks; }
+  };
+
+  std::vector<Worker*>    m_apcWorkers;                     ///< m_apcWorkers[0] belongs to the thread calling run() and always exists
+  std::vector<std::thread> m_acThreads;                     ///< threads of the workers 1 ... N-1
+  TComTaskGraph*          m_pcGraph;                        ///< graph being run
+  TComRomContext*         m_pcRomContext;                   ///< context of the thread calling run()
+  std::atomic<Int>        m_iNumReady;                      ///< number of tasks in the deques
+  std::atomic<Int>        m_iNumSleeping;                   ///< number of workers waiting for a task
+  Bool                    m_bExit;
+  std::mutex              m_cMutex;                         ///< protects m_bExit and the sleeping of the workers
+  std::condition_variable m_cWakeUp;                        ///< signalled when a task is ready or a graph has finished
+  std::condition_variable m_cAsleep;                        ///< signalled when a worker starts waiting for a task
+  std::mutex              m_cRunMutex;                      ///< one graph at a time
+
+  Void      xPush               ( Int iWorkerIdx, Int iTask );
+  Int       xPop                ( Int iWorkerIdx );
+  Int       xSteal              ( Int iWorkerIdx );
+  Int       xGetTask            ( Int iWorkerIdx );
+  Void      xRunTask            ( Int iWorkerIdx, Int iTask );
+  Void      xWorkerThread       ( Int iWorkerIdx );
+
+public:
+  TComThreadPool();
+  virtual ~TComThreadPool();
+
+  /// start the workers; iNumThreads includes the thread calling run(). A pool that is not created runs every graph
+  /// on that thread alone.
+  Void      create              ( Int iNumThreads );
+  Void      destroy             ();
+
+  /// number of workers; tasks are given an index below this, e.g. to pick per-worker coding tools
+  Int       getNumThreads       () const                    { return (Int)m_apcWorkers.size(); }
+
+  /// run all tasks of the graph and return when they have finished; not to be called from within a task
+  Void      run                 ( TComTaskGraph& rcGraph );
+};
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
@@ -68,6 +68,7 @@ typedef struct
 // ====================================================================================================================
 
 TComTrQuant::TComTrQuant()
+: m_simdExtension( getSIMDExtension() )
 {
   // allocate temporary buffers
   m_plTempCoeff  = new TCoeff[ MAX_CU_SIZE*MAX_CU_SIZE ];
@@ -1919,6 +1920,26 @@ Void TComTrQuant::invRdpcmNxN( TComTU& rTu, const ComponentID compID, Pel* pcRes
 // Logical transform
 // ------------------------------------------------------------------------------------------------
 
+#if SIMD_SELF_CHECK
+/** Compare a block produced with the SIMD transforms against the plain C result and abort on mismatch
+ */
+Void TComTrQuant::xSelfCheck( const Char* name, const TCoeff* pSIMD, const TCoeff* pReference, Int iWidth, Int iHeight )
+{
+  for (Int y = 0; y < iHeight; y++)
+  {
+    for (Int x = 0; x < iWidth; x++)
+    {
+      if (pSIMD[(y * iWidth) + x] != pReference[(y * iWidth) + x])
+      {
+        std::cerr << "ERROR: SIMD self-check failed for " << name << " (" << iWidth << "x" << iHeight << ") at ("
+                  << x << "," << y << "): SIMD=" << pSIMD[(y * iWidth) + x] << " reference=" << pReference[(y * iWidth) + x] << std::endl;
+        exit(1);
+      }
+    }
+  }
+}
+#endif
+
 /** Wrapper function between HM interface and core NxN forward transform (2D)
  *  \param piBlkResi input data (residual)
  *  \param psCoeff output data (transform coefficients)
@@ -1939,6 +1960,17 @@ Void TComTrQuant::xT( const ComponentID compID, Bool useDST, Pel* piBlkResi, UIn
   TCoeff block[ MAX_TU_SIZE * MAX_TU_SIZE ];
   TCoeff coeff[ MAX_TU_SIZE * MAX_TU_SIZE ];
 
+#if SIMD_X86_TARGET
+  // also in builds with RExt__HIGH_BIT_DEPTH_SUPPORT, in which the extended precision dynamic range reaches 22 bits
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    xTrMxNAVX2( g_bitDepth[toChannelType(compID)], piBlkResi, uiStride, psCoeff, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
+#if !SIMD_SELF_CHECK
+    return;
+#endif
+  }
+#endif
+
   for (Int y = 0; y < iHeight; y++)
     for (Int x = 0; x < iWidth; x++)
     {
@@ -1947,6 +1979,14 @@ Void TComTrQuant::xT( const ComponentID compID, Bool useDST, Pel* piBlkResi, UIn
 
   xTrMxN( g_bitDepth[toChannelType(compID)], block, coeff, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
 
+#if SIMD_SELF_CHECK
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    xSelfCheck( "xT", psCoeff, coeff, iWidth, iHeight );
+    return;
+  }
+#endif
+
   memcpy(psCoeff, coeff, (iWidth * iHeight * sizeof(TCoeff)));
 }
 
@@ -1970,10 +2010,35 @@ Void TComTrQuant::xIT( const ComponentID compID, Bool useDST, TCoeff* plCoef, Pe
   TCoeff block[ MAX_TU_SIZE * MAX_TU_SIZE ];
   TCoeff coeff[ MAX_TU_SIZE * MAX_TU_SIZE ];
 
+#if SIMD_X86_TARGET
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    xITrMxNAVX2( g_bitDepth[toChannelType(compID)], plCoef, pResidual, uiStride, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
+#if !SIMD_SELF_CHECK
+    return;
+#endif
+  }
+#endif
+
   memcpy(coeff, plCoef, (iWidth * iHeight * sizeof(TCoeff)));
 
   xITrMxN( g_bitDepth[toChannelType(compID)], coeff, block, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
 
+#if SIMD_SELF_CHECK
+  if ( m_simdExtension >= SIMD_AVX2 )
+  {
+    TCoeff simd[ MAX_TU_SIZE * MAX_TU_SIZE ];
+    for (Int y = 0; y < iHeight; y++)
+      for (Int x = 0; x < iWidth; x++)
+      {
+        simd [(y * iWidth) + x] = pResidual[(y * uiStride) + x];
+        block[(y * iWidth) + x] = Pel(block[(y * iWidth) + x]);
+      }
+    xSelfCheck( "xIT", simd, block, iWidth, iHeight );
+    return;
+  }
+#endif
+
   for (Int y = 0; y < iHeight; y++)
     for (Int x = 0; x < iWidth; x++)
     {
@@ -43,6 +43,7 @@
 #include "TComDataCU.h"
 #include "TComChromaFormat.h"
 #include "ContextTables.h"
+#include "TComSIMD.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -257,6 +258,8 @@ protected:
 
   Bool     m_scalingListEnabledFlag;
 
+  SIMDExtension m_simdExtension; ///< extension used for the AVX2 transforms (SIMD_NONE = plain C only)
+
   Int      *m_quantCoef            [SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
   Int      *m_dequantCoef          [SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of dequantization matrix coefficient 4x4
   Double   *m_errScale             [SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
@@ -264,13 +267,31 @@ protected:
   Double    m_errScaleNoScalingList[SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
 #endif
 
-private:
+  // the transforms are protected, so that the benchmark can check the SIMD kernels against the plain C ones
+
   // forward Transform
   Void xT   ( const ComponentID compID, Bool useDST, Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iWidth, Int iHeight );
 
+  // inverse transform
+  Void xIT    ( const ComponentID compID, Bool useDST, TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight );
+
   // skipping Transform
   Void xTransformSkip ( Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, TComTU &rTu, const ComponentID component );
 
+  // inverse skipping transform
+  Void xITransformSkip ( TCoeff* plCoef, Pel* pResidual, UInt uiStride, TComTU &rTu, const ComponentID component );
+
+private:
+#if SIMD_X86_TARGET
+  // AVX2 transforms (TComTrQuantSIMD.cpp), bit-exact with the partial butterflies used by xT() / xIT(). They are also
+  // built with RExt__HIGH_BIT_DEPTH_SUPPORT, which extended precision above 8 bits needs (dynamic range up to 22 bits).
+  static Void xTrMxNAVX2 ( Int bitDepth, const Pel* piBlkResi, UInt uiStride, TCoeff* psCoeff, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange );
+  static Void xITrMxNAVX2( Int bitDepth, const TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange );
+#endif
+#if SIMD_SELF_CHECK
+  static Void xSelfCheck ( const Char* name, const TCoeff* pSIMD, const TCoeff* pReference, Int iWidth, Int iHeight );
+#endif
+
   Void signBitHidingHDQ( const ComponentID compID, TCoeff* pQCoef, TCoeff* pCoef, TCoeff* deltaU, const TUEntropyCodingParameters &codingParameters );
 
   // quantization
@@ -338,12 +359,6 @@ __inline UInt              xGetCodedLevel  ( Double&                         rd6
                  const ComponentID   compID,
                  const QpParam      &cQP );
 
-  // inverse transform
-  Void xIT    ( const ComponentID compID, Bool useDST, TCoeff* plCoef, Pel* pResidual, UInt uiStride, Int iWidth, Int iHeight );
-
-  // inverse skipping transform
-  Void xITransformSkip ( TCoeff* plCoef, Pel* pResidual, UInt uiStride, TComTU &rTu, const ComponentID component );
-
 #if RDPCM_INTER_LOSSLESS && !RExt__MEETINGNOTES_UNIFIED_RESIDUAL_DPCM
   Void xInterInverseRdpcm( TComTU &rTu, Pel *&residuals, UInt stride, ComponentID compID );
   Void xInterResidueDpcm          ( TComTU      &rTu, 
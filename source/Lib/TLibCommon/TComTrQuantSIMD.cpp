@@ -0,0 +1,507 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComTrQuantSIMD.cpp
+    \brief    AVX2 forward / inverse core transforms for TComTrQuant
+    \note     The 1D transforms are evaluated for 8 (or, when a pass only has 4 lines, 4) lines at once, one line per
+              32-bit lane, using the same even/odd decomposition as the partial butterflies in TComTrQuant.cpp. All
+              arithmetic is done in 32-bit lanes, which wrap in the same way as the 32-bit TCoeff of the C code, so the
+              results are bit-exact with it.
+    \note     With RExt__HIGH_BIT_DEPTH_SUPPORT (32-bit Pel, 64-bit TCoeff, high precision forward matrices), which the
+              extended precision processing of more than 8-bit video requires, 4 lines are evaluated at once, one line
+              per 64-bit lane, so the results are bit-exact with the 64-bit TCoeff of the C code for dynamic ranges up
+              to 22 bits.
+*/
+
+#include <limits>
+#include "TComTrQuant.h"
+
+#if SIMD_X86_TARGET
+
+#include <immintrin.h>
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Local helpers
+// ====================================================================================================================
+
+#if RExt__HIGH_BIT_DEPTH_SUPPORT
+/// operations on 4 lines of 64-bit values held in a 256-bit register. The products take the low 32 bits of each lane
+/// (_mm256_mul_epi32): the factors, residuals, coefficients clipped to the dynamic range and their butterfly sums,
+/// stay within 32 bits for dynamic ranges up to 22 bits.
+struct TrLines4
+{
+  typedef __m256i Vec;
+  static const Int NUM_LINES = 4;
+
+  static inline SIMD_TARGET_AVX2 Vec  set1 ( TCoeff i )               { return _mm256_set1_epi64x( i ); }
+  static inline SIMD_TARGET_AVX2 Vec  add  ( Vec a, Vec b )           { return _mm256_add_epi64( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  sub  ( Vec a, Vec b )           { return _mm256_sub_epi64( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  mul  ( Int c, Vec a )           { return _mm256_mul_epi32( _mm256_set1_epi64x( c ), a ); }
+  /// arithmetic shift, which AVX2 lacks for 64-bit lanes: a logical shift of the one's complement of negative values
+  static inline SIMD_TARGET_AVX2 Vec  sra  ( Vec a, __m128i shift )
+  {
+    const __m256i sign = _mm256_cmpgt_epi64( _mm256_setzero_si256(), a );
+    return _mm256_xor_si256( _mm256_srl_epi64( _mm256_xor_si256( a, sign ), shift ), sign );
+  }
+  static inline SIMD_TARGET_AVX2 Vec  clip ( Vec a, Vec lo, Vec hi )
+  {
+    a = _mm256_blendv_epi8( a, lo, _mm256_cmpgt_epi64( lo, a ) );
+    return _mm256_blendv_epi8( a, hi, _mm256_cmpgt_epi64( a, hi ) );
+  }
+
+  static inline SIMD_TARGET_AVX2 Vec  load ( const TCoeff *p )        { return _mm256_loadu_si256( (const __m256i*)p ); }
+  static inline SIMD_TARGET_AVX2 Void store( TCoeff *p, Vec a )       { _mm256_storeu_si256( (__m256i*)p, a ); }
+
+  /// loads the first iCount (<= NUM_LINES) values of a row
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const TCoeff *p, Int iCount ) { return load( p ); }
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const Pel    *p, Int iCount ) { return _mm256_cvtepi32_epi64( _mm_loadu_si128( (const __m128i*)p ) ); }
+  /// stores the first iCount (<= NUM_LINES) values of a row. Pel stores keep the low 32 bits, values have been clipped before.
+  static inline SIMD_TARGET_AVX2 Void storeRow( TCoeff *p, Vec a, Int iCount ) { store( p, a ); }
+  static inline SIMD_TARGET_AVX2 Void storeRow( Pel    *p, Vec a, Int iCount )
+  {
+    const __m256i packed = _mm256_permutevar8x32_epi32( a, _mm256_setr_epi32( 0, 2, 4, 6, 0, 2, 4, 6 ) );
+    _mm_storeu_si128( (__m128i*)p, _mm256_castsi256_si128( packed ) );
+  }
+
+  static inline SIMD_TARGET_AVX2 Void transpose( Vec *r )
+  {
+    const __m256i t0 = _mm256_unpacklo_epi64( r[0], r[1] );
+    const __m256i t1 = _mm256_unpackhi_epi64( r[0], r[1] );
+    const __m256i t2 = _mm256_unpacklo_epi64( r[2], r[3] );
+    const __m256i t3 = _mm256_unpackhi_epi64( r[2], r[3] );
+    r[0] = _mm256_permute2x128_si256( t0, t2, 0x20 );
+    r[1] = _mm256_permute2x128_si256( t1, t3, 0x20 );
+    r[2] = _mm256_permute2x128_si256( t0, t2, 0x31 );
+    r[3] = _mm256_permute2x128_si256( t1, t3, 0x31 );
+  }
+};
+
+/// widest set of lines, used by the passes with enough lines
+typedef TrLines4 TrLinesWide;
+
+#else
+/// operations on 4 lines held in a 128-bit register
+struct TrLines4
+{
+  typedef __m128i Vec;
+  static const Int NUM_LINES = 4;
+
+  static inline SIMD_TARGET_AVX2 Vec  set1 ( TCoeff i )               { return _mm_set1_epi32( i ); }
+  static inline SIMD_TARGET_AVX2 Vec  add  ( Vec a, Vec b )           { return _mm_add_epi32( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  sub  ( Vec a, Vec b )           { return _mm_sub_epi32( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  mul  ( Int c, Vec a )           { return _mm_mullo_epi32( _mm_set1_epi32( c ), a ); }
+  static inline SIMD_TARGET_AVX2 Vec  sra  ( Vec a, __m128i shift )   { return _mm_sra_epi32( a, shift ); }
+  static inline SIMD_TARGET_AVX2 Vec  clip ( Vec a, Vec lo, Vec hi )  { return _mm_min_epi32( _mm_max_epi32( a, lo ), hi ); }
+
+  static inline SIMD_TARGET_AVX2 Vec  load ( const TCoeff *p )        { return _mm_loadu_si128( (const __m128i*)p ); }
+  static inline SIMD_TARGET_AVX2 Void store( TCoeff *p, Vec a )       { _mm_storeu_si128( (__m128i*)p, a ); }
+
+  /// loads the first iCount (<= NUM_LINES) values of a row
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const TCoeff *p, Int iCount ) { return load( p ); }
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const Pel    *p, Int iCount ) { return _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)p ) ); }
+  /// stores the first iCount (<= NUM_LINES) values of a row. Pel stores saturate, values have been clipped before.
+  static inline SIMD_TARGET_AVX2 Void storeRow( TCoeff *p, Vec a, Int iCount ) { store( p, a ); }
+  static inline SIMD_TARGET_AVX2 Void storeRow( Pel    *p, Vec a, Int iCount ) { _mm_storel_epi64( (__m128i*)p, _mm_packs_epi32( a, a ) ); }
+
+  static inline SIMD_TARGET_AVX2 Void transpose( Vec *r )
+  {
+    const __m128i t0 = _mm_unpacklo_epi32( r[0], r[1] );
+    const __m128i t1 = _mm_unpacklo_epi32( r[2], r[3] );
+    const __m128i t2 = _mm_unpackhi_epi32( r[0], r[1] );
+    const __m128i t3 = _mm_unpackhi_epi32( r[2], r[3] );
+    r[0] = _mm_unpacklo_epi64( t0, t1 );
+    r[1] = _mm_unpackhi_epi64( t0, t1 );
+    r[2] = _mm_unpacklo_epi64( t2, t3 );
+    r[3] = _mm_unpackhi_epi64( t2, t3 );
+  }
+};
+
+/// operations on 8 lines held in a 256-bit register
+struct TrLines8
+{
+  typedef __m256i Vec;
+  static const Int NUM_LINES = 8;
+
+  static inline SIMD_TARGET_AVX2 Vec  set1 ( TCoeff i )               { return _mm256_set1_epi32( i ); }
+  static inline SIMD_TARGET_AVX2 Vec  add  ( Vec a, Vec b )           { return _mm256_add_epi32( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  sub  ( Vec a, Vec b )           { return _mm256_sub_epi32( a, b ); }
+  static inline SIMD_TARGET_AVX2 Vec  mul  ( Int c, Vec a )           { return _mm256_mullo_epi32( _mm256_set1_epi32( c ), a ); }
+  static inline SIMD_TARGET_AVX2 Vec  sra  ( Vec a, __m128i shift )   { return _mm256_sra_epi32( a, shift ); }
+  static inline SIMD_TARGET_AVX2 Vec  clip ( Vec a, Vec lo, Vec hi )  { return _mm256_min_epi32( _mm256_max_epi32( a, lo ), hi ); }
+
+  static inline SIMD_TARGET_AVX2 Vec  load ( const TCoeff *p )        { return _mm256_loadu_si256( (const __m256i*)p ); }
+  static inline SIMD_TARGET_AVX2 Void store( TCoeff *p, Vec a )       { _mm256_storeu_si256( (__m256i*)p, a ); }
+
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const TCoeff *p, Int iCount )
+  {
+    return ( iCount < NUM_LINES ) ? _mm256_inserti128_si256( _mm256_setzero_si256(), _mm_loadu_si128( (const __m128i*)p ), 0 ) : load( p );
+  }
+  static inline SIMD_TARGET_AVX2 Vec  loadRow ( const Pel *p, Int iCount )
+  {
+    return _mm256_cvtepi16_epi32( ( iCount < NUM_LINES ) ? _mm_loadl_epi64( (const __m128i*)p ) : _mm_loadu_si128( (const __m128i*)p ) );
+  }
+  static inline SIMD_TARGET_AVX2 Void storeRow( TCoeff *p, Vec a, Int iCount )
+  {
+    if ( iCount < NUM_LINES )
+    {
+      _mm_storeu_si128( (__m128i*)p, _mm256_castsi256_si128( a ) );
+    }
+    else
+    {
+      store( p, a );
+    }
+  }
+  static inline SIMD_TARGET_AVX2 Void storeRow( Pel *p, Vec a, Int iCount )
+  {
+    const __m128i packed = _mm_packs_epi32( _mm256_castsi256_si128( a ), _mm256_extracti128_si256( a, 1 ) );
+    if ( iCount < NUM_LINES )
+    {
+      _mm_storel_epi64( (__m128i*)p, packed );
+    }
+    else
+    {
+      _mm_storeu_si128( (__m128i*)p, packed );
+    }
+  }
+
+  static inline SIMD_TARGET_AVX2 Void transpose( Vec *r )
+  {
+    __m256i t[8], u[8];
+    for ( Int i = 0; i < 8; i += 2 )
+    {
+      t[i + 0] = _mm256_unpacklo_epi32( r[i], r[i + 1] );
+      t[i + 1] = _mm256_unpackhi_epi32( r[i], r[i + 1] );
+    }
+    for ( Int i = 0; i < 8; i += 4 )
+    {
+      u[i + 0] = _mm256_unpacklo_epi64( t[i + 0], t[i + 2] );
+      u[i + 1] = _mm256_unpackhi_epi64( t[i + 0], t[i + 2] );
+      u[i + 2] = _mm256_unpacklo_epi64( t[i + 1], t[i + 3] );
+      u[i + 3] = _mm256_unpackhi_epi64( t[i + 1], t[i + 3] );
+    }
+    for ( Int i = 0; i < 4; i++ )
+    {
+      r[i + 0] = _mm256_permute2x128_si256( u[i], u[i + 4], 0x20 );
+      r[i + 4] = _mm256_permute2x128_si256( u[i], u[i + 4], 0x31 );
+    }
+  }
+};
+
+/// widest set of lines, used by the passes with enough lines
+typedef TrLines8 TrLinesWide;
+
+#endif // RExt__HIGH_BIT_DEPTH_SUPPORT
+
+/// coefficient matrix of the N-point DCT for the given direction, N x N with a row stride of N
+template<Int N> static inline const TMatrixCoeff* xGetDCTMatrix( TransformDirection dir );
+template<> inline const TMatrixCoeff* xGetDCTMatrix< 4>( TransformDirection dir ) { return &g_aiT4 [dir][0][0]; }
+template<> inline const TMatrixCoeff* xGetDCTMatrix< 8>( TransformDirection dir ) { return &g_aiT8 [dir][0][0]; }
+template<> inline const TMatrixCoeff* xGetDCTMatrix<16>( TransformDirection dir ) { return &g_aiT16[dir][0][0]; }
+template<> inline const TMatrixCoeff* xGetDCTMatrix<32>( TransformDirection dir ) { return &g_aiT32[dir][0][0]; }
+
+/**
+ * \brief Forward N-point DCT / 4-point DST of one vector of lines, without rounding
+ *
+ * Splits x[] into even and odd halves until two values are left, as partialButterfly4 .. 32() do. Overwrites x[].
+ */
+template<class L, Int N, Bool bDST>
+static inline SIMD_TARGET_AVX2 Void xForwardCore( typename L::Vec *x, typename L::Vec *y )
+{
+  typedef typename L::Vec Vec;
+
+  if ( bDST )
+  {
+    const TMatrixCoeff *T = &g_as_DST_MAT_4[TRANSFORM_FORWARD][0][0];
+    for ( Int k = 0; k < 4; k++ )
+    {
+      y[k] = L::add( L::add( L::mul( T[k*4 + 0], x[0] ), L::mul( T[k*4 + 1], x[1] ) ),
+                     L::add( L::mul( T[k*4 + 2], x[2] ), L::mul( T[k*4 + 3], x[3] ) ) );
+    }
+    return;
+  }
+
+  const TMatrixCoeff *T = xGetDCTMatrix<N>( TRANSFORM_FORWARD );
+  Vec odd[N/2];
+
+  // at each level, rows k = step, 3*step, ... are the odd part of the remaining len values
+  for ( Int len = N, step = 1; len > 2; len >>= 1, step <<= 1 )
+  {
+    for ( Int n = 0; n < len/2; n++ )
+    {
+      odd[n] = L::sub( x[n], x[len - 1 - n] );
+      x  [n] = L::add( x[n], x[len - 1 - n] );
+    }
+    for ( Int k = step; k < N; k += 2*step )
+    {
+      Vec sum = L::mul( T[k*N], odd[0] );
+      for ( Int n = 1; n < len/2; n++ )
+      {
+        sum = L::add( sum, L::mul( T[k*N + n], odd[n] ) );
+      }
+      y[k] = sum;
+    }
+  }
+
+  y[0  ] = L::add( L::mul( T[0        ], x[0] ), L::mul( T[1          ], x[1] ) );
+  y[N/2] = L::add( L::mul( T[(N/2)*N  ], x[0] ), L::mul( T[(N/2)*N + 1], x[1] ) );
+}
+
+/**
+ * \brief Inverse N-point DCT / 4-point DST of one vector of lines, without rounding
+ *
+ * Builds the output from the two-value even part upwards, combining it with the odd part of each level, as
+ * partialButterflyInverse4 .. 32() do.
+ */
+template<class L, Int N, Bool bDST>
+static inline SIMD_TARGET_AVX2 Void xInverseCore( const typename L::Vec *x, typename L::Vec *y )
+{
+  typedef typename L::Vec Vec;
+
+  if ( bDST )
+  {
+    const TMatrixCoeff *T = &g_as_DST_MAT_4[TRANSFORM_INVERSE][0][0];
+    for ( Int n = 0; n < 4; n++ )
+    {
+      y[n] = L::add( L::add( L::mul( T[0*4 + n], x[0] ), L::mul( T[1*4 + n], x[1] ) ),
+                     L::add( L::mul( T[2*4 + n], x[2] ), L::mul( T[3*4 + n], x[3] ) ) );
+    }
+    return;
+  }
+
+  const TMatrixCoeff *T = xGetDCTMatrix<N>( TRANSFORM_INVERSE );
+
+  y[0] = L::add( L::mul( T[0], x[0] ), L::mul( T[(N/2)*N    ], x[N/2] ) );
+  y[1] = L::add( L::mul( T[1], x[0] ), L::mul( T[(N/2)*N + 1], x[N/2] ) );
+
+  for ( Int len = 4; len <= N; len <<= 1 )
+  {
+    const Int step = N / len;
+    for ( Int n = 0; n < len/2; n++ )
+    {
+      Vec odd = L::mul( T[step*N + n], x[step] );
+      for ( Int k = 3*step; k < N; k += 2*step )
+      {
+        odd = L::add( odd, L::mul( T[k*N + n], x[k] ) );
+      }
+      const Vec even = y[n];
+      y[n          ] = L::add( even, odd );
+      y[len - 1 - n] = L::sub( even, odd );
+    }
+  }
+}
+
+/**
+ * \brief Forward 1D transform of a block of line x N samples
+ *
+ * Line j is read from src + j*srcStride, output k of it is written to dst[k*line + j] (the layout of
+ * partialButterfly4 .. 32()).
+ */
+template<class L, Int N, Bool bDST, typename SrcType>
+static SIMD_TARGET_AVX2 Void xForward1D( const SrcType *src, Int srcStride, TCoeff *dst, Int line, Int shift )
+{
+  typedef typename L::Vec Vec;
+  const Int     W      = L::NUM_LINES;
+  const Int     rows   = ( N < W ) ? W : N;
+  const Vec     add    = L::set1( ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0 );
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+
+  for ( Int j = 0; j < line; j += W )
+  {
+    Vec x[rows], y[N];
+
+    // gather the columns of the W lines
+    for ( Int n = 0; n < N; n += W )
+    {
+      for ( Int i = 0; i < W; i++ )
+      {
+        x[n + i] = L::loadRow( src + ( j + i ) * srcStride + n, N );
+      }
+      L::transpose( x + n );
+    }
+
+    xForwardCore<L, N, bDST>( x, y );
+
+    for ( Int k = 0; k < N; k++ )
+    {
+      L::store( dst + k * line + j, L::sra( L::add( y[k], add ), vShift ) );
+    }
+  }
+}
+
+/**
+ * \brief Inverse 1D transform of a block of N x line coefficients
+ *
+ * Input k of line j is read from src[k*line + j], the clipped output of line j is written to dst + j*dstStride (the
+ * layout of partialButterflyInverse4 .. 32()).
+ */
+template<class L, Int N, Bool bDST, typename DstType>
+static SIMD_TARGET_AVX2 Void xInverse1D( const TCoeff *src, DstType *dst, Int dstStride, Int line, Int shift, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  typedef typename L::Vec Vec;
+  const Int     W      = L::NUM_LINES;
+  const Int     rows   = ( N < W ) ? W : N;
+  const Vec     add    = L::set1( ( shift > 0 ) ? ( 1 << ( shift - 1 ) ) : 0 );
+  const Vec     vMin   = L::set1( outputMinimum );
+  const Vec     vMax   = L::set1( outputMaximum );
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+
+  for ( Int j = 0; j < line; j += W )
+  {
+    Vec x[N], y[rows];
+
+    for ( Int k = 0; k < N; k++ )
+    {
+      x[k] = L::load( src + k * line + j );
+    }
+
+    xInverseCore<L, N, bDST>( x, y );
+    for ( Int n = N; n < rows; n++ )
+    {
+      y[n] = L::set1( 0 );
+    }
+
+    for ( Int n = 0; n < N; n++ )
+    {
+      y[n] = L::clip( L::sra( L::add( y[n], add ), vShift ), vMin, vMax );
+    }
+
+    // scatter the results back to the W lines
+    for ( Int n = 0; n < N; n += W )
+    {
+      L::transpose( y + n );
+      for ( Int i = 0; i < W; i++ )
+      {
+        L::storeRow( dst + ( j + i ) * dstStride + n, y[n + i], N );
+      }
+    }
+  }
+}
+
+template<class L, typename SrcType>
+static Void xForward1D( const SrcType *src, Int srcStride, TCoeff *dst, Int size, Int line, Int shift, Bool useDST )
+{
+  switch ( size )
+  {
+    case  4:
+      if ( useDST ) { xForward1D<L,  4, true >( src, srcStride, dst, line, shift ); }
+      else          { xForward1D<L,  4, false>( src, srcStride, dst, line, shift ); }
+      break;
+    case  8: xForward1D<L,  8, false>( src, srcStride, dst, line, shift ); break;
+    case 16: xForward1D<L, 16, false>( src, srcStride, dst, line, shift ); break;
+    case 32: xForward1D<L, 32, false>( src, srcStride, dst, line, shift ); break;
+    default:
+      assert(0); exit (1); break;
+  }
+}
+
+template<class L, typename DstType>
+static Void xInverse1D( const TCoeff *src, DstType *dst, Int dstStride, Int size, Int line, Int shift, Bool useDST, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  switch ( size )
+  {
+    case  4:
+      if ( useDST ) { xInverse1D<L,  4, true >( src, dst, dstStride, line, shift, outputMinimum, outputMaximum ); }
+      else          { xInverse1D<L,  4, false>( src, dst, dstStride, line, shift, outputMinimum, outputMaximum ); }
+      break;
+    case  8: xInverse1D<L,  8, false>( src, dst, dstStride, line, shift, outputMinimum, outputMaximum ); break;
+    case 16: xInverse1D<L, 16, false>( src, dst, dstStride, line, shift, outputMinimum, outputMaximum ); break;
+    case 32: xInverse1D<L, 32, false>( src, dst, dstStride, line, shift, outputMinimum, outputMaximum ); break;
+    default:
+      assert(0); exit (1); break;
+  }
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/**
+ * \brief AVX2 version of xT() without MATRIX_MULT: forward 2D transform of a block of residuals
+ */
+Void TComTrQuant::xTrMxNAVX2( Int bitDepth, const Pel *piBlkResi, UInt uiStride, TCoeff *psCoeff, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange )
+{
+  static const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_FORWARD];
+
+  const Int shift_1st = ((g_aucConvertToBit[iWidth] + 2) +  bitDepth + TRANSFORM_MATRIX_SHIFT) - maxTrDynamicRange;
+  const Int shift_2nd = (g_aucConvertToBit[iHeight] + 2) + TRANSFORM_MATRIX_SHIFT;
+  const Bool bDST     = useDST && ( iWidth == 4 ) && ( iHeight == 4 );
+
+  assert(shift_1st >= 0);
+  assert(shift_2nd >= 0);
+
+  TCoeff tmp[ MAX_TU_SIZE * MAX_TU_SIZE ];
+
+  // rows of the residual: iHeight lines of iWidth samples
+  if ( iHeight >= TrLinesWide::NUM_LINES ) { xForward1D<TrLinesWide>( piBlkResi, Int(uiStride), tmp, iWidth, iHeight, shift_1st, bDST ); }
+  else                                  { xForward1D<TrLines4>( piBlkResi, Int(uiStride), tmp, iWidth, iHeight, shift_1st, bDST ); }
+
+  // columns: iWidth lines of iHeight values
+  if ( iWidth >= TrLinesWide::NUM_LINES )  { xForward1D<TrLinesWide>( tmp, iHeight, psCoeff, iHeight, iWidth, shift_2nd, bDST ); }
+  else                                  { xForward1D<TrLines4>( tmp, iHeight, psCoeff, iHeight, iWidth, shift_2nd, bDST ); }
+}
+
+/**
+ * \brief AVX2 version of xIT() without MATRIX_MULT: inverse 2D transform of a block of coefficients
+ */
+Void TComTrQuant::xITrMxNAVX2( Int bitDepth, const TCoeff *plCoef, Pel *pResidual, UInt uiStride, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange )
+{
+  static const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_INVERSE];
+
+  const Int    shift_1st   = TRANSFORM_MATRIX_SHIFT + 1; //1 has been added to shift_1st at the expense of shift_2nd
+  const Int    shift_2nd   = (TRANSFORM_MATRIX_SHIFT + maxTrDynamicRange - 1) - bitDepth;
+  const TCoeff clipMinimum = -(1 << maxTrDynamicRange);
+  const TCoeff clipMaximum =  (1 << maxTrDynamicRange) - 1;
+  const Bool   bDST        = useDST && ( iWidth == 4 ) && ( iHeight == 4 );
+
+  assert(shift_1st >= 0);
+  assert(shift_2nd >= 0);
+
+  TCoeff tmp[ MAX_TU_SIZE * MAX_TU_SIZE ];
+
+  // columns: iWidth lines of iHeight coefficients
+  if ( iWidth >= TrLinesWide::NUM_LINES )  { xInverse1D<TrLinesWide>( plCoef, tmp, iHeight, iHeight, iWidth, shift_1st, bDST, clipMinimum, clipMaximum ); }
+  else                                  { xInverse1D<TrLines4>( plCoef, tmp, iHeight, iHeight, iWidth, shift_1st, bDST, clipMinimum, clipMaximum ); }
+
+  // rows: iHeight lines of iWidth residuals
+  const TCoeff pelMinimum = std::numeric_limits<Pel>::min();
+  const TCoeff pelMaximum = std::numeric_limits<Pel>::max();
+  if ( iHeight >= TrLinesWide::NUM_LINES ) { xInverse1D<TrLinesWide>( tmp, pResidual, Int(uiStride), iWidth, iHeight, shift_2nd, bDST, pelMinimum, pelMaximum ); }
+  else                                  { xInverse1D<TrLines4>( tmp, pResidual, Int(uiStride), iWidth, iHeight, shift_2nd, bDST, pelMinimum, pelMaximum ); }
+}
+
+//! \}
+
+#endif // SIMD_X86_TARGET
@@ -214,11 +214,35 @@
 #define AMP_MRG                                           1 ///< encoder only force merge for AMP partition (no motion search for AMP)
 #endif
 
+#define HASH_ME_MAX_CANDIDATES                           64 ///< maximum number of hash matches that the hash motion search verifies per prediction unit and reference picture
+#define PYRAMID_ME_REFINE_RANGE                           2 ///< search range of the pyramid motion search on the level downscaled by 2, around the vector found on the level downscaled by 4
+#define PYRAMID_ME_TZ_SEARCH_RANGE                       16 ///< range of the TZ search when it also starts from the vector of the pyramid motion search
+#define LOOKAHEAD_BLOCK_SIZE                              8 ///< size of the blocks of the lookahead cost estimation, at half resolution
+#define LOOKAHEAD_SEARCH_RANGE                            4 ///< search range at half resolution of the lookahead inter cost estimation
+#define LOOKAHEAD_SCENE_CUT_RATIO                       0.8 ///< a picture is a scene cut when its lookahead inter cost exceeds this share of its intra cost
+#define LOOKAHEAD_FADE_MIN_DELTA                        1.0 ///< minimum change of the 8-bit mean luma between consecutive pictures of a fade
+#define LOOKAHEAD_INTRA_PRUNING_RATIO                   0.5 ///< intra modes are not tested in a CTU of an inter picture with a lookahead inter cost below this share of its intra cost
+
 #define CABAC_INIT_PRESENT_FLAG                           1
 
 #define LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS    4 // NOTE: RExt - new definition
 #define CHROMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS  8 // NOTE: RExt - new definition
 
+// This can be disabled by the makefile
+#ifndef ENABLE_SIMD_OPT
+#define ENABLE_SIMD_OPT                                   1 ///< 0 = plain C kernels only, 1 (default) = use SSE4.1/AVX2 kernels where the CPU supports them (selected at run time)
+#endif
+
+// This can be enabled by the makefile
+#ifndef SIMD_SELF_CHECK
+#define SIMD_SELF_CHECK                                   0 ///< 1 = run the plain C reference alongside every dispatched SIMD kernel and abort on the first mismatch
+#endif
+
+// This can be disabled by the makefile
+#ifndef ENABLE_FAST_CABAC_DECODER
+#define ENABLE_FAST_CABAC_DECODER                         1 ///< 0 = bit-serial CABAC decoding engine, 1 (default) = 64-bit value register refilled a word at a time and batched bypass bins (bit-exact with 0)
+#endif
+
 
 // ====================================================================================================================
 // RExt control settings
@@ -243,7 +267,10 @@
 #define RExt__INPUT_MSB_EXTENSION                                              1 ///< 0 = the MSB of each sample as it is read from the source is always the MSB of the sample's internal representation, 1 (default) = allow a number (configured by command line) of additional zero MSBs to be added to each sample as it is read in
 
 #define RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION                   1 ///< 0 = disable feature, 1 (default) = have command line control to optionally cost function for lossless / mixed lossless evaluation.
+// This can be enabled by the makefile
+#ifndef RExt__HIGH_BIT_DEPTH_SUPPORT
 #define RExt__HIGH_BIT_DEPTH_SUPPORT                                           0 ///< 0 (default) use data type definitions for 8-10 bit video, 1 = use larger data types to allow for up to 16-bit video (originally developed as part of N0188)
+#endif
 
 #define RExt__NRCE2_RESIDUAL_DPCM                                              1 ///< 0 = use residual DPCM for intra lossless coding only, 1 (default) = enable residual DPCM for inter and allow control for intra and inter via sequence parameter set flags
 #define RExt__NRCE2_RESIDUAL_ROTATION                                          1 ///< 0 = process transform-skipped and transquant-bypassed TU coefficients in the same order as transformed TUs, 1 (default) = allow (conditional on sequence-level flag) transform-skipped and transquant-bypassed TUs to be rotated through 180 degrees prior to entropy coding
@@ -292,6 +319,18 @@
 #define RExt__HIGH_PRECISION_FORWARD_TRANSFORM                                 0 ///< 0 (default) use original 6-bit transform matrices for both forward and inverse transform, 1 = use original matrices for inverse transform and high precision matrices for forward transform
 #endif
 
+#if ENABLE_SIMD_OPT && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+#define SIMD_X86_TARGET                                                        1 ///< x86 CPU detection and the SIMD kernels that support both Pel sizes (the core transforms) are built
+#else
+#define SIMD_X86_TARGET                                                        0
+#endif
+
+#if SIMD_X86_TARGET && !RExt__HIGH_BIT_DEPTH_SUPPORT
+#define SIMD_X86                                                               1 ///< x86 SIMD kernels on 16-bit Pel are built
+#else
+#define SIMD_X86                                                               0
+#endif
+
 #if FULL_NBIT
 # define DISTORTION_PRECISION_ADJUSTMENT(x)  0
 #else
@@ -305,6 +344,7 @@
 
 #define INTRABC_LEFTWIDTH                                                     64 ///< if the left CTU is used for IntraBC, this is set to be the CTU width; if only the left 4 columns are used, this is set to be 4
 #define INTRABC_FASTME                                                         1 ///< Fast motion estimation
+#define INTRABC_HASH_MAX_CANDIDATES                                           64 ///< maximum number of hash matches that the IntraBC hash search verifies per block
 
 #if RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION
 #define RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_TEST_QP                      0 ///< QP to use for lossless coding.
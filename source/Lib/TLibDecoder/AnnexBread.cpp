@@ -39,12 +39,26 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstring>
+#include <fstream>
 #include <vector>
 #include "AnnexBread.h"
+#include "TLibCommon/TComSIMD.h"
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
 #include "TLibCommon/TComCodingStatistics.h"
 #endif
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 //! \ingroup TLibDecoder
@@ -196,4 +210,254 @@ byteStreamNALUnit(
   stats.m_numBytesInNALUnit = UInt(nalUnit.size());
   return eof;
 }
+
+// ====================================================================================================================
+// Start code search
+// ====================================================================================================================
+
+static const uint8_t* findZeroBytePairC(const uint8_t* begin, const uint8_t* end)
+{
+  const uint8_t* p = begin;
+  while (end - p >= 2)
+  {
+    /* the first byte of a pair is searched in [p, end-1) */
+    p = (const uint8_t*)memchr(p, 0, (end - 1) - p);
+    if (!p)
+    {
+      return end;
+    }
+    if (p[1] == 0)
+    {
+      return p;
+    }
+    /* p[1] is not zero, so no pair starts at p+1 either */
+    p += 2;
+  }
+  return end;
+}
+
+#if SIMD_X86
+/* 32 positions per iteration: the bytes at p and at p+1 are compared to zero at once */
+static SIMD_TARGET_SSE41 const uint8_t* findZeroBytePairSSE41(const uint8_t* begin, const uint8_t* end)
+{
+  const uint8_t* p    = begin;
+  const __m128i  zero = _mm_setzero_si128();
+  while (end - p >= 17 + 16)
+  {
+    const __m128i first0  = _mm_loadu_si128((const __m128i*)p);
+    const __m128i second0 = _mm_loadu_si128((const __m128i*)(p + 1));
+    const __m128i first1  = _mm_loadu_si128((const __m128i*)(p + 16));
+    const __m128i second1 = _mm_loadu_si128((const __m128i*)(p + 17));
+    const Int mask0 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(first0, second0), zero));
+    const Int mask1 = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(first1, second1), zero));
+    if (mask0 | mask1)
+    {
+      const UInt mask = UInt(mask0) | (UInt(mask1) << 16);
+      UInt i = 0;
+      while (!((mask >> i) & 1))
+      {
+        i++;
+      }
+      return p + i;
+    }
+    p += 32;
+  }
+  return findZeroBytePairC(p, end);
+}
+#endif
+
+const uint8_t* findZeroBytePair(const uint8_t* begin, const uint8_t* end)
+{
+  typedef const uint8_t* (*FpFindZeroBytePair)(const uint8_t*, const uint8_t*);
+#if SIMD_X86
+  static const FpFindZeroBytePair fpFind = (getSIMDExtension() >= SIMD_SSE41) ? findZeroBytePairSSE41 : findZeroBytePairC;
+#else
+  static const FpFindZeroBytePair fpFind = findZeroBytePairC;
+#endif
+  return fpFind(begin, end);
+}
+
+// ====================================================================================================================
+// Memory mapped byte stream
+// ====================================================================================================================
+
+InputMappedByteStream::InputMappedByteStream()
+: m_isOpen(false)
+, m_pData(NULL)
+, m_Size(0)
+, m_Pos(0)
+, m_isMapped(false)
+{
+}
+
+InputMappedByteStream::~InputMappedByteStream()
+{
+  close();
+}
+
+Bool InputMappedByteStream::open(const Char* fileName)
+{
+  close();
+
+#if !defined(_WIN32)
+  Int fd = ::open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0)
+  {
+    void* pMap = mmap(NULL, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (pMap != MAP_FAILED)
+    {
+      madvise(pMap, size_t(fileStat.st_size), MADV_SEQUENTIAL);
+      m_pData    = (const uint8_t*)pMap;
+      m_Size     = size_t(fileStat.st_size);
+      m_isMapped = true;
+    }
+  }
+  ::close(fd);
+#endif
+
+  /* files that cannot be mapped (e.g. pipes) are read into memory */
+  if (!m_isMapped)
+  {
+    std::ifstream file(fileName, std::ifstream::in | std::ifstream::binary);
+    if (!file)
+    {
+      return false;
+    }
+    Char buffer[1 << 16];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+      m_Buffer.insert(m_Buffer.end(), (uint8_t*)buffer, (uint8_t*)buffer + file.gcount());
+    }
+    m_pData = m_Buffer.empty() ? NULL : &m_Buffer[0];
+    m_Size  = m_Buffer.size();
+  }
+
+  m_Pos    = 0;
+  m_isOpen = true;
+  return true;
+}
+
+Void InputMappedByteStream::close()
+{
+#if !defined(_WIN32)
+  if (m_isMapped)
+  {
+    munmap((void*)m_pData, m_Size);
+  }
+#endif
+  m_Buffer.clear();
+  m_isOpen   = false;
+  m_pData    = NULL;
+  m_Size     = 0;
+  m_Pos      = 0;
+  m_isMapped = false;
+}
+
+/**
+ * Extract the next NAL unit of the mapped bytestream bs, following the
+ * same steps as the istream based version above.  nalUnit points into
+ * the data of bs and is valid until bs is closed.
+ *
+ * Returns false if EOF was reached (NB, nalunit data may be valid),
+ *         otherwise true.
+ */
+Bool
+byteStreamNALUnit(
+  InputMappedByteStream& bs,
+  const uint8_t*& nalUnit,
+  UInt& nalUnitSize,
+  AnnexBStats& stats)
+{
+  const uint8_t* data = bs.m_pData;
+  const size_t   size = bs.m_Size;
+  size_t         pos  = bs.m_Pos;
+
+#define START_CODE_3_AT(p) ((p) + 3 <= size && data[p] == 0 && data[(p) + 1] == 0 && data[(p) + 2] == 1)
+#define START_CODE_4_AT(p) ((p) + 4 <= size && data[p] == 0 && START_CODE_3_AT((p) + 1))
+
+  nalUnit     = NULL;
+  nalUnitSize = 0;
+
+  /* leading_zero_8bits */
+  const size_t leadingStart = pos;
+  while (pos < size && !START_CODE_3_AT(pos) && !START_CODE_4_AT(pos))
+  {
+    assert(data[pos] == 0);
+    pos++;
+  }
+  stats.m_numLeadingZero8BitsBytes += UInt(pos - leadingStart);
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::SStat &statBits=TComCodingStatistics::GetStatisticEP(STATS__NAL_UNIT_PACKING);
+  statBits.bits += 8*Int(pos - leadingStart); statBits.count += Int(pos - leadingStart);
+#endif
+  if (pos == size)
+  {
+    bs.m_Pos = pos;
+    stats.m_numBytesInNALUnit = 0;
+    return true;
+  }
+
+  /* zero_byte and start_code_prefix_one_3bytes */
+  if (!START_CODE_3_AT(pos))
+  {
+    pos++;
+    stats.m_numZeroByteBytes++;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    statBits.bits+=8; statBits.count++;
+#endif
+  }
+  pos += 3;
+  stats.m_numStartCodePrefixBytes += 3;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  statBits.bits+=24; statBits.count+=3;
+#endif
+
+  /* the NAL unit ends before a byte aligned 0x000000, 0x000001 or 0x000002,
+   * or at the end of the stream */
+  const uint8_t* nalEnd = data + size;
+  for (const uint8_t* p = data + pos; p < data + size; p++)
+  {
+    p = findZeroBytePair(p, data + size);
+    if (p + 2 >= data + size)
+    {
+      break;
+    }
+    if (p[2] <= 2)
+    {
+      nalEnd = p;
+      break;
+    }
+  }
+  nalUnit     = data + pos;
+  nalUnitSize = UInt(nalEnd - nalUnit);
+  pos        += nalUnitSize;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::SStat &bodyStats=TComCodingStatistics::GetStatisticEP(STATS__NAL_UNIT_TOTAL_BODY);
+  bodyStats.bits += 8*Int(nalUnitSize); bodyStats.count += Int(nalUnitSize);
+#endif
+
+  /* trailing_zero_8bits */
+  const size_t trailingStart = pos;
+  while (pos < size && !START_CODE_3_AT(pos) && !START_CODE_4_AT(pos))
+  {
+    assert(data[pos] == 0);
+    pos++;
+  }
+  stats.m_numTrailingZero8BitsBytes += UInt(pos - trailingStart);
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  statBits.bits += 8*Int(pos - trailingStart); statBits.count += Int(pos - trailingStart);
+#endif
+
+#undef START_CODE_3_AT
+#undef START_CODE_4_AT
+
+  bs.m_Pos = pos;
+  stats.m_numBytesInNALUnit = nalUnitSize;
+  return pos == size;
+}
 //! \}
@@ -188,7 +188,54 @@ struct AnnexBStats
   }
 };
 
+/**
+ * Byte stream reader operating on a file that is mapped into memory
+ * (or, where mapping is not available, read into memory as a whole).
+ * NAL units are returned as pointers into the file data, so no bytes
+ * are copied and a NAL unit can be decoded again without rewinding.
+ */
+class InputMappedByteStream
+{
+public:
+  InputMappedByteStream();
+  ~InputMappedByteStream();
+
+  /**
+   * Map the file fileName.  Returns false if the file could not be
+   * opened.
+   */
+  Bool open(const Char* fileName);
+  Void close();
+
+  Bool isOpen() const { return m_isOpen; }
+
+  /**
+   * returns true if all bytes of the stream have been consumed.
+   */
+  Bool eof() const { return m_Pos == m_Size; }
+
+private:
+  Bool            m_isOpen;
+  const uint8_t*  m_pData;   /* start of the stream data */
+  size_t          m_Size;    /* number of bytes in the stream */
+  size_t          m_Pos;     /* current position */
+  Bool            m_isMapped; /* m_pData is a file mapping, otherwise it points to m_Buffer */
+  std::vector<uint8_t> m_Buffer;
+
+  friend Bool byteStreamNALUnit(InputMappedByteStream& bs, const uint8_t*& nalUnit, UInt& nalUnitSize, AnnexBStats& stats);
+
+  InputMappedByteStream(const InputMappedByteStream&);
+  InputMappedByteStream& operator=(const InputMappedByteStream&);
+};
+
 Bool byteStreamNALUnit(InputByteStream& bs, std::vector<uint8_t>& nalUnit, AnnexBStats& stats);
+Bool byteStreamNALUnit(InputMappedByteStream& bs, const uint8_t*& nalUnit, UInt& nalUnitSize, AnnexBStats& stats);
+
+/**
+ * returns the first position p in [begin, end) with p[0] == 0 and
+ * p[1] == 0, or end if there is none.
+ */
+const uint8_t* findZeroBytePair(const uint8_t* begin, const uint8_t* end);
 
 //! \}
 
@@ -40,8 +40,11 @@
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <cstring>
+#include <cassert>
 
 #include "NALread.h"
+#include "AnnexBread.h"
 #include "TLibCommon/NAL.h"
 #include "TLibCommon/TComBitStream.h"
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
@@ -52,41 +55,56 @@ using namespace std;
 
 //! \ingroup TLibDecoder
 //! \{
-static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream *bitstream, Bool isVclNalUnit)
+/**
+ * Copy the NAL unit payload of nalUnitSize bytes at nalUnitData to nalUnitBuf,
+ * removing the emulation prevention bytes and recording their locations in
+ * bitstream.  nalUnitData may be the data of nalUnitBuf itself.
+ */
+static void convertPayloadToRBSP(const uint8_t* nalUnitData, UInt nalUnitSize, vector<uint8_t>& nalUnitBuf, TComInputBitstream *bitstream, Bool isVclNalUnit)
 {
-  UInt zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
-
-  UInt pos = 0;
+  nalUnitBuf.resize(nalUnitSize);
   bitstream->clearEmulationPreventionByteLocation();
-  for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++, pos++)
+  if (nalUnitSize == 0)
   {
-    assert(zeroCount < 2 || *it_read >= 0x03);
-    if (zeroCount == 2 && *it_read == 0x03)
+    return;
+  }
+
+  const uint8_t* const end = nalUnitData + nalUnitSize;
+  const uint8_t* it_read = nalUnitData;
+  uint8_t*       it_write = &nalUnitBuf[0];
+
+  /* the bytes between two emulation_prevention_three_bytes are moved as a whole */
+  while (it_read < end)
+  {
+    const uint8_t* zeros = findZeroBytePair(it_read, end);
+    const uint8_t* copyEnd = (zeros + 2 < end) ? zeros + 2 : end;
+    memmove(it_write, it_read, copyEnd - it_read);
+    it_write += copyEnd - it_read;
+    if (copyEnd == end)
+    {
+      break;
+    }
+    assert(*copyEnd >= 0x03);
+    if (*copyEnd == 0x03)
     {
-      bitstream->pushEmulationPreventionByteLocation( pos );
-      pos++;
-      it_read++;
-      zeroCount = 0;
+      bitstream->pushEmulationPreventionByteLocation( UInt(copyEnd - nalUnitData) );
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
       TComCodingStatistics::IncrementStatisticEP(STATS__EMULATION_PREVENTION_3_BYTES, 8, 0);
 #endif
-      if (it_read == nalUnitBuf.end())
-      {
-        break;
-      }
+      it_read = copyEnd + 1;
+    }
+    else
+    {
+      it_read = copyEnd;
     }
-    zeroCount = (*it_read == 0x00) ? zeroCount+1 : 0;
-    *it_write = *it_read;
   }
-  assert(zeroCount == 0);
   
   if (isVclNalUnit)
   {
     // Remove cabac_zero_word from payload if present
     Int n = 0;
     
-    while (it_write[-1] == 0x00)
+    while (it_write > &nalUnitBuf[0] && it_write[-1] == 0x00)
     {
       it_write--;
       n++;
@@ -98,7 +116,7 @@ static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream
     }
   }
 
-  nalUnitBuf.resize(it_write - nalUnitBuf.begin());
+  nalUnitBuf.resize(it_write - &nalUnitBuf[0]);
 }
 
 Void readNalUnitHeader(InputNALUnit& nalu)
@@ -141,14 +159,20 @@ Void readNalUnitHeader(InputNALUnit& nalu)
  * a bitstream
  */
 void read(InputNALUnit& nalu, vector<uint8_t>& nalUnitBuf)
+{
+  read(nalu, nalUnitBuf.empty() ? NULL : &nalUnitBuf[0], UInt(nalUnitBuf.size()), nalUnitBuf);
+}
+
+/**
+ * create a NALunit structure from the NAL unit bytes at nalUnitData, which
+ * are not modified.  The payload is stored in nalUnitBuf, which has to be
+ * kept until the NAL unit has been decoded.
+ */
+void read(InputNALUnit& nalu, const uint8_t* nalUnitData, UInt nalUnitSize, vector<uint8_t>& nalUnitBuf)
 {
   /* perform anti-emulation prevention */
-  TComInputBitstream *pcBitstream = new TComInputBitstream(NULL);
-  convertPayloadToRBSP(nalUnitBuf, pcBitstream, (nalUnitBuf[0] & 64) == 0);
-  
   nalu.m_Bitstream = new TComInputBitstream(&nalUnitBuf);
-  nalu.m_Bitstream->setEmulationPreventionByteLocation(pcBitstream->getEmulationPreventionByteLocation());
-  delete pcBitstream;
+  convertPayloadToRBSP(nalUnitData, nalUnitSize, nalUnitBuf, nalu.m_Bitstream, (nalUnitData[0] & 64) == 0);
   readNalUnitHeader(nalu);
 }
 //! \}
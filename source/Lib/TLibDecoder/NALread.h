@@ -61,6 +61,7 @@ struct InputNALUnit : public NALUnit
 };
 
 void read(InputNALUnit& nalu, std::vector<uint8_t>& nalUnitBuf);
+void read(InputNALUnit& nalu, const uint8_t* nalUnitData, UInt nalUnitSize, std::vector<uint8_t>& nalUnitBuf);
 
 //! \}
 
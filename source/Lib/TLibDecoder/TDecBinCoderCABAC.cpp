@@ -35,6 +35,8 @@
     \brief    binary entropy decoder of CABAC
 */
 
+#include <algorithm>
+
 #include "TDecBinCoderCABAC.h"
 #include "TLibCommon/Debug.h"
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
@@ -65,6 +67,305 @@ TDecBinCABAC::uninit()
   m_pcTComBitstream = 0;
 }
 
+#if ENABLE_FAST_CABAC_DECODER
+
+/** floor(log2(x)) for x > 0
+ */
+static inline Int xFloorLog2( UInt x )
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz( x );
+#else
+  Int result = 0;
+  while ( x >>= 1 )
+  {
+    result++;
+  }
+  return result;
+#endif
+}
+
+Void
+TDecBinCABAC::start()
+{
+  assert( m_pcTComBitstream->getNumBitsUntilByteAligned() == 0 );
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
+#endif
+  std::vector<uint8_t>& fifo = m_pcTComBitstream->getFIFO();
+  m_pucData       = fifo.empty() ? NULL : &fifo[0];
+  m_uiDataSize    = UInt( fifo.size() );
+  m_uiStartIdx    = m_pcTComBitstream->getByteLocation();
+  m_uiDataIdx     = m_uiStartIdx;
+
+  // the 9 bit offset and 55 bits read ahead
+  m_uiRange       = 510;
+  m_uiValue       = 0;
+  for ( Int i = 0; i < 8; i++ )
+  {
+    m_uiValue = ( m_uiValue << 8 ) | ( m_uiDataIdx < m_uiDataSize ? m_pucData[m_uiDataIdx] : 0 );
+    m_uiDataIdx++;
+  }
+  m_bitsAvailable = 64 - 9;
+}
+
+/** load whole bytes into m_uiValue until between 48 and 55 bits are read ahead. Bytes beyond the end of the bitstream
+    are read as zero; the bit-serial engine would never use them.
+ */
+Void
+TDecBinCABAC::xRefill()
+{
+  const Int numBytes = ( 64 - 9 - m_bitsAvailable ) >> 3;
+  assert( numBytes > 0 && numBytes < 8 );
+  if ( m_uiDataIdx + 8 <= m_uiDataSize )
+  {
+    const UChar* p = m_pucData + m_uiDataIdx;
+    const UInt64 word = ( UInt64( ( UInt( p[0] ) << 24 ) | ( UInt( p[1] ) << 16 ) | ( UInt( p[2] ) << 8 ) | p[3] ) << 32 )
+                      |         ( ( UInt( p[4] ) << 24 ) | ( UInt( p[5] ) << 16 ) | ( UInt( p[6] ) << 8 ) | p[7] );
+    m_uiValue = ( m_uiValue << ( 8 * numBytes ) ) | ( word >> ( 64 - 8 * numBytes ) );
+  }
+  else
+  {
+    for ( Int i = 0; i < numBytes; i++ )
+    {
+      m_uiValue = ( m_uiValue << 8 ) | ( m_uiDataIdx + i < m_uiDataSize ? m_pucData[m_uiDataIdx + i] : 0 );
+    }
+  }
+  m_uiDataIdx     += numBytes;
+  m_bitsAvailable += 8 * numBytes;
+}
+
+/** The bit-serial engine reads two bytes at start() and one further byte for every 8 bits of renormalisation.
+    The number of renormalisation bits follows from the bits loaded into m_uiValue and the bits still read ahead.
+ */
+Int
+TDecBinCABAC::xGetBitsNeeded() const
+{
+  const UInt numShiftedBits = 8 * ( m_uiDataIdx - m_uiStartIdx ) - 9 - m_bitsAvailable;
+  return -8 + Int( numShiftedBits & 7 );
+}
+
+Void
+TDecBinCABAC::xSyncBitstream()
+{
+  const UInt numShiftedBits = 8 * ( m_uiDataIdx - m_uiStartIdx ) - 9 - m_bitsAvailable;
+  m_pcTComBitstream->setByteLocation( m_uiStartIdx + 2 + ( numShiftedBits >> 3 ) );
+}
+
+Void
+TDecBinCABAC::finish()
+{
+  UInt lastByte;
+
+  xSyncBitstream();
+  m_pcTComBitstream->peekPreviousByte( lastByte );
+  // Check for proper stop/alignment pattern
+  assert( ((lastByte << (8 + xGetBitsNeeded())) & 0xff) == 0x80 );
+}
+
+/**
+ - Copy CABAC state, including the read ahead position in the bitstream data.
+ .
+ \param pcTDecBinIf The source CABAC engine.
+ */
+Void
+TDecBinCABAC::copyState( TDecBinIf* pcTDecBinIf )
+{
+  TDecBinCABAC* pcTDecBinCABAC = pcTDecBinIf->getTDecBinCABAC();
+  m_uiRange       = pcTDecBinCABAC->m_uiRange;
+  m_uiValue       = pcTDecBinCABAC->m_uiValue;
+  m_bitsAvailable = pcTDecBinCABAC->m_bitsAvailable;
+  m_pucData       = pcTDecBinCABAC->m_pucData;
+  m_uiDataSize    = pcTDecBinCABAC->m_uiDataSize;
+  m_uiStartIdx    = pcTDecBinCABAC->m_uiStartIdx;
+  m_uiDataIdx     = pcTDecBinCABAC->m_uiDataIdx;
+}
+
+
+/** The MPS and LPS paths are merged: the LPS case is selected with masks, and the renormalisation shift of both
+    follows from the new range, as sm_aucRenormTable covers the LPS ranges and gives one bit for MPS ranges below 256.
+ */
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
+#endif
+{
+#ifdef DEBUG_CABAC_BINS
+  const UInt startingRange = m_uiRange;
+#endif
+
+  const UInt   uiLPS       = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
+  const UInt   uiMPSRange  = m_uiRange - uiLPS;
+  const UInt64 scaledRange = UInt64( uiMPSRange ) << m_bitsAvailable;
+  const UInt   isLPS       = ( m_uiValue >= scaledRange ) ? 1 : 0;
+
+  m_uiValue -= scaledRange & ( 0 - UInt64( isLPS ) );
+  const UInt uiRange = uiMPSRange ^ ( ( uiMPSRange ^ uiLPS ) & ( 0 - isLPS ) );
+  const Int  numBits = TComCABACTables::sm_aucRenormTable[ ( uiRange >> 3 ) & 0x1f ] & ( ( Int( uiRange ) - 256 ) >> 31 );
+  m_uiRange        = uiRange << numBits;
+  m_bitsAvailable -= numBits;
+
+  ruiBin = rcCtxModel.getMps() ^ isLPS;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(whichStat, uiMPSRange+uiLPS, uiRange, Int(ruiBin));
+#endif
+  rcCtxModel.updateLPSOrMPS( isLPS );
+
+  if ( m_bitsAvailable < 16 )
+  {
+    xRefill();
+  }
+
+#ifdef DEBUG_CABAC_BINS
+  if ((g_debugCounter + debugCabacBinWindow) >= debugCabacBinTargetLine)
+    std::cout << g_debugCounter << ": coding bin value " << ruiBin << ", range = [" << startingRange << "->" << m_uiRange << "]\n";
+
+  if (g_debugCounter >= debugCabacBinTargetLine)
+  {
+    char breakPointThis;
+    breakPointThis = 7;
+  }
+  if (g_debugCounter >= (debugCabacBinTargetLine + debugCabacBinWindow)) exit(0);
+  g_debugCounter++;
+#endif
+}
+
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin )
+#endif
+{
+  m_bitsAvailable--;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << m_bitsAvailable;
+  ruiBin = ( m_uiValue >= scaledRange ) ? 1 : 0;
+  m_uiValue -= scaledRange & ( 0 - UInt64( ruiBin ) );
+
+  if ( m_bitsAvailable < 16 )
+  {
+    xRefill();
+  }
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, 1, Int(ruiBin));
+#endif
+}
+
+/** Bypass bins are the binary digits of the quotient of the offset, extended by the next bits of the bitstream, and
+    the range, so up to 16 bins are decoded with one division.
+ */
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
+#endif
+{
+  UInt bins = 0;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  Int origNumBins=numBins;
+#endif
+  while ( numBins > 0 )
+  {
+    const Int numChunkBins = std::min( numBins, 16 );
+    m_bitsAvailable -= numChunkBins;
+
+    const UInt offset   = UInt( m_uiValue >> m_bitsAvailable );
+    const UInt quotient = offset / m_uiRange;
+    m_uiValue -= UInt64( quotient * m_uiRange ) << m_bitsAvailable;
+    bins       = ( bins << numChunkBins ) | quotient;
+    numBins   -= numChunkBins;
+
+    if ( m_bitsAvailable < 16 )
+    {
+      xRefill();
+    }
+  }
+
+  ruiBin = bins;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, origNumBins, Int(ruiBin));
+#endif
+}
+
+/** Decode bypass bins up to and including the first zero bin, returning the number of one bins. 16 bins are decoded
+    at a time as in decodeBinsEP(), and the engine is then set back to the state after the zero bin.
+ */
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes )
+#endif
+{
+  const Int numChunkBins = 16;
+  UInt numOnes = 0;
+  while ( true )
+  {
+    const UInt offset   = UInt( m_uiValue >> ( m_bitsAvailable - numChunkBins ) );
+    const UInt quotient = offset / m_uiRange;
+    const UInt zeros    = ~quotient & ( ( 1 << numChunkBins ) - 1 );
+    const Int  numBins  = zeros ? numChunkBins - xFloorLog2( zeros ) : numChunkBins;
+
+    // the bins up to the first zero bin are the leading bits of the quotient
+    m_bitsAvailable -= numBins;
+    m_uiValue       -= UInt64( ( quotient >> ( numChunkBins - numBins ) ) * m_uiRange ) << m_bitsAvailable;
+    numOnes         += zeros ? numBins - 1 : numBins;
+
+    if ( m_bitsAvailable < 16 )
+    {
+      xRefill();
+    }
+    if ( zeros )
+    {
+      break;
+    }
+  }
+
+  ruiNumOnes = numOnes;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  for ( UInt i = 0; i < numOnes; i++ )
+  {
+    TComCodingStatistics::IncrementStatisticEP(whichStat, 1, 1);
+  }
+  TComCodingStatistics::IncrementStatisticEP(whichStat, 1, 0);
+#endif
+}
+
+Void
+TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
+{
+  m_uiRange -= 2;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << m_bitsAvailable;
+  if( m_uiValue >= scaledRange )
+  {
+    ruiBin = 1;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, 2, ruiBin);
+    TComCodingStatistics::IncrementStatisticEP(STATS__BYTE_ALIGNMENT_BITS, -xGetBitsNeeded(), 0);
+#endif
+    // the arithmetic decoding ends here, PCM samples or the end of the substream follow in the bitstream
+    xSyncBitstream();
+  }
+  else
+  {
+    ruiBin = 0;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, m_uiRange, ruiBin);
+#endif
+    if ( m_uiRange < 256 )
+    {
+      m_uiRange <<= 1;
+      m_bitsAvailable--;
+      if ( m_bitsAvailable < 16 )
+      {
+        xRefill();
+      }
+    }
+  }
+}
+
+#else
+
 Void
 TDecBinCABAC::start()
 {
@@ -257,6 +558,27 @@ Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
 
 }
 
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeUnaryBinsEP( UInt& ruiNumOnes )
+#endif
+{
+  UInt numOnes = 0;
+  UInt bin;
+  do
+  {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    decodeBinEP( bin, whichStat );
+#else
+    decodeBinEP( bin );
+#endif
+    numOnes += bin;
+  }
+  while ( bin );
+  ruiNumOnes = numOnes;
+}
+
 Void
 TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
 {
@@ -290,6 +612,8 @@ TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
   }
 }
 
+#endif // ENABLE_FAST_CABAC_DECODER
+
 /** Read a PCM code.
  * \param uiLength code bit-depth
  * \param ruiCode pointer to PCM code value
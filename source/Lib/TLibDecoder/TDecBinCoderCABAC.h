@@ -60,10 +60,12 @@ public:
   Void  decodeBin         ( UInt& ruiBin, ContextModel& rcCtxModel, const class TComCodingStatisticsClassType &whichStat );
   Void  decodeBinEP       ( UInt& ruiBin                          , const class TComCodingStatisticsClassType &whichStat );
   Void  decodeBinsEP      ( UInt& ruiBin, Int numBins             , const class TComCodingStatisticsClassType &whichStat );
+  Void  decodeUnaryBinsEP ( UInt& ruiNumOnes                      , const class TComCodingStatisticsClassType &whichStat );
 #else
   Void  decodeBin         ( UInt& ruiBin, ContextModel& rcCtxModel );
   Void  decodeBinEP       ( UInt& ruiBin                           );
   Void  decodeBinsEP      ( UInt& ruiBin, Int numBins              );
+  Void  decodeUnaryBinsEP ( UInt& ruiNumOnes                       );
 #endif
 
   Void  decodeBinTrm      ( UInt& ruiBin                           );
@@ -74,10 +76,28 @@ public:
   TDecBinCABAC* getTDecBinCABAC()  { return this; }
 
 private:
+#if ENABLE_FAST_CABAC_DECODER
+  Void  xRefill           ();
+  Int   xGetBitsNeeded    () const;                        ///< m_bitsNeeded of the bit-serial engine
+  Void  xSyncBitstream    ();                              ///< move the bitstream to the byte position of the bit-serial engine
+#endif
+
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
+#if ENABLE_FAST_CABAC_DECODER
+  // The offset is held in the top bits of m_uiValue, followed by m_bitsAvailable bits read ahead from the bitstream.
+  // Bytes are loaded from the bitstream data directly; the bitstream position is only updated when the arithmetic
+  // decoding is terminated, so that the following PCM samples and trailing bits are read from the right place.
+  UInt64              m_uiValue;
+  Int                 m_bitsAvailable;
+  const UChar*        m_pucData;                           ///< bytes of the bitstream
+  UInt                m_uiDataSize;
+  UInt                m_uiStartIdx;                        ///< byte position of the bitstream at start()
+  UInt                m_uiDataIdx;                         ///< next byte to be loaded into m_uiValue
+#else
   UInt                m_uiValue;
   Int                 m_bitsNeeded;
+#endif
 };
 
 //! \}
@@ -170,7 +170,24 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
 
 Void TDecGop::filterPicture(TComPic*& rpcPic)
 {
-  TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
+  const Bool bIsReferenced = rpcPic->getSlice(rpcPic->getCurrSliceIdx())->isReferenced();
+
+  filterPicture(rpcPic, rpcPic->getCurrSliceIdx(), takeDecTime(), bIsReferenced);
+
+  rpcPic->setOutputMark(true);
+  rpcPic->setReconMark(true);
+}
+
+/** \param pcPic         picture to be filtered
+    \param uiSliceIdx    index of the slice whose parameters are used, the last one of the picture. It is passed in
+                         since the current slice index of the picture is reset once the picture has been decoded.
+    \param dDecTime      time spent decoding the slices of the picture, printed in the status line
+    \param bIsReferenced reference marking of the picture when it was decoded. It is passed in since the
+                         marking may be changed by the decoding of later pictures while this one is filtered.
+ */
+Void TDecGop::filterPicture(TComPic* pcPic, UInt uiSliceIdx, Double dDecTime, Bool bIsReferenced)
+{
+  TComSlice*  pcSlice = pcPic->getSlice(uiSliceIdx);
 
   //-- For time output for each slice
   long iBeforeTime = clock();
@@ -178,29 +195,29 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   // deblocking filter
   Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
   m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
-  m_pcLoopFilter->loopFilterPic( rpcPic );
+  m_pcLoopFilter->loopFilterPic( pcPic );
 #if !HM_CLEANUP_SAO
   if(pcSlice->getSPS()->getUseSAO())
   {
-    m_sliceStartCUAddress.push_back(rpcPic->getNumCUsInFrame()* rpcPic->getNumPartInCU());
-    rpcPic->createNonDBFilterInfo(m_sliceStartCUAddress, 0, &m_LFCrossSliceBoundaryFlag, rpcPic->getPicSym()->getNumTiles(), bLFCrossTileBoundary);
+    m_sliceStartCUAddress.push_back(pcPic->getNumCUsInFrame()* pcPic->getNumPartInCU());
+    pcPic->createNonDBFilterInfo(m_sliceStartCUAddress, 0, &m_LFCrossSliceBoundaryFlag, pcPic->getPicSym()->getNumTiles(), bLFCrossTileBoundary);
   }
 #endif
   if( pcSlice->getSPS()->getUseSAO() )
   {
 #if HM_CLEANUP_SAO
-    m_pcSAO->reconstructBlkSAOParams(rpcPic, rpcPic->getPicSym()->getSAOBlkParam());
-    m_pcSAO->SAOProcess(rpcPic);
-    m_pcSAO->PCMLFDisableProcess(rpcPic);
+    m_pcSAO->reconstructBlkSAOParams(pcPic, pcPic->getPicSym()->getSAOBlkParam());
+    m_pcSAO->SAOProcess(pcPic);
+    m_pcSAO->PCMLFDisableProcess(pcPic);
 #else
     {
-      SAOParam *saoParam = rpcPic->getPicSym()->getSaoParam();
+      SAOParam *saoParam = pcPic->getPicSym()->getSaoParam();
       saoParam->bSaoFlag[CHANNEL_TYPE_LUMA] = pcSlice->getSaoEnabledFlag();
       saoParam->bSaoFlag[CHANNEL_TYPE_CHROMA] = pcSlice->getSaoEnabledFlagChroma();
       m_pcSAO->setSaoLcuBasedOptimization(1);
-      m_pcSAO->createPicSaoInfo(rpcPic);
+      m_pcSAO->createPicSaoInfo(pcPic);
       m_pcSAO->SAOProcess(saoParam);
-      m_pcSAO->PCMLFDisableProcess(rpcPic);
+      m_pcSAO->PCMLFDisableProcess(pcPic);
       m_pcSAO->destroyPicSaoInfo();
     }
 #endif
@@ -208,12 +225,12 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
 #if !HM_CLEANUP_SAO
   if(pcSlice->getSPS()->getUseSAO())
   {
-    rpcPic->destroyNonDBFilterInfo();
+    pcPic->destroyNonDBFilterInfo();
   }
 #endif
-  rpcPic->compressMotion();
+  pcPic->compressMotion();
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
-  if (!pcSlice->isReferenced()) c += 32;
+  if (!bIsReferenced) c += 32;
 
   //-- For time output for each slice
   printf("POC %4d TId: %1d ( %c-SLICE, QP%3d ) ", pcSlice->getPOC(),
@@ -221,9 +238,8 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
                                                   c,
                                                   pcSlice->getSliceQp() );
 
-  m_dDecTime += (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
-  printf ("[DT %6.3f] ", m_dDecTime );
-  m_dDecTime  = 0;
+  dDecTime += (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
+  printf ("[DT %6.3f] ", dDecTime );
 
   for (Int iRefList = 0; iRefList < 2; iRefList++)
   {
@@ -236,19 +252,16 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   }
   if (m_decodedPictureHashSEIEnabled)
   {
-    SEIMessages pictureHashes = getSeisByType(rpcPic->getSEIs(), SEI::DECODED_PICTURE_HASH );
+    SEIMessages pictureHashes = getSeisByType(pcPic->getSEIs(), SEI::DECODED_PICTURE_HASH );
     const SEIDecodedPictureHash *hash = ( pictureHashes.size() > 0 ) ? (SEIDecodedPictureHash*) *(pictureHashes.begin()) : NULL;
     if (pictureHashes.size() > 1)
     {
       printf ("Warning: Got multiple decoded picture hash SEI messages. Using first.");
     }
-    calcAndPrintHashStatus(*rpcPic->getPicYuvRec(), hash);
+    calcAndPrintHashStatus(*pcPic->getPicYuvRec(), hash);
   }
 
   printf("\n");
-
-  rpcPic->setOutputMark(true);
-  rpcPic->setReconMark(true);
 #if !HM_CLEANUP_SAO
   m_sliceStartCUAddress.clear();
   m_LFCrossSliceBoundaryFlag.clear();
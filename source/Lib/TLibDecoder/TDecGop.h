@@ -103,6 +103,9 @@ public:
   Void  destroy ();
   Void  decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic );
   Void  filterPicture  (TComPic*& rpcPic );
+  Void  filterPicture  (TComPic* pcPic, UInt uiSliceIdx, Double dDecTime, Bool bIsReferenced ); ///< filter and check a picture without touching its output/reconstruction marks
+
+  Double takeDecTime   ()                      { Double dDecTime = m_dDecTime; m_dDecTime = 0; return dDecTime; }
 
   void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled = enabled; }
 
@@ -342,16 +342,7 @@ Void TDecSbac::xReadCoefRemainExGolomb ( UInt &rSymbol, UInt &rParam )
 
   UInt prefix   = 0;
   UInt codeWord = 0;
-  do
-  {
-    prefix++;
-    m_pcTDecBinIf->decodeBinEP( codeWord RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
-  }
-  while( codeWord);
-
-  codeWord  = 1 - codeWord;
-  prefix -= codeWord;
-  codeWord=0;
+  m_pcTDecBinIf->decodeUnaryBinsEP( prefix RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(whichStat) );
 
   if (prefix < COEF_REMAIN_BIN_REDUCTION )
   {
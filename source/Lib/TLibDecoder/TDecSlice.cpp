@@ -50,6 +50,15 @@ TDecSlice::TDecSlice()
   m_pcBufferBinCABACs    = NULL;
   m_pcBufferLowLatSbacDecoders = NULL;
   m_pcBufferLowLatBinCABACs    = NULL;
+  m_pcThreadPool               = NULL;
+  m_pcSubstreamSbacDecoders    = NULL;
+  m_pcSubstreamBinCABACs       = NULL;
+  m_bSliceEnded                = false;
+  m_uiWorkerMaxDepth           = 0;
+  m_uiWorkerMaxWidth           = 0;
+  m_uiWorkerMaxHeight          = 0;
+  m_eWorkerChromaFormat        = CHROMA_400;
+  m_uiWorkerMaxTrSize          = 0;
 }
 
 TDecSlice::~TDecSlice()
@@ -71,8 +80,37 @@ Void TDecSlice::initCtxMem(  UInt i )
   CTXMem.resize(i);
 }
 
-Void TDecSlice::create()
+/** Create the per-worker decoding tools when the thread pool has more than one worker. The workers are kept until
+ * destroyWorkers() is called or the CTU geometry or chroma format changes.
+ * \param uiMaxDepth       total number of allowable depth
+ * \param uiMaxWidth       largest CU width
+ * \param uiMaxHeight      largest CU height
+ * \param chromaFormatIDC  chroma format
+ * \param uiMaxTrSize      largest transform size
+ */
+Void TDecSlice::create( UInt uiMaxDepth, UInt uiMaxWidth, UInt uiMaxHeight, ChromaFormat chromaFormatIDC, UInt uiMaxTrSize )
 {
+  if ( !m_apcWorkers.empty()
+    && ( uiMaxDepth != m_uiWorkerMaxDepth || uiMaxWidth != m_uiWorkerMaxWidth || uiMaxHeight != m_uiWorkerMaxHeight
+      || chromaFormatIDC != m_eWorkerChromaFormat || uiMaxTrSize != m_uiWorkerMaxTrSize ) )
+  {
+    destroyWorkers();
+  }
+
+  if ( m_pcThreadPool->getNumThreads() > 1 && m_apcWorkers.empty() )
+  {
+    for (Int i = 0; i < m_pcThreadPool->getNumThreads(); i++)
+    {
+      TDecSliceWorker* pcWorker = new TDecSliceWorker;
+      pcWorker->create( uiMaxDepth, uiMaxWidth, uiMaxHeight, chromaFormatIDC, uiMaxTrSize );
+      m_apcWorkers.push_back( pcWorker );
+    }
+    m_uiWorkerMaxDepth    = uiMaxDepth;
+    m_uiWorkerMaxWidth    = uiMaxWidth;
+    m_uiWorkerMaxHeight   = uiMaxHeight;
+    m_eWorkerChromaFormat = chromaFormatIDC;
+    m_uiWorkerMaxTrSize   = uiMaxTrSize;
+  }
 }
 
 Void TDecSlice::destroy()
@@ -97,12 +135,27 @@ Void TDecSlice::destroy()
     delete[] m_pcBufferLowLatBinCABACs;
     m_pcBufferLowLatBinCABACs = NULL;
   }
+  delete[] m_pcSubstreamSbacDecoders;
+  delete[] m_pcSubstreamBinCABACs;
+  m_pcSubstreamSbacDecoders = NULL;
+  m_pcSubstreamBinCABACs    = NULL;
+}
+
+Void TDecSlice::destroyWorkers()
+{
+  for (std::vector<TDecSliceWorker*>::iterator i = m_apcWorkers.begin(); i != m_apcWorkers.end(); i++)
+  {
+    (*i)->destroy();
+    delete (*i);
+  }
+  m_apcWorkers.clear();
 }
 
-Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder)
+Void TDecSlice::init(TDecEntropy* pcEntropyDecoder, TDecCu* pcCuDecoder, TComThreadPool* pcThreadPool)
 {
   m_pcEntropyDecoder  = pcEntropyDecoder;
   m_pcCuDecoder       = pcCuDecoder;
+  m_pcThreadPool      = pcThreadPool;
 }
 
 Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rpcPic, TDecSbac* pcSbacDecoder, TDecSbac* pcSbacDecoders)
@@ -132,6 +185,12 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
   TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
   Int  iNumSubstreams = pcSlice->getPPS()->getNumSubstreams();
 
+  if ( xUseThreads( rpcPic, iStartCUAddr ) )
+  {
+    xDecompressSliceThreads( ppcSubstreams, rpcPic, iStartCUAddr, pcSbacDecoders );
+    return;
+  }
+
   // delete decoders if already allocated in previous slice
   if (m_pcBufferSbacDecoders)
   {
@@ -311,39 +370,7 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
 #endif
 
 #if HM_CLEANUP_SAO
-    if ( pcSlice->getSPS()->getUseSAO() )
-    {
-      SAOBlkParam& saoblkParam = (rpcPic->getPicSym()->getSAOBlkParam())[iCUAddr];
-      Bool bIsSAOSliceEnabled = false;
-      Bool sliceEnabled[MAX_NUM_COMPONENT];
-      for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
-      {
-        ComponentID compId=ComponentID(comp);
-        sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < rpcPic->getNumberValidComponents());
-        if (sliceEnabled[compId]) bIsSAOSliceEnabled=true;
-        saoblkParam[compId].modeIdc = SAO_MODE_OFF;
-      }
-      if (bIsSAOSliceEnabled)
-      {
-        Bool leftMergeAvail = false;
-        Bool aboveMergeAvail= false;
-
-        //merge left condition
-        Int rx = (iCUAddr % uiWidthInLCUs);
-        if(rx > 0)
-        {
-          leftMergeAvail = rpcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-1);
-        }
-        //merge up condition
-        Int ry = (iCUAddr / uiWidthInLCUs);
-        if(ry > 0)
-        {
-          aboveMergeAvail = rpcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-uiWidthInLCUs);
-        }
-
-        pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail);
-      }
-    }
+    xDecodeSAOBlkParam( rpcPic, iCUAddr, pcSbacDecoder );
 #else
     if ( pcSlice->getSPS()->getUseSAO() && (pcSlice->getSaoEnabledFlag()||pcSlice->getSaoEnabledFlagChroma()) )
     {
@@ -433,6 +460,275 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
   }
 }
 
+#if HM_CLEANUP_SAO
+/** Parse the SAO parameters of a CTU.
+ * \param pcPic          picture class
+ * \param iCUAddr        CTU address
+ * \param pcSbacDecoder  SBAC decoder of the substream containing the CTU
+ */
+Void TDecSlice::xDecodeSAOBlkParam( TComPic* pcPic, Int iCUAddr, TDecSbac* pcSbacDecoder )
+{
+  TComSlice* pcSlice       = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  UInt       uiWidthInLCUs = pcPic->getPicSym()->getFrameWidthInCU();
+
+  if ( pcSlice->getSPS()->getUseSAO() )
+  {
+    SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[iCUAddr];
+    Bool bIsSAOSliceEnabled = false;
+    Bool sliceEnabled[MAX_NUM_COMPONENT];
+    for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
+    {
+      ComponentID compId=ComponentID(comp);
+      sliceEnabled[compId] = pcSlice->getSaoEnabledFlag(toChannelType(compId)) && (comp < pcPic->getNumberValidComponents());
+      if (sliceEnabled[compId]) bIsSAOSliceEnabled=true;
+      saoblkParam[compId].modeIdc = SAO_MODE_OFF;
+    }
+    if (bIsSAOSliceEnabled)
+    {
+      Bool leftMergeAvail = false;
+      Bool aboveMergeAvail= false;
+
+      //merge left condition
+      Int rx = (iCUAddr % uiWidthInLCUs);
+      if(rx > 0)
+      {
+        leftMergeAvail = pcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-1);
+      }
+      //merge up condition
+      Int ry = (iCUAddr / uiWidthInLCUs);
+      if(ry > 0)
+      {
+        aboveMergeAvail = pcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-uiWidthInLCUs);
+      }
+
+      pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail);
+    }
+  }
+}
+#endif
+
+/** Check whether the substreams of the slice can be decoded in parallel: this needs the per-worker decoding tools
+ * and a slice with more than one substream, which are either the CTU rows of a picture with a single tile (WPP) or
+ * whole tiles (tiles without WPP). Dependent slice segments carry contexts from one segment to the next and are
+ * decoded sequentially, as are all slices when a trace or bit statistics are written in decoding order.
+ * \param pcPic         picture class
+ * \param iStartCUAddr  address of the first CTU of the slice segment
+ * \returns true if xDecompressSliceThreads can be used
+ */
+Bool TDecSlice::xUseThreads( TComPic* pcPic, Int iStartCUAddr )
+{
+#if ENC_DEC_TRACE || RExt__DECODER_DEBUG_BIT_STATISTICS || !HM_CLEANUP_SAO
+  return false;
+#else
+  TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  TComPPS*   pcPPS   = pcSlice->getPPS();
+
+  if ( m_apcWorkers.empty() || pcSlice->getNumEntryPointOffsets() <= 0 || pcPPS->getDependentSliceSegmentsEnabledFlag() )
+  {
+    return false;
+  }
+  if ( pcPPS->getEntropyCodingSyncEnabledFlag() )
+  {
+    return pcPic->getPicSym()->getNumTiles() == 1 && xIsSubstreamStart( pcPic, iStartCUAddr );
+  }
+  return pcPPS->getTilesEnabledFlag()
+      && pcSlice->getTileLocationCount() == UInt( pcSlice->getNumEntryPointOffsets() )
+      && xIsSubstreamStart( pcPic, iStartCUAddr );
+#endif
+}
+
+/** \param pcPic    picture class
+ * \param iCUAddr  CTU address
+ * \returns true if the CTU is the first one of a CTU row (WPP) or of a tile (tiles without WPP)
+ */
+Bool TDecSlice::xIsSubstreamStart( TComPic* pcPic, Int iCUAddr )
+{
+  if ( pcPic->getSlice(pcPic->getCurrSliceIdx())->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    return iCUAddr % pcPic->getFrameWidthInCU() == 0;
+  }
+  return iCUAddr == Int( pcPic->getPicSym()->getTComTile(pcPic->getPicSym()->getTileIdxMap(iCUAddr))->getFirstCUAddr() );
+}
+
+/** Decode the substreams of the slice on the thread pool, as a task graph with one task per CTU: a CTU waits for the
+ * previous CTU of its substream and, for WPP, for the CTU above-right, whose contexts after the second CTU of a row are
+ * inherited by the row below. Tiles need no further dependency, as no prediction crosses a tile boundary; the
+ * neighbouring CTUs of another tile are only looked at by availability checks, whose outcome is decided by the tile
+ * index. The result is identical to the one of the sequential loop in decompressSlice.
+ * \param ppcSubstreams   substreams of the slice, as extracted by TDecGop
+ * \param pcPic           picture class
+ * \param iStartCUAddr    address of the first CTU of the slice
+ * \param pcSbacDecoders  SBAC decoders of the substreams, initialised by TDecGop
+ */
+Void TDecSlice::xDecompressSliceThreads( TComInputBitstream** ppcSubstreams, TComPic* pcPic, Int iStartCUAddr, TDecSbac* pcSbacDecoders )
+{
+  TComSlice*  pcSlice         = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  TComPicSym* pcPicSym        = pcPic->getPicSym();
+  const Bool  bWPP            = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+  const UInt  uiWidthInCU     = pcPic->getFrameWidthInCU();
+  const UInt  uiNumSubstreams = pcSlice->getNumEntryPointOffsets()+1;
+  const Int   iNumCUsInFrame  = pcPic->getNumCUsInFrame();
+
+  m_aiSubstreamStartCUAddr.clear();
+  for ( Int iCUAddr = iStartCUAddr; m_aiSubstreamStartCUAddr.size() < uiNumSubstreams && iCUAddr < iNumCUsInFrame; iCUAddr = pcPicSym->xCalculateNxtCUAddr(iCUAddr) )
+  {
+    if ( iCUAddr == iStartCUAddr || xIsSubstreamStart( pcPic, iCUAddr ) )
+    {
+      m_aiSubstreamStartCUAddr.push_back( iCUAddr );
+    }
+  }
+
+  // TDecGop extracts a single substream when tiles are used without WPP: split it at the tile entry points
+  if ( !bWPP )
+  {
+    std::vector<uint8_t>& rcFIFO = ppcSubstreams[0]->getFIFO();
+    for (UInt ui = 0; ui < m_aiSubstreamStartCUAddr.size(); ui++)
+    {
+      UInt uiBegin = ui == 0 ? 0 : pcSlice->getTileLocation(ui-1);
+      UInt uiEnd   = ui < pcSlice->getTileLocationCount() ? pcSlice->getTileLocation(ui) : (UInt)rcFIFO.size();
+      m_apcTileSubstreams.push_back( new TComInputBitstream( new std::vector<uint8_t>( rcFIFO.begin() + uiBegin, rcFIFO.begin() + uiEnd ) ) );
+    }
+  }
+
+  // the contexts after the second CTU of each CTU row, for the row below
+  if (m_pcBufferSbacDecoders)
+  {
+    delete [] m_pcBufferSbacDecoders;
+  }
+  if (m_pcBufferBinCABACs)
+  {
+    delete [] m_pcBufferBinCABACs;
+  }
+  m_pcBufferSbacDecoders = new TDecSbac    [m_aiSubstreamStartCUAddr.size()];
+  m_pcBufferBinCABACs    = new TDecBinCABAC[m_aiSubstreamStartCUAddr.size()];
+  for (UInt ui = 0; ui < m_aiSubstreamStartCUAddr.size(); ui++)
+  {
+    m_pcBufferSbacDecoders[ui].init(&m_pcBufferBinCABACs[ui]);
+  }
+
+  // the state of each substream, which the CTUs of the substream pass on to each other whichever worker decodes them
+  delete[] m_pcSubstreamSbacDecoders;
+  delete[] m_pcSubstreamBinCABACs;
+  m_pcSubstreamSbacDecoders = new TDecSbac    [m_aiSubstreamStartCUAddr.size()];
+  m_pcSubstreamBinCABACs    = new TDecBinCABAC[m_aiSubstreamStartCUAddr.size()];
+  for (UInt ui = 0; ui < m_aiSubstreamStartCUAddr.size(); ui++)
+  {
+    m_pcSubstreamSbacDecoders[ui].init( &m_pcSubstreamBinCABACs[ui] );
+    if ( bWPP )
+    {
+      m_pcSubstreamSbacDecoders[ui].setBitstream( ppcSubstreams[ui] );
+      m_pcSubstreamSbacDecoders[ui].load( &pcSbacDecoders[ui] );
+    }
+    else
+    {
+      m_pcSubstreamSbacDecoders[ui].setBitstream( m_apcTileSubstreams[ui] );
+      m_pcSubstreamSbacDecoders[ui].resetEntropy( pcSlice );
+    }
+  }
+  m_bSliceEnded = false;
+
+  for (std::vector<TDecSliceWorker*>::iterator i = m_apcWorkers.begin(); i != m_apcWorkers.end(); i++)
+  {
+    (*i)->setUpScalingList( pcSlice );
+  }
+
+  // the substreams other than the last one are complete CTU rows or tiles; the last one may end before its last CTU
+  TComTaskGraph    cGraph;
+  std::vector<Int> aiFirstTask;
+  for (UInt uiSubStrm = 0; uiSubStrm < m_aiSubstreamStartCUAddr.size(); uiSubStrm++)
+  {
+    aiFirstTask.push_back( cGraph.getNumTasks() );
+    Int iCUAddr = m_aiSubstreamStartCUAddr[uiSubStrm];
+    do
+    {
+      const UInt uiCol  = iCUAddr % uiWidthInCU;
+      const Int  iTask  = cGraph.addTask( [=]( Int iWorkerIdx ) { xDecompressCTU( pcPic, uiSubStrm, iCUAddr, m_apcWorkers[iWorkerIdx] ); } );
+      if ( iTask > aiFirstTask[uiSubStrm] )
+      {
+        cGraph.addDependency( iTask, iTask - 1 );
+      }
+      if ( bWPP && uiSubStrm > 0 )
+      {
+        cGraph.addDependency( iTask, aiFirstTask[uiSubStrm-1] + min( uiCol + 1, uiWidthInCU - 1 ) );
+      }
+      iCUAddr = pcPicSym->xCalculateNxtCUAddr( iCUAddr );
+    }
+    while ( iCUAddr < iNumCUsInFrame && !xIsSubstreamStart( pcPic, iCUAddr ) );
+  }
+  m_pcThreadPool->run( cGraph );
+
+  for (std::vector<TComInputBitstream*>::iterator i = m_apcTileSubstreams.begin(); i != m_apcTileSubstreams.end(); i++)
+  {
+    (*i)->deleteFifo();
+    delete (*i);
+  }
+  m_apcTileSubstreams.clear();
+}
+
+/** Task of xDecompressSliceThreads: decode one CTU with the decoding tools of the worker running the task, unless the
+ * end of the slice has been parsed before it in the last substream.
+ * The reconstruction level buffer that all CTUs share (TComRomContext::pcGlbArlCoeff) is cleared by every worker but
+ * never read by the decoder.
+ * \param pcPic      picture class
+ * \param uiSubStrm  substream of the CTU
+ * \param iCUAddr    CTU address
+ * \param pcWorker   decoding tools of the worker
+ */
+Void TDecSlice::xDecompressCTU( TComPic* pcPic, UInt uiSubStrm, Int iCUAddr, TDecSliceWorker* pcWorker )
+{
+  // only the last substream may end before its last CTU, and only its CTUs, which wait for each other, look at the flag
+  if ( uiSubStrm + 1 == m_aiSubstreamStartCUAddr.size() && m_bSliceEnded )
+  {
+    return;
+  }
+
+  TComSlice*   pcSlice          = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const Bool   bWPP             = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag();
+  const UInt   uiWidthInCU      = pcPic->getFrameWidthInCU();
+  const UInt   uiCol            = iCUAddr % uiWidthInCU;
+
+  TDecCu*      pcCuDecoder      = pcWorker->getCuDecoder();
+  TDecSbac*    pcSbacDecoder    = &m_pcSubstreamSbacDecoders[uiSubStrm];
+  pcWorker->getEntropyDecoder()->setEntropyDecoder( pcSbacDecoder );
+
+  TComDataCU* pcCU = pcPic->getCU( iCUAddr );
+  pcCU->initCU( pcPic, iCUAddr );
+
+  // inherit the contexts after the second CTU of the row above, if it belongs to the slice
+  if ( bWPP && uiCol == 0 && uiSubStrm > 0 && uiWidthInCU > 1 )
+  {
+    pcSbacDecoder->loadContexts( &m_pcBufferSbacDecoders[uiSubStrm-1] );
+  }
+
+#if HM_CLEANUP_SAO
+  xDecodeSAOBlkParam( pcPic, iCUAddr, pcSbacDecoder );
+#endif
+
+  // only the task that parses the end of the slice updates its end address, which is beyond all other CTUs
+  UInt uiIsLast = 0;
+  pcCuDecoder->decodeCU     ( pcCU, uiIsLast );
+  pcCuDecoder->decompressCU ( pcCU );
+
+  if ( bWPP && uiCol == uiWidthInCU-1 && !uiIsLast )
+  {
+    // Parse end_of_substream_one_bit for WPP case
+    UInt binVal;
+    pcSbacDecoder->parseTerminatingBit( binVal );
+    assert( binVal );
+  }
+
+  //Store probabilities of second LCU in line into buffer
+  if ( bWPP && uiCol == 1 )
+  {
+    m_pcBufferSbacDecoders[uiSubStrm].loadContexts( pcSbacDecoder );
+  }
+
+  if ( uiIsLast )
+  {
+    m_bSliceEnded = true;
+  }
+}
+
 ParameterSetManagerDecoder::ParameterSetManagerDecoder()
 : m_vpsBuffer(MAX_NUM_VPS)
 , m_spsBuffer(MAX_NUM_SPS)
@@ -49,6 +49,10 @@
 #include "TDecCu.h"
 #include "TDecSbac.h"
 #include "TDecBinCoderCABAC.h"
+#include "TDecSliceWorker.h"
+#include "TLibCommon/TComThreadPool.h"
+
+#include <vector>
 
 //! \ingroup TLibDecoder
 //! \{
@@ -70,19 +74,43 @@ private:
   TDecSbac*       m_pcBufferLowLatSbacDecoders;   ///< dependent tiles: line to store temporary contexts, one per column of tiles.
   TDecBinCABAC*   m_pcBufferLowLatBinCABACs;
   std::vector<TDecSbac*> CTXMem;
+
+  // parallel decoding of WPP CTU rows and tiles
+  TComThreadPool*         m_pcThreadPool;                   ///< thread pool of the decoder
+  std::vector<TDecSliceWorker*> m_apcWorkers;               ///< per-worker CU decoding tools, kept from picture to picture
+  UInt                    m_uiWorkerMaxDepth;               ///< CTU depth the workers were created for
+  UInt                    m_uiWorkerMaxWidth;               ///< CTU width the workers were created for
+  UInt                    m_uiWorkerMaxHeight;              ///< CTU height the workers were created for
+  ChromaFormat            m_eWorkerChromaFormat;            ///< chroma format the workers were created for
+  UInt                    m_uiWorkerMaxTrSize;              ///< largest transform size the workers were created for
+  std::vector<Int>        m_aiSubstreamStartCUAddr;         ///< per substream of the slice: address of the first CTU
+  std::vector<TComInputBitstream*> m_apcTileSubstreams;     ///< per substream of the slice: tile data (tiles without WPP)
+  TDecSbac*               m_pcSubstreamSbacDecoders;        ///< per substream of the slice: SBAC decoder
+  TDecBinCABAC*           m_pcSubstreamBinCABACs;           ///< per substream of the slice: bin decoder
+  Bool                    m_bSliceEnded;                    ///< set when the end of the slice has been parsed
   
 public:
   TDecSlice();
   virtual ~TDecSlice();
   
-  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder );
-  Void  create            ();
+  Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder, TComThreadPool* pcThreadPool );
+  Void  create            ( UInt uiMaxDepth, UInt uiMaxWidth, UInt uiMaxHeight, ChromaFormat chromaFormatIDC, UInt uiMaxTrSize );
   Void  destroy           ();
-  
+  Void  destroyWorkers    ();
+
   Void  decompressSlice   ( TComInputBitstream** ppcSubstreams,   TComPic*& rpcPic, TDecSbac* pcSbacDecoder, TDecSbac* pcSbacDecoders );
   Void      initCtxMem(  UInt i );
   Void      setCtxMem( TDecSbac* sb, Int b )   { CTXMem[b] = sb; }
   Int       getCtxMemSize( )                   { return (Int)CTXMem.size(); }
+
+private:
+#if HM_CLEANUP_SAO
+  Void  xDecodeSAOBlkParam      ( TComPic* pcPic, Int iCUAddr, TDecSbac* pcSbacDecoder );
+#endif
+  Bool  xUseThreads             ( TComPic* pcPic, Int iStartCUAddr );
+  Bool  xIsSubstreamStart       ( TComPic* pcPic, Int iCUAddr );
+  Void  xDecompressSliceThreads ( TComInputBitstream** ppcSubstreams, TComPic* pcPic, Int iStartCUAddr, TDecSbac* pcSbacDecoders );
+  Void  xDecompressCTU          ( TComPic* pcPic, UInt uiSubStrm, Int iCUAddr, TDecSliceWorker* pcWorker );
 };
 
 
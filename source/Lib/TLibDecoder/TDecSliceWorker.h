@@ -0,0 +1,80 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecSliceWorker.h
+    \brief    per-thread CU decoding tools for parallel decoding of WPP CTU rows and tiles (header)
+*/
+
+#ifndef __TDECSLICEWORKER__
+#define __TDECSLICEWORKER__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComPrediction.h"
+#include "TDecCu.h"
+#include "TDecEntropy.h"
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CU-level decoding tools, so that the workers of the thread pool can decode CTUs of several
+/// substreams at the same time; the SBAC decoder is the one of the substream, set for every CTU
+class TDecSliceWorker
+{
+private:
+  TDecCu                  m_cCuDecoder;                   ///< CU decoder
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization
+  TComPrediction          m_cPrediction;                  ///< prediction
+  TDecEntropy             m_cEntropyDecoder;              ///< entropy decoder
+
+public:
+  TDecSliceWorker();
+  virtual ~TDecSliceWorker();
+
+  Void      create              ( UInt uiMaxDepth, UInt uiMaxWidth, UInt uiMaxHeight, ChromaFormat chromaFormatIDC, UInt uiMaxTrSize );
+  Void      destroy             ();
+
+  /// set up the quantization matrices in the same way as TDecTop does for the decoder's transform & quantization class
+  Void      setUpScalingList    ( TComSlice* pcSlice );
+
+  TDecCu*         getCuDecoder        () { return &m_cCuDecoder;      }
+  TDecEntropy*    getEntropyDecoder   () { return &m_cEntropyDecoder; }
+};
+
+//! \}
+
+#endif // __TDECSLICEWORKER__
@@ -49,6 +49,7 @@ TDecTop::TDecTop()
   m_pcPic = 0;
   m_iMaxRefPicNum = 0;
 #if ENC_DEC_TRACE
+  TComRomScope cRomScope( &m_cRomContext );
   if (g_hTrace == NULL)
   {
     g_hTrace = fopen( "TraceDec_RExt.txt", "wb" );
@@ -64,11 +65,16 @@ TDecTop::TDecTop()
   m_bFirstSliceInSequence   = true;
   m_prevSliceSkipped = false;
   m_skippedPOC = 0;
+  m_bPipelined = false;
+  m_bParameterSetsPending = false;
+  m_pcFilterSPS = NULL;
+  m_bFilterThreadExit = false;
 }
 
 TDecTop::~TDecTop()
 {
 #if ENC_DEC_TRACE
+  TComRomScope cRomScope( &m_cRomContext );
   if (g_hTrace != stdout)
   {
     fclose( g_hTrace );
@@ -78,6 +84,8 @@ TDecTop::~TDecTop()
 
 Void TDecTop::create()
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   m_cGopDecoder.create();
   m_apcSlicePilot = new TComSlice;
   m_uiSliceIdx = 0;
@@ -85,45 +93,66 @@ Void TDecTop::create()
 
 Void TDecTop::destroy()
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
+  if (m_cFilterThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> cLock(m_cPictureTaskMutex);
+      m_bFilterThreadExit = true;
+    }
+    m_cPictureTaskCond.notify_all();
+    m_cFilterThread.join();
+    m_bFilterThreadExit = false;
+  }
+
   m_cGopDecoder.destroy();
 
   delete m_apcSlicePilot;
   m_apcSlicePilot = NULL;
 
   m_cSliceDecoder.destroy();
+  m_cSliceDecoder.destroyWorkers();
+  m_cThreadPool.destroy();
 }
 
 Void TDecTop::init()
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   // initialize ROM
   initROM();
   m_cGopDecoder.init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cSAO);
-  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder );
+  m_cFilterGopDecoder.init( NULL, NULL, NULL, NULL, NULL, &m_cFilterLoopFilter, &m_cFilterSAO );
+  m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder, &m_cThreadPool );
   m_cEntropyDecoder.init(&m_cPrediction);
 }
 
 Void TDecTop::deletePicBuffer ( )
 {
-  TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
-  Int iSize = Int( m_cListPic.size() );
+  TComRomScope cRomScope( &m_cRomContext );
 
-  for (Int i = 0; i < iSize; i++ )
-  {
-    TComPic* pcPic = *(iterPic++);
-    pcPic->destroy();
+  flushPipeline();
 
-    delete pcPic;
-    pcPic = NULL;
-  }
+  m_cPicPool.destroy();
+  m_cListPic.clear();
 
   m_cSAO.destroy();
 
   m_cLoopFilter.        destroy();
 
+  m_cFilterSAO.destroy();
+  m_cFilterLoopFilter.destroy();
+  m_pcFilterSPS = NULL;
+
   // destroy ROM
   destroyROM();
 }
 
+/** Get a picture buffer for the picture of pcSlice
+ * The picture pool is filled up to the DPB size of the SPS when a picture is decoded. Pictures that are no longer
+ * needed go back to the pool and are reused in place, they are only recreated when the picture format changes.
+ */
 Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
 {
   Int  numReorderPics[MAX_TLAYER];
@@ -135,60 +164,88 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
     numReorderPics[temporalLayer] = pcSlice->getSPS()->getNumReorderPics(temporalLayer);
   }
 
+  const Int          iWidth          = pcSlice->getSPS()->getPicWidthInLumaSamples();
+  const Int          iHeight         = pcSlice->getSPS()->getPicHeightInLumaSamples();
+  const ChromaFormat chromaFormatIDC = pcSlice->getSPS()->getChromaFormatIdc();
+
+  xReleasePics();
+
   m_iMaxRefPicNum = pcSlice->getSPS()->getMaxDecPicBuffering(pcSlice->getTLayer());     // m_uiMaxDecPicBuffering has the space for the picture currently being decoded
-  if (m_cListPic.size() < (UInt)m_iMaxRefPicNum)
+  while (m_cPicPool.getNumPics() < (UInt)m_iMaxRefPicNum)
   {
-    rpcPic = new TComPic();
+    TComPic* pcPic = new TComPic();
 
-    rpcPic->create ( pcSlice->getSPS()->getPicWidthInLumaSamples(), pcSlice->getSPS()->getPicHeightInLumaSamples(), pcSlice->getSPS()->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
-                     conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+    pcPic->create ( iWidth, iHeight, chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
+                    conformanceWindow, defaultDisplayWindow, numReorderPics, true);
 #if !HM_CLEANUP_SAO
-    rpcPic->getPicSym()->allocSaoParam(&m_cSAO);
+    pcPic->getPicSym()->allocSaoParam(&m_cSAO);
 #endif
-    m_cListPic.pushBack( rpcPic );
+    m_cPicPool.addPic( pcPic );
+  }
+
+  rpcPic = m_cPicPool.acquire( pcSlice->getPOC() );
+  if ( rpcPic == NULL )
+  {
+    //There is no room for this picture, either because of faulty encoder or dropped NAL. Extend the buffer.
+    m_iMaxRefPicNum++;
+    m_cPicPool.addPic( new TComPic() );
+    rpcPic = m_cPicPool.acquire( pcSlice->getPOC() );
+  }
+  m_cListPic.pushBack( rpcPic );
 
+  waitForPicture(rpcPic);
+  rpcPic->setOutputMark(false);
+  rpcPic->setReconMark( false );
+  if (rpcPic->isFormat(iWidth, iHeight, chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth))
+  {
+    rpcPic->reinit( conformanceWindow, defaultDisplayWindow, numReorderPics );
+    rpcPic->getPicYuvRec()->setBorderExtension( false );
     return;
   }
+  rpcPic->destroy();
+  rpcPic->create ( iWidth, iHeight, chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
+                   conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+#if !HM_CLEANUP_SAO
+  rpcPic->getPicSym()->allocSaoParam(&m_cSAO);
+#endif
+}
 
-  Bool bBufferIsAvailable = false;
-  TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
+/** Return the pictures that are neither needed for output nor used for reference to the picture pool. This is called
+ * when the reference picture set of a new picture has been applied, which is when the DPB drops pictures.
+ */
+Void TDecTop::xReleasePics()
+{
+  TComList<TComPic*>::iterator iterPic = m_cListPic.begin();
   while (iterPic != m_cListPic.end())
   {
-    rpcPic = *(iterPic++);
-    if ( rpcPic->getReconMark() == false && rpcPic->getOutputMark() == false)
+    TComPic* pcPic = *(iterPic);
+    if ( !pcPic->getOutputMark() && ( !pcPic->getReconMark() || !pcPic->getSlice( 0 )->isReferenced() ) )
     {
-      rpcPic->setOutputMark(false);
-      bBufferIsAvailable = true;
-      break;
+      m_cPicPool.release( pcPic );
+      iterPic = m_cListPic.erase( iterPic );
     }
-
-    if ( rpcPic->getSlice( 0 )->isReferenced() == false  && rpcPic->getOutputMark() == false)
+    else
     {
-      rpcPic->setOutputMark(false);
-      rpcPic->setReconMark( false );
-      rpcPic->getPicYuvRec()->setBorderExtension( false );
-      bBufferIsAvailable = true;
-      break;
+      iterPic++;
     }
   }
+}
 
-  if ( !bBufferIsAvailable )
+/** Return all pictures to the picture pool, once the application has flushed them to the output.
+ */
+Void TDecTop::releasePicBuffer()
+{
+  for (TComList<TComPic*>::iterator iterPic = m_cListPic.begin(); iterPic != m_cListPic.end(); iterPic++)
   {
-    //There is no room for this picture, either because of faulty encoder or dropped NAL. Extend the buffer.
-    m_iMaxRefPicNum++;
-    rpcPic = new TComPic();
-    m_cListPic.pushBack( rpcPic );
+    m_cPicPool.release( *iterPic );
   }
-  rpcPic->destroy();
-  rpcPic->create ( pcSlice->getSPS()->getPicWidthInLumaSamples(), pcSlice->getSPS()->getPicHeightInLumaSamples(), pcSlice->getSPS()->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
-                   conformanceWindow, defaultDisplayWindow, numReorderPics, true);
-#if !HM_CLEANUP_SAO
-  rpcPic->getPicSym()->allocSaoParam(&m_cSAO);
-#endif
+  m_cListPic.clear();
 }
 
 Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   if (!m_pcPic)
   {
     /* nothing to deblock */
@@ -199,24 +256,186 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
 
   // Execute Deblock + Cleanup
 
-  m_cGopDecoder.filterPicture(pcPic);
+  if (getPipelined())
+  {
+    // The picture is marked right away, so that picture buffer management and output decisions are
+    // the same as in serial decoding. Users of the picture wait for the queued filtering to finish.
+    const Double dDecTime      = m_cGopDecoder.takeDecTime();
+    const UInt   uiSliceIdx    = pcPic->getCurrSliceIdx();
+    const Bool   bIsReferenced = pcPic->getSlice(uiSliceIdx)->isReferenced();
+    TComPic*     pcFilterPic   = pcPic;
+
+    queuePictureTask( pcPic, NULL, [this, pcFilterPic, uiSliceIdx, dDecTime, bIsReferenced]() { xFilterPictureTask(pcFilterPic, uiSliceIdx, dDecTime, bIsReferenced); } );
+    pcPic->setOutputMark(true);
+    pcPic->setReconMark(true);
+  }
+  else
+  {
+    m_cGopDecoder.filterPicture(pcPic);
+  }
 
   TComSlice::sortPicList( m_cListPic ); // sorting for application output
   poc                 = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
   rpcListPic          = &m_cListPic;
   m_cCuDecoder.destroy();
+  m_cSliceDecoder.destroy();
   m_bFirstSliceInPicture  = true;
 
   return;
 }
 
+Bool TDecTop::getPipelined() const
+{
+#if HM_CLEANUP_SAO
+  return m_bPipelined;
+#else
+  return false; // the old SAO collects slice boundary information for filtering in the parsing TDecGop
+#endif
+}
+
+/** Queue a task to run on the filter thread after all previously queued ones.
+    \param pcPic0 first picture accessed by the task
+    \param pcPic1 second picture accessed by the task, or NULL
+    \param cRun   the work to be done
+ */
+Void TDecTop::queuePictureTask( TComPic* pcPic0, TComPic* pcPic1, const std::function<Void()>& cRun )
+{
+  if (!m_cFilterThread.joinable())
+  {
+    m_cFilterThread = std::thread(&TDecTop::xFilterThread, this);
+  }
+
+  TDecPictureTask cTask;
+  cTask.apcPic[0] = pcPic0;
+  cTask.apcPic[1] = pcPic1;
+  cTask.cRun      = cRun;
+  {
+    std::lock_guard<std::mutex> cLock(m_cPictureTaskMutex);
+    m_cPictureTasks.push_back(cTask);
+  }
+  m_cPictureTaskCond.notify_all();
+}
+
+/** Block until no queued or running task accesses the picture any more.
+ */
+Void TDecTop::waitForPicture( const TComPic* pcPic )
+{
+  std::unique_lock<std::mutex> cLock(m_cPictureTaskMutex);
+  while (xIsPictureQueued(pcPic))
+  {
+    m_cPictureTaskCond.wait(cLock);
+  }
+}
+
+/** Block until all queued tasks have run.
+ */
+Void TDecTop::flushPipeline()
+{
+  std::unique_lock<std::mutex> cLock(m_cPictureTaskMutex);
+  while (!m_cPictureTasks.empty())
+  {
+    m_cPictureTaskCond.wait(cLock);
+  }
+}
+
+/** Apply newly received parameter sets. These may replace the ones queued pictures are filtered with,
+ *  so the pipeline is drained first.
+ */
+Void TDecTop::xApplyPrefetchedPS()
+{
+  if (m_bParameterSetsPending)
+  {
+    flushPipeline();
+    m_pcFilterSPS = NULL;
+    m_bParameterSetsPending = false;
+  }
+  m_parameterSetManagerDecoder.applyPrefetchedPS();
+}
+
+/** Wait for the queued filtering of all pictures still marked as used for reference. The picture about
+ *  to be decoded may predict from them, use their motion for TMVP and extend their borders.
+ */
+Void TDecTop::xWaitForReferencePictures()
+{
+  for (TComList<TComPic*>::iterator iterPic = m_cListPic.begin(); iterPic != m_cListPic.end(); iterPic++)
+  {
+    if ((*iterPic)->getSlice(0)->isReferenced())
+    {
+      waitForPicture(*iterPic);
+    }
+  }
+}
+
+Void TDecTop::xFilterPictureTask( TComPic* pcPic, UInt uiSliceIdx, Double dDecTime, Bool bIsReferenced )
+{
+  TComSPS* sps = pcPic->getSlice(0)->getSPS();
+
+  if (sps != m_pcFilterSPS)
+  {
+    m_cFilterSAO.destroy();
+#if HM_CLEANUP_SAO
+    m_cFilterSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), sps->getMaxCUWidth(), sps->getMaxCUHeight(), sps->getMaxCUDepth() );
+#else
+    m_cFilterSAO.create( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getMaxCUWidth(), sps->getMaxCUHeight() );
+#endif
+    m_cFilterLoopFilter.create( sps->getMaxCUDepth() );
+    m_pcFilterSPS = sps;
+  }
+
+  m_cFilterGopDecoder.filterPicture(pcPic, uiSliceIdx, dDecTime, bIsReferenced);
+}
+
+/// caller must hold m_cPictureTaskMutex
+Bool TDecTop::xIsPictureQueued( const TComPic* pcPic ) const
+{
+  for (std::deque<TDecPictureTask>::const_iterator it = m_cPictureTasks.begin(); it != m_cPictureTasks.end(); it++)
+  {
+    if (it->apcPic[0] == pcPic || it->apcPic[1] == pcPic)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Body of the filter thread. The running task stays at the front of the queue until it has finished,
+ *  so that waiting for a picture also covers the task currently working on it.
+ */
+Void TDecTop::xFilterThread()
+{
+  TComRomScope cRomScope( &m_cRomContext );
+  std::unique_lock<std::mutex> cLock(m_cPictureTaskMutex);
+
+  while (true)
+  {
+    while (m_cPictureTasks.empty() && !m_bFilterThreadExit)
+    {
+      m_cPictureTaskCond.wait(cLock);
+    }
+    if (m_cPictureTasks.empty())
+    {
+      return;
+    }
+
+    std::function<Void()> cRun = m_cPictureTasks.front().cRun;
+    cLock.unlock();
+    cRun();
+    cLock.lock();
+
+    m_cPictureTasks.pop_front();
+    m_cPictureTaskCond.notify_all();
+  }
+}
+
 Void TDecTop::xCreateLostPicture(Int iLostPoc)
 {
+  flushPipeline();
   printf("\ninserting lost poc : %d\n",iLostPoc);
   TComSlice cFillSlice;
   cFillSlice.setSPS( m_parameterSetManagerDecoder.getFirstSPS() );
   cFillSlice.setPPS( m_parameterSetManagerDecoder.getFirstPPS() );
   cFillSlice.initSlice();
+  cFillSlice.setPOC( iLostPoc );
   TComPic *cFillPic;
   xGetNewPicBuffer(&cFillSlice,cFillPic);
   cFillPic->getSlice(0)->setSPS( m_parameterSetManagerDecoder.getFirstSPS() );
@@ -262,7 +481,7 @@ Void TDecTop::xCreateLostPicture(Int iLostPoc)
 
 Void TDecTop::xActivateParameterSets()
 {
-  m_parameterSetManagerDecoder.applyPrefetchedPS();
+  xApplyPrefetchedPS();
 
   TComPPS *pps = m_parameterSetManagerDecoder.getPPS(m_apcSlicePilot->getPPSId());
   assert (pps != 0);
@@ -428,6 +647,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     // Buffer initialize for prediction.
     m_cPrediction.initTempBuff(m_apcSlicePilot->getSPS()->getChromaFormatIdc());
     m_apcSlicePilot->applyReferencePictureSet(m_cListPic, m_apcSlicePilot->getRPS());
+    xWaitForReferencePictures();
     //  Get a new picture buffer
     xGetNewPicBuffer (m_apcSlicePilot, pcPic);
 
@@ -459,7 +679,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
     m_cTrQuant.init     ( g_uiMaxCUWidth, g_uiMaxCUHeight, m_apcSlicePilot->getSPS()->getMaxTrSize());
 
-    m_cSliceDecoder.create();
+    m_cSliceDecoder.create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight, m_apcSlicePilot->getSPS()->getChromaFormatIdc(), m_apcSlicePilot->getSPS()->getMaxTrSize() );
   }
   else
   {
@@ -663,6 +883,7 @@ Void TDecTop::xDecodeVPS()
 
   m_cEntropyDecoder.decodeVPS( vps );
   m_parameterSetManagerDecoder.storePrefetchedVPS(vps);
+  m_bParameterSetsPending = true;
 }
 
 Void TDecTop::xDecodeSPS()
@@ -670,6 +891,7 @@ Void TDecTop::xDecodeSPS()
   TComSPS* sps = new TComSPS();
   m_cEntropyDecoder.decodeSPS( sps );
   m_parameterSetManagerDecoder.storePrefetchedSPS(sps);
+  m_bParameterSetsPending = true;
 }
 
 Void TDecTop::xDecodePPS()
@@ -677,6 +899,7 @@ Void TDecTop::xDecodePPS()
   TComPPS* pps = new TComPPS();
   m_cEntropyDecoder.decodePPS( pps );
   m_parameterSetManagerDecoder.storePrefetchedPPS( pps );
+  m_bParameterSetsPending = true;
 }
 
 Void TDecTop::xDecodeSEI( TComInputBitstream* bs, const NalUnitType nalUnitType )
@@ -692,7 +915,7 @@ Void TDecTop::xDecodeSEI( TComInputBitstream* bs, const NalUnitType nalUnitType
     if (activeParamSets.size()>0)
     {
       SEIActiveParameterSets *seiAps = (SEIActiveParameterSets*)(*activeParamSets.begin());
-      m_parameterSetManagerDecoder.applyPrefetchedPS();
+      xApplyPrefetchedPS();
       assert(seiAps->activeSeqParamSetId.size()>0);
       if (! m_parameterSetManagerDecoder.activateSPSWithSEI(seiAps->activeSeqParamSetId[0] ))
       {
@@ -704,6 +927,8 @@ Void TDecTop::xDecodeSEI( TComInputBitstream* bs, const NalUnitType nalUnitType
 
 Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   // Initialize entropy decoder
   m_cEntropyDecoder.setEntropyDecoder (&m_cCavlcDecoder);
   m_cEntropyDecoder.setBitstream      (nalu.m_Bitstream);
@@ -44,6 +44,8 @@
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/SEI.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TLibCommon/TComPicPool.h"
 
 #include "TDecGop.h"
 #include "TDecEntropy.h"
@@ -51,6 +53,12 @@
 #include "TDecCAVLC.h"
 #include "SEIread.h"
 
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 struct InputNALUnit;
 
 //! \ingroup TLibDecoder
@@ -60,10 +68,19 @@ struct InputNALUnit;
 // Class definition
 // ====================================================================================================================
 
+/// work deferred to the filter thread of the pipelined decoder, run in the order it is queued
+struct TDecPictureTask
+{
+  TComPic*               apcPic[2]; ///< pictures accessed by the task, which may not be reused before it has run
+  std::function<Void()>  cRun;
+};
+
 /// decoder class
 class TDecTop
 {
 private:
+  TComRomContext          m_cRomContext;      ///< CTU geometry, bit depths and derived tables, bound by the entry points
+
   Int                     m_iMaxRefPicNum;
   
   NalUnitType             m_associatedIRAPType; ///< NAL unit type of the associated IRAP picture
@@ -71,6 +88,7 @@ private:
   Int                     m_pocRandomAccess;   ///< POC number of the random access point (the first IDR or CRA picture)
 
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
+  TComPicPool             m_cPicPool;         ///< picture buffers; m_cListPic holds the acquired ones
   ParameterSetManagerDecoder m_parameterSetManagerDecoder;  // storage for parameter sets 
   TComSlice*              m_apcSlicePilot;
   
@@ -79,6 +97,7 @@ private:
   // functional classes
   TComPrediction          m_cPrediction;
   TComTrQuant             m_cTrQuant;
+  TComThreadPool          m_cThreadPool;            ///< workers shared by the slice decoders
   TDecGop                 m_cGopDecoder;
   TDecSlice               m_cSliceDecoder;
   TDecCu                  m_cCuDecoder;
@@ -100,6 +119,19 @@ private:
   Bool                    m_prevSliceSkipped;
   Int                     m_skippedPOC;
 
+  // pipelined decoding: in-loop filtering, hash checking and picture output run on a separate thread
+  Bool                    m_bPipelined;
+  Bool                    m_bParameterSetsPending;  ///< parameter sets were received that may replace ones used by queued pictures
+  TDecGop                 m_cFilterGopDecoder;
+  TComLoopFilter          m_cFilterLoopFilter;
+  TComSampleAdaptiveOffset m_cFilterSAO;
+  const TComSPS*          m_pcFilterSPS;            ///< SPS the filter thread's loop filter and SAO were created for
+  std::deque<TDecPictureTask> m_cPictureTasks;      ///< queued and running tasks, the running one at the front
+  Bool                    m_bFilterThreadExit;
+  std::thread             m_cFilterThread;
+  std::mutex              m_cPictureTaskMutex;
+  std::condition_variable m_cPictureTaskCond;
+
 public:
   TDecTop();
   virtual ~TDecTop();
@@ -107,17 +139,30 @@ public:
   Void  create  ();
   Void  destroy ();
 
-  void setDecodedPictureHashSEIEnabled(Int enabled) { m_cGopDecoder.setDecodedPictureHashSEIEnabled(enabled); }
+  /// CTU geometry and bit depths of the active SPS
+  const TComRomContext& getRomContext() const { return m_cRomContext; }
+  TComRomContext&       getRomContext()       { return m_cRomContext; }
+
+  void setDecodedPictureHashSEIEnabled(Int enabled) { m_cGopDecoder.setDecodedPictureHashSEIEnabled(enabled); m_cFilterGopDecoder.setDecodedPictureHashSEIEnabled(enabled); }
+  Void  setNumThreads   ( Int iNumThreads ) { m_cThreadPool.destroy(); m_cThreadPool.create(iNumThreads); }
+  Void  setPipelined    ( Bool bPipelined ) { m_bPipelined = bPipelined; }
+  Bool  getPipelined    () const;
+
+  Void  queuePictureTask( TComPic* pcPic0, TComPic* pcPic1, const std::function<Void()>& cRun );
+  Void  waitForPicture  ( const TComPic* pcPic );
+  Void  flushPipeline   ();
 
   Void  init();
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
   
   Void  deletePicBuffer();
+  Void  releasePicBuffer();
 
   Void executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic);
 
 protected:
   Void  xGetNewPicBuffer  (TComSlice* pcSlice, TComPic*& rpcPic);
+  Void  xReleasePics      ();
   Void  xCreateLostPicture (Int iLostPOC);
 
   Void      xActivateParameterSets();
@@ -127,6 +172,12 @@ protected:
   Void      xDecodePPS();
   Void      xDecodeSEI( TComInputBitstream* bs, const NalUnitType nalUnitType );
 
+  Void      xApplyPrefetchedPS();
+  Void      xWaitForReferencePictures();
+  Void      xFilterPictureTask( TComPic* pcPic, UInt uiSliceIdx, Double dDecTime, Bool bIsReferenced );
+  Bool      xIsPictureQueued  ( const TComPic* pcPic ) const;
+  Void      xFilterThread     ();
+
 };// END CLASS DEFINITION TDecTop
 
 
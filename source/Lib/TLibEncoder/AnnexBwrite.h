@@ -44,44 +44,52 @@
 //! \{
 
 /**
- * write all NALunits in au to bytestream out in a manner satisfying
- * AnnexB of AVC.  NALunits are written in the order they are found in au.
+ * write a single NALunit to bytestream out in a manner satisfying AnnexB of AVC,
+ * returning the size of the byte stream NAL unit in bytes.
  * the zero_byte word is appended to:
- *  - the initial startcode in the access unit,
+ *  - the initial startcode in the access unit (bFirstInAccessUnit),
  *  - any SPS/PPS nal units
  */
+static UInt writeAnnexB(std::ostream& out, const NALUnitEBSP& nalu, Bool bFirstInAccessUnit)
+{
+  UInt size = 0; /* size of annexB unit in bytes */
+
+  static const Char start_code_prefix[] = {0,0,0,1};
+  if (bFirstInAccessUnit || nalu.m_nalUnitType == NAL_UNIT_SPS || nalu.m_nalUnitType == NAL_UNIT_PPS)
+  {
+    /* From AVC, When any of the following conditions are fulfilled, the
+     * zero_byte syntax element shall be present:
+     *  - the nal_unit_type within the nal_unit() is equal to 7 (sequence
+     *    parameter set) or 8 (picture parameter set),
+     *  - the byte stream NAL unit syntax structure contains the first NAL
+     *    unit of an access unit in decoding order, as specified by subclause
+     *    7.4.1.2.3.
+     */
+    out.write(start_code_prefix, 4);
+    size += 4;
+  }
+  else
+  {
+    out.write(start_code_prefix+1, 3);
+    size += 3;
+  }
+  out << nalu.m_nalUnitData.str();
+  size += UInt(nalu.m_nalUnitData.str().size());
+
+  return size;
+}
+
+/**
+ * write all NALunits in au to bytestream out in a manner satisfying
+ * AnnexB of AVC.  NALunits are written in the order they are found in au.
+ */
 static std::vector<UInt> writeAnnexB(std::ostream& out, const AccessUnit& au)
 {
   std::vector<UInt> annexBsizes;
 
   for (AccessUnit::const_iterator it = au.begin(); it != au.end(); it++)
   {
-    const NALUnitEBSP& nalu = **it;
-    UInt size = 0; /* size of annexB unit in bytes */
-
-    static const Char start_code_prefix[] = {0,0,0,1};
-    if (it == au.begin() || nalu.m_nalUnitType == NAL_UNIT_SPS || nalu.m_nalUnitType == NAL_UNIT_PPS)
-    {
-      /* From AVC, When any of the following conditions are fulfilled, the
-       * zero_byte syntax element shall be present:
-       *  - the nal_unit_type within the nal_unit() is equal to 7 (sequence
-       *    parameter set) or 8 (picture parameter set),
-       *  - the byte stream NAL unit syntax structure contains the first NAL
-       *    unit of an access unit in decoding order, as specified by subclause
-       *    7.4.1.2.3.
-       */
-      out.write(start_code_prefix, 4);
-      size += 4;
-    }
-    else
-    {
-      out.write(start_code_prefix+1, 3);
-      size += 3;
-    }
-    out << nalu.m_nalUnitData.str();
-    size += UInt(nalu.m_nalUnitData.str().size());
-
-    annexBsizes.push_back(size);
+    annexBsizes.push_back(writeAnnexB(out, **it, it == au.begin()));
   }
 
   return annexBsizes;
@@ -40,15 +40,4 @@
 //! \ingroup TLibEncoder
 //! \{
 
-//////////////////////////////////////////////////////////////////////
-// Construction/Destruction
-//////////////////////////////////////////////////////////////////////
-
-TEncAnalyze             m_gcAnalyzeAll;
-TEncAnalyze             m_gcAnalyzeI;
-TEncAnalyze             m_gcAnalyzeP;
-TEncAnalyze             m_gcAnalyzeB;
-
-TEncAnalyze             m_gcAnalyzeAll_in;
-
 //! \}
@@ -82,6 +82,19 @@ public:
     m_uiNumPic++;
   }
 
+  /// add the results of the pictures coded by another encoder instance
+  Void  addResults( const TEncAnalyze& rcAnalyze )
+  {
+    m_dAddBits  += rcAnalyze.m_dAddBits;
+    for(UInt i=0; i<MAX_NUM_COMPONENT; i++)
+    {
+      m_dPSNRSum[i] += rcAnalyze.m_dPSNRSum[i];
+      m_MSEyuvframe[i] += rcAnalyze.m_MSEyuvframe[i];
+    }
+
+    m_uiNumPic += rcAnalyze.m_uiNumPic;
+  }
+
   Double  getPsnr(ComponentID compID) const { return  m_dPSNRSum[compID];  }
   Double  getBits()                   const { return  m_dAddBits;   }
   Void    setBits(Double numBits)     { m_dAddBits=numBits; }
@@ -286,13 +299,6 @@ public:
   }
 };
 
-extern TEncAnalyze             m_gcAnalyzeAll;
-extern TEncAnalyze             m_gcAnalyzeI;
-extern TEncAnalyze             m_gcAnalyzeP;
-extern TEncAnalyze             m_gcAnalyzeB;
-
-extern TEncAnalyze             m_gcAnalyzeAll_in;
-
 //! \}
 
 #endif // !defined(AFX_TENCANALYZE_H__C79BCAA2_6AC8_4175_A0FE_CF02F5829233__INCLUDED_)
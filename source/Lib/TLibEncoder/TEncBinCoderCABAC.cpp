@@ -46,6 +46,9 @@
 TEncBinCABAC::TEncBinCABAC()
 : m_pcTComBitIf( 0 )
 , m_binCountIncrement( 0 )
+, m_contextBaseAddr( 0 )
+, m_puiDirtyContextChunks( &m_uiUntrackedContextChunks )
+, m_uiUntrackedContextChunks( 0 )
 #if FAST_BIT_EST
 , m_fracBits( 0 )
 #endif
@@ -66,6 +69,16 @@ Void TEncBinCABAC::uninit()
   m_pcTComBitIf = 0;
 }
 
+/** Select the context set whose modified chunks are flagged by encodeBin
+ * \param pcContexts     first context model of the set
+ * \param puiDirtyChunks mask receiving one bit per (1 << CONTEXT_CHUNK_LOG2_SIZE) bytes of the set
+ */
+Void TEncBinCABAC::setContextTracker( const ContextModel* pcContexts, UInt64* puiDirtyChunks )
+{
+  m_contextBaseAddr       = reinterpret_cast<uintptr_t>( pcContexts );
+  m_puiDirtyContextChunks = puiDirtyChunks;
+}
+
 Void TEncBinCABAC::start()
 {
   m_uiLow            = 0;
@@ -198,6 +211,7 @@ Void TEncBinCABAC::encodeBin( UInt binValue, ContextModel &rcCtxModel )
 
   m_uiBinsCoded += m_binCountIncrement;
   rcCtxModel.setBinsCoded( 1 );
+  xMarkContextDirty( rcCtxModel );
   
   UInt  uiLPS   = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
   m_uiRange    -= uiLPS;
@@ -38,7 +38,10 @@
 #ifndef __TENCBINCODERCABAC__
 #define __TENCBINCODERCABAC__
 
+#include <stdint.h>
+
 #include "TLibCommon/TComCABACTables.h"
+#include "TLibCommon/ContextTables.h"
 #include "TEncBinCoder.h"
 
 //! \ingroup TLibEncoder
@@ -76,6 +79,9 @@ public:
   UInt  getBinsCoded              ()              { return m_uiBinsCoded;                }
   Void  setBinCountingEnableFlag  ( Bool bFlag )  { m_binCountIncrement = bFlag ? 1 : 0; }
   Bool  getBinCountingEnableFlag  ()              { return m_binCountIncrement != 0;     }
+
+  Void  setContextTracker         ( const ContextModel* pcContexts, UInt64* puiDirtyChunks );
+  Bool  isContextTracker          ( const UInt64* puiDirtyChunks ) const { return m_puiDirtyContextChunks == puiDirtyChunks; }
   
 #if FAST_BIT_EST
 protected:
@@ -84,6 +90,13 @@ private:
 #endif
   Void testAndWriteOut();
   Void writeOut();
+
+  /// flag the chunk of the tracked context set that holds rcCtxModel as modified
+  Void xMarkContextDirty( const ContextModel& rcCtxModel )
+  {
+    const uintptr_t offset = reinterpret_cast<uintptr_t>( &rcCtxModel ) - m_contextBaseAddr;
+    *m_puiDirtyContextChunks |= UInt64(1) << ( ( offset >> CONTEXT_CHUNK_LOG2_SIZE ) & 63 );
+  }
   
   TComBitIf*          m_pcTComBitIf;
   UInt                m_uiLow;
@@ -93,6 +106,9 @@ private:
   Int                 m_bitsLeft;
   UInt                m_uiBinsCoded;
   Int                 m_binCountIncrement;
+  uintptr_t           m_contextBaseAddr;          ///< address of the context set whose modifications are tracked
+  UInt64*             m_puiDirtyContextChunks;    ///< modified chunk mask of the tracked context set
+  UInt64              m_uiUntrackedContextChunks; ///< sink for the mask while no context set is tracked
 #if FAST_BIT_EST
   UInt64 m_fracBits;
 #endif
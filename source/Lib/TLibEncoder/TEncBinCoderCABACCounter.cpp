@@ -78,8 +78,8 @@ Void TEncBinCABACCounter::encodeBin( UInt binValue, ContextModel &rcCtxModel )
 #endif
   
   m_uiBinsCoded += m_binCountIncrement;
-  m_fracBits += rcCtxModel.getEntropyBits( binValue );
-  rcCtxModel.update( binValue );
+  m_fracBits += rcCtxModel.estimateBitsAndUpdate( binValue );
+  xMarkContextDirty( rcCtxModel );
 
 #ifdef DEBUG_ENCODER_SEARCH_BINS
   if ((g_debugCounter + debugEncoderSearchBinWindow) >= debugEncoderSearchBinTargetLine)
@@ -0,0 +1,347 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncBlockHash.cpp
+    \brief    hash table of block positions for hash-based block matching
+*/
+
+#include "TEncBlockHash.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+/// multipliers of the polynomial hash along a row and along a column of row hashes
+static const UInt s_uiRowFactor = 0x9E3779B1;
+static const UInt s_uiColFactor = 0x85EBCA77;
+
+static const Int  s_aiBlockSize[TEncBlockHash::NUM_BLOCK_SIZES] = { 8, 16 };
+
+/// uiFactor ^ iExp, modulo 2^32
+static UInt xPow( UInt uiFactor, Int iExp )
+{
+  UInt uiResult = 1;
+  for (Int i = 0; i < iExp; i++)
+  {
+    uiResult *= uiFactor;
+  }
+  return uiResult;
+}
+
+/// 1 + uiFactor + ... + uiFactor ^ (iNum - 1), modulo 2^32
+static UInt xSumOfPowers( UInt uiFactor, Int iNum )
+{
+  UInt uiSum = 0;
+  for (Int i = 0; i < iNum; i++)
+  {
+    uiSum = uiSum * uiFactor + 1;
+  }
+  return uiSum;
+}
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncBlockHash::TEncBlockHash()
+: m_uiBucketMask ( 0 )
+{
+}
+
+TEncBlockHash::~TEncBlockHash()
+{
+  destroy();
+}
+
+Void TEncBlockHash::create( UInt uiNumBucketsLog2 )
+{
+  m_uiBucketMask = ( 1 << uiNumBucketsLog2 ) - 1;
+  for (Int iSizeIdx = 0; iSizeIdx < NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    m_aacBuckets[iSizeIdx].resize( 1 << uiNumBucketsLog2 );
+  }
+}
+
+Void TEncBlockHash::destroy()
+{
+  for (Int iSizeIdx = 0; iSizeIdx < NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    std::vector<EntryList>().swap( m_aacBuckets[iSizeIdx] );
+  }
+  std::vector<UInt>().swap( m_auiRowHash );
+  std::vector<UChar>().swap( m_aucRowUniform );
+  std::vector<Int>().swap( m_aiNumUniformRows );
+  m_uiBucketMask = 0;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+Void TEncBlockHash::clear()
+{
+  for (Int iSizeIdx = 0; iSizeIdx < NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    for (std::vector<EntryList>::iterator it = m_aacBuckets[iSizeIdx].begin(); it != m_aacBuckets[iSizeIdx].end(); it++)
+    {
+      it->clear();
+    }
+  }
+}
+
+/** Add the blocks at all sample positions of an area. The row hashes of all windows of a row are rolled along the
+ * row, and the block hashes are rolled down the columns of row hashes, so the blocks are added in raster order.
+ * \param piPlane      sample (0, 0) of the plane
+ * \param iStride      stride of the plane
+ * \param iAreaX       left position of the area
+ * \param iAreaY       top position of the area
+ * \param iAreaWidth   width of the area
+ * \param iAreaHeight  height of the area
+ * \param bSkipUniformLines  do not add blocks whose rows are all uniform or whose columns are all uniform: flat areas
+ *                           and stripes would fill single buckets with matches at every position
+ */
+Void TEncBlockHash::addBlocks( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iAreaWidth, Int iAreaHeight, Bool bSkipUniformLines )
+{
+  for (Int iSizeIdx = 0; iSizeIdx < NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    const Int iSize = s_aiBlockSize[iSizeIdx];
+    if (iAreaWidth < iSize || iAreaHeight < iSize)
+    {
+      continue;
+    }
+
+    const Int  iNumX        = iAreaWidth - iSize + 1;
+    const UInt uiColLeading = xPow( s_uiColFactor, iSize - 1 );
+
+    xGetRowHashes( piPlane, iStride, iAreaX, iAreaY, iNumX, iAreaHeight, iSize );
+    UInt* puiBlockHash = &m_auiRowHash[iNumX * iAreaHeight];
+
+    // the hash of a row window of equal samples v is v * uiRowUniform, and the hash of a block of equal rows with row
+    // hash h is h * uiColUniform; other windows and blocks have these hashes only by rare collisions
+    const UInt uiRowUniform = xSumOfPowers( s_uiRowFactor, iSize );
+    const UInt uiColUniform = xSumOfPowers( s_uiColFactor, iSize );
+    if ( bSkipUniformLines )
+    {
+      m_aucRowUniform.resize( iNumX * iAreaHeight );
+      m_aiNumUniformRows.assign( iNumX, 0 );
+    }
+
+    if ( bSkipUniformLines )
+    {
+      for (Int y = 0; y < iAreaHeight; y++)
+      {
+        const Pel*  piRow         = piPlane + ( iAreaY + y ) * iStride + iAreaX;
+        const UInt* puiRowHash    = &m_auiRowHash[y * iNumX];
+        UChar*      pucRowUniform = &m_aucRowUniform[y * iNumX];
+        for (Int x = 0; x < iNumX; x++)
+        {
+          pucRowUniform[x] = puiRowHash[x] == UInt( piRow[x] ) * uiRowUniform;
+        }
+      }
+    }
+
+    // hashes of the blocks, rolled down the columns of row hashes
+    for (Int x = 0; x < iNumX; x++)
+    {
+      UInt uiHash = 0;
+      for (Int j = 0; j < iSize; j++)
+      {
+        uiHash = uiHash * s_uiColFactor + m_auiRowHash[j * iNumX + x];
+      }
+      puiBlockHash[x] = uiHash;
+    }
+    if ( bSkipUniformLines )
+    {
+      for (Int j = 0; j < iSize; j++)
+      {
+        for (Int x = 0; x < iNumX; x++)
+        {
+          m_aiNumUniformRows[x] += m_aucRowUniform[j * iNumX + x];
+        }
+      }
+    }
+
+    std::vector<EntryList>& rcBuckets = m_aacBuckets[iSizeIdx];
+    for (Int y = 0; ; y++)
+    {
+      const UInt* puiTopRow = &m_auiRowHash[y * iNumX];
+      for (Int x = 0; x < iNumX; x++)
+      {
+        if ( bSkipUniformLines && ( m_aiNumUniformRows[x] == iSize || puiBlockHash[x] == puiTopRow[x] * uiColUniform ) )
+        {
+          continue;
+        }
+        TEncBlockHashEntry cEntry;
+        cEntry.uiHash = xFinalize( puiBlockHash[x] );
+        cEntry.iPosX  = iAreaX + x;
+        cEntry.iPosY  = iAreaY + y;
+        rcBuckets[cEntry.uiHash & m_uiBucketMask].push_back( cEntry );
+      }
+
+      if (y + iSize >= iAreaHeight)
+      {
+        break;
+      }
+
+      const UInt* puiBottomRow = &m_auiRowHash[( y + iSize ) * iNumX];
+      for (Int x = 0; x < iNumX; x++)
+      {
+        puiBlockHash[x] = ( puiBlockHash[x] - puiTopRow[x] * uiColLeading ) * s_uiColFactor + puiBottomRow[x];
+      }
+      if ( bSkipUniformLines )
+      {
+        const UChar* pucTopUniform    = &m_aucRowUniform[y * iNumX];
+        const UChar* pucBottomUniform = &m_aucRowUniform[( y + iSize ) * iNumX];
+        for (Int x = 0; x < iNumX; x++)
+        {
+          m_aiNumUniformRows[x] += pucBottomUniform[x] - pucTopUniform[x];
+        }
+      }
+    }
+  }
+}
+
+/** Hash the blocks of one size at all sample positions of an area, without adding them to the table.
+ * \param piPlane       sample (0, 0) of the plane
+ * \param iStride       stride of the plane
+ * \param iAreaX        left position of the area
+ * \param iAreaY        top position of the area
+ * \param iAreaWidth    width of the area
+ * \param iAreaHeight   height of the area
+ * \param iSize         block size
+ * \param puiHash       hashes of the blocks, the hash of the block at (iAreaX + x, iAreaY + y) is written to
+ *                      puiHash[y * iHashStride + x]
+ * \param iHashStride   stride of puiHash
+ */
+Void TEncBlockHash::getBlockHashes( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iAreaWidth, Int iAreaHeight, Int iSize, UInt* puiHash, Int iHashStride )
+{
+  if (iAreaWidth < iSize || iAreaHeight < iSize)
+  {
+    return;
+  }
+
+  const Int  iNumX        = iAreaWidth - iSize + 1;
+  const UInt uiColLeading = xPow( s_uiColFactor, iSize - 1 );
+
+  xGetRowHashes( piPlane, iStride, iAreaX, iAreaY, iNumX, iAreaHeight, iSize );
+  UInt* puiBlockHash = &m_auiRowHash[iNumX * iAreaHeight];
+
+  for (Int x = 0; x < iNumX; x++)
+  {
+    UInt uiHash = 0;
+    for (Int j = 0; j < iSize; j++)
+    {
+      uiHash = uiHash * s_uiColFactor + m_auiRowHash[j * iNumX + x];
+    }
+    puiBlockHash[x] = uiHash;
+  }
+
+  for (Int y = 0; ; y++)
+  {
+    for (Int x = 0; x < iNumX; x++)
+    {
+      puiHash[y * iHashStride + x] = xFinalize( puiBlockHash[x] );
+    }
+
+    if (y + iSize >= iAreaHeight)
+    {
+      break;
+    }
+
+    const UInt* puiTopRow    = &m_auiRowHash[y * iNumX];
+    const UInt* puiBottomRow = &m_auiRowHash[( y + iSize ) * iNumX];
+    for (Int x = 0; x < iNumX; x++)
+    {
+      puiBlockHash[x] = ( puiBlockHash[x] - puiTopRow[x] * uiColLeading ) * s_uiColFactor + puiBottomRow[x];
+    }
+  }
+}
+
+UInt TEncBlockHash::getBlockHash( const Pel* piSrc, Int iStride, Int iSize )
+{
+  UInt uiHash = 0;
+  for (Int j = 0; j < iSize; j++)
+  {
+    UInt uiRowHash = 0;
+    for (Int i = 0; i < iSize; i++)
+    {
+      uiRowHash = uiRowHash * s_uiRowFactor + UInt( piSrc[i] );
+    }
+    uiHash = uiHash * s_uiColFactor + uiRowHash;
+    piSrc += iStride;
+  }
+  return xFinalize( uiHash );
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Hash the windows of iSize samples at all positions of the rows of an area into the first iAreaHeight rows of
+ * m_auiRowHash, and allocate one more row for the block hashes.
+ */
+Void TEncBlockHash::xGetRowHashes( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iNumX, Int iAreaHeight, Int iSize )
+{
+  const UInt uiRowLeading = xPow( s_uiRowFactor, iSize - 1 );
+
+  m_auiRowHash.resize( iNumX * ( iAreaHeight + 1 ) );
+  for (Int y = 0; y < iAreaHeight; y++)
+  {
+    const Pel* piRow      = piPlane + ( iAreaY + y ) * iStride + iAreaX;
+    UInt*      puiRowHash = &m_auiRowHash[y * iNumX];
+
+    UInt uiHash = 0;
+    for (Int i = 0; i < iSize; i++)
+    {
+      uiHash = uiHash * s_uiRowFactor + UInt( piRow[i] );
+    }
+    puiRowHash[0] = uiHash;
+    for (Int x = 1; x < iNumX; x++)
+    {
+      uiHash = ( uiHash - UInt( piRow[x - 1] ) * uiRowLeading ) * s_uiRowFactor + UInt( piRow[x + iSize - 1] );
+      puiRowHash[x] = uiHash;
+    }
+  }
+}
+
+/// mix the bits of the polynomial hash, so that the low bits that select the bucket depend on all samples
+UInt TEncBlockHash::xFinalize( UInt uiHash )
+{
+  uiHash ^= uiHash >> 16;
+  uiHash *= 0x85EBCA6B;
+  uiHash ^= uiHash >> 13;
+  uiHash *= 0xC2B2AE35;
+  uiHash ^= uiHash >> 16;
+  return uiHash;
+}
+
+//! \}
@@ -0,0 +1,119 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncBlockHash.h
+    \brief    hash table of block positions for hash-based block matching (header)
+*/
+
+#ifndef __TENCBLOCKHASH__
+#define __TENCBLOCKHASH__
+
+#include "TLibCommon/CommonDef.h"
+
+#include <vector>
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Type definition
+// ====================================================================================================================
+
+/// position of a block in a hash table
+struct TEncBlockHashEntry
+{
+  UInt  uiHash;   ///< hash of the block samples
+  Int   iPosX;    ///< horizontal position of the top-left sample in the plane
+  Int   iPosY;    ///< vertical position of the top-left sample in the plane
+};
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/** Hash table of the square 8x8 and 16x16 blocks of a luma plane. The hash of a block is a 2-D polynomial rolling
+ * hash, so the blocks at every sample position of an area are hashed with a few operations per sample and block size.
+ * Blocks with the same samples have the same hash, but a match still has to be verified against the samples.
+ */
+class TEncBlockHash
+{
+public:
+  static const Int NUM_BLOCK_SIZES = 2;  ///< 8x8 and 16x16
+  static const Int MAX_BLOCK_SIZE  = 16; ///< size of the largest blocks
+
+private:
+  typedef std::vector<TEncBlockHashEntry> EntryList;
+
+  UInt                    m_uiBucketMask;
+  std::vector<EntryList>  m_aacBuckets[NUM_BLOCK_SIZES];  ///< entries, indexed by the low bits of the hash
+  std::vector<UInt>       m_auiRowHash;                   ///< temporary row hashes of addBlocks()
+  std::vector<UChar>      m_aucRowUniform;                ///< temporary flags of addBlocks(): all samples of the row window are equal
+  std::vector<Int>        m_aiNumUniformRows;             ///< temporary counts of addBlocks(): uniform row windows of the block
+
+  static UInt xFinalize     ( UInt uiHash );
+
+  Void        xGetRowHashes ( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iNumX, Int iAreaHeight, Int iSize );
+
+public:
+  TEncBlockHash();
+  virtual ~TEncBlockHash();
+
+  /// allocate (1 << uiNumBucketsLog2) buckets per block size
+  Void  create              ( UInt uiNumBucketsLog2 );
+  Void  destroy             ();
+
+  /// remove all entries, keeping the memory
+  Void  clear               ();
+
+  /// add all blocks that lie completely inside the area, piPlane points to the sample (0, 0) of the plane
+  Void  addBlocks           ( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iAreaWidth, Int iAreaHeight, Bool bSkipUniformLines = false );
+
+  /// hashes of the blocks of size iSize at all positions of the area, equal to the hashes that addBlocks() computes
+  Void  getBlockHashes      ( const Pel* piPlane, Int iStride, Int iAreaX, Int iAreaY, Int iAreaWidth, Int iAreaHeight, Int iSize, UInt* puiHash, Int iHashStride );
+
+  /// entries whose hash is in the same bucket as uiHash, in the order they were added
+  const std::vector<TEncBlockHashEntry>& getEntries( UInt uiHash, Int iSize ) const { return m_aacBuckets[getSizeIdx( iSize )][uiHash & m_uiBucketMask]; }
+
+  /// index of a block size, -1 if blocks of the size are not hashed
+  static Int  getSizeIdx      ( Int iSize )                { return iSize == 8 ? 0 : ( iSize == 16 ? 1 : -1 ); }
+
+  /// whether blocks of the size are hashed
+  static Bool isSupportedSize ( Int iWidth, Int iHeight )  { return iWidth == iHeight && getSizeIdx( iWidth ) >= 0; }
+
+  /// hash of one block, equal to the hash that addBlocks() computes for a block with the same samples
+  static UInt getBlockHash    ( const Pel* piSrc, Int iStride, Int iSize );
+};
+
+//! \}
+
+#endif // __TENCBLOCKHASH__
@@ -169,6 +169,9 @@ protected:
   Int       m_iFastSearch;                      //  0:Full search  1:Diamond  2:PMVFAST
   Int       m_iSearchRange;                     //  0:Full frame
   Int       m_bipredSearchRange;
+  Bool      m_useHashME;                        //  look up exactly matching blocks in the reference pictures first
+  Bool      m_useSubPelCache;                   //  interpolate the sub-pel planes of the reference pictures once
+  Bool      m_usePyramidME;                     //  coarse motion search on picture pyramids for the start of the TZ search
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -183,11 +186,15 @@ protected:
 #endif
   Bool      m_useExtendedPrecision;
   Bool      m_useIntraBlockCopy;
+  Bool      m_useIntraBlockCopyHashSearch;
 #if RExt__O0235_HIGH_PRECISION_PREDICTION_WEIGHTING
   Bool      m_useHighPrecisionPredictionWeighting;
 #endif
   Bool      m_bUseAdaptiveQP;
   Int       m_iQPAdaptationRange;
+  Bool      m_useLookahead;                     //  analyse the received pictures on a lookahead thread
+  Bool      m_useLookaheadSceneCut;             //  code the scene cuts found by the lookahead with I slices
+  Bool      m_useLookaheadIntraPruning;         //  skip intra modes in CTUs that the lookahead found well predicted
   
   //====== Tool list ========
   Bool      m_bUseSBACRD;
@@ -251,6 +258,8 @@ protected:
 
   Int       m_iWaveFrontSynchro;
   Int       m_iWaveFrontSubstreams;
+  Int       m_iNumThreads;                      //  number of worker threads of the encoder
+  Bool      m_bLowLatencyOutput;                //  pass NAL units on as soon as they are coded, code pictures as they are received if the GOP does not reorder them
 
   Int       m_decodedPictureHashSEIEnabled;              ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
   Int       m_bufferingPeriodSEIEnabled;
@@ -360,6 +369,8 @@ public:
   TEncCfg()
   : m_puiColumnWidth()
   , m_puiRowHeight()
+  , m_iNumThreads(1)
+  , m_bLowLatencyOutput(false)
   {}
 
   virtual ~TEncCfg()
@@ -423,6 +434,9 @@ public:
   Void      setFastSearch                   ( Int   i )      { m_iFastSearch = i; }
   Void      setSearchRange                  ( Int   i )      { m_iSearchRange = i; }
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
+  Void      setUseHashME                    ( Bool  b )      { m_useHashME = b; }
+  Void      setUseSubPelCache               ( Bool  b )      { m_useSubPelCache = b; }
+  Void      setUsePyramidME                 ( Bool  b )      { m_usePyramidME = b; }
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -445,6 +459,9 @@ public:
   Bool      getUseIntraBlockCopy()         const   { return m_useIntraBlockCopy;  }
   Void      setUseIntraBlockCopy(Bool value)       { m_useIntraBlockCopy = value; }
 
+  Bool      getUseIntraBlockCopyHashSearch()         const   { return m_useIntraBlockCopyHashSearch;  }
+  Void      setUseIntraBlockCopyHashSearch(Bool value)       { m_useIntraBlockCopyHashSearch = value; }
+
 #if RExt__O0235_HIGH_PRECISION_PREDICTION_WEIGHTING
   Bool      getUseHighPrecisionPredictionWeighting() const { return m_useHighPrecisionPredictionWeighting; }
   Void      setUseHighPrecisionPredictionWeighting(Bool value) { m_useHighPrecisionPredictionWeighting = value; }
@@ -452,6 +469,9 @@ public:
 
   Void      setUseAdaptiveQP                ( Bool  b )      { m_bUseAdaptiveQP = b; }
   Void      setQPAdaptationRange            ( Int   i )      { m_iQPAdaptationRange = i; }
+  Void      setUseLookahead                 ( Bool  b )      { m_useLookahead = b; }
+  Void      setUseLookaheadSceneCut         ( Bool  b )      { m_useLookaheadSceneCut = b; }
+  Void      setUseLookaheadIntraPruning     ( Bool  b )      { m_useLookaheadIntraPruning = b; }
   
 #if RExt__BACKWARDS_COMPATIBILITY_HM_TRANSQUANTBYPASS
   //====== Lossless ========
@@ -493,12 +513,19 @@ public:
   //==== Motion search ========
   Int       getFastSearch                   ()      { return  m_iFastSearch; }
   Int       getSearchRange                  ()      { return  m_iSearchRange; }
+  Int       getBipredSearchRange            ()      { return  m_bipredSearchRange; }
+  Bool      getUseHashME                    ()      { return  m_useHashME; }
+  Bool      getUseSubPelCache               ()      { return  m_useSubPelCache; }
+  Bool      getUsePyramidME                 ()      { return  m_usePyramidME; }
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   ()      { return  m_iMaxDeltaQP; }
   Int       getMaxCuDQPDepth                ()      { return  m_iMaxCuDQPDepth; }
   Bool      getUseAdaptiveQP                ()      { return  m_bUseAdaptiveQP; }
   Int       getQPAdaptationRange            ()      { return  m_iQPAdaptationRange; }
+  Bool      getUseLookahead                 ()      { return  m_useLookahead; }
+  Bool      getUseLookaheadSceneCut         ()      { return  m_useLookaheadSceneCut; }
+  Bool      getUseLookaheadIntraPruning     ()      { return  m_useLookaheadIntraPruning; }
 #if RExt__BACKWARDS_COMPATIBILITY_HM_TRANSQUANTBYPASS
   //====== Lossless ========
   Bool      getUseLossless                  ()      { return  m_useLossless;  }
@@ -646,6 +673,10 @@ public:
   Int   getWaveFrontsynchro()                            { return m_iWaveFrontSynchro; }
   Void  setWaveFrontSubstreams(Int iWaveFrontSubstreams) { m_iWaveFrontSubstreams = iWaveFrontSubstreams; }
   Int   getWaveFrontSubstreams()                         { return m_iWaveFrontSubstreams; }
+  Void  setNumThreads(Int iNumThreads)                   { m_iNumThreads = iNumThreads; }
+  Int   getNumThreads()                                  { return m_iNumThreads; }
+  Void  setLowLatencyOutput(Bool b)                      { m_bLowLatencyOutput = b; }
+  Bool  getLowLatencyOutput()                            { return m_bLowLatencyOutput; }
   Void  setDecodedPictureHashSEIEnabled(Int b)           { m_decodedPictureHashSEIEnabled = b; }
   Int   getDecodedPictureHashSEIEnabled()                { return m_decodedPictureHashSEIEnabled; }
   Void  setBufferingPeriodSEIEnabled(Int b)              { m_bufferingPeriodSEIEnabled = b; }
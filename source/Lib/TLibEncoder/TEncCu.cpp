@@ -200,20 +200,35 @@ Void TEncCu::destroy()
 /** \param    pcEncTop      pointer of encoder class
  */
 Void TEncCu::init( TEncTop* pcEncTop )
+{
+  init( pcEncTop, pcEncTop->getPredSearch(), pcEncTop->getTrQuant(), pcEncTop->getRdCost(), pcEncTop->getEntropyCoder(),
+        pcEncTop->getRDSbacCoder(), pcEncTop->getRDGoOnSbacCoder() );
+}
+
+/** \param pcEncTop           encoder class, for the configuration and the shared coders
+ * \param pcPredSearch       search class used by this CU encoder
+ * \param pcTrQuant          transform & quantization class used by this CU encoder
+ * \param pcRdCost           RD cost class used by this CU encoder
+ * \param pcEntropyCoder     entropy encoder used by this CU encoder
+ * \param pppcRDSbacCoder    SBAC coders for RD optimization, per depth
+ * \param pcRDGoOnSbacCoder  go-on SBAC coder for RD optimization
+ */
+Void TEncCu::init( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder )
 {
   m_pcEncCfg           = pcEncTop;
-  m_pcPredSearch       = pcEncTop->getPredSearch();
-  m_pcTrQuant          = pcEncTop->getTrQuant();
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
   m_pcBitCounter       = pcEncTop->getBitCounter();
-  m_pcRdCost           = pcEncTop->getRdCost();
+  m_pcRdCost           = pcRdCost;
 
-  m_pcEntropyCoder     = pcEncTop->getEntropyCoder();
+  m_pcEntropyCoder     = pcEntropyCoder;
   m_pcCavlcCoder       = pcEncTop->getCavlcCoder();
   m_pcSbacCoder        = pcEncTop->getSbacCoder();
   m_pcBinCABAC         = pcEncTop->getBinCABAC();
 
-  m_pppcRDSbacCoder    = pcEncTop->getRDSbacCoder();
-  m_pcRDGoOnSbacCoder  = pcEncTop->getRDGoOnSbacCoder();
+  m_pppcRDSbacCoder    = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder  = pcRDGoOnSbacCoder;
 
   m_bUseSBACRD         = pcEncTop->getUseSBACRD();
   m_pcRateCtrl         = pcEncTop->getRateCtrl();
@@ -424,6 +439,14 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
   Bool    doNotBlockPu = true;
   Bool    earlyDetectionSkipMode = false;
 
+  // the lookahead found the CTU much cheaper to predict from the previous picture than from its neighbours
+  Bool    bLookaheadSkipIntra = false;
+  if ( m_pcEncCfg->getUseLookaheadIntraPruning() && rpcBestCU->getSlice()->getSliceType() != I_SLICE )
+  {
+    const TEncPic* pcEPic = dynamic_cast<const TEncPic*>( pcPic );
+    bLookaheadSkipIntra = pcEPic->getLookaheadInterCost( rpcBestCU->getAddr() ) < LOOKAHEAD_INTRA_PRUNING_RATIO * pcEPic->getLookaheadIntraCost( rpcBestCU->getAddr() );
+  }
+
   Bool bBoundary = false;
   UInt uiLPelX   = rpcBestCU->getCUPelX();
   UInt uiRPelX   = uiLPelX + rpcBestCU->getWidth(0)  - 1;
@@ -700,10 +723,11 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
         Double intraCost = 0.0;
 #endif
 
-        if((rpcBestCU->getSlice()->getSliceType() == I_SLICE)                                     ||
-           (rpcBestCU->getCbf( 0, COMPONENT_Y  ) != 0)                                            ||
-          ((rpcBestCU->getCbf( 0, COMPONENT_Cb ) != 0) && (numberValidComponents > COMPONENT_Cb)) ||
-          ((rpcBestCU->getCbf( 0, COMPONENT_Cr ) != 0) && (numberValidComponents > COMPONENT_Cr))  ) // avoid very complex intra if it is unlikely
+        if(((rpcBestCU->getSlice()->getSliceType() == I_SLICE)                                     ||
+            (rpcBestCU->getCbf( 0, COMPONENT_Y  ) != 0)                                            ||
+           ((rpcBestCU->getCbf( 0, COMPONENT_Cb ) != 0) && (numberValidComponents > COMPONENT_Cb)) ||
+           ((rpcBestCU->getCbf( 0, COMPONENT_Cr ) != 0) && (numberValidComponents > COMPONENT_Cr))  ) && // avoid very complex intra if it is unlikely
+           !bLookaheadSkipIntra)
         {
 #if RExt__O0245_INTRABC_FAST_SEARCH_MODIFICATIONS
           xCheckRDCostIntra( rpcBestCU, rpcTempCU, intraCost, SIZE_2Nx2N DEBUG_STRING_PASS_INTO(sDebug) );
@@ -1038,6 +1062,7 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
   rpcBestCU->copyToPic(uiDepth);                                                     // Copy Best data to Picture for next partition prediction.
 
   xCopyYuv2Pic( rpcBestCU->getPic(), rpcBestCU->getAddr(), rpcBestCU->getZorderIdxInCU(), uiDepth, uiDepth, rpcBestCU, uiLPelX, uiTPelY );   // Copy Yuv data to picture Yuv
+  m_pcPredSearch->invalidateIntraBCHash( uiTPelY );
   if( bBoundary ||(bSliceEnd && bInsidePicture))
   {
     return;
@@ -1131,8 +1156,13 @@ Void TEncCu::finishCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
   }
   if(granularityBoundary)
   {
-    pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
-    pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+    // the running slice sizes are only needed to end slices by size; they are left alone otherwise,
+    // as CTU rows may then be compressed concurrently (TEncSlice::compressSlice with several threads)
+    if(pcSlice->getSliceMode()==FIXED_NUMBER_OF_BYTES || pcSlice->getSliceSegmentMode()==FIXED_NUMBER_OF_BYTES)
+    {
+      pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+      pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+    }
     if (m_pcBitCounter)
     {
       m_pcEntropyCoder->resetBits();
@@ -103,6 +103,10 @@ public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
 
+  /// copy parameters from encoder class, using the given coding tools instead of the encoder's own
+  Void  init                ( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComRdCost* pcRdCost,
+                              TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder );
+
   /// create internal buffers
   Void  create              ( UChar uhTotalDepth, UInt iMaxWidth, UInt iMaxHeight, ChromaFormat chromaFormat );
 
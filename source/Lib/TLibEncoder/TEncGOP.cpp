@@ -41,6 +41,7 @@
 
 #include "TEncTop.h"
 #include "TEncGOP.h"
+#include "TEncPic.h"
 #include "TEncAnalyze.h"
 #include "libmd5/MD5.h"
 #include "TLibCommon/SEI.h"
@@ -79,6 +80,7 @@ TEncGOP::TEncGOP()
   m_iGopSize            = 0;
   m_iNumPicCoded        = 0; //Niko
   m_bFirst              = true;
+  m_bPictureOutput      = false;
 
   m_pcCfg               = NULL;
   m_pcSliceEncoder      = NULL;
@@ -138,6 +140,12 @@ Void TEncGOP::init ( TEncTop* pcTEncTop )
   m_lastBPSEI          = 0;
   m_totalCoded         = 0;
 
+  // pictures can be coded as they are received if the GOP structure does not reorder them
+  m_bPictureOutput = m_pcCfg->getLowLatencyOutput() && !m_pcCfg->getUseRateCtrl();
+  for ( Int iGOPid = 0; iGOPid < m_pcCfg->getGOPSize(); iGOPid++ )
+  {
+    m_bPictureOutput &= ( m_pcCfg->getGOPEntry( iGOPid ).m_POC == iGOPid + 1 );
+  }
 }
 
 SEIActiveParameterSets* TEncGOP::xCreateSEIActiveParameterSets (TComSPS *sps)
@@ -345,9 +353,16 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
   xInitGOP( iPOCLast, iNumPicRcvd, rcListPic, rcListPicYuvRecOut, isField );
 
-  m_iNumPicCoded = 0;
+  // with picture output, each call codes the last received picture only
+  const Int iGOPidFirst = ( m_bPictureOutput && !isField ) ? iNumPicRcvd - 1 : 0;
+  const Int iGOPidEnd   = ( m_bPictureOutput && !isField ) ? iNumPicRcvd     : m_iGopSize;
+
+  if ( iGOPidFirst == 0 )
+  {
+    m_iNumPicCoded = 0;
+  }
   SEIPictureTiming pictureTimingSEI;
-  Bool writeSOP = m_pcCfg->getSOPDescriptionSEIEnabled();
+  Bool writeSOP = m_pcCfg->getSOPDescriptionSEIEnabled() && iGOPidFirst == 0;
 
   // Initialize Scalable Nesting SEI with single layer values
   SEIScalableNesting scalableNestingSEI;
@@ -364,7 +379,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   UInt *accumBitsDU = NULL;
   UInt *accumNalsDU = NULL;
   SEIDecodingUnitInfo decodingUnitInfoSEI;
-  for ( Int iGOPid=0; iGOPid < m_iGopSize; iGOPid++ )
+  for ( Int iGOPid=iGOPidFirst; iGOPid < iGOPidEnd; iGOPid++ )
   {
     UInt uiColDir = 1;
     //-- For time output for each slice
@@ -445,6 +460,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     // start a new access unit: create an entry in the list of output access units
     accessUnitsInGOP.push_back(AccessUnit());
     AccessUnit& accessUnit = accessUnitsInGOP.back();
+    UInt uiNumNalusEmitted = 0; ///< number of NAL units of the access unit passed to the NAL unit callback
     xGetBuffer( rcListPic, rcListPicYuvRecOut, iNumPicRcvd, iTimeOffset, pcPic, pcPicYuvRecOut, pocCurr, isField );
 
     //  Slice data initialization
@@ -644,6 +660,15 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
     pcSlice->setList1IdxToList0Idx();
 
+    if (m_pcCfg->getUseHashME())
+    {
+      xBuildRefPicBlockHashes( pcSlice );
+    }
+    if (m_pcCfg->getUsePyramidME())
+    {
+      xPyramidMotionSearch( pcPic, pcSlice );
+    }
+
     if (m_pcEncTop->getTMVPModeId() == 2)
     {
       if (iGOPid == 0) // first picture in SOP (i.e. forward B)
@@ -939,12 +964,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     pcSlice = pcPic->getSlice(0);
 
     // SAO parameter estimation using non-deblocked pixels for LCU bottom and right boundary areas
-#if HM_CLEANUP_SAO
-    if( pcSlice->getSPS()->getUseSAO() && m_pcCfg->getSaoLcuBoundary() )
-    {
-      m_pcSAO->getPreDBFStatistics(pcPic);
-    }
-#else
+#if !HM_CLEANUP_SAO
     if( m_pcCfg->getSaoLcuBasedOptimization() && m_pcCfg->getSaoLcuBoundary() )
     {
       m_pcSAO->resetStats();
@@ -959,7 +979,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     {
       dblMetric(pcPic, uiNumSlices);
     }
-    m_pcLoopFilter->loopFilterPic( pcPic );
+    xLoopFilterPic( pcPic );
 
 #if !HM_CLEANUP_SAO
     pcSlice = pcPic->getSlice(0);
@@ -1243,6 +1263,8 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 
     /* use the main bitstream buffer for storing the marshalled picture */
     m_pcEntropyCoder->setBitstream(NULL);
+    // the HRD parameters are only set up once the SPS is written
+    const Bool bLatePrefixSEI = xHasLatePrefixSEI( pcSlice );
 
     startCUAddrSliceIdx = 0;
     startCUAddrSlice    = 0;
@@ -1487,6 +1509,10 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
           xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
           accessUnit.push_back(new NALUnitEBSP(nalu));
           actualTotalBits += UInt(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+          if ( m_cNalUnitCallback && !bLatePrefixSEI )
+          {
+            xEmitNalUnits( accessUnit, uiNumNalusEmitted );
+          }
           bNALUAlignedWrittenToList = true;
           uiOneBitstreamPerSliceLength += nalu.m_Bitstream.getNumberOfWrittenBits(); // length of bitstream after byte-alignment
 
@@ -1668,12 +1694,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       {
         //get complementary top field
 
-        TComList<TComPic*>::iterator   iterPic = rcListPic.begin();
-        while ((*iterPic)->getPOC() != pcPic->getPOC()-1)
-        {
-          iterPic ++;
-        }
-        TComPic* pcPicFirstField = *(iterPic);
+        TComPic* pcPicFirstField = m_pcEncTop->getPicPool()->getPic( pcPic->getPOC()-1 );
         xCalculateInterlacedAddPSNR(pcPicFirstField, pcPic, pcPicFirstField->getPicYuvRec(), pcPic->getPicYuvRec(), accessUnit, dEncTime, snr_conversion );
       }
 
@@ -1888,6 +1909,22 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       xResetNonNestedSEIPresentFlags();
       xResetNestedSEIPresentFlags();
 
+      if ( m_cNalUnitCallback )
+      {
+        xEmitNalUnits( accessUnit, uiNumNalusEmitted );
+      }
+      if ( m_cAccessUnitCallback )
+      {
+        Double dLatency = 0.0;
+        std::map<Int, std::chrono::steady_clock::time_point>::iterator itReceived = m_cPictureReceiveTime.find( pcPic->getPOC() );
+        if ( itReceived != m_cPictureReceiveTime.end() )
+        {
+          dLatency = std::chrono::duration<Double>( std::chrono::steady_clock::now() - itReceived->second ).count();
+        }
+        m_cAccessUnitCallback( pcPic->getPOC(), accessUnit, dLatency );
+      }
+      m_cPictureReceiveTime.erase( pcPic->getPOC() );
+
       pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
 
       pcPic->setReconMark   ( true );
@@ -1907,6 +1944,8 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
   if( accumNalsDU != NULL) delete accumNalsDU;
 
   assert ( (m_iNumPicCoded == iNumPicRcvd) );
+
+  xReleasePics( rcListPic );
 }
 
 Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR)
@@ -1962,6 +2001,19 @@ Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pr
   printf("\nRVM: %.3lf\n" , xCalculateRVM());
 }
 
+/** \param rcGOPEncoder GOP encoder of another encoder instance, which coded the pictures following the ones coded here
+ */
+Void TEncGOP::addSummary( const TEncGOP& rcGOPEncoder )
+{
+  m_gcAnalyzeAll.addResults   ( rcGOPEncoder.m_gcAnalyzeAll    );
+  m_gcAnalyzeI.addResults     ( rcGOPEncoder.m_gcAnalyzeI      );
+  m_gcAnalyzeP.addResults     ( rcGOPEncoder.m_gcAnalyzeP      );
+  m_gcAnalyzeB.addResults     ( rcGOPEncoder.m_gcAnalyzeB      );
+  m_gcAnalyzeAll_in.addResults( rcGOPEncoder.m_gcAnalyzeAll_in );
+
+  m_vRVM_RP.insert( m_vRVM_RP.end(), rcGOPEncoder.m_vRVM_RP.begin(), rcGOPEncoder.m_vRVM_RP.end() );
+}
+
 Void TEncGOP::preLoopFilterPicAll( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiBits )
 {
   TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
@@ -2057,24 +2109,37 @@ Void TEncGOP::xGetBuffer( TComList<TComPic*>&      rcListPic,
   rpcPicYuvRecOut = *(iterPicYuvRec);
 
   //  Current pic.
-  TComList<TComPic*>::iterator        iterPic       = rcListPic.begin();
-  while (iterPic != rcListPic.end())
-  {
-    rpcPic = *(iterPic);
-    rpcPic->setCurrSliceIdx(0);
-    if (rpcPic->getPOC() == pocCurr)
-    {
-      break;
-    }
-    iterPic++;
-  }
+  rpcPic = m_pcEncTop->getPicPool()->getPic( pocCurr );
 
   assert (rpcPic != NULL);
+  rpcPic->setCurrSliceIdx(0);
   assert (rpcPic->getPOC() == pocCurr);
 
   return;
 }
 
+/** Return the coded pictures that are no longer used for reference to the picture pool. The reconstruction has been
+ * copied to the output list already, so nothing else needs them.
+ * \param rcListPic  list of the pictures in use
+ */
+Void TEncGOP::xReleasePics( TComList<TComPic*>& rcListPic )
+{
+  TComList<TComPic*>::iterator iterPic = rcListPic.begin();
+  while ( iterPic != rcListPic.end() )
+  {
+    TComPic* pcPic = *(iterPic);
+    if ( pcPic->getReconMark() && !pcPic->getSlice(0)->isReferenced() )
+    {
+      m_pcEncTop->getPicPool()->release( pcPic );
+      iterPic = rcListPic.erase( iterPic );
+    }
+    else
+    {
+      iterPic++;
+    }
+  }
+}
+
 UInt64 TEncGOP::xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1)
 {
   UInt64  uiTotalDiff = 0;
@@ -2138,6 +2203,160 @@ static const Char* nalUnitTypeToString(NalUnitType type)
 }
 #endif
 
+/** deblock the picture and gather its SAO statistics, one CTU row at a time
+ * The statistics of a row are gathered as soon as the samples they read are final: the statistics on the samples
+ * before deblocking before the row above, the row itself and the row below are deblocked (each of which modifies
+ * samples they read), the statistics on the deblocked samples once the row below has been deblocked.
+ */
+Void TEncGOP::xLoopFilterPic( TComPic* pcPic )
+{
+#if HM_CLEANUP_SAO
+  const Bool bUseSAO  = pcPic->getSlice(0)->getSPS()->getUseSAO();
+  const Int  iNumRows = pcPic->getFrameHeightInCU();
+
+  TComTaskGraph cGraph;
+  std::vector<Int> aiPreDBFTasks( iNumRows, -1 );
+  std::vector<Int> aiDeblockTasks( iNumRows, -1 );
+
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+  if ( bUseSAO && m_pcCfg->getSaoLcuBoundary() )
+  {
+    for ( Int iRow = 0; iRow < iNumRows; iRow++ )
+    {
+      aiPreDBFTasks[iRow] = cGraph.addTask( [=]( Int ) { m_pcSAO->getPreDBFStatistics( pcPic, iRow ); } );
+    }
+  }
+#endif
+
+  for ( Int iRow = 0; iRow < iNumRows; iRow++ )
+  {
+    aiDeblockTasks[iRow] = cGraph.addTask( [=]( Int ) { m_pcLoopFilter->loopFilterCTURow( pcPic, UInt( iRow ) ); } );
+    if ( iRow > 0 )
+    {
+      cGraph.addDependency( aiDeblockTasks[iRow], aiDeblockTasks[iRow - 1] );
+    }
+    for ( Int iStatRow = max( iRow - 1, 0 ); iStatRow <= min( iRow + 1, iNumRows - 1 ); iStatRow++ )
+    {
+      if ( aiPreDBFTasks[iStatRow] >= 0 )
+      {
+        cGraph.addDependency( aiDeblockTasks[iRow], aiPreDBFTasks[iStatRow] );
+      }
+    }
+  }
+
+  if ( bUseSAO )
+  {
+    for ( Int iRow = 0; iRow < iNumRows; iRow++ )
+    {
+      const Int iTask = cGraph.addTask( [=]( Int ) { m_pcSAO->getStatistics( pcPic, iRow ); } );
+      cGraph.addDependency( iTask, aiDeblockTasks[min( iRow + 1, iNumRows - 1 )] );
+    }
+  }
+
+  m_pcEncTop->getThreadPool()->run( cGraph );
+#else
+  m_pcLoopFilter->loopFilterPic( pcPic );
+#endif
+}
+
+/** build the block hash index of the hash motion search for each reference picture of the slice that does not have
+ * one yet, one task per picture
+ */
+Void TEncGOP::xBuildRefPicBlockHashes( TComSlice* pcSlice )
+{
+  std::vector<TEncPic*> apcRefPics;
+  for ( Int iList = 0; iList < NUM_REF_PIC_LIST_01; iList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iList ) ); iRefIdx++ )
+    {
+      TEncPic* pcRefPic = dynamic_cast<TEncPic*>( pcSlice->getRefPic( RefPicList( iList ), iRefIdx ) );
+      if ( pcRefPic->getBlockHash() == NULL && std::find( apcRefPics.begin(), apcRefPics.end(), pcRefPic ) == apcRefPics.end() )
+      {
+        apcRefPics.push_back( pcRefPic );
+      }
+    }
+  }
+
+  TComTaskGraph cGraph;
+  for ( UInt ui = 0; ui < apcRefPics.size(); ui++ )
+  {
+    TEncPic* pcRefPic = apcRefPics[ui];
+    cGraph.addTask( [=]( Int ) { pcRefPic->buildBlockHash(); } );
+  }
+  m_pcEncTop->getThreadPool()->run( cGraph );
+}
+
+/** pyramid motion search of the CTUs of the picture against each reference picture of the slice, one task per CTU
+ * row and reference picture. A picture in both lists is searched once.
+ */
+Void TEncGOP::xPyramidMotionSearch( TComPic* pcPic, TComSlice* pcSlice )
+{
+  TEncPic* pcEPic = dynamic_cast<TEncPic*>( pcPic );
+  pcEPic->initPyramidMvs( pcSlice->getNumRefIdx( REF_PIC_LIST_0 ), pcSlice->getNumRefIdx( REF_PIC_LIST_1 ) );
+
+  std::vector<TEncPic*> apcRefPics;
+  std::vector<TComMv*>  apcRefPicMvs;
+  std::vector< std::pair<TComMv*, TComMv*> > acCopies;
+  TComTaskGraph cGraph;
+  for ( Int iList = 0; iList < NUM_REF_PIC_LIST_01; iList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iList ) ); iRefIdx++ )
+    {
+      TEncPic* pcRefPic = dynamic_cast<TEncPic*>( pcSlice->getRefPic( RefPicList( iList ), iRefIdx ) );
+      TComMv*  pcMvs    = pcEPic->getPyramidMvs( RefPicList( iList ), iRefIdx );
+      const UInt uiIdx  = UInt( std::find( apcRefPics.begin(), apcRefPics.end(), pcRefPic ) - apcRefPics.begin() );
+      if ( uiIdx < apcRefPics.size() )
+      {
+        acCopies.push_back( std::make_pair( pcMvs, apcRefPicMvs[uiIdx] ) );
+        continue;
+      }
+      apcRefPics.push_back( pcRefPic );
+      apcRefPicMvs.push_back( pcMvs );
+
+      const Int iSearchRange = m_pcCfg->getSearchRange();
+      for ( UInt uiRow = 0; uiRow < pcPic->getFrameHeightInCU(); uiRow++ )
+      {
+        cGraph.addTask( [=]( Int ) { m_pcEncTop->getPreanalyzer()->xPyramidMotionSearch( pcEPic, pcRefPic, pcMvs, iSearchRange, uiRow ); } );
+      }
+    }
+  }
+  m_pcEncTop->getThreadPool()->run( cGraph );
+
+  for ( UInt ui = 0; ui < acCopies.size(); ui++ )
+  {
+    std::copy( acCopies[ui].second, acCopies[ui].second + pcPic->getNumCUsInFrame(), acCopies[ui].first );
+  }
+}
+
+/** whether prefix SEI messages are inserted in front of the slices once the whole picture is coded
+ * (temporal level 0 index, picture timing and decoding unit information), in which case no NAL unit of the access
+ * unit can be passed on before the end of the picture.
+ */
+Bool TEncGOP::xHasLatePrefixSEI( TComSlice* pcSlice )
+{
+  if ( m_pcCfg->getTemporalLevel0IndexSEIEnabled() )
+  {
+    return true;
+  }
+  return ( m_pcCfg->getPictureTimingSEIEnabled() || m_pcCfg->getDecodingUnitInfoSEIEnabled() ) &&
+         ( pcSlice->getSPS()->getVuiParametersPresentFlag() ) &&
+         ( ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getNalHrdParametersPresentFlag() )
+        || ( pcSlice->getSPS()->getVuiParameters()->getHrdParameters()->getVclHrdParametersPresentFlag() ) );
+}
+
+/** pass the NAL units of the access unit following the first ruiNumEmitted ones to the NAL unit callback
+ */
+Void TEncGOP::xEmitNalUnits( const AccessUnit& rcAccessUnit, UInt& ruiNumEmitted )
+{
+  AccessUnit::const_iterator it = rcAccessUnit.begin();
+  advance( it, ruiNumEmitted );
+  for ( ; it != rcAccessUnit.end(); it++ )
+  {
+    m_cNalUnitCallback( **it );
+    ruiNumEmitted++;
+  }
+}
+
 Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit& accessUnit, Double dEncTime, const InputColourSpaceConversion conversion )
 {
   Double  dPSNR[MAX_NUM_COMPONENT];
@@ -2158,34 +2377,40 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   //===== calculate PSNR =====
   Double MSEyuvframe[MAX_NUM_COMPONENT] = {0, 0, 0};
 
+  // one task per component
+  TComTaskGraph cGraph;
   for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
-    const Pel*  pOrg    = (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic ->getPicYuvTrueOrg()->getAddr(ch) : pcPic ->getPicYuvOrg()->getAddr(ch);
-    Pel*  pRec    = picd.getAddr(ch);
-    const Int   iStride = pcPicD->getStride(ch);
+    cGraph.addTask( [&, ch]( Int )
+    {
+      const Pel*  pOrg    = (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic ->getPicYuvTrueOrg()->getAddr(ch) : pcPic ->getPicYuvOrg()->getAddr(ch);
+      Pel*  pRec    = picd.getAddr(ch);
+      const Int   iStride = pcPicD->getStride(ch);
 
-    const Int   iWidth  = pcPicD->getWidth (ch) - (m_pcEncTop->getPad(0) >> pcPic->getComponentScaleX(ch));
-    const Int   iHeight = pcPicD->getHeight(ch) - (m_pcEncTop->getPad(1) >> pcPic->getComponentScaleY(ch));
+      const Int   iWidth  = pcPicD->getWidth (ch) - (m_pcEncTop->getPad(0) >> pcPic->getComponentScaleX(ch));
+      const Int   iHeight = pcPicD->getHeight(ch) - (m_pcEncTop->getPad(1) >> pcPic->getComponentScaleY(ch));
 
-    Int   iSize   = iWidth*iHeight;
+      Int   iSize   = iWidth*iHeight;
 
-    UInt64 uiSSDtemp=0;
-    for(Int y = 0; y < iHeight; y++ )
-    {
-      for(Int x = 0; x < iWidth; x++ )
+      UInt64 uiSSDtemp=0;
+      for(Int y = 0; y < iHeight; y++ )
       {
-        Intermediate_Int iDiff = (Intermediate_Int)( pOrg[x] - pRec[x] );
-        uiSSDtemp   += iDiff * iDiff;
+        for(Int x = 0; x < iWidth; x++ )
+        {
+          Intermediate_Int iDiff = (Intermediate_Int)( pOrg[x] - pRec[x] );
+          uiSSDtemp   += iDiff * iDiff;
+        }
+        pOrg += iStride;
+        pRec += iStride;
       }
-      pOrg += iStride;
-      pRec += iStride;
-    }
-    const Int maxval = 255 << (g_bitDepth[toChannelType(ch)] - 8);
-    const Double fRefValue = (Double) maxval * maxval * iSize;
-    dPSNR[ch]         = ( uiSSDtemp ? 10.0 * log10( fRefValue / (Double)uiSSDtemp ) : 999.99 );
-    MSEyuvframe[ch]   = (Double)uiSSDtemp/(iSize);
+      const Int maxval = 255 << (g_bitDepth[toChannelType(ch)] - 8);
+      const Double fRefValue = (Double) maxval * maxval * iSize;
+      dPSNR[ch]         = ( uiSSDtemp ? 10.0 * log10( fRefValue / (Double)uiSSDtemp ) : 999.99 );
+      MSEyuvframe[ch]   = (Double)uiSSDtemp/(iSize);
+    } );
   }
+  m_pcEncTop->getThreadPool()->run( cGraph );
 
 
   /* calculate the size of the access unit, excluding:
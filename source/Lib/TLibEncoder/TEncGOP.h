@@ -39,6 +39,9 @@
 #define __TENCGOP__
 
 #include <list>
+#include <map>
+#include <functional>
+#include <chrono>
 
 #include <stdlib.h>
 
@@ -63,6 +66,11 @@
 
 class TEncTop;
 
+/// called for every NAL unit as soon as it is final, in bitstream order
+typedef std::function<Void( const NALUnitEBSP& rcNalu )> NalUnitCallback;
+/// called when the last NAL unit of an access unit has been passed to the NalUnitCallback, dLatency is the time in seconds since the picture was received
+typedef std::function<Void( Int iPOC, const AccessUnit& rcAccessUnit, Double dLatency )> AccessUnitCallback;
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -83,6 +91,7 @@ private:
   Int                     m_iGopSize;
   Int                     m_iNumPicCoded;
   Bool                    m_bFirst;
+  Bool                    m_bPictureOutput;               ///< pictures are coded in input order, each one as soon as it is received
   
   //  Access channel
   TEncTop*                m_pcEncTop;
@@ -122,6 +131,19 @@ private:
   Bool                    m_pictureTimingSEIPresentInAU;
   Bool                    m_nestedBufferingPeriodSEIPresentInAU;
   Bool                    m_nestedPictureTimingSEIPresentInAU;
+
+  // statistics of the coded pictures
+  TEncAnalyze             m_gcAnalyzeAll;
+  TEncAnalyze             m_gcAnalyzeI;
+  TEncAnalyze             m_gcAnalyzeP;
+  TEncAnalyze             m_gcAnalyzeB;
+
+  TEncAnalyze             m_gcAnalyzeAll_in;
+
+  // low-latency output
+  NalUnitCallback         m_cNalUnitCallback;
+  AccessUnitCallback      m_cAccessUnitCallback;
+  std::map<Int, std::chrono::steady_clock::time_point> m_cPictureReceiveTime; ///< time each not yet coded picture was received, by POC
 public:
   TEncGOP();
   virtual ~TEncGOP();
@@ -136,16 +158,22 @@ public:
 
   
   Int   getGOPSize()          { return  m_iGopSize;  }
+  Bool  getPictureOutput()    { return  m_bPictureOutput; }
   
   TComList<TComPic*>*   getListPic()      { return m_pcListPic; }
   
   Void  printOutSummary      ( UInt uiNumAllPicCoded, Bool isField, const Bool printMSEBasedSNR );
+  Void  addSummary           ( const TEncGOP& rcGOPEncoder ); ///< append the statistics of pictures coded after the ones of this encoder
   Void  preLoopFilterPicAll  ( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiBits );
   
   TEncSlice*  getSliceEncoder()   { return m_pcSliceEncoder; }
   NalUnitType getNalUnitType( Int pocCurr, Int lastIdr );
   Void arrangeLongtermPicturesInRPS(TComSlice *, TComList<TComPic*>& );
 
+  Void  setNalUnitCallback   ( const NalUnitCallback& rcCallback )    { m_cNalUnitCallback    = rcCallback; }
+  Void  setAccessUnitCallback( const AccessUnitCallback& rcCallback ) { m_cAccessUnitCallback = rcCallback; }
+  Void  setPictureReceived   ( Int iPOC )                             { m_cPictureReceiveTime[iPOC] = std::chrono::steady_clock::now(); }
+
 protected:
   TEncRateCtrl* getRateCtrl()       { return m_pcRateCtrl;  }
 
@@ -154,7 +182,15 @@ protected:
   Void  xInitGOP          ( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Bool isField );
   Void  xInitGOP          ( Int iPOC, Int iNumPicRcvd, TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut );
   Void  xGetBuffer        ( TComList<TComPic*>& rcListPic, TComList<TComPicYuv*>& rcListPicYuvRecOut, Int iNumPicRcvd, Int iTimeOffset, TComPic*& rpcPic, TComPicYuv*& rpcPicYuvRecOut, Int pocCurr, Bool isField );
+  Void  xReleasePics      ( TComList<TComPic*>& rcListPic );
   
+  Void  xLoopFilterPic    ( TComPic* pcPic );
+  Void  xBuildRefPicBlockHashes ( TComSlice* pcSlice );
+  Void  xPyramidMotionSearch ( TComPic* pcPic, TComSlice* pcSlice );
+
+  Bool  xHasLatePrefixSEI ( TComSlice* pcSlice );
+  Void  xEmitNalUnits     ( const AccessUnit& rcAccessUnit, UInt& ruiNumEmitted );
+
   Void  xCalculateAddPSNR          ( TComPic* pcPic, TComPicYuv* pcPicD, const AccessUnit&, Double dEncTime, const InputColourSpaceConversion snr_conversion );
   Void  xCalculateInterlacedAddPSNR( TComPic* pcPicOrgFirstField, TComPic* pcPicOrgSecondField,
                                      TComPicYuv* pcPicRecFirstField, TComPicYuv* pcPicRecSecondField,
@@ -0,0 +1,248 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.cpp
+    \brief    lookahead analysis of the received pictures
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "TEncLookahead.h"
+#include "TEncTop.h"
+
+using namespace std;
+
+//! \ingroup TLibEncoder
+//! \{
+
+TEncLookahead::TEncLookahead()
+: m_pcEncTop(NULL)
+, m_bPrevValid(false)
+, m_dPrevMean(0.0)
+, m_dPrevMeanDelta(0.0)
+, m_bThreadExit(false)
+{
+  for (Int iLevel = 0; iLevel < TEncPic::NUM_PYRAMID_LEVELS; iLevel++)
+  {
+    m_apcPicYuvPrev[iLevel] = NULL;
+  }
+}
+
+TEncLookahead::~TEncLookahead()
+{
+}
+
+Void TEncLookahead::init( TEncTop* pcEncTop )
+{
+  m_pcEncTop       = pcEncTop;
+  m_bPrevValid     = false;
+  m_dPrevMeanDelta = 0.0;
+}
+
+Void TEncLookahead::destroy()
+{
+  if (m_cThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> cLock(m_cQueueMutex);
+      m_bThreadExit = true;
+    }
+    m_cQueueCond.notify_all();
+    m_cThread.join();
+    m_bThreadExit = false;
+  }
+
+  for (Int iLevel = 0; iLevel < TEncPic::NUM_PYRAMID_LEVELS; iLevel++)
+  {
+    if (m_apcPicYuvPrev[iLevel])
+    {
+      m_apcPicYuvPrev[iLevel]->destroy();
+      delete m_apcPicYuvPrev[iLevel];
+      m_apcPicYuvPrev[iLevel] = NULL;
+    }
+  }
+  m_bPrevValid = false;
+}
+
+/** Queue a picture for analysis after all previously queued ones. The thread is started on first use.
+ * \param pcEPic received picture
+ * \return Void
+ */
+Void TEncLookahead::push( TEncPic* pcEPic )
+{
+  if (!m_cThread.joinable())
+  {
+    m_cThread = std::thread(&TEncLookahead::xThread, this, g_pcRomContext);
+  }
+
+  {
+    std::lock_guard<std::mutex> cLock(m_cQueueMutex);
+    m_cQueue.push_back(pcEPic);
+  }
+  m_cQueueCond.notify_all();
+}
+
+Void TEncLookahead::wait()
+{
+  std::unique_lock<std::mutex> cLock(m_cQueueMutex);
+  while (!m_cQueue.empty())
+  {
+    m_cQueueCond.wait(cLock);
+  }
+}
+
+Void TEncLookahead::xThread( TComRomContext* pcRomContext )
+{
+  TComRomScope cRomScope( pcRomContext );
+  std::unique_lock<std::mutex> cLock(m_cQueueMutex);
+
+  while (true)
+  {
+    while (m_cQueue.empty() && !m_bThreadExit)
+    {
+      m_cQueueCond.wait(cLock);
+    }
+    if (m_cQueue.empty())
+    {
+      return;
+    }
+
+    TEncPic* pcEPic = m_cQueue.front();
+    cLock.unlock();
+    xAnalyze( pcEPic );
+    cLock.lock();
+
+    m_cQueue.pop_front();
+    m_cQueueCond.notify_all();
+  }
+}
+
+/** Analyse a picture: the activity for adaptive QP, the picture pyramid and the intra and inter costs of the blocks of
+ * the half resolution luma, summed up per CTU. The inter costs are against the previous picture in input order. A
+ * picture is a scene cut when inter prediction hardly lowers its cost, unless its mean luma keeps changing in the same
+ * direction as in a fade.
+ * \param pcEPic picture to be analysed
+ * \return Void
+ */
+Void TEncLookahead::xAnalyze( TEncPic* pcEPic )
+{
+  TEncPreanalyzer* pcPreanalyzer = m_pcEncTop->getPreanalyzer();
+  if ( m_pcEncTop->getUseAdaptiveQP() )
+  {
+    pcPreanalyzer->xPreanalyze( pcEPic );
+  }
+  pcPreanalyzer->xBuildPyramid( pcEPic );
+  pcEPic->initLookahead();
+
+  TComPicYuv* pcLowRes = pcEPic->getPicYuvPyramid( 0 );
+  const Int   iWidth          = pcLowRes->getWidth ( COMPONENT_Y );
+  const Int   iHeight         = pcLowRes->getHeight( COMPONENT_Y );
+  const Int   iStride         = pcLowRes->getStride( COMPONENT_Y );
+  const Int   iBlocksInWidth  = ( iWidth  + LOOKAHEAD_BLOCK_SIZE - 1 ) / LOOKAHEAD_BLOCK_SIZE;
+  const Int   iBlocksInHeight = ( iHeight + LOOKAHEAD_BLOCK_SIZE - 1 ) / LOOKAHEAD_BLOCK_SIZE;
+  const UInt  uiFrameWidthInCU = pcEPic->getFrameWidthInCU();
+
+  m_acBlockMv.assign( iBlocksInWidth * iBlocksInHeight, TComMv() );
+
+  Distortion uiIntraSum = 0;
+  Distortion uiBestSum  = 0;  // lower of the intra and the inter cost of each block
+  for ( Int by = 0; by < iBlocksInHeight; by++ )
+  {
+    for ( Int bx = 0; bx < iBlocksInWidth; bx++ )
+    {
+      const Int  iPosX    = bx * LOOKAHEAD_BLOCK_SIZE;
+      const Int  iPosY    = by * LOOKAHEAD_BLOCK_SIZE;
+      const UInt uiCUAddr = ( ( iPosY << 1 ) / g_uiMaxCUHeight ) * uiFrameWidthInCU + ( iPosX << 1 ) / g_uiMaxCUWidth;
+
+      const Distortion uiIntraCost = pcPreanalyzer->xLowResIntraCost( pcLowRes, iPosX, iPosY );
+      Distortion       uiInterCost = uiIntraCost;
+      if ( m_bPrevValid )
+      {
+        // zero vector and the vectors of the left and the above block
+        TComMv acCandidates[3];
+        Int    iNumCandidates = 1;
+        if ( bx > 0 )
+        {
+          acCandidates[iNumCandidates++] = m_acBlockMv[ by * iBlocksInWidth + bx - 1 ];
+        }
+        if ( by > 0 )
+        {
+          acCandidates[iNumCandidates++] = m_acBlockMv[ ( by - 1 ) * iBlocksInWidth + bx ];
+        }
+        uiInterCost = pcPreanalyzer->xLowResInterCost( pcEPic, m_apcPicYuvPrev, iPosX, iPosY, acCandidates, iNumCandidates, m_acBlockMv[ by * iBlocksInWidth + bx ] );
+      }
+
+      pcEPic->addLookaheadCost( uiCUAddr, uiIntraCost, uiInterCost );
+      uiIntraSum += uiIntraCost;
+      uiBestSum  += min( uiIntraCost, uiInterCost );
+    }
+  }
+
+  UInt64 uiSum = 0;
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    const Pel* piLine = pcLowRes->getAddr( COMPONENT_Y ) + y * iStride;
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      uiSum += piLine[x];
+    }
+  }
+  const Double dMean = Double( uiSum ) / ( iWidth * iHeight ) / Double( 1 << ( g_bitDepth[CHANNEL_TYPE_LUMA] - 8 ) );
+
+  if ( m_bPrevValid )
+  {
+    const Double dMeanDelta = dMean - m_dPrevMean;
+    const Bool   bFade      = fabs( dMeanDelta ) >= LOOKAHEAD_FADE_MIN_DELTA && fabs( m_dPrevMeanDelta ) >= LOOKAHEAD_FADE_MIN_DELTA &&
+                              ( dMeanDelta > 0 ) == ( m_dPrevMeanDelta > 0 );
+    // the inter cost of a fade is high as well, but the picture still predicts well once weighted
+    pcEPic->setSceneCut( !bFade && uiBestSum > LOOKAHEAD_SCENE_CUT_RATIO * uiIntraSum );
+    m_dPrevMeanDelta = dMeanDelta;
+  }
+  m_dPrevMean = dMean;
+
+  for ( Int iLevel = 0; iLevel < TEncPic::NUM_PYRAMID_LEVELS; iLevel++ )
+  {
+    TComPicYuv* pcLevel = pcEPic->getPicYuvPyramid( iLevel );
+    if ( m_apcPicYuvPrev[iLevel] == NULL )
+    {
+      m_apcPicYuvPrev[iLevel] = new TComPicYuv;
+      m_apcPicYuvPrev[iLevel]->create( pcLevel->getWidth( COMPONENT_Y ), pcLevel->getHeight( COMPONENT_Y ), CHROMA_400, g_uiMaxCUWidth >> ( iLevel + 1 ), g_uiMaxCUHeight >> ( iLevel + 1 ), g_uiMaxCUDepth );
+    }
+    // including the padding, which the inter cost estimation of the next picture reads
+    pcLevel->copyToPic( m_apcPicYuvPrev[iLevel] );
+  }
+  m_bPrevValid = true;
+}
+
+//! \}
@@ -0,0 +1,94 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncLookahead.h
+    \brief    lookahead analysis of the received pictures (header)
+*/
+
+#ifndef __TENCLOOKAHEAD__
+#define __TENCLOOKAHEAD__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComRom.h"
+#include "TEncPic.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//! \ingroup TLibEncoder
+//! \{
+
+class TEncTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// analysis of the received pictures on a separate thread ahead of their coding: the activity for adaptive QP, the
+/// picture pyramid, half resolution intra and inter costs per CTU and the detection of scene cuts. The costs serve the
+/// scene cut detection and the intra pruning of TEncCu only; the rate control and the adaptive QP do not use them.
+class TEncLookahead
+{
+private:
+  TEncTop*                m_pcEncTop;
+  TComPicYuv*             m_apcPicYuvPrev[TEncPic::NUM_PYRAMID_LEVELS]; ///< pyramid of the previous picture in input order
+  Bool                    m_bPrevValid;             ///< a picture has been analysed into m_apcPicYuvPrev
+  Double                  m_dPrevMean;              ///< 8-bit mean luma of the previous picture
+  Double                  m_dPrevMeanDelta;         ///< change of the mean luma from the picture before the previous one
+  std::vector<TComMv>     m_acBlockMv;              ///< vectors of the blocks of the picture in analysis
+  std::deque<TEncPic*>    m_cQueue;                 ///< queued pictures, the one in analysis at the front
+  Bool                    m_bThreadExit;
+  std::thread             m_cThread;
+  std::mutex              m_cQueueMutex;
+  std::condition_variable m_cQueueCond;
+
+  Void  xThread   ( TComRomContext* pcRomContext );
+  Void  xAnalyze  ( TEncPic* pcEPic );
+
+public:
+  TEncLookahead();
+  virtual ~TEncLookahead();
+
+  Void  init      ( TEncTop* pcEncTop );
+  Void  destroy   ();
+
+  /// queue a received picture for analysis, its original must not change until it has been analysed
+  Void  push      ( TEncPic* pcEPic );
+  /// block until all queued pictures have been analysed
+  Void  wait      ();
+};
+
+//! \}
+
+#endif // __TENCLOOKAHEAD__
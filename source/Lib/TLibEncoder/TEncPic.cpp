@@ -105,7 +105,22 @@ Void TEncPicQPAdaptationLayer::destroy()
 TEncPic::TEncPic()
 : m_acAQLayer(NULL)
 , m_uiMaxAQDepth(0)
+, m_pcBlockHash(NULL)
+, m_bBlockHashValid(false)
+, m_abSubPelRowDone(NULL)
+, m_bSceneCut(false)
 {
+  for (Int iFracY = 0; iFracY < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracY++)
+  {
+    for (Int iFracX = 0; iFracX < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracX++)
+    {
+      m_apcPicYuvSubPel[iFracY][iFracX] = NULL;
+    }
+  }
+  for (Int iLevel = 0; iLevel < NUM_PYRAMID_LEVELS; iLevel++)
+  {
+    m_apcPicYuvPyramid[iLevel] = NULL;
+  }
 }
 
 /** Destructor
@@ -138,6 +153,9 @@ Void TEncPic::create( Int iWidth, Int iHeight, ChromaFormat chromaFormat, UInt u
       m_acAQLayer[d].create( iWidth, iHeight, uiMaxWidth>>d, uiMaxHeight>>d );
     }
   }
+
+  m_abSubPelRowDone = new std::atomic<Bool>[ getFrameHeightInCU() ];
+  invalidateSubPelPlanes();
 }
 
 /** Clean up
@@ -150,7 +168,223 @@ Void TEncPic::destroy()
     delete[] m_acAQLayer;
     m_acAQLayer = NULL;
   }
+  if (m_pcBlockHash)
+  {
+    m_pcBlockHash->destroy();
+    delete m_pcBlockHash;
+    m_pcBlockHash = NULL;
+  }
+  m_bBlockHashValid = false;
+  for (Int iFracY = 0; iFracY < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracY++)
+  {
+    for (Int iFracX = 0; iFracX < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracX++)
+    {
+      if (m_apcPicYuvSubPel[iFracY][iFracX])
+      {
+        m_apcPicYuvSubPel[iFracY][iFracX]->destroy();
+        delete m_apcPicYuvSubPel[iFracY][iFracX];
+        m_apcPicYuvSubPel[iFracY][iFracX] = NULL;
+      }
+    }
+  }
+  if (m_abSubPelRowDone)
+  {
+    delete[] m_abSubPelRowDone;
+    m_abSubPelRowDone = NULL;
+  }
+  for (Int iLevel = 0; iLevel < NUM_PYRAMID_LEVELS; iLevel++)
+  {
+    if (m_apcPicYuvPyramid[iLevel])
+    {
+      m_apcPicYuvPyramid[iLevel]->destroy();
+      delete m_apcPicYuvPyramid[iLevel];
+      m_apcPicYuvPyramid[iLevel] = NULL;
+    }
+  }
+  for (Int iList = 0; iList < NUM_REF_PIC_LIST_01; iList++)
+  {
+    m_acPyramidMv[iList].clear();
+  }
+  m_auiLookaheadIntraCost.clear();
+  m_auiLookaheadInterCost.clear();
   TComPic::destroy();
 }
+
+/** Build the block hash index of the original luma picture. Blocks whose rows or columns are all uniform are left out,
+ * they are found as well by the regular motion search.
+ * \return Void
+ */
+Void TEncPic::buildBlockHash()
+{
+  if (m_bBlockHashValid)
+  {
+    return;
+  }
+
+  TComPicYuv* pcPicYuvOrg = getPicYuvOrg();
+  const Int   iWidth      = pcPicYuvOrg->getWidth ( COMPONENT_Y );
+  const Int   iHeight     = pcPicYuvOrg->getHeight( COMPONENT_Y );
+
+  if (m_pcBlockHash == NULL)
+  {
+    // about four blocks of each size per bucket
+    UInt uiNumBucketsLog2 = 8;
+    while ( ( 4 << ( uiNumBucketsLog2 + 1 ) ) <= iWidth * iHeight )
+    {
+      uiNumBucketsLog2++;
+    }
+    m_pcBlockHash = new TEncBlockHash;
+    m_pcBlockHash->create( uiNumBucketsLog2 );
+  }
+  else
+  {
+    m_pcBlockHash->clear();
+  }
+
+  m_pcBlockHash->addBlocks( pcPicYuvOrg->getAddr( COMPONENT_Y ), pcPicYuvOrg->getStride( COMPONENT_Y ), 0, 0, iWidth, iHeight, true );
+  m_bBlockHashValid = true;
+}
+
+/** Interpolate the sub-pel planes of the reconstructed luma for the CTU rows covering the luma lines iTop to iBottom
+ * that have not been interpolated since the last invalidateSubPelPlanes(). Lines outside the picture belong to the
+ * first and last CTU row. Can be called concurrently, the reconstruction must be final and border-extended.
+ * \param iTop    first luma line
+ * \param iBottom last luma line
+ * \return Void
+ */
+Void TEncPic::prepareSubPelPlanes( Int iTop, Int iBottom )
+{
+  const Int iNumRows  = getFrameHeightInCU();
+  const Int iFirstRow = Clip3( 0, iNumRows - 1, iTop    / Int( g_uiMaxCUHeight ) );
+  const Int iLastRow  = Clip3( 0, iNumRows - 1, iBottom / Int( g_uiMaxCUHeight ) );
+
+  for (Int iRow = iFirstRow; iRow <= iLastRow; iRow++)
+  {
+    if ( !m_abSubPelRowDone[iRow].load( std::memory_order_acquire ) )
+    {
+      std::lock_guard<std::mutex> cLock( m_cSubPelMutex );
+      if ( !m_abSubPelRowDone[iRow].load( std::memory_order_relaxed ) )
+      {
+        xInterpolateSubPelRow( iRow );
+        m_abSubPelRowDone[iRow].store( true, std::memory_order_release );
+      }
+    }
+  }
+}
+
+/** Mark the sub-pel planes outdated, the reconstruction is about to be replaced
+ * \return Void
+ */
+Void TEncPic::invalidateSubPelPlanes()
+{
+  const Int iNumRows = getFrameHeightInCU();
+  for (Int iRow = 0; iRow < iNumRows; iRow++)
+  {
+    m_abSubPelRowDone[iRow].store( false, std::memory_order_relaxed );
+  }
+}
+
+/** Interpolate the sub-pel planes of one CTU row, in the same two passes (horizontal to the intermediate precision,
+ * then vertical) as the fractional motion search, so that both give the same samples. The first and last rows extend
+ * into the margin as far as the 8-tap filter can be applied.
+ * \param iCTURow CTU row
+ * \return Void
+ */
+Void TEncPic::xInterpolateSubPelRow( Int iCTURow )
+{
+  TComPicYuv*        pcPicYuvRec = getPicYuvRec();
+  const ChromaFormat chFmt       = pcPicYuvRec->getChromaFormat();
+  const Int          iStride     = pcPicYuvRec->getStride( COMPONENT_Y );
+  const Int          iMarginX    = pcPicYuvRec->getMarginX( COMPONENT_Y ) - ( NTAPS_LUMA >> 1 );
+  const Int          iMarginY    = pcPicYuvRec->getMarginY( COMPONENT_Y ) - ( NTAPS_LUMA >> 1 );
+  const Int          iPicHeight  = pcPicYuvRec->getHeight( COMPONENT_Y );
+  const Int          iNumRows    = getFrameHeightInCU();
+  const Int          iRowHeight  = g_uiMaxCUHeight;
+
+  const Int iTop    = ( iCTURow == 0 )            ? -iMarginY             : iCTURow * iRowHeight;
+  const Int iBottom = ( iCTURow == iNumRows - 1 ) ? iPicHeight + iMarginY : ( iCTURow + 1 ) * iRowHeight;
+  const Int iWidth  = pcPicYuvRec->getWidth( COMPONENT_Y ) + 2 * iMarginX;
+  const Int iHeight = iBottom - iTop;
+
+  if ( m_apcPicYuvSubPel[0][1] == NULL )
+  {
+    for (Int iFracY = 0; iFracY < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracY++)
+    {
+      for (Int iFracX = ( iFracY == 0 ? 1 : 0 ); iFracX < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracX++)
+      {
+        m_apcPicYuvSubPel[iFracY][iFracX] = new TComPicYuv;
+        m_apcPicYuvSubPel[iFracY][iFracX]->create( pcPicYuvRec->getWidth( COMPONENT_Y ), iPicHeight, CHROMA_400, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+      }
+    }
+  }
+
+  // horizontally filtered lines of the row, with the lines above and below that the vertical filter reads
+  std::vector<Pel> acInt( ( iHeight + NTAPS_LUMA - 1 ) * iWidth );
+  Pel* piInt = &acInt[0];
+  Pel* piSrc = pcPicYuvRec->getAddr( COMPONENT_Y ) + ( iTop - ( NTAPS_LUMA >> 1 ) + 1 ) * iStride - iMarginX;
+
+  for (Int iFracX = 0; iFracX < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracX++)
+  {
+    m_cSubPelFilter.filterHor( COMPONENT_Y, piSrc, iStride, piInt, iWidth, iWidth, iHeight + NTAPS_LUMA - 1, iFracX, false, chFmt );
+
+    for (Int iFracY = ( iFracX == 0 ? 1 : 0 ); iFracY < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracY++)
+    {
+      Pel* piDst = m_apcPicYuvSubPel[iFracY][iFracX]->getAddr( COMPONENT_Y ) + iTop * iStride - iMarginX;
+      m_cSubPelFilter.filterVer( COMPONENT_Y, piInt + ( ( NTAPS_LUMA >> 1 ) - 1 ) * iWidth, iWidth, piDst, iStride, iWidth, iHeight, iFracY, false, true, chFmt );
+    }
+  }
+}
+
+/** Allocate the levels of the picture pyramid, each one with the margin of the full resolution picture
+ * \return Void
+ */
+Void TEncPic::createPyramid()
+{
+  Int iWidth  = getPicYuvOrg()->getWidth ( COMPONENT_Y );
+  Int iHeight = getPicYuvOrg()->getHeight( COMPONENT_Y );
+  for (Int iLevel = 0; iLevel < NUM_PYRAMID_LEVELS; iLevel++)
+  {
+    iWidth  = ( iWidth  + 1 ) >> 1;
+    iHeight = ( iHeight + 1 ) >> 1;
+    m_apcPicYuvPyramid[iLevel] = new TComPicYuv;
+    m_apcPicYuvPyramid[iLevel]->create( iWidth, iHeight, CHROMA_400, g_uiMaxCUWidth >> ( iLevel + 1 ), g_uiMaxCUHeight >> ( iLevel + 1 ), g_uiMaxCUDepth );
+  }
+}
+
+/** Size the vectors of the pyramid motion search
+ * \param iNumRefIdxL0 number of reference pictures in list 0
+ * \param iNumRefIdxL1 number of reference pictures in list 1
+ * \return Void
+ */
+Void TEncPic::initPyramidMvs( Int iNumRefIdxL0, Int iNumRefIdxL1 )
+{
+  m_acPyramidMv[REF_PIC_LIST_0].assign( iNumRefIdxL0 * getNumCUsInFrame(), TComMv() );
+  m_acPyramidMv[REF_PIC_LIST_1].assign( iNumRefIdxL1 * getNumCUsInFrame(), TComMv() );
+}
+
+TComMv* TEncPic::getPyramidMvs( RefPicList eRefPicList, Int iRefIdx )
+{
+  const UInt uiOffset = iRefIdx * getNumCUsInFrame();
+  return uiOffset < m_acPyramidMv[eRefPicList].size() ? &m_acPyramidMv[eRefPicList][uiOffset] : NULL;
+}
+
+Void TEncPic::initLookahead()
+{
+  m_auiLookaheadIntraCost.assign( getNumCUsInFrame(), 0 );
+  m_auiLookaheadInterCost.assign( getNumCUsInFrame(), 0 );
+  m_bSceneCut = false;
+}
+
+/** Accumulate the lookahead costs of a block into the ones of its CTU
+ * \param uiCUAddr    address of the CTU
+ * \param uiIntraCost intra cost of the block
+ * \param uiInterCost inter cost of the block
+ * \return Void
+ */
+Void TEncPic::addLookaheadCost( UInt uiCUAddr, Distortion uiIntraCost, Distortion uiInterCost )
+{
+  m_auiLookaheadIntraCost[uiCUAddr] += uiIntraCost;
+  m_auiLookaheadInterCost[uiCUAddr] += uiInterCost;
+}
 //! \}
 
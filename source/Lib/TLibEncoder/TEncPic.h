@@ -40,6 +40,10 @@
 
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TEncBlockHash.h"
+#include <atomic>
+#include <mutex>
 
 //! \ingroup TLibEncoder
 //! \{
@@ -91,12 +95,31 @@ public:
   Void                   setAvgActivity( Double d )  { m_dAvgActivity = d; }
 };
 
-/// Picture class including local image characteristics information for QP adaptation
+/// Picture class including local image characteristics information for QP adaptation, the block hash index for
+/// hash-based motion search, the sub-pel interpolated luma planes for the fractional motion search, the picture
+/// pyramid and vectors of the pyramid motion search and the results of the lookahead analysis
 class TEncPic : public TComPic
 {
+public:
+  static const Int NUM_PYRAMID_LEVELS = 2;          ///< 1/2 and 1/4 of the width and height
+
 private:
   TEncPicQPAdaptationLayer* m_acAQLayer;
   UInt                      m_uiMaxAQDepth;
+  TEncBlockHash*            m_pcBlockHash;          ///< 8x8 and 16x16 blocks of the original luma, allocated on first use
+  Bool                      m_bBlockHashValid;      ///< m_pcBlockHash has been built from the current original picture
+  TComPicYuv*               m_apcPicYuvSubPel[LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS];
+                                                    ///< [ver][hor] quarter-sample phases of the reconstructed luma, [0][0] unused, allocated on first use
+  std::atomic<Bool>*        m_abSubPelRowDone;      ///< per CTU row, the sub-pel planes of the row have been interpolated
+  std::mutex                m_cSubPelMutex;         ///< serialises the allocation and interpolation of the sub-pel planes
+  TComInterpolationFilter   m_cSubPelFilter;
+  TComPicYuv*               m_apcPicYuvPyramid[NUM_PYRAMID_LEVELS]; ///< downscaled luma of the original, allocated on first use
+  std::vector<TComMv>       m_acPyramidMv[NUM_REF_PIC_LIST_01];    ///< [iRefIdx * number of CTUs + CTU] integer vector of the pyramid motion search
+  std::vector<Distortion>   m_auiLookaheadIntraCost;               ///< per CTU, half resolution SATD of the best of a few intra predictions
+  std::vector<Distortion>   m_auiLookaheadInterCost;               ///< per CTU, half resolution SATD of the motion compensated previous picture
+  Bool                      m_bSceneCut;                           ///< the lookahead found the picture unrelated to the previous one
+
+  Void                      xInterpolateSubPelRow( Int iCTURow );
 
 public:
   TEncPic();
@@ -108,6 +131,36 @@ public:
 
   TEncPicQPAdaptationLayer* getAQLayer( UInt uiDepth )  { return &m_acAQLayer[uiDepth]; }
   UInt                      getMaxAQDepth()             { return m_uiMaxAQDepth;        }
+
+  /// build the block hash index of the original picture, if it has not been built since the last invalidateBlockHash()
+  Void                      buildBlockHash();
+  Void                      invalidateBlockHash()       { m_bBlockHashValid = false;    }
+  /// block hash index of the original picture, NULL if it has not been built
+  const TEncBlockHash*      getBlockHash() const        { return m_bBlockHashValid ? m_pcBlockHash : NULL; }
+
+  /// interpolate the sub-pel planes of the CTU rows covering the luma lines iTop to iBottom, where not done yet
+  Void                      prepareSubPelPlanes( Int iTop, Int iBottom );
+  Void                      invalidateSubPelPlanes();
+  /// luma of the reconstruction at the quarter-sample phase (iFracX, iFracY), with the layout of getPicYuvRec()
+  TComPicYuv*               getPicYuvSubPel( Int iFracX, Int iFracY ) { return m_apcPicYuvSubPel[iFracY][iFracX]; }
+
+  Void                      createPyramid();
+  /// luma of the original downscaled by 2^(iLevel+1) in each direction, NULL if not created
+  TComPicYuv*               getPicYuvPyramid( Int iLevel )        { return m_apcPicYuvPyramid[iLevel]; }
+  /// size the vectors of the pyramid motion search for the given number of reference pictures in each list
+  Void                      initPyramidMvs( Int iNumRefIdxL0, Int iNumRefIdxL1 );
+  /// vectors of the pyramid motion search against a reference picture, one per CTU, NULL if not searched
+  TComMv*                   getPyramidMvs( RefPicList eRefPicList, Int iRefIdx );
+
+  /// reset the results of the lookahead analysis
+  Void                      initLookahead();
+  Void                      addLookaheadCost( UInt uiCUAddr, Distortion uiIntraCost, Distortion uiInterCost );
+  /// lookahead intra cost of a CTU
+  Distortion                getLookaheadIntraCost( UInt uiCUAddr ) const { return m_auiLookaheadIntraCost[uiCUAddr]; }
+  /// lookahead inter cost of a CTU against the previous picture in input order, its intra cost if there is none
+  Distortion                getLookaheadInterCost( UInt uiCUAddr ) const { return m_auiLookaheadInterCost[uiCUAddr]; }
+  Void                      setSceneCut( Bool b )                        { m_bSceneCut = b; }
+  Bool                      getSceneCut() const                          { return m_bSceneCut; }
 };
 
 //! \}
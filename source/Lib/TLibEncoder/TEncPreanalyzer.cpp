@@ -37,6 +37,8 @@
 
 #include <cfloat>
 #include <algorithm>
+#include <limits>
+#include <cstring>
 
 #include "TEncPreanalyzer.h"
 
@@ -137,5 +139,248 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
     pcAQLayer->setAvgActivity( dAvgAct );
   }
 }
+
+/** Build the levels of the picture pyramid of the original luma, each one by 2x2 averaging of the one above
+ * \param pcEPic Picture object to be analyzed
+ * \return Void
+ */
+Void TEncPreanalyzer::xBuildPyramid( TEncPic* pcEPic )
+{
+  if ( pcEPic->getPicYuvPyramid( 0 ) == NULL )
+  {
+    pcEPic->createPyramid();
+  }
+
+  TComPicYuv* pcSrc = pcEPic->getPicYuvOrg();
+  for ( Int iLevel = 0; iLevel < TEncPic::NUM_PYRAMID_LEVELS; iLevel++ )
+  {
+    TComPicYuv* pcDst = pcEPic->getPicYuvPyramid( iLevel );
+    xDownscale( pcSrc, pcDst );
+    pcDst->setBorderExtension( false );
+    pcDst->extendPicBorder();
+    pcSrc = pcDst;
+  }
+}
+
+/** Downscale the luma by 2 in each direction, the last column and line are repeated for odd sizes
+ * \param pcSrc source picture
+ * \param pcDst destination picture, of half the size rounded up
+ * \return Void
+ */
+Void TEncPreanalyzer::xDownscale( TComPicYuv* pcSrc, TComPicYuv* pcDst )
+{
+  const Int iSrcWidth  = pcSrc->getWidth ( COMPONENT_Y );
+  const Int iSrcHeight = pcSrc->getHeight( COMPONENT_Y );
+  const Int iSrcStride = pcSrc->getStride( COMPONENT_Y );
+  const Int iDstStride = pcDst->getStride( COMPONENT_Y );
+
+  for ( Int y = 0; y < pcDst->getHeight( COMPONENT_Y ); y++ )
+  {
+    const Pel* piSrc0 = pcSrc->getAddr( COMPONENT_Y ) + ( 2 * y ) * iSrcStride;
+    const Pel* piSrc1 = pcSrc->getAddr( COMPONENT_Y ) + min( 2 * y + 1, iSrcHeight - 1 ) * iSrcStride;
+    Pel*       piDst  = pcDst->getAddr( COMPONENT_Y ) + y * iDstStride;
+    for ( Int x = 0; x < pcDst->getWidth( COMPONENT_Y ); x++ )
+    {
+      const Int x0 = 2 * x;
+      const Int x1 = min( 2 * x + 1, iSrcWidth - 1 );
+      piDst[x] = ( piSrc0[x0] + piSrc0[x1] + piSrc1[x0] + piSrc1[x1] + 2 ) >> 2;
+    }
+  }
+}
+
+/** Find the displacement of a block of one pyramid level with the lowest SAD, plus a small penalty for the length of
+ * the displacement, within iRange of rcCentre. The block stays within the picture and its padding.
+ * \param pcOrg    pyramid level of the current picture
+ * \param pcRef    same pyramid level of the reference picture
+ * \param iPosX    horizontal position of the block
+ * \param iPosY    vertical position of the block
+ * \param iWidth   width of the block
+ * \param iHeight  height of the block
+ * \param rcCentre centre of the search
+ * \param iRange   search range
+ * \returns best displacement
+ */
+TComMv TEncPreanalyzer::xPyramidBlockSearch( TComPicYuv* pcOrg, TComPicYuv* pcRef, Int iPosX, Int iPosY, Int iWidth, Int iHeight, const TComMv& rcCentre, Int iRange )
+{
+  const Int iStride  = pcRef->getStride ( COMPONENT_Y );
+  const Int iMarginX = pcRef->getMarginX( COMPONENT_Y ) >> 1;
+  const Int iMarginY = pcRef->getMarginY( COMPONENT_Y ) >> 1;
+
+  const Int iLeft   = max( rcCentre.getHor() - iRange, -iPosX - iMarginX );
+  const Int iRight  = min( rcCentre.getHor() + iRange, pcRef->getWidth ( COMPONENT_Y ) - iPosX - iWidth  + iMarginX );
+  const Int iTop    = max( rcCentre.getVer() - iRange, -iPosY - iMarginY );
+  const Int iBottom = min( rcCentre.getVer() + iRange, pcRef->getHeight( COMPONENT_Y ) - iPosY - iHeight + iMarginY );
+
+  DistParam cDistParam;
+  m_cRdCost.setDistParam( iWidth, iHeight, DF_SAD, cDistParam );
+  cDistParam.pOrg         = pcOrg->getAddr( COMPONENT_Y ) + iPosY * pcOrg->getStride( COMPONENT_Y ) + iPosX;
+  cDistParam.iStrideOrg   = pcOrg->getStride( COMPONENT_Y );
+  cDistParam.iStrideCur   = iStride;
+  cDistParam.bitDepth     = g_bitDepth[CHANNEL_TYPE_LUMA];
+  cDistParam.bApplyWeight = false;
+  cDistParam.compIdx      = COMPONENT_Y;
+
+  const Pel* piRef     = pcRef->getAddr( COMPONENT_Y ) + iPosY * iStride + iPosX;
+  Distortion uiCostBest = std::numeric_limits<Distortion>::max();
+  TComMv     cMvBest;
+  for ( Int y = iTop; y <= iBottom; y++ )
+  {
+    for ( Int x = iLeft; x <= iRight; x++ )
+    {
+      cDistParam.pCur = const_cast<Pel*>( piRef + y * iStride + x );
+      const Distortion uiCost = cDistParam.DistFunc( &cDistParam ) + abs( x ) + abs( y );
+      if ( uiCost < uiCostBest )
+      {
+        uiCostBest = uiCost;
+        cMvBest.set( x, y );
+      }
+    }
+  }
+  return cMvBest;
+}
+
+/** Coarse motion search of the CTUs of a CTU row against a reference picture: a full search over a quarter of the
+ * search range on the pyramid level downscaled by 4 in each direction (a sixteenth of the samples), refined within
+ * PYRAMID_ME_REFINE_RANGE on the level downscaled by 2 (a quarter of the samples). Both pictures need their pyramid.
+ * \param pcEPic       current picture
+ * \param pcRefPic     reference picture
+ * \param pcMvs        integer vectors of the CTUs of the picture, the ones of the row are set
+ * \param iSearchRange search range at full resolution
+ * \param uiCTURow     CTU row
+ * \return Void
+ */
+Void TEncPreanalyzer::xPyramidMotionSearch( TEncPic* pcEPic, TEncPic* pcRefPic, TComMv* pcMvs, Int iSearchRange, UInt uiCTURow )
+{
+  const UInt uiFrameWidthInCU = pcEPic->getFrameWidthInCU();
+
+  for ( UInt uiCol = 0; uiCol < uiFrameWidthInCU; uiCol++ )
+  {
+    TComMv cMv;
+    Int    iRange = ( iSearchRange + 3 ) >> 2;
+    for ( Int iLevel = TEncPic::NUM_PYRAMID_LEVELS - 1; iLevel >= 0; iLevel-- )
+    {
+      TComPicYuv* pcOrg   = pcEPic  ->getPicYuvPyramid( iLevel );
+      TComPicYuv* pcRef   = pcRefPic->getPicYuvPyramid( iLevel );
+      const Int   iShift  = iLevel + 1;
+      const Int   iPosX   = ( uiCol    * g_uiMaxCUWidth  ) >> iShift;
+      const Int   iPosY   = ( uiCTURow * g_uiMaxCUHeight ) >> iShift;
+      const Int   iWidth  = min( Int( ( ( uiCol    + 1 ) * g_uiMaxCUWidth  ) >> iShift ), pcOrg->getWidth ( COMPONENT_Y ) ) - iPosX;
+      const Int   iHeight = min( Int( ( ( uiCTURow + 1 ) * g_uiMaxCUHeight ) >> iShift ), pcOrg->getHeight( COMPONENT_Y ) ) - iPosY;
+
+      cMv    = xPyramidBlockSearch( pcOrg, pcRef, iPosX, iPosY, iWidth, iHeight, cMv, iRange );
+      cMv   <<= 1;
+      iRange = PYRAMID_ME_REFINE_RANGE;
+    }
+    pcMvs[ uiCTURow * uiFrameWidthInCU + uiCol ] = cMv;
+  }
+}
+
+/** Intra cost of a block of the lookahead: the lowest SATD of the DC, horizontal and vertical predictions from the
+ * neighbouring samples of the original. The block may extend into the padding of the picture.
+ * \param pcLowRes half resolution luma of the picture
+ * \param iPosX    horizontal position of the block
+ * \param iPosY    vertical position of the block
+ * \returns intra cost
+ */
+Distortion TEncPreanalyzer::xLowResIntraCost( TComPicYuv* pcLowRes, Int iPosX, Int iPosY )
+{
+  const Int iSize     = LOOKAHEAD_BLOCK_SIZE;
+  const Int iStride   = pcLowRes->getStride( COMPONENT_Y );
+  const Int iBitDepth = g_bitDepth[CHANNEL_TYPE_LUMA];
+  Pel*      piOrg     = pcLowRes->getAddr( COMPONENT_Y ) + iPosY * iStride + iPosX;
+  const Bool bAbove   = iPosY > 0;
+  const Bool bLeft    = iPosX > 0;
+
+  Int iSum = 0;
+  for ( Int i = 0; i < iSize; i++ )
+  {
+    iSum += ( bAbove ? piOrg[i - iStride] : 0 ) + ( bLeft ? piOrg[i * iStride - 1] : 0 );
+  }
+  const Int iNumRef = ( bAbove ? iSize : 0 ) + ( bLeft ? iSize : 0 );
+  const Pel iDC     = iNumRef ? Pel( ( iSum + ( iNumRef >> 1 ) ) / iNumRef ) : Pel( 1 << ( iBitDepth - 1 ) );
+
+  Pel acPred[LOOKAHEAD_BLOCK_SIZE * LOOKAHEAD_BLOCK_SIZE];
+  for ( Int i = 0; i < iSize * iSize; i++ )
+  {
+    acPred[i] = iDC;
+  }
+  Distortion uiCost = m_cRdCost.calcHAD( iBitDepth, piOrg, iStride, acPred, iSize, iSize, iSize );
+
+  if ( bAbove )
+  {
+    for ( Int y = 0; y < iSize; y++ )
+    {
+      ::memcpy( acPred + y * iSize, piOrg - iStride, sizeof(Pel) * iSize );
+    }
+    uiCost = min( uiCost, m_cRdCost.calcHAD( iBitDepth, piOrg, iStride, acPred, iSize, iSize, iSize ) );
+  }
+  if ( bLeft )
+  {
+    for ( Int y = 0; y < iSize; y++ )
+    {
+      for ( Int x = 0; x < iSize; x++ )
+      {
+        acPred[y * iSize + x] = piOrg[y * iStride - 1];
+      }
+    }
+    uiCost = min( uiCost, m_cRdCost.calcHAD( iBitDepth, piOrg, iStride, acPred, iSize, iSize, iSize ) );
+  }
+  return uiCost;
+}
+
+/** Inter cost of a block of the lookahead at half resolution: of the given candidate vectors and the result of a
+ * search at quarter resolution, the one with the lowest SAD is refined by a full search and the SATD of the best
+ * position is returned. The block may extend into the padding of the picture.
+ * \param pcEPic         picture, with its pyramid
+ * \param apcPicYuvRef   pyramid of the reference picture
+ * \param iPosX          horizontal position of the block at half resolution
+ * \param iPosY          vertical position of the block at half resolution
+ * \param pcCandidates   candidate vectors, e.g. of the neighbouring blocks
+ * \param iNumCandidates number of candidate vectors
+ * \param rcMv           returns the vector of the block
+ * \returns inter cost
+ */
+Distortion TEncPreanalyzer::xLowResInterCost( TEncPic* pcEPic, TComPicYuv* const apcPicYuvRef[TEncPic::NUM_PYRAMID_LEVELS], Int iPosX, Int iPosY, const TComMv* pcCandidates, Int iNumCandidates, TComMv& rcMv )
+{
+  TComPicYuv* pcLowRes    = pcEPic->getPicYuvPyramid( 0 );
+  TComPicYuv* pcLowResRef = apcPicYuvRef[0];
+  const Int iSize    = LOOKAHEAD_BLOCK_SIZE;
+  const Int iStride  = pcLowResRef->getStride( COMPONENT_Y );
+  const Int iMarginX = pcLowResRef->getMarginX( COMPONENT_Y ) >> 1;
+  const Int iMarginY = pcLowResRef->getMarginY( COMPONENT_Y ) >> 1;
+  Pel*      piOrg    = pcLowRes->getAddr( COMPONENT_Y ) + iPosY * pcLowRes->getStride( COMPONENT_Y ) + iPosX;
+  Pel*      piRef    = pcLowResRef->getAddr( COMPONENT_Y ) + iPosY * iStride + iPosX;
+
+  DistParam cDistParam;
+  m_cRdCost.setDistParam( iSize, iSize, DF_SAD, cDistParam );
+  cDistParam.pOrg         = piOrg;
+  cDistParam.iStrideOrg   = pcLowRes->getStride( COMPONENT_Y );
+  cDistParam.iStrideCur   = iStride;
+  cDistParam.bitDepth     = g_bitDepth[CHANNEL_TYPE_LUMA];
+  cDistParam.bApplyWeight = false;
+  cDistParam.compIdx      = COMPONENT_Y;
+
+  TComMv cCoarseMv = xPyramidBlockSearch( pcEPic->getPicYuvPyramid( 1 ), apcPicYuvRef[1], iPosX >> 1, iPosY >> 1, iSize >> 1, iSize >> 1, TComMv(), LOOKAHEAD_SEARCH_RANGE );
+  cCoarseMv <<= 1;
+
+  TComMv     cCentre;
+  Distortion uiCostBest = std::numeric_limits<Distortion>::max();
+  for ( Int i = 0; i <= iNumCandidates; i++ )
+  {
+    const TComMv& rcCandidate = i < iNumCandidates ? pcCandidates[i] : cCoarseMv;
+    const Int x = Clip3( -iPosX - iMarginX, pcLowResRef->getWidth ( COMPONENT_Y ) - iPosX - iSize + iMarginX, Int( rcCandidate.getHor() ) );
+    const Int y = Clip3( -iPosY - iMarginY, pcLowResRef->getHeight( COMPONENT_Y ) - iPosY - iSize + iMarginY, Int( rcCandidate.getVer() ) );
+    cDistParam.pCur = piRef + y * iStride + x;
+    const Distortion uiCost = cDistParam.DistFunc( &cDistParam ) + abs( x ) + abs( y );
+    if ( uiCost < uiCostBest )
+    {
+      uiCostBest = uiCost;
+      cCentre.set( x, y );
+    }
+  }
+
+  rcMv = xPyramidBlockSearch( pcLowRes, pcLowResRef, iPosX, iPosY, iSize, iSize, cCentre, LOOKAHEAD_SEARCH_RANGE );
+  return m_cRdCost.calcHAD( g_bitDepth[CHANNEL_TYPE_LUMA], piOrg, cDistParam.iStrideOrg, piRef + rcMv.getVer() * iStride + rcMv.getHor(), iStride, iSize, iSize );
+}
 //! \}
 
@@ -39,6 +39,7 @@
 #define __TENCPREANALYZER__
 
 #include "TEncPic.h"
+#include "TLibCommon/TComRdCost.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -50,11 +51,28 @@
 /// Source picture analyzer class
 class TEncPreanalyzer
 {
+private:
+  TComRdCost m_cRdCost;                             ///< SAD and SATD functions of the pyramid motion search and the lookahead costs
+
+  Void   xDownscale          ( TComPicYuv* pcSrc, TComPicYuv* pcDst );
+  TComMv xPyramidBlockSearch ( TComPicYuv* pcOrg, TComPicYuv* pcRef, Int iPosX, Int iPosY, Int iWidth, Int iHeight, const TComMv& rcCentre, Int iRange );
+
 public:
   TEncPreanalyzer();
   virtual ~TEncPreanalyzer();
 
   Void xPreanalyze( TEncPic* pcPic );
+
+  /// build the picture pyramid of the original for the pyramid motion search
+  Void xBuildPyramid( TEncPic* pcPic );
+  /// coarse motion search of the CTUs of a CTU row against a reference picture on the picture pyramids
+  Void xPyramidMotionSearch( TEncPic* pcPic, TEncPic* pcRefPic, TComMv* pcMvs, Int iSearchRange, UInt uiCTURow );
+
+  /// SATD of the best DC, horizontal or vertical prediction of a block of the half resolution luma from its neighbours
+  Distortion xLowResIntraCost( TComPicYuv* pcLowRes, Int iPosX, Int iPosY );
+  /// SATD of a block of the half resolution luma after a small motion search around the best of a few candidates and
+  /// of a coarse search at quarter resolution
+  Distortion xLowResInterCost( TEncPic* pcPic, TComPicYuv* const apcPicYuvRef[TEncPic::NUM_PYRAMID_LEVELS], Int iPosX, Int iPosY, const TComMv* pcCandidates, Int iNumCandidates, TComMv& rcMv );
 };
 
 //! \}
@@ -70,6 +70,8 @@ TEncSampleAdaptiveOffset::TEncSampleAdaptiveOffset()
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   m_preDBFstatData = NULL;
 #endif
+  m_newModeCands = NULL;
+  m_pcThreadPool = NULL;
 }
 
 TEncSampleAdaptiveOffset::~TEncSampleAdaptiveOffset()
@@ -114,6 +116,7 @@ Void TEncSampleAdaptiveOffset::createEncData()
       m_statData[i][compIdx] = new SAOStatData[NUM_SAO_NEW_TYPES];
     }
   }
+  m_newModeCands = new SAONewModeCand[m_numCTUsPic*MAX_NUM_COMPONENT*NUM_SAO_NEW_TYPES];
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   if(isPreDBFSamplesUsed)
   {
@@ -229,6 +232,7 @@ Void TEncSampleAdaptiveOffset::destroyEncData()
     }
     delete[] m_statData; m_statData = NULL;
   }
+  delete[] m_newModeCands; m_newModeCands = NULL;
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   if(m_preDBFstatData != NULL)
   {
@@ -258,13 +262,18 @@ Void TEncSampleAdaptiveOffset::initRDOCabacCoder(TEncSbac* pcRDGoOnSbacCoder, TC
 
 
 
+/** decide the SAO parameters of the picture and apply them
+ * The statistics of every CTU row must have been gathered by getStatistics(), and by getPreDBFStatistics() if the
+ * pre-deblocking samples are used. The offsets of the new mode only depend on the statistics of the CTU and are derived
+ * for all CTUs in parallel; the merge decisions and the rate estimation follow the CABAC state from CTU to CTU and
+ * remain serial; the offsets are then applied to the CTU rows in parallel.
+ */
 Void TEncSampleAdaptiveOffset::SAOProcess(TComPic* pPic, Bool* sliceEnabled, const Double *lambdas
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
                                          , Bool isPreDBFSamplesUsed
 #endif
                                           )
 {
-  TComPicYuv* orgYuv= pPic->getPicYuvOrg();
   TComPicYuv* resYuv= pPic->getPicYuvRec();
   memcpy(m_labmda, lambdas, sizeof(m_labmda));
   TComPicYuv* srcYuv = m_tempPicYuv;
@@ -272,8 +281,6 @@ Void TEncSampleAdaptiveOffset::SAOProcess(TComPic* pPic, Bool* sliceEnabled, con
   srcYuv->setBorderExtension(false);
   srcYuv->extendPicBorder();
 
-  //collect statistics
-  getStatistics(m_statData, orgYuv, srcYuv, pPic);
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   if(isPreDBFSamplesUsed)
   {
@@ -283,16 +290,47 @@ Void TEncSampleAdaptiveOffset::SAOProcess(TComPic* pPic, Bool* sliceEnabled, con
   //slice on/off 
   decidePicParams(sliceEnabled, pPic->getSlice(0)->getDepth()); 
 
+  //new mode candidates
+  TComTaskGraph cGraph;
+  for(Int ctuRow = 0; ctuRow < m_numCTUInHeight; ctuRow++)
+  {
+    cGraph.addTask( [&, ctuRow]( Int )
+    {
+      for(Int ctu = ctuRow*m_numCTUInWidth; ctu < (ctuRow+1)*m_numCTUInWidth; ctu++)
+      {
+        deriveNewModeCands(ctu, sliceEnabled, m_statData);
+      }
+    } );
+  }
+  m_pcThreadPool->run( cGraph );
+
   //block on/off 
   SAOBlkParam* reconParams = new SAOBlkParam[m_numCTUsPic]; //temporary parameter buffer for storing reconstructed SAO parameters
-  decideBlkParams(pPic, sliceEnabled, m_statData, srcYuv, resYuv, reconParams, pPic->getPicSym()->getSAOBlkParam());
+  decideBlkParams(pPic, sliceEnabled, m_statData, reconParams, pPic->getPicSym()->getSAOBlkParam());
+
+  //apply reconstructed offsets
+  cGraph.clear();
+  for(Int ctuRow = 0; ctuRow < m_numCTUInHeight; ctuRow++)
+  {
+    cGraph.addTask( [&, ctuRow]( Int )
+    {
+      for(Int ctu = ctuRow*m_numCTUInWidth; ctu < (ctuRow+1)*m_numCTUInWidth; ctu++)
+      {
+        offsetCTU(ctu, srcYuv, resYuv, reconParams[ctu], pPic);
+      }
+    } );
+  }
+  m_pcThreadPool->run( cGraph );
   delete[] reconParams;
 }
 
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-Void TEncSampleAdaptiveOffset::getPreDBFStatistics(TComPic* pPic)
+/** statistics of the CTUs of a row on the samples at the bottom and right boundaries before deblocking, to be called
+ * before the deblocking of the row and of the row below it
+ */
+Void TEncSampleAdaptiveOffset::getPreDBFStatistics(TComPic* pPic, Int ctuRow)
 {
-  getStatistics(m_preDBFstatData, pPic->getPicYuvOrg(), pPic->getPicYuvRec(), pPic, true);
+  getStatistics(m_preDBFstatData, pPic->getPicYuvOrg(), pPic->getPicYuvRec(), pPic, ctuRow, true);
 }
 
 Void TEncSampleAdaptiveOffset::addPreDBFStatistics(SAOStatData*** blkStats)
@@ -311,7 +349,15 @@ Void TEncSampleAdaptiveOffset::addPreDBFStatistics(SAOStatData*** blkStats)
 
 #endif
 
-Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic
+/** statistics of the CTUs of a row on the deblocked samples, to be called once the row and the row below it have
+ * been deblocked
+ */
+Void TEncSampleAdaptiveOffset::getStatistics(TComPic* pPic, Int ctuRow)
+{
+  getStatistics(m_statData, pPic->getPicYuvOrg(), pPic->getPicYuvRec(), pPic, ctuRow);
+}
+
+Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int ctuRow
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
                           , Bool isCalculatePreDeblockSamples
 #endif
@@ -321,7 +367,7 @@ Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv
 
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
 
-  for(Int ctu= 0; ctu < m_numCTUsPic; ctu++)
+  for(Int ctu = ctuRow*m_numCTUInWidth; ctu < (ctuRow+1)*m_numCTUInWidth; ctu++)
   {
     Int yPos   = (ctu / m_numCTUInWidth)*m_maxCUHeight;
     Int xPos   = (ctu % m_numCTUInWidth)*m_maxCUWidth;
@@ -584,6 +630,39 @@ Void TEncSampleAdaptiveOffset::deriveOffsets(Int ctu, ComponentID compIdx, Int t
 }
 
 
+/** derive the offsets of each new type of the enabled components of a CTU and their distortion, for deriveModeNewRDO()
+ */
+Void TEncSampleAdaptiveOffset::deriveNewModeCands(Int ctu, Bool* sliceEnabled, SAOStatData*** blkStats)
+{
+  const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
+  Int invQuantOffset[MAX_NUM_SAO_CLASSES];
+
+  for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
+  {
+    if(!sliceEnabled[compIdx])
+    {
+      continue;
+    }
+    const ComponentID component = ComponentID(compIdx);
+
+    for(Int typeIdc=0; typeIdc< NUM_SAO_NEW_TYPES; typeIdc++)
+    {
+      SAONewModeCand& cand = getNewModeCand(ctu, compIdx, typeIdc);
+      cand.offset.modeIdc = SAO_MODE_NEW;
+      cand.offset.typeIdc = typeIdc;
+
+      //derive coded offset
+      deriveOffsets(ctu, component, typeIdc, blkStats[ctu][compIdx][typeIdc], cand.offset.offset, cand.offset.typeAuxInfo);
+
+      //inversed quantized offsets
+      invertQuantOffsets(component, typeIdc, cand.offset.typeAuxInfo, invQuantOffset, cand.offset.offset);
+
+      //get distortion
+      cand.dist = getDistortion(ctu, component, typeIdc, cand.offset.typeAuxInfo, invQuantOffset, blkStats[ctu][compIdx][typeIdc]);
+    }
+  }
+}
+
 Void TEncSampleAdaptiveOffset::deriveModeNewRDO(Int ctu, SAOBlkParam* mergeList[NUM_SAO_MERGE_TYPES], Bool* sliceEnabled, SAOStatData*** blkStats, SAOBlkParam& modeParam, Double& modeNormCost, TEncSbac** cabacCoderRDO, Int inCabacLabel)
 {
   Double minCost, cost;
@@ -594,7 +673,6 @@ Void TEncSampleAdaptiveOffset::deriveModeNewRDO(Int ctu, SAOBlkParam* mergeList[
 
   Int64 dist[MAX_NUM_COMPONENT], modeDist[MAX_NUM_COMPONENT];
   SAOOffset testOffset[MAX_NUM_COMPONENT];
-  Int invQuantOffset[MAX_NUM_SAO_CLASSES];
   for(Int comp=0; comp < MAX_NUM_COMPONENT; comp++)
   {
     modeDist[comp] = 0;
@@ -620,17 +698,10 @@ Void TEncSampleAdaptiveOffset::deriveModeNewRDO(Int ctu, SAOBlkParam* mergeList[
     {
       for(Int typeIdc=0; typeIdc< NUM_SAO_NEW_TYPES; typeIdc++)
       {
-        testOffset[compIdx].modeIdc = SAO_MODE_NEW;
-        testOffset[compIdx].typeIdc = typeIdc;
-
-        //derive coded offset
-        deriveOffsets(ctu, compIdx, typeIdc, blkStats[ctu][compIdx][typeIdc], testOffset[compIdx].offset, testOffset[compIdx].typeAuxInfo);
-
-        //inversed quantized offsets
-        invertQuantOffsets(compIdx, typeIdc, testOffset[compIdx].typeAuxInfo, invQuantOffset, testOffset[compIdx].offset);
-
-        //get distortion
-        dist[compIdx] = getDistortion(ctu, compIdx, testOffset[compIdx].typeIdc, testOffset[compIdx].typeAuxInfo, invQuantOffset, blkStats[ctu][compIdx][typeIdc]);
+        //coded offset and distortion
+        const SAONewModeCand& cand = getNewModeCand(ctu, compIdx, typeIdc);
+        testOffset[compIdx] = cand.offset;
+        dist[compIdx]       = cand.dist;
 
         //get rate
         m_pcRDGoOnSbacCoder->load(cabacCoderRDO[SAO_CABACSTATE_BLK_MID]);
@@ -699,13 +770,10 @@ Void TEncSampleAdaptiveOffset::deriveModeNewRDO(Int ctu, SAOBlkParam* mergeList[
         dist[component]= 0;
         continue;
       }
-      testOffset[component].modeIdc = SAO_MODE_NEW;
-      testOffset[component].typeIdc = typeIdc;
-
-      //derive offset & get distortion
-      deriveOffsets(ctu, component, typeIdc, blkStats[ctu][component][typeIdc], testOffset[component].offset, testOffset[component].typeAuxInfo);
-      invertQuantOffsets(component, typeIdc, testOffset[component].typeAuxInfo, invQuantOffset, testOffset[component].offset);
-      dist[component]= getDistortion(ctu, component, typeIdc, testOffset[component].typeAuxInfo, invQuantOffset, blkStats[ctu][component][typeIdc]);
+      //offset & distortion
+      const SAONewModeCand& cand = getNewModeCand(ctu, component, typeIdc);
+      testOffset[component] = cand.offset;
+      dist[component]       = cand.dist;
 
 #if !RExt__BACKWARDS_COMPATIBILITY_HM_TICKET_1192
       m_pcRDGoOnSbacCoder->codeSAOOffsetParam(component, testOffset[component], sliceEnabled[component]);
@@ -818,7 +886,7 @@ Void TEncSampleAdaptiveOffset::deriveModeMergeRDO(Int ctu, SAOBlkParam* mergeLis
   m_pcRDGoOnSbacCoder->load(cabacCoderRDO[SAO_CABACSTATE_BLK_TEMP]);
 }
 
-Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled, SAOStatData*** blkStats, TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam* reconParams, SAOBlkParam* codedParams)
+Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled, SAOStatData*** blkStats, SAOBlkParam* reconParams, SAOBlkParam* codedParams)
 {
   Bool allBlksDisabled = true;
   const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
@@ -895,10 +963,9 @@ Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled,
 
     m_pcRDGoOnSbacCoder->load(m_pppcRDSbacCoder[ SAO_CABACSTATE_BLK_NEXT ]);
 
-    //apply reconstructed offsets
+    //reconstructed offsets, applied by SAOProcess()
     reconParams[ctu] = codedParams[ctu];
     reconstructBlkSAOParam(reconParams[ctu], mergeList);
-    offsetCTU(ctu, srcYuv, resYuv, reconParams[ctu], pic);
   } //ctu
 
 #if !RExt__BACKWARDS_COMPATIBILITY_HM_TICKET_1149
@@ -956,21 +1023,8 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
 #endif
                         )
 {
-  if(m_lineBufWidth != m_maxCUWidth)
-  {
-    m_lineBufWidth = m_maxCUWidth;
-
-    if (m_signLineBuf1) delete[] m_signLineBuf1; m_signLineBuf1 = NULL;
-    m_signLineBuf1 = new Char[m_lineBufWidth+1]; 
-
-    if (m_signLineBuf2) delete[] m_signLineBuf2; m_signLineBuf2 = NULL;
-    m_signLineBuf2 = new Char[m_lineBufWidth+1];
-  }
-
-  Int x,y, startX, startY, endX, endY, edgeType, firstLineStartX, firstLineEndX;
-  Char signLeft, signRight, signDown;
+  Int startX, startY, endX, endY, firstLineStartX, firstLineEndX;
   Int64 *diff, *count;
-  Pel *srcLine, *orgLine;
   Int* skipLinesR = m_skipLinesR[compIdx];
   Int* skipLinesB = m_skipLinesB[compIdx];
 
@@ -979,16 +1033,12 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
     SAOStatData& statsData= statsDataTypes[typeIdx];
     statsData.reset();
 
-    srcLine = srcBlk;
-    orgLine = orgBlk;
     diff    = statsData.diff;
     count   = statsData.count;
     switch(typeIdx)
     {
     case SAO_TYPE_EO_0:
       {
-        diff +=2;
-        count+=2;
         endY   = (isBelowAvail) ? (height - skipLinesB[typeIdx]) : height;
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
@@ -1004,21 +1054,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
 #else
         endX   = isRightAvail ? (width - skipLinesR[typeIdx]): (width - 1);
 #endif
-        for (y=0; y<endY; y++)
-        {
-          signLeft = (Char)m_sign[srcLine[startX] - srcLine[startX-1]];
-          for (x=startX; x<endX; x++)
-          {
-            signRight =  (Char)m_sign[srcLine[x] - srcLine[x+1]]; 
-            edgeType  =  signRight + signLeft;
-            signLeft  = -signRight;
-
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-          }
-          srcLine  += srcStride;
-          orgLine  += orgStride;
-        }
+        m_statsEOBlk(srcBlk + startX, orgBlk + startX, srcStride, orgStride, endX - startX, endY, 1, 0, diff, count);
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         if(isCalculatePreDeblockSamples)
         {
@@ -1026,22 +1062,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
           {
             startX = isLeftAvail  ? 0 : 1;
             endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              signLeft = (Char)m_sign[srcLine[startX] - srcLine[startX-1]];
-              for (x=startX; x<endX; x++)
-              {
-                signRight =  (Char)m_sign[srcLine[x] - srcLine[x+1]]; 
-                edgeType  =  signRight + signLeft;
-                signLeft  = -signRight;
-
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            m_statsEOBlk(srcBlk + endY*srcStride + startX, orgBlk + endY*orgStride + startX, srcStride, orgStride, endX - startX, skipLinesB[typeIdx], 1, 0, diff, count);
           }
         }
 #endif
@@ -1049,14 +1070,12 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
       break;
     case SAO_TYPE_EO_90:
       {
-        diff +=2;
-        count+=2;
-        Char *signUpLine = m_signLineBuf1;
-
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? 0
                                                  : (isRightAvail ? (width - skipLinesR[typeIdx]) : width)
                                                  ;
+#else
+        startX = 0;
 #endif
         startY = isAboveAvail ? 0 : 1;
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
@@ -1067,79 +1086,23 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
         endX   = isRightAvail ? (width - skipLinesR[typeIdx]) : width ;
 #endif
         endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
-        if (!isAboveAvail)
-        {
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
-
-        Pel* srcLineAbove = srcLine - srcStride;
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        for (x=startX; x<endX; x++) 
-#else
-        for (x=0; x< endX; x++) 
-#endif
-        {
-          signUpLine[x] = (Char)m_sign[srcLine[x] - srcLineAbove[x]];
-        }
-
-        Pel* srcLineBelow;
-        for (y=startY; y<endY; y++)
-        {
-          srcLineBelow = srcLine + srcStride;
-
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-          for (x=startX; x<endX; x++)
-#else
-          for (x=0; x<endX; x++)
-#endif
-          {
-            signDown  = (Char)m_sign[srcLine[x] - srcLineBelow[x]]; 
-            edgeType  = signDown + signUpLine[x];
-            signUpLine[x]= -signDown;
-
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-          }
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
+        m_statsEOBlk(srcBlk + startY*srcStride + startX, orgBlk + startY*orgStride + startX, srcStride, orgStride, endX - startX, endY - startY, 0, 1, diff, count);
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
-            startX = 0;
-            endX   = width;
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x<endX; x++)
-              {
-                edgeType = m_sign[srcLine[x] - srcLineBelow[x]] + m_sign[srcLine[x] - srcLineAbove[x]];
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            m_statsEOBlk(srcBlk + endY*srcStride, orgBlk + endY*orgStride, srcStride, orgStride, width, skipLinesB[typeIdx], 0, 1, diff, count);
           }
         }
 #endif
-
       }
       break;
     case SAO_TYPE_EO_135:
+    case SAO_TYPE_EO_45:
       {
-        diff +=2;
-        count+=2;
-        Char *signUpLine, *signDownLine, *signTmpLine;
-
-        signUpLine  = m_signLineBuf1;
-        signDownLine= m_signLineBuf2;
+        // below-right neighbour for 135 degrees, below-left one for 45 degrees
+        const Int dx = (typeIdx == SAO_TYPE_EO_135) ? 1 : -1;
 
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
@@ -1158,154 +1121,35 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
 #endif
         endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
 
-        //prepare 2nd line's upper sign
-        Pel* srcLineBelow = srcLine + srcStride;
-        for (x=startX; x<endX+1; x++)
-        {
-          signUpLine[x] = (Char)m_sign[srcLineBelow[x] - srcLine[x-1]];
-        }
-
         //1st line
-        Pel* srcLineAbove = srcLine - srcStride;
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveLeftAvail ? 0    : 1) : startX;
-        firstLineEndX   = (!isCalculatePreDeblockSamples) ? (isAboveAvail     ? endX : 1) : endX;
-#else
-        firstLineStartX = isAboveLeftAvail ? 0    : 1;
-        firstLineEndX   = isAboveAvail     ? endX : 1;
-#endif
-        for(x=firstLineStartX; x<firstLineEndX; x++)
-        {
-          edgeType = m_sign[srcLine[x] - srcLineAbove[x-1]] - signUpLine[x+1];
-          diff [edgeType] += (orgLine[x] - srcLine[x]);
-          count[edgeType] ++;
-        }
-        srcLine  += srcStride;
-        orgLine  += orgStride;
-
-
-        //middle lines
-        for (y=1; y<endY; y++)
+        if (typeIdx == SAO_TYPE_EO_135)
         {
-          srcLineBelow = srcLine + srcStride;
-
-          for (x=startX; x<endX; x++)
-          {
-            signDown = (Char)m_sign[srcLine[x] - srcLineBelow[x+1]] ;
-            edgeType = signDown + signUpLine[x];
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-
-            signDownLine[x+1] = -signDown; 
-          }
-          signDownLine[startX] = (Char)m_sign[srcLineBelow[startX] - srcLine[startX-1]];
-
-          signTmpLine  = signUpLine;
-          signUpLine   = signDownLine;
-          signDownLine = signTmpLine;
-
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        if(isCalculatePreDeblockSamples)
-        {
-          if(isBelowAvail)
-          {
-            startX = isLeftAvail  ? 0     : 1 ;
-            endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x< endX; x++)
-              {
-                edgeType = m_sign[srcLine[x] - srcLineBelow[x+1]] + m_sign[srcLine[x] - srcLineAbove[x-1]];
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
-          }
-        }
-#endif
-      }
-      break;
-    case SAO_TYPE_EO_45:
-      {
-        diff +=2;
-        count+=2;
-        Char *signUpLine = m_signLineBuf1+1;
-
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
-                                                 : (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
-                                                 ;
-#else
-        startX = isLeftAvail ? 0 : 1;
-#endif
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        endX   = (!isCalculatePreDeblockSamples) ? (isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1))
-                                                 : (isRightAvail ? width : (width - 1))
-                                                 ;
+          firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveLeftAvail ? 0    : 1) : startX;
+          firstLineEndX   = (!isCalculatePreDeblockSamples) ? (isAboveAvail     ? endX : 1) : endX;
 #else
-        endX   = isRightAvail ? (width - skipLinesR[typeIdx]) : (width - 1);
+          firstLineStartX = isAboveLeftAvail ? 0    : 1;
+          firstLineEndX   = isAboveAvail     ? endX : 1;
 #endif
-        endY   = isBelowAvail ? (height - skipLinesB[typeIdx]) : (height - 1);
-
-        //prepare 2nd line upper sign
-        Pel* srcLineBelow = srcLine + srcStride;
-        for (x=startX-1; x<endX; x++)
-        {
-          signUpLine[x] = (Char)m_sign[srcLineBelow[x] - srcLine[x+1]];
         }
-
-
-        //first line
-        Pel* srcLineAbove = srcLine - srcStride;
+        else
+        {
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-        firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveAvail ? startX : endX)
-                                                          : startX
-                                                          ;
-        firstLineEndX   = (!isCalculatePreDeblockSamples) ? ((!isRightAvail && isAboveRightAvail) ? width : endX)
-                                                          : endX
-                                                          ;
+          firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveAvail ? startX : endX)
+                                                            : startX
+                                                            ;
+          firstLineEndX   = (!isCalculatePreDeblockSamples) ? ((!isRightAvail && isAboveRightAvail) ? width : endX)
+                                                            : endX
+                                                            ;
 #else
-        firstLineStartX = isAboveAvail ? startX : endX;
-        firstLineEndX   = (!isRightAvail && isAboveRightAvail) ? width : endX;
+          firstLineStartX = isAboveAvail ? startX : endX;
+          firstLineEndX   = (!isRightAvail && isAboveRightAvail) ? width : endX;
 #endif
-        for(x=firstLineStartX; x<firstLineEndX; x++)
-        {
-          edgeType = m_sign[srcLine[x] - srcLineAbove[x+1]] - signUpLine[x-1];
-          diff [edgeType] += (orgLine[x] - srcLine[x]);
-          count[edgeType] ++;
         }
-
-        srcLine += srcStride;
-        orgLine += orgStride;
+        m_statsEOBlk(srcBlk + firstLineStartX, orgBlk + firstLineStartX, srcStride, orgStride, firstLineEndX - firstLineStartX, 1, dx, 1, diff, count);
 
         //middle lines
-        for (y=1; y<endY; y++)
-        {
-          srcLineBelow = srcLine + srcStride;
-
-          for(x=startX; x<endX; x++)
-          {
-            signDown = (Char)m_sign[srcLine[x] - srcLineBelow[x-1]] ;
-            edgeType = signDown + signUpLine[x];
-
-            diff [edgeType] += (orgLine[x] - srcLine[x]);
-            count[edgeType] ++;
-
-            signUpLine[x-1] = -signDown; 
-          }
-          signUpLine[endX-1] = (Char)m_sign[srcLineBelow[endX-1] - srcLine[endX]];
-          srcLine  += srcStride;
-          orgLine  += orgStride;
-        }
+        m_statsEOBlk(srcBlk + srcStride + startX, orgBlk + orgStride + startX, srcStride, orgStride, endX - startX, endY - 1, dx, 1, diff, count);
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         if(isCalculatePreDeblockSamples)
         {
@@ -1313,21 +1157,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
           {
             startX = isLeftAvail  ? 0     : 1 ;
             endX   = isRightAvail ? width : (width -1);
-
-            for(y=0; y<skipLinesB[typeIdx]; y++)
-            {
-              srcLineBelow = srcLine + srcStride;
-              srcLineAbove = srcLine - srcStride;
-
-              for (x=startX; x<endX; x++)
-              {
-                edgeType = m_sign[srcLine[x] - srcLineBelow[x-1]] + m_sign[srcLine[x] - srcLineAbove[x+1]];
-                diff [edgeType] += (orgLine[x] - srcLine[x]);
-                count[edgeType] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-            }
+            m_statsEOBlk(srcBlk + endY*srcStride + startX, orgBlk + endY*orgStride + startX, srcStride, orgStride, endX - startX, skipLinesB[typeIdx], dx, 1, diff, count);
           }
         }
 #endif
@@ -1343,47 +1173,18 @@ Void TEncSampleAdaptiveOffset::getBlkStats(ComponentID compIdx, SAOStatData* sta
                                                 :width
                                                 ;
 #else
+        startX = 0;
         endX = isRightAvail ? (width- skipLinesR[typeIdx]) : width;
 #endif
         endY = isBelowAvail ? (height- skipLinesB[typeIdx]) : height;
         Int shiftBits = g_bitDepth[toChannelType(compIdx)] - NUM_SAO_BO_CLASSES_LOG2;
-        for (y=0; y< endY; y++)
-        {
-#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-          for (x=startX; x< endX; x++)
-#else
-          for (x=0; x< endX; x++)
-#endif
-          {
-
-            Int bandIdx= srcLine[x] >> shiftBits; 
-            diff [bandIdx] += (orgLine[x] - srcLine[x]);
-            count[bandIdx] ++;
-          }
-          srcLine += srcStride;
-          orgLine += orgStride;
-        }
+        m_statsBOBlk(srcBlk + startX, orgBlk + startX, srcStride, orgStride, endX - startX, endY, shiftBits, diff, count);
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         if(isCalculatePreDeblockSamples)
         {
           if(isBelowAvail)
           {
-            startX = 0;
-            endX   = width;
-
-            for(y= 0; y< skipLinesB[typeIdx]; y++)
-            {
-              for (x=startX; x< endX; x++)
-              {
-                Int bandIdx= srcLine[x] >> shiftBits; 
-                diff [bandIdx] += (orgLine[x] - srcLine[x]);
-                count[bandIdx] ++;
-              }
-              srcLine  += srcStride;
-              orgLine  += orgStride;
-
-            }
-
+            m_statsBOBlk(srcBlk + endY*srcStride, orgBlk + endY*orgStride, srcStride, orgStride, width, skipLinesB[typeIdx], shiftBits, diff, count);
           }
         }
 #endif
@@ -45,6 +45,7 @@
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TLibCommon/TComBitCounter.h"
+#include "TLibCommon/TComThreadPool.h"
 
 //! \ingroup TLibEncoder
 //! \{
@@ -95,6 +96,12 @@ struct SAOStatData //data structure for SAO statistics
 #endif
 };
 
+struct SAONewModeCand //offsets of one new type and their distortion, which only depend on the statistics of the CTU
+{
+  SAOOffset offset; //quantized offsets
+  Int64     dist;
+};
+
 class TEncSampleAdaptiveOffset : public TComSampleAdaptiveOffset
 {
 public:
@@ -108,6 +115,7 @@ public:
   Void createEncData();
 #endif
   Void destroyEncData();
+  Void setThreadPool(TComThreadPool* pcThreadPool) { m_pcThreadPool = pcThreadPool; }
   Void initRDOCabacCoder(TEncSbac* pcRDGoOnSbacCoder, TComSlice* pcSlice) ;
   Void SAOProcess(TComPic* pPic, Bool* sliceEnabled, const Double *lambdas
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
@@ -115,17 +123,21 @@ public:
 #endif
                 ); 
 public: //methods
+  //statistics of the CTUs of one row, gathered before SAOProcess() as soon as the samples they read are final
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
-  Void getPreDBFStatistics(TComPic* pPic); 
+  Void getPreDBFStatistics(TComPic* pPic, Int ctuRow); 
 #endif
+  Void getStatistics(TComPic* pPic, Int ctuRow);
 private: //methods
-  Void getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv,TComPic* pPic
+  Void getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv,TComPic* pPic, Int ctuRow
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
                    , Bool isCalculatePreDeblockSamples = false
 #endif
                    );
   Void decidePicParams(Bool* sliceEnabled, Int picTempLayer);
-  Void decideBlkParams(TComPic* pic, Bool* sliceEnabled, SAOStatData*** blkStats, TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam* reconParams, SAOBlkParam* codedParams);
+  Void deriveNewModeCands(Int ctu, Bool* sliceEnabled, SAOStatData*** blkStats);
+  Void decideBlkParams(TComPic* pic, Bool* sliceEnabled, SAOStatData*** blkStats, SAOBlkParam* reconParams, SAOBlkParam* codedParams);
+  SAONewModeCand& getNewModeCand(Int ctu, Int compIdx, Int typeIdc) { return m_newModeCands[(ctu*MAX_NUM_COMPONENT + compIdx)*NUM_SAO_NEW_TYPES + typeIdc]; }
   Void getBlkStats(ComponentID compIdx, SAOStatData* statsDataTypes, Pel* srcBlk, Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
                   , Bool isCalculatePreDeblockSamples
@@ -150,6 +162,8 @@ private: //members
   TEncBinCABAC**         m_pppcBinCoderCABAC;
 #endif
   Double                 m_labmda[MAX_NUM_COMPONENT];
+  SAONewModeCand*        m_newModeCands; //[ctu][comp][type], see getNewModeCand()
+  TComThreadPool*        m_pcThreadPool;
 
   //statistics
   SAOStatData***         m_statData; //[ctu][comp][classes]
@@ -41,6 +41,7 @@
 
 #include <map>
 #include <algorithm>
+#include <atomic>
 
 #if RExt__ENVIRONMENT_VARIABLE_DEBUG_AND_TEST
 #include "../TLibCommon/Debug.h"
@@ -98,6 +99,14 @@ TEncSbac::TEncSbac()
 #endif
 {
   assert( m_numContextModels <= MAX_NUM_CTX_MOD );
+
+  static_assert( ( MAX_NUM_CTX_MOD * sizeof( ContextModel ) ) >> CONTEXT_CHUNK_LOG2_SIZE <= 64, "context chunks must fit in a 64-bit mask" );
+  static std::atomic<UInt> numInstances( 0 );
+
+  m_numContextChunks     = Int( ( m_numContextModels * sizeof( ContextModel ) + ( 1 << CONTEXT_CHUNK_LOG2_SIZE ) - 1 ) >> CONTEXT_CHUNK_LOG2_SIZE );
+  m_uiLastContextVersion = UInt64( numInstances++ ) << 40;
+  m_uiDirtyContextChunks = ~UInt64( 0 );
+  ::memset( m_contextChunkVersion, 0, sizeof( m_contextChunkVersion ) );
 }
 
 TEncSbac::~TEncSbac()
@@ -108,6 +117,19 @@ TEncSbac::~TEncSbac()
 // Public member functions
 // ====================================================================================================================
 
+Void TEncSbac::init( TEncBinIf* p )
+{
+  m_pcBinIf = p;
+
+  TEncBinCABAC* pcBinCABAC = p ? p->getTEncBinCABAC() : NULL;
+  if ( pcBinCABAC )
+  {
+    pcBinCABAC->setContextTracker( m_contextModels, &m_uiDirtyContextChunks );
+  }
+  // modifications made while the bin coder was tracking another instance are unknown
+  m_uiDirtyContextChunks = ~UInt64( 0 );
+}
+
 Void TEncSbac::resetEntropy           ()
 {
   Int  iQp              = m_pcSlice->getSliceQp();
@@ -155,6 +177,8 @@ Void TEncSbac::resetEntropy           ()
   m_cCrossComponentDecorrelationSCModel.initBuffer( eSliceType, iQp, (UChar*)INIT_CROSS_COMPONENT_DECORRELATION );
 #endif
 
+  m_uiDirtyContextChunks = ~UInt64( 0 );
+
   // new structure
   m_uiLastQp = iQp;
 
@@ -274,6 +298,7 @@ Void TEncSbac::updateContextTables( SliceType eSliceType, Int iQp, Bool bExecute
 #if RExt__O0202_CROSS_COMPONENT_DECORRELATION
   m_cCrossComponentDecorrelationSCModel.initBuffer( eSliceType, iQp, (UChar*)INIT_CROSS_COMPONENT_DECORRELATION );
 #endif
+  m_uiDirtyContextChunks = ~UInt64( 0 );
 
   m_pcBinIf->start();
 }
@@ -427,9 +452,15 @@ Void  TEncSbac::loadIntraDirMode( TEncSbac* pSrc, const ChannelType chType )
 {
   m_pcBinIf->copyState( pSrc->m_pcBinIf );
   if (isLuma(chType))
+  {
     this->m_cCUIntraPredSCModel      .copyFrom( &pSrc->m_cCUIntraPredSCModel       );
+    xMarkContextsDirty( m_cCUIntraPredSCModel.get( 0 ), NUM_ADI_CTX );
+  }
   else
+  {
     this->m_cCUChromaPredSCModel     .copyFrom( &pSrc->m_cCUChromaPredSCModel      );
+    xMarkContextsDirty( m_cCUChromaPredSCModel.get( 0 ), NUM_CHROMA_PRED_CTX );
+  }
 }
 
 
@@ -446,7 +477,47 @@ Void TEncSbac::xCopyFrom( TEncSbac* pSrc )
   this->m_uiCoeffCost = pSrc->m_uiCoeffCost;
   this->m_uiLastQp    = pSrc->m_uiLastQp;
 
-  memcpy( m_contextModels, pSrc->m_contextModels, m_numContextModels * sizeof( ContextModel ) );
+  xCopyContextsFrom( pSrc );
+}
+
+/** Assign a new version to every chunk modified since the last call, so that it no longer matches any other instance
+ */
+Void TEncSbac::xCommitContextChunks()
+{
+  TEncBinCABAC* pcBinCABAC = m_pcBinIf ? m_pcBinIf->getTEncBinCABAC() : NULL;
+  if ( pcBinCABAC == NULL || !pcBinCABAC->isContextTracker( &m_uiDirtyContextChunks ) )
+  {
+    // the bin coder has since been attached to another instance, so our writes were not recorded
+    m_uiDirtyContextChunks = ~UInt64( 0 );
+  }
+
+  if ( m_uiDirtyContextChunks )
+  {
+    const UInt64 version = ++m_uiLastContextVersion;
+    UInt64       dirty   = m_uiDirtyContextChunks;
+    for ( Int chunk = 0; dirty != 0 && chunk < m_numContextChunks; chunk++, dirty >>= 1 )
+    {
+      if ( dirty & 1 )
+      {
+        m_contextChunkVersion[chunk] = version;
+      }
+    }
+    m_uiDirtyContextChunks = 0;
+  }
+}
+
+/** Flag the chunks overlapping a range of context models as modified
+ * \param pcFirst first modified context model
+ * \param iNum    number of modified context models
+ */
+Void TEncSbac::xMarkContextsDirty( const ContextModel* pcFirst, Int iNum )
+{
+  const Int firstChunk = Int( ( pcFirst - m_contextModels ) * sizeof( ContextModel ) ) >> CONTEXT_CHUNK_LOG2_SIZE;
+  const Int lastChunk  = Int( ( pcFirst + iNum - m_contextModels ) * sizeof( ContextModel ) - 1 ) >> CONTEXT_CHUNK_LOG2_SIZE;
+  for ( Int chunk = firstChunk; chunk <= lastChunk; chunk++ )
+  {
+    m_uiDirtyContextChunks |= UInt64( 1 ) << chunk;
+  }
 }
 
 Void TEncSbac::codeMVPIdx ( TComDataCU* pcCU, UInt uiAbsPartIdx, RefPicList eRefList )
@@ -1984,9 +2055,27 @@ Void TEncSbac::estSignificantCoefficientsBit( estBitsSbacStruct* pcEstBitsSbac,
  .
  \param pSrc From where to copy context information.
  */
+/** Copy the context models of pSrc, skipping the chunks that are already shared with it
+ * \param pSrc instance to copy from
+ */
 Void TEncSbac::xCopyContextsFrom( TEncSbac* pSrc )
 {
-  memcpy(m_contextModels, pSrc->m_contextModels, m_numContextModels*sizeof(m_contextModels[0]));
+  pSrc->xCommitContextChunks();
+  this->xCommitContextChunks();
+
+  const Int chunkSize = 1 << CONTEXT_CHUNK_LOG2_SIZE;
+  const UChar* src    = reinterpret_cast<const UChar*>( pSrc->m_contextModels );
+  UChar*       dst    = reinterpret_cast<UChar*>( m_contextModels );
+
+  for ( Int chunk = 0; chunk < m_numContextChunks; chunk++ )
+  {
+    if ( m_contextChunkVersion[chunk] != pSrc->m_contextChunkVersion[chunk] )
+    {
+      // the last chunk may extend past m_numContextModels, but never past the end of m_contextModels
+      ::memcpy( dst + chunk * chunkSize, src + chunk * chunkSize, chunkSize );
+      m_contextChunkVersion[chunk] = pSrc->m_contextChunkVersion[chunk];
+    }
+  }
 }
 
 Void  TEncSbac::loadContexts ( TEncSbac* pScr)
@@ -69,7 +69,7 @@ public:
   TEncSbac();
   virtual ~TEncSbac();
 
-  Void  init                   ( TEncBinIf* p )  { m_pcBinIf = p; }
+  Void  init                   ( TEncBinIf* p );
   Void  uninit                 ()                { m_pcBinIf = 0; }
 
   //  Virtual list
@@ -122,6 +122,8 @@ private:
 
   Void  xCopyFrom            ( TEncSbac* pSrc );
   Void  xCopyContextsFrom    ( TEncSbac* pSrc );
+  Void  xCommitContextChunks ();
+  Void  xMarkContextsDirty   ( const ContextModel* pcFirst, Int iNum );
 
   Void codeDFFlag( UInt /*uiCode*/, const Char* /*pSymbolName*/ )       {printf("Not supported in codeDFFlag()\n"); assert(0); exit(1);};
   Void codeDFSvlc( Int /*iCode*/, const Char* /*pSymbolName*/ )         {printf("Not supported in codeDFSvlc()\n"); assert(0); exit(1);};
@@ -197,6 +199,13 @@ private:
 
   ContextModel         m_contextModels[MAX_NUM_CTX_MOD];
   Int                  m_numContextModels;
+
+  // copy-on-write snapshots: m_contextModels is split into chunks of (1 << CONTEXT_CHUNK_LOG2_SIZE) bytes, and two
+  // instances whose chunk versions are equal hold identical contents in that chunk, so load/store copy only the others
+  UInt64               m_contextChunkVersion[64];
+  UInt64               m_uiDirtyContextChunks;  ///< chunks modified since their version was last assigned
+  UInt64               m_uiLastContextVersion;  ///< last version assigned, unique across all instances
+  Int                  m_numContextChunks;
   ContextModel3DBuffer m_cCUSplitFlagSCModel;
   ContextModel3DBuffer m_cCUSkipFlagSCModel;
   ContextModel3DBuffer m_cCUMergeFlagExtSCModel;
@@ -39,6 +39,7 @@
 #include "TLibCommon/TComRom.h"
 #include "TLibCommon/TComMotionInfo.h"
 #include "TEncSearch.h"
+#include "TEncPic.h"
 #include "TLibCommon/TComTU.h"
 #include "TLibCommon/Debug.h"
 #include <math.h>
@@ -137,6 +138,11 @@ TEncSearch::TEncSearch()
   m_pcEncCfg                                       = NULL;
   m_pcEntropyCoder                                 = NULL;
   m_pTempPel                                       = NULL;
+  m_pcIntraBCHash                                  = NULL;
+  for (Int iSizeIdx = 0; iSizeIdx < TEncBlockHash::NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    m_aiIntraBCHashCurrBottom[iSizeIdx]            = 0;
+  }
   setWpScalingDistParam( NULL, -1, REF_PIC_LIST_X );
 }
 
@@ -259,6 +265,15 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
 
   m_pTempPel = new Pel[g_uiMaxCUWidth*g_uiMaxCUHeight];
 
+  if ( pcEncCfg->getUseIntraBlockCopy() && pcEncCfg->getUseIntraBlockCopyHashSearch() )
+  {
+    // the blocks overlapping the current CTU start up to MAX_BLOCK_SIZE - 1 samples left of it
+    for (Int iSizeIdx = 0; iSizeIdx < TEncBlockHash::NUM_BLOCK_SIZES; iSizeIdx++)
+    {
+      m_auiIntraBCHashCurr[iSizeIdx].resize( ( g_uiMaxCUWidth + TEncBlockHash::MAX_BLOCK_SIZE - 1 ) * g_uiMaxCUHeight );
+    }
+  }
+
   const UInt uiNumLayersToAllocate = pcEncCfg->getQuadtreeTULog2MaxSize()-pcEncCfg->getQuadtreeTULog2MinSize()+1;
   const UInt uiNumPartitions = 1<<(g_uiMaxCUDepth<<1);
   for (UInt ch=0; ch<MAX_NUM_COMPONENT; ch++)
@@ -302,6 +317,30 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
   m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE, pcEncCfg->getChromaFormatIdc());
 }
 
+/** Set the block hash table that the IntraBC search of the next CTU looks up.
+ * \param pcIntraBCHash  reconstructed blocks of the CTU to the left of the next CTU, NULL if the hash search is not used
+ */
+Void TEncSearch::setIntraBCHash( const TEncBlockHash* pcIntraBCHash )
+{
+  m_pcIntraBCHash = pcIntraBCHash;
+  for (Int iSizeIdx = 0; iSizeIdx < TEncBlockHash::NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    m_aiIntraBCHashCurrBottom[iSizeIdx] = 0;
+  }
+}
+
+/** Mark the hashes of the blocks overlapping the current CTU as changed from a row down, after a CU has been written
+ * to the reconstruction.
+ * \param iPelY  top row of the CU
+ */
+Void TEncSearch::invalidateIntraBCHash( Int iPelY )
+{
+  for (Int iSizeIdx = 0; iSizeIdx < TEncBlockHash::NUM_BLOCK_SIZES; iSizeIdx++)
+  {
+    m_aiIntraBCHashCurrBottom[iSizeIdx] = min( m_aiIntraBCHashCurrBottom[iSizeIdx], iPelY );
+  }
+}
+
 #if FASTME_SMOOTHER_MV
 #define FIRSTSEARCHSTOP     1
 #else
@@ -742,16 +781,29 @@ __inline Void TEncSearch::xTZ8PointDiamondSearch( TComPattern* pcPatternKey, Int
 
 //<--
 
+/** evaluate the 9 half- or quarter-sample positions around baseRefMv
+ * The samples are taken from m_filteredBlock, or, if given, from the sub-pel planes of the reference picture
+ * \param pcPatternKey  original samples of the block
+ * \param baseRefMv     centre of the refinement, in units of 1/iFrac relative to the integer vector
+ * \param iFrac         2 for the half-sample, 1 for the quarter-sample refinement
+ * \param rcMvFrac      vector of the centre for the vector cost, set to the offset of the best position
+ * \param apiSubPel     [ver][hor] block at the integer vector in each quarter-sample phase, NULL to use m_filteredBlock
+ * \param iSubPelStride stride of apiSubPel
+ * \returns cost of the best position
+ */
 Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
                                            TComMv baseRefMv,
-                                           Int iFrac, TComMv& rcMvFrac )
+                                           Int iFrac, TComMv& rcMvFrac,
+                                           Pel* const apiSubPel[][LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS],
+                                           Int iSubPelStride )
 {
+  const Int iBitDepthLuma = g_bitDepth[CHANNEL_TYPE_LUMA];
   Distortion  uiDist;
   Distortion  uiDistBest  = std::numeric_limits<Distortion>::max();
   UInt        uiDirecBest = 0;
 
   Pel*  piRefPos;
-  Int iRefStride = m_filteredBlock[0][0].getStride(COMPONENT_Y);
+  Int iRefStride = apiSubPel ? iSubPelStride : m_filteredBlock[0][0].getStride(COMPONENT_Y);
 
   m_pcRdCost->setDistParam( pcPatternKey, m_filteredBlock[0][0].getAddr(COMPONENT_Y), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() );
 
@@ -764,14 +816,21 @@ Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
 
     Int horVal = cMvTest.getHor() * iFrac;
     Int verVal = cMvTest.getVer() * iFrac;
-    piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
-    if ( horVal == 2 && ( verVal & 1 ) == 0 )
+    if ( apiSubPel )
     {
-      piRefPos += 1;
+      piRefPos = apiSubPel[ verVal & 3 ][ horVal & 3 ] + ( verVal >> 2 ) * iRefStride + ( horVal >> 2 );
     }
-    if ( ( horVal & 1 ) == 0 && verVal == 2 )
+    else
     {
-      piRefPos += iRefStride;
+      piRefPos = m_filteredBlock[ verVal & 3 ][ horVal & 3 ].getAddr(COMPONENT_Y);
+      if ( horVal == 2 && ( verVal & 1 ) == 0 )
+      {
+        piRefPos += 1;
+      }
+      if ( ( horVal & 1 ) == 0 && verVal == 2 )
+      {
+        piRefPos += iRefStride;
+      }
     }
     cMvTest = pcMvRefine[i];
     cMvTest += rcMvFrac;
@@ -779,7 +838,7 @@ Distortion TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
     setDistParamComp(COMPONENT_Y);
 
     m_cDistParam.pCur = piRefPos;
-    m_cDistParam.bitDepth = g_bitDepth[CHANNEL_TYPE_LUMA];
+    m_cDistParam.bitDepth = iBitDepthLuma;
     uiDist = m_cDistParam.DistFunc( &m_cDistParam );
     uiDist += m_pcRdCost->getCost( cMvTest.getHor(), cMvTest.getVer() );
 
@@ -4293,6 +4352,7 @@ Void TEncSearch::xSetIntraSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int i
 #if RExt__O0155_INTRA_BLOCK_COPY_CONSTRAINED_INTRA_PREDICTION
 Bool TEncSearch::xCIPIntraSearchPruning( TComDataCU* pcCU, Int relX, Int relY, Int roiWidth, Int roiHeight )
 {
+  const UInt* auiRasterToZscan = g_auiRasterToZscan;
   UInt uiAbsPartIdx;
   TComDataCU* pcPredCU;
 
@@ -4313,14 +4373,14 @@ Bool TEncSearch::xCIPIntraSearchPruning( TComDataCU* pcCU, Int relX, Int relY, I
       {
         pcPredCU = pcCU->getCULeft();
         currX += pcCU->getPic()->getMinCUWidth() * pcCU->getPic()->getNumPartInWidth();
-        uiAbsPartIdx = g_auiRasterToZscan[currX/pcCU->getPic()->getMinCUWidth() + (currY/pcCU->getPic()->getMinCUHeight())*pcCU->getPic()->getNumPartInWidth()];
+        uiAbsPartIdx = auiRasterToZscan[currX/pcCU->getPic()->getMinCUWidth() + (currY/pcCU->getPic()->getMinCUHeight())*pcCU->getPic()->getNumPartInWidth()];
         if(pcPredCU->isInter(uiAbsPartIdx))
           return false;
       }
       else
       {
         pcPredCU = pcCU->getPic()->getCU( pcCU->getAddr() );
-        uiAbsPartIdx = g_auiRasterToZscan[currX/pcCU->getPic()->getMinCUWidth() + (currY/pcCU->getPic()->getMinCUHeight())*pcCU->getPic()->getNumPartInWidth()];
+        uiAbsPartIdx = auiRasterToZscan[currX/pcCU->getPic()->getMinCUWidth() + (currY/pcCU->getPic()->getMinCUHeight())*pcCU->getPic()->getNumPartInWidth()];
         if(pcPredCU->isInter(uiAbsPartIdx))
           return false;
       }
@@ -4332,6 +4392,179 @@ Bool TEncSearch::xCIPIntraSearchPruning( TComDataCU* pcCU, Int relX, Int relY, I
 #endif
 
 
+/** Look up the block in the hashes of the reconstruction: the table of the CTU to the left, which the slice encoder
+ * fills when that CTU has been compressed, and the hashes of the blocks overlapping the current CTU at each position,
+ * which are updated for the rows whose reconstruction has changed since the last search. Each match in the search
+ * range is verified with the SAD against the reconstruction. The distortion parameters have to be set up for SADs of 4
+ * rows, as in xIntraPatternSearch().
+ * \param pcCU           CU being searched
+ * \param pcPatternKey   original samples of the block
+ * \param piRefY         reconstruction at the position of the block
+ * \param iRefStride     stride of the reconstruction
+ * \param pcMvSrchRngLT  top-left of the search range
+ * \param pcMvSrchRngRB  bottom-right of the search range
+ * \param iRoiWidth      width of the block
+ * \param iRoiHeight     height of the block
+ * \param ruiSadBest     cost (SAD and vector cost) of the best vector so far, updated if a match is better
+ * \param riBestX        horizontal component of the best vector so far
+ * \param riBestY        vertical component of the best vector so far
+ */
+Void TEncSearch::xIntraBCHashSearch( TComDataCU  *pcCU,
+                                     TComPattern *pcPatternKey,
+                                     Pel         *piRefY,
+                                     Int          iRefStride,
+                                     TComMv      *pcMvSrchRngLT,
+                                     TComMv      *pcMvSrchRngRB,
+                                     Int          iRoiWidth,
+                                     Int          iRoiHeight,
+                                     Distortion  &ruiSadBest,
+                                     Int         &riBestX,
+                                     Int         &riBestY )
+{
+  const UInt lcuWidth   = pcCU->getSlice()->getSPS()->getMaxCUWidth();
+  const UInt lcuHeight  = pcCU->getSlice()->getSPS()->getMaxCUHeight();
+  const Int  cuPelX     = pcCU->getCUPelX();
+  const Int  cuPelY     = pcCU->getCUPelY();
+  const Int  iCTUPelX   = cuPelX - cuPelX % lcuWidth;
+  const Int  iCTUPelY   = cuPelY - cuPelY % lcuHeight;
+
+  const Int  iSrchRngHorLeft   = max( pcMvSrchRngLT->getHor(), -cuPelX );
+  const Int  iSrchRngHorRight  = pcMvSrchRngRB->getHor();
+  const Int  iSrchRngVerTop    = max( pcMvSrchRngLT->getVer(), -cuPelY );
+  const Int  iSrchRngVerBottom = pcMvSrchRngRB->getVer();
+
+  const Int  iSizeIdx = TEncBlockHash::getSizeIdx( iRoiWidth );
+  UInt*      puiHashCurr = &m_auiIntraBCHashCurr[iSizeIdx][0];
+  const Int  iHashStride = lcuWidth + TEncBlockHash::MAX_BLOCK_SIZE - 1;
+  const Int  iHashX      = iCTUPelX - ( TEncBlockHash::MAX_BLOCK_SIZE - 1 );  // position of the first column of puiHashCurr
+
+  // the blocks overlapping the current CTU, from the right edge of the CTU to the left (the blocks completely inside the
+  // CTU to the left are in its table), are hashed down to the bottom of the CU: the samples below are not coded yet
+  TComPicYuv* pcPicYuvRec = pcCU->getPic()->getPicYuvRec();
+  const Int   iAreaX      = max( iCTUPelX - ( iRoiWidth - 1 ), 0 );
+  const Int   iAreaRight  = min<Int>( iCTUPelX + lcuWidth, pcPicYuvRec->getWidth( COMPONENT_Y ) );
+  const Int   iCurrBottom = cuPelY + iRoiHeight;
+  if ( m_aiIntraBCHashCurrBottom[iSizeIdx] < iCurrBottom )
+  {
+    // rehash the blocks that extend below the rows that have not changed
+    const Int iTop = max( m_aiIntraBCHashCurrBottom[iSizeIdx] - ( iRoiHeight - 1 ), iCTUPelY );
+    m_cIntraBCHashCurr.getBlockHashes( pcPicYuvRec->getAddr( COMPONENT_Y ), pcPicYuvRec->getStride( COMPONENT_Y ), iAreaX, iTop,
+                                       iAreaRight - iAreaX, iCurrBottom - iTop, iRoiWidth,
+                                       puiHashCurr + ( iTop - iCTUPelY ) * iHashStride + ( iAreaX - iHashX ), iHashStride );
+    m_aiIntraBCHashCurrBottom[iSizeIdx] = iCurrBottom;
+  }
+
+  const UInt uiHash = TEncBlockHash::getBlockHash( pcPatternKey->getROIY(), pcPatternKey->getPatternLStride(), iRoiWidth );
+  Int        iNumCandidates = 0;
+
+  const Int iMinY = max( cuPelY + iSrchRngVerTop, iCTUPelY );
+  const Int iMaxY = min( cuPelY + iSrchRngVerBottom, iCurrBottom - iRoiHeight );
+  const Int iMinX = max( cuPelX + iSrchRngHorLeft, iAreaX );
+  const Int iMaxX = min( cuPelX + iSrchRngHorRight, iAreaRight - iRoiWidth );
+  for (Int iPosY = iMinY; iPosY <= iMaxY; iPosY++)
+  {
+    const UInt* puiHashRow = puiHashCurr + ( iPosY - iCTUPelY ) * iHashStride - iHashX;
+    for (Int iPosX = iMinX; iPosX <= iMaxX; iPosX++)
+    {
+      if ( puiHashRow[iPosX] != uiHash || ( iPosX == cuPelX && iPosY == cuPelY ) )
+      {
+        continue;
+      }
+      if ( iNumCandidates++ == INTRABC_HASH_MAX_CANDIDATES ||
+           xIntraBCHashTestCandidate( pcCU, pcPatternKey, piRefY, iRefStride, iPosX - cuPelX, iPosY - cuPelY, iRoiWidth, iRoiHeight, ruiSadBest, riBestX, riBestY ) )
+      {
+        return;
+      }
+    }
+  }
+
+  const std::vector<TEncBlockHashEntry>& rcEntries = m_pcIntraBCHash->getEntries( uiHash, iRoiWidth );
+  for (std::vector<TEncBlockHashEntry>::const_iterator it = rcEntries.begin(); it != rcEntries.end(); it++)
+  {
+    const Int x = it->iPosX - cuPelX;
+    const Int y = it->iPosY - cuPelY;
+
+    if ( it->uiHash != uiHash || x < iSrchRngHorLeft || x > iSrchRngHorRight || y < iSrchRngVerTop || y > iSrchRngVerBottom )
+    {
+      continue;
+    }
+    if ( iNumCandidates++ == INTRABC_HASH_MAX_CANDIDATES ||
+         xIntraBCHashTestCandidate( pcCU, pcPatternKey, piRefY, iRefStride, x, y, iRoiWidth, iRoiHeight, ruiSadBest, riBestX, riBestY ) )
+    {
+      return;
+    }
+  }
+}
+
+/** Verify a candidate of the IntraBC hash search: check that the block is coded and available, and compute its SAD
+ * against the reconstruction.
+ * \param pcCU           CU being searched
+ * \param pcPatternKey   original samples of the block
+ * \param piRefY         reconstruction at the position of the block
+ * \param iRefStride     stride of the reconstruction
+ * \param iMvX           horizontal component of the vector of the candidate
+ * \param iMvY           vertical component of the vector of the candidate
+ * \param iRoiWidth      width of the block
+ * \param iRoiHeight     height of the block
+ * \param ruiSadBest     cost (SAD and vector cost) of the best vector so far, updated if the candidate is better
+ * \param riBestX        horizontal component of the best vector so far
+ * \param riBestY        vertical component of the best vector so far
+ * \returns true if the candidate matches the block exactly, so that no better vector than it needs to be searched
+ */
+Bool TEncSearch::xIntraBCHashTestCandidate( TComDataCU  *pcCU,
+                                            TComPattern *pcPatternKey,
+                                            Pel         *piRefY,
+                                            Int          iRefStride,
+                                            Int          iMvX,
+                                            Int          iMvY,
+                                            Int          iRoiWidth,
+                                            Int          iRoiHeight,
+                                            Distortion  &ruiSadBest,
+                                            Int         &riBestX,
+                                            Int         &riBestY )
+{
+  const UInt lcuWidth   = pcCU->getSlice()->getSPS()->getMaxCUWidth();
+  const UInt lcuHeight  = pcCU->getSlice()->getSPS()->getMaxCUHeight();
+  const Int  iRelCUPelX = pcCU->getCUPelX() % lcuWidth;
+  const Int  iRelCUPelY = pcCU->getCUPelY() % lcuHeight;
+
+  Int iTempX = iMvX + iRelCUPelX + iRoiWidth - 1;
+  Int iTempY = iMvY + iRelCUPelY + iRoiHeight - 1;
+  if ((iTempX >= 0) && (iTempY >= 0))
+  {
+    Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
+    if (g_auiRasterToZscan[iTempRasterIdx] >= pcCU->getZorderIdxInCU())
+    {
+      return false;
+    }
+  }
+
+#if RExt__O0155_INTRA_BLOCK_COPY_CONSTRAINED_INTRA_PREDICTION
+  if (!isValidIntraBCSearchArea(pcCU, iMvX + iRelCUPelX, iMvY + iRelCUPelY, iRoiWidth, iRoiHeight))
+  {
+    return false;
+  }
+#endif
+
+  const Distortion uiMvCost = m_pcRdCost->getCost( iMvX, iMvY );
+  Distortion       uiSad    = uiMvCost;
+  for (Int r = 0; r < iRoiHeight && uiSad < ruiSadBest; r += 4)
+  {
+    m_cDistParam.pCur = piRefY + ( iMvY + r ) * iRefStride + iMvX;
+    m_cDistParam.pOrg = pcPatternKey->getROIY() + r * pcPatternKey->getPatternLStride();
+    uiSad += m_cDistParam.DistFunc( &m_cDistParam );
+  }
+
+  if ( uiSad < ruiSadBest )
+  {
+    ruiSadBest = uiSad;
+    riBestX    = iMvX;
+    riBestY    = iMvY;
+    return uiSad == uiMvCost;
+  }
+  return false;
+}
+
 // based on xPatternSearch
 Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
                                       TComPattern *pcPatternKey,
@@ -4351,6 +4584,8 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
 #endif
                                       )
 {
+  const UInt* auiRasterToZscan = g_auiRasterToZscan;
+  const Int   iBitDepthLuma    = g_bitDepth[CHANNEL_TYPE_LUMA];
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
   Int   iSrchRngHorRight  = pcMvSrchRngRB->getHor();
   Int   iSrchRngVerTop    = pcMvSrchRngLT->getVer();
@@ -4373,7 +4608,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
 
 #if INTRABC_FASTME
   setDistParamComp(COMPONENT_Y);
-  m_cDistParam.bitDepth  = g_bitDepth[CHANNEL_TYPE_LUMA];
+  m_cDistParam.bitDepth  = iBitDepthLuma;
   m_cDistParam.iRows     = 4;//to calculate the sad line by line;
   m_cDistParam.iSubShift = 0;
 
@@ -4399,7 +4634,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
     if ((iTempX >= 0) && (iTempY >= 0))
     {
       Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
-      Int iTempZscanIdx = g_auiRasterToZscan[iTempRasterIdx];
+      Int iTempZscanIdx = auiRasterToZscan[iTempRasterIdx];
       if(iTempZscanIdx >= pcCU->getZorderIdxInCU())
       {
         validCand = false;
@@ -4433,6 +4668,24 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
   }
 #endif
 
+  if ( m_pcIntraBCHash != NULL && TEncBlockHash::isSupportedSize( iRoiWidth, iRoiHeight ) )
+  {
+    const Distortion uiSadBeforeHash = uiSadBest;
+    xIntraBCHashSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, iRoiWidth, iRoiHeight, uiSadBest, iBestX, iBestY );
+
+    if ( uiSadBest < uiSadBeforeHash )
+    {
+      // an exact match of the reconstruction is taken without SAD search
+      if ( uiSadBest == m_pcRdCost->getCost( iBestX, iBestY ) )
+      {
+        rcMv.set( iBestX, iBestY );
+        ruiSAD = 0;
+        return;
+      }
+      // otherwise the match bounds the SAD search below, like a match of the 1-D search
+      uiTempSadBest = uiSadBest;
+    }
+  }
      
   for(Int y = max(iSrchRngVerTop, -cuPelY); y <= -iRoiHeight; y++)
   {
@@ -4549,7 +4802,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
         if ((iTempX >= 0) && (iTempY >= 0))
         {
           Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
-          Int iTempZscanIdx = g_auiRasterToZscan[iTempRasterIdx];
+          Int iTempZscanIdx = auiRasterToZscan[iTempRasterIdx];
           if(iTempZscanIdx >= pcCU->getZorderIdxInCU())
           continue;
         }
@@ -4606,7 +4859,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
         if ((iTempX >= 0) && (iTempY >= 0))
         {
           Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
-          Int iTempZscanIdx = g_auiRasterToZscan[iTempRasterIdx];
+          Int iTempZscanIdx = auiRasterToZscan[iTempRasterIdx];
           if(iTempZscanIdx >= pcCU->getZorderIdxInCU())
           continue;
         }
@@ -4679,7 +4932,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
         if ((iTempX >= 0) && (iTempY >= 0))
         {
           Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
-          Int iTempZscanIdx = g_auiRasterToZscan[iTempRasterIdx];
+          Int iTempZscanIdx = auiRasterToZscan[iTempRasterIdx];
           if(iTempZscanIdx >= pcCU->getZorderIdxInCU())
             continue;
         }
@@ -4752,7 +5005,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
       if ((iTempX >= 0) && (iTempY >= 0))
       {
       Int iTempRasterIdx = (iTempY/pcCU->getPic()->getMinCUHeight()) * pcCU->getPic()->getNumPartInWidth() + (iTempX/pcCU->getPic()->getMinCUWidth());
-        Int iTempZscanIdx = g_auiRasterToZscan[iTempRasterIdx];
+        Int iTempZscanIdx = auiRasterToZscan[iTempRasterIdx];
         if(iTempZscanIdx >= pcCU->getZorderIdxInCU())
           continue;
       }
@@ -4765,7 +5018,7 @@ Void TEncSearch::xIntraPatternSearch( TComDataCU  *pcCU,
       piRefSrch = piRefY + x;
       m_cDistParam.pCur = piRefSrch;
     
-      m_cDistParam.bitDepth = g_bitDepth[CHANNEL_TYPE_LUMA];
+      m_cDistParam.bitDepth = iBitDepthLuma;
       uiSad = m_cDistParam.DistFunc( &m_cDistParam );
     
       uiSad += m_pcRdCost->getCost( x, y);
@@ -5135,6 +5388,21 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_pcRdCost->setCostScale  ( 2 );
 
   setWpScalingDistParam( pcCU, iRefIdxPred, eRefPicList );
+
+  if ( m_pcEncCfg->getUseHashME() && !bBi && !m_cDistParam.bApplyWeight &&
+       xHashMotionSearch( pcCU, pcPatternKey, uiPartAddr, eRefPicList, iRefIdxPred, piRefY, iRefStride, rcMv, ruiCost ) )
+  {
+    // the block is an exact copy of a block of the reference original: the integer vector is taken without search
+    m_pcRdCost->setCostScale( 0 );
+    rcMv <<= 2;
+
+    UInt uiMvBits = m_pcRdCost->getBits( rcMv.getHor(), rcMv.getVer() );
+
+    ruiBits      += uiMvBits;
+    ruiCost      += m_pcRdCost->getCost( ruiBits );
+    return;
+  }
+
   //  Do integer search
   if ( !m_iFastSearch || bBi )
   {
@@ -5143,7 +5411,13 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   else
   {
     rcMv = *pcMvPred;
-    xPatternSearchFast  ( pcCU, pcPatternKey, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost );
+    const TComMv* pcMvPyramid = NULL;
+    if ( m_pcEncCfg->getUsePyramidME() )
+    {
+      const TComMv* pcMvs = dynamic_cast<TEncPic*>( pcCU->getPic() )->getPyramidMvs( eRefPicList, iRefIdxPred );
+      pcMvPyramid = pcMvs ? &pcMvs[ pcCU->getAddr() ] : NULL;
+    }
+    xPatternSearchFast  ( pcCU, pcPatternKey, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pcMvPyramid );
   }
 
 #if RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION
@@ -5153,7 +5427,16 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
 #endif
   m_pcRdCost->setCostScale ( 1 );
 
-  xPatternSearchFracDIF( pcCU, pcPatternKey, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost ,bBi );
+  TEncPic* pcSubPelRef = NULL;
+  if ( m_pcEncCfg->getUseSubPelCache() )
+  {
+    // the refinement reads from one line above to one line below the block at the integer vector
+    const Int iPelY = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[ uiPartAddr ] ] + rcMv.getVer();
+    pcSubPelRef = dynamic_cast<TEncPic*>( pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred ) );
+    pcSubPelRef->prepareSubPelPlanes( iPelY - 1, iPelY + iRoiHeight );
+  }
+
+  xPatternSearchFracDIF( pcCU, pcPatternKey, piRefY, iRefStride, &rcMv, cMvHalf, cMvQter, ruiCost ,bBi, pcSubPelRef );
 
   m_pcRdCost->setCostScale( 0 );
   rcMv <<= 2;
@@ -5169,6 +5452,102 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
 
 
 
+/** look up the prediction unit in the block hash index of the reference picture
+ * The key is the largest hashed block size fitting into the prediction unit, at its top-left corner. A candidate is
+ * accepted only if the whole prediction unit is an exact copy of the reference original at the candidate position, the
+ * best of them is chosen by SAD against the reference reconstruction plus the vector cost.
+ * \param pcCU         CU of the prediction unit
+ * \param pcPatternKey original samples of the prediction unit
+ * \param uiPartAddr   partition address of the prediction unit within the CU
+ * \param eRefPicList  reference picture list
+ * \param iRefIdx      reference index
+ * \param piRefY       reconstruction of the reference picture at the position of the prediction unit
+ * \param iRefStride   stride of piRefY
+ * \param rcMv         integer vector of the best match
+ * \param ruiDist      distortion of the best match without the vector cost, measured as in xPatternRefinement():
+ *                     the Hadamard cost when HADME is used
+ * \returns whether a match was found
+ */
+Bool TEncSearch::xHashMotionSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx, Pel* piRefY, Int iRefStride, TComMv& rcMv, Distortion& ruiDist )
+{
+  const Int iBitDepthLuma = g_bitDepth[CHANNEL_TYPE_LUMA];
+  const Int iRoiWidth  = pcPatternKey->getROIYWidth();
+  const Int iRoiHeight = pcPatternKey->getROIYHeight();
+  const Int iKeySize   = min( iRoiWidth, iRoiHeight ) >= 16 ? 16 : 8;
+  if ( min( iRoiWidth, iRoiHeight ) < iKeySize )
+  {
+    return false;
+  }
+
+  const TEncBlockHash* pcBlockHash = dynamic_cast<TEncPic*>( pcCU->getSlice()->getRefPic( eRefPicList, iRefIdx ) )->getBlockHash();
+  if ( pcBlockHash == NULL )
+  {
+    return false;
+  }
+
+  TComPicYuv* pcRefOrg    = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdx )->getPicYuvOrg();
+  const Int   iOrgStride  = pcRefOrg->getStride( COMPONENT_Y );
+  const Int   iPicWidth   = pcRefOrg->getWidth ( COMPONENT_Y );
+  const Int   iPicHeight  = pcRefOrg->getHeight( COMPONENT_Y );
+  const Int   iPelX       = pcCU->getCUPelX() + g_auiRasterToPelX[ g_auiZscanToRaster[ uiPartAddr ] ];
+  const Int   iPelY       = pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[ uiPartAddr ] ];
+  const Pel*  piKey       = pcPatternKey->getROIY();
+  const Int   iKeyStride  = pcPatternKey->getPatternLStride();
+
+  const UInt uiHash = TEncBlockHash::getBlockHash( piKey, iKeyStride, iKeySize );
+  const std::vector<TEncBlockHashEntry>& rcEntries = pcBlockHash->getEntries( uiHash, iKeySize );
+
+  Distortion uiSadBest      = std::numeric_limits<Distortion>::max();
+  Int        iNumCandidates = 0;
+  for (std::vector<TEncBlockHashEntry>::const_iterator it = rcEntries.begin(); it != rcEntries.end() && iNumCandidates < HASH_ME_MAX_CANDIDATES; it++)
+  {
+    if ( it->uiHash != uiHash || it->iPosX + iRoiWidth > iPicWidth || it->iPosY + iRoiHeight > iPicHeight )
+    {
+      continue;
+    }
+
+    const Pel* piRefOrg = pcRefOrg->getAddr( COMPONENT_Y ) + it->iPosY * iOrgStride + it->iPosX;
+    Bool bExact = true;
+    for (Int r = 0; r < iRoiHeight && bExact; r++)
+    {
+      bExact = memcmp( piKey + r * iKeyStride, piRefOrg + r * iOrgStride, iRoiWidth * sizeof(Pel) ) == 0;
+    }
+    if ( !bExact )
+    {
+      continue;
+    }
+
+    iNumCandidates++;
+
+    const Int x = it->iPosX - iPelX;
+    const Int y = it->iPosY - iPelY;
+
+    m_pcRdCost->setDistParam( pcPatternKey, piRefY + y * iRefStride + x, iRefStride, m_cDistParam );
+    setDistParamComp( COMPONENT_Y );
+    m_cDistParam.bitDepth = iBitDepthLuma;
+
+    const Distortion uiSad = m_cDistParam.DistFunc( &m_cDistParam ) + m_pcRdCost->getCost( x, y );
+    if ( uiSad < uiSadBest )
+    {
+      uiSadBest = uiSad;
+      rcMv.set( x, y );
+    }
+  }
+
+  if ( iNumCandidates == 0 )
+  {
+    return false;
+  }
+
+  // the distortion of the fractional refinement at the integer vector, to be comparable with the searched vectors
+  m_pcRdCost->setDistParam( pcPatternKey, piRefY + rcMv.getVer() * iRefStride + rcMv.getHor(), iRefStride, 1, m_cDistParam, m_pcEncCfg->getUseHADME() );
+  setDistParamComp( COMPONENT_Y );
+  m_cDistParam.bitDepth = iBitDepthLuma;
+
+  ruiDist = m_cDistParam.DistFunc( &m_cDistParam );
+  return true;
+}
+
 Void TEncSearch::xSetSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng, TComMv& rcMvSrchRngLT, TComMv& rcMvSrchRngRB )
 {
   Int  iMvShift = 2;
@@ -5192,6 +5571,7 @@ Void TEncSearch::xSetSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int iSrchR
 
 Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD )
 {
+  const Int iBitDepthLuma = g_bitDepth[CHANNEL_TYPE_LUMA];
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
   Int   iSrchRngHorRight  = pcMvSrchRngRB->getHor();
   Int   iSrchRngVerTop    = pcMvSrchRngLT->getVer();
@@ -5227,7 +5607,7 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
 
       setDistParamComp(COMPONENT_Y);
 
-      m_cDistParam.bitDepth = g_bitDepth[CHANNEL_TYPE_LUMA];
+      m_cDistParam.bitDepth = iBitDepthLuma;
       uiSad = m_cDistParam.DistFunc( &m_cDistParam );
 
       // motion cost
@@ -5252,7 +5632,7 @@ Void TEncSearch::xPatternSearch( TComPattern* pcPatternKey, Pel* piRefY, Int iRe
 
 
 
-Void TEncSearch::xPatternSearchFast( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD )
+Void TEncSearch::xPatternSearchFast( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD, const TComMv* pcMvPyramid )
 {
   assert (MD_LEFT < NUM_MV_PREDICTORS);
   pcCU->getMvPredLeft       ( m_acMvPredictors[MD_LEFT] );
@@ -5264,7 +5644,7 @@ Void TEncSearch::xPatternSearchFast( TComDataCU* pcCU, TComPattern* pcPatternKey
   switch ( m_iFastSearch )
   {
     case 1:
-      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD );
+      xTZSearch( pcCU, pcPatternKey, piRefY, iRefStride, pcMvSrchRngLT, pcMvSrchRngRB, rcMv, ruiSAD, pcMvPyramid );
       break;
 
     default:
@@ -5275,7 +5655,12 @@ Void TEncSearch::xPatternSearchFast( TComDataCU* pcCU, TComPattern* pcPatternKey
 
 
 
-Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD )
+/** TZ search of the integer vector
+ * \param pcMvPyramid integer vector of the pyramid motion search of the CTU, or NULL. It is tested as a start point;
+ *                    if it is the best start point, it is close to the motion, so the first and star refinement
+ *                    searches are narrowed to PYRAMID_ME_TZ_SEARCH_RANGE and the raster search is skipped.
+ */
+Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD, const TComMv* pcMvPyramid )
 {
   Int   iSrchRngHorLeft   = pcMvSrchRngLT->getHor();
   Int   iSrchRngHorRight  = pcMvSrchRngRB->getHor();
@@ -5314,6 +5699,22 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
 
+  // test whether the vector of the pyramid motion search is a better start point
+  Bool bPyramidStart = false;
+  if ( pcMvPyramid )
+  {
+    TComMv cMv = *pcMvPyramid;
+    cMv <<= 2;
+    pcCU->clipMv( cMv );
+    cMv >>= 2;
+    xTZSearchHelp( pcPatternKey, cStruct, cMv.getHor(), cMv.getVer(), 0, 0 );
+    bPyramidStart = ( cStruct.iBestX == cMv.getHor() ) && ( cStruct.iBestY == cMv.getVer() );
+    if ( bPyramidStart )
+    {
+      uiSearchRange = min( uiSearchRange, UInt( PYRAMID_ME_TZ_SEARCH_RANGE ) );
+    }
+  }
+
   // start search
   Int  iDist = 0;
   Int  iStartX = cStruct.iBestX;
@@ -5363,7 +5764,7 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
   }
 
   // raster search if distance is too big
-  if ( bEnableRasterSearch && ( ((Int)(cStruct.uiBestDistance) > iRaster) || bAlwaysRasterSearch ) )
+  if ( bEnableRasterSearch && !bPyramidStart && ( ((Int)(cStruct.uiBestDistance) > iRaster) || bAlwaysRasterSearch ) )
   {
     cStruct.uiBestDistance = iRaster;
     for ( iStartY = iSrchRngVerTop; iStartY <= iSrchRngVerBottom; iStartY += iRaster )
@@ -5460,7 +5861,8 @@ Void TEncSearch::xPatternSearchFracDIF(TComDataCU*  pcCU,
                                        TComMv&      rcMvHalf,
                                        TComMv&      rcMvQter,
                                        Distortion&  ruiCost,
-                                       Bool         biPred
+                                       Bool         biPred,
+                                       TEncPic*     pcSubPelRef
                                       )
 {
   //  Reference pattern initialization (integer scale)
@@ -5471,22 +5873,44 @@ Void TEncSearch::xPatternSearchFracDIF(TComDataCU*  pcCU,
                           pcPatternKey->getROIYHeight(),
                           iRefStride );
 
+  // with the sub-pel planes of the reference picture, which have the layout of the reconstruction, the blocks at the
+  // integer vector in each phase are used instead of interpolating m_filteredBlock
+  Pel* apiSubPel[LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS][LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS];
+  if ( pcSubPelRef )
+  {
+    const Int iPlaneOffset = Int( piRefY + iOffset - pcSubPelRef->getPicYuvRec()->getAddr( COMPONENT_Y ) );
+    for (Int iFracY = 0; iFracY < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracY++)
+    {
+      for (Int iFracX = 0; iFracX < LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS; iFracX++)
+      {
+        apiSubPel[iFracY][iFracX] = ( iFracX == 0 && iFracY == 0 ) ? piRefY + iOffset
+                                  : pcSubPelRef->getPicYuvSubPel( iFracX, iFracY )->getAddr( COMPONENT_Y ) + iPlaneOffset;
+      }
+    }
+  }
+
   //  Half-pel refinement
-  xExtDIFUpSamplingH ( &cPatternRoi, biPred );
+  if ( !pcSubPelRef )
+  {
+    xExtDIFUpSamplingH ( &cPatternRoi, biPred );
+  }
 
   rcMvHalf = *pcMvInt;   rcMvHalf <<= 1;    // for mv-cost
   TComMv baseRefMv(0, 0);
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf   );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 2, rcMvHalf, pcSubPelRef ? apiSubPel : NULL, iRefStride );
 
   m_pcRdCost->setCostScale( 0 );
 
-  xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf, biPred );
+  if ( !pcSubPelRef )
+  {
+    xExtDIFUpSamplingQ ( &cPatternRoi, rcMvHalf, biPred );
+  }
   baseRefMv = rcMvHalf;
   baseRefMv <<= 1;
 
   rcMvQter = *pcMvInt;   rcMvQter <<= 1;    // for mv-cost
   rcMvQter += rcMvHalf;  rcMvQter <<= 1;
-  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter );
+  ruiCost = xPatternRefinement( pcPatternKey, baseRefMv, 1, rcMvQter, pcSubPelRef ? apiSubPel : NULL, iRefStride );
 }
 
 
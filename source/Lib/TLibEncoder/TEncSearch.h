@@ -49,12 +49,14 @@
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TEncCfg.h"
+#include "TEncBlockHash.h"
 
 
 //! \ingroup TLibEncoder
 //! \{
 
 class TEncCu;
+class TEncPic;
 
 // ====================================================================================================================
 // Class definition
@@ -123,6 +125,12 @@ protected:
   // AMVP cost computation
   // UInt            m_auiMVPIdxCost[AMVP_MAX_NUM_CANDS+1][AMVP_MAX_NUM_CANDS];
   UInt            m_auiMVPIdxCost[AMVP_MAX_NUM_CANDS+1][AMVP_MAX_NUM_CANDS+1]; //th array bounds
+
+  // IntraBC hash search
+  const TEncBlockHash* m_pcIntraBCHash;                                             ///< reconstructed blocks of the CTU to the left of the current CTU, NULL if not used
+  TEncBlockHash        m_cIntraBCHashCurr;                                          ///< hashes the blocks overlapping the current CTU
+  std::vector<UInt>    m_auiIntraBCHashCurr[TEncBlockHash::NUM_BLOCK_SIZES];        ///< hashes of the reconstructed blocks overlapping the current CTU, by top-left position
+  Int                  m_aiIntraBCHashCurrBottom[TEncBlockHash::NUM_BLOCK_SIZES];   ///< row below the blocks in m_auiIntraBCHashCurr whose reconstruction has not changed since they were hashed
   
 public:
   TEncSearch();
@@ -138,13 +146,20 @@ public:
             TComRdCost*   pcRdCost,
             TEncSbac***   pppcRDSbacCoder,
             TEncSbac*     pcRDGoOnSbacCoder );
+
+  /// set the block hash table of the CTU to the left, which the IntraBC search of the next CTU looks up
+  Void setIntraBCHash           ( const TEncBlockHash* pcIntraBCHash );
+  /// the reconstruction of the current CTU has changed from row iPelY down; the next IntraBC search hashes these rows again
+  Void invalidateIntraBCHash    ( Int iPelY );
   
 protected:
   
   /// sub-function for motion vector refinement used in fractional-pel accuracy
   Distortion  xPatternRefinement( TComPattern* pcPatternKey,
                                   TComMv baseRefMv,
-                                  Int iFrac, TComMv& rcMvFrac );
+                                  Int iFrac, TComMv& rcMvFrac,
+                                  Pel* const apiSubPel[][LUMA_INTERPOLATION_FILTER_SUB_SAMPLE_POSITIONS] = NULL,
+                                  Int iSubPelStride = 0 );
   
   typedef struct
   {
@@ -258,6 +273,30 @@ public:
   }
 #endif
 
+  Void xIntraBCHashSearch       ( TComDataCU*  pcCU,
+                                  TComPattern* pcPatternKey,
+                                  Pel*         piRefY,
+                                  Int          iRefStride,
+                                  TComMv*      pcMvSrchRngLT,
+                                  TComMv*      pcMvSrchRngRB,
+                                  Int          iRoiWidth,
+                                  Int          iRoiHeight,
+                                  Distortion&  ruiSadBest,
+                                  Int&         riBestX,
+                                  Int&         riBestY );
+
+  Bool xIntraBCHashTestCandidate( TComDataCU*  pcCU,
+                                  TComPattern* pcPatternKey,
+                                  Pel*         piRefY,
+                                  Int          iRefStride,
+                                  Int          iMvX,
+                                  Int          iMvY,
+                                  Int          iRoiWidth,
+                                  Int          iRoiHeight,
+                                  Distortion&  ruiSadBest,
+                                  Int&         riBestX,
+                                  Int&         riBestY );
+
   Void xIntraPatternSearch      ( TComDataCU*  pcCU,
                                   TComPattern* pcPatternKey,
                                   Pel*         piRefY,
@@ -468,6 +507,16 @@ protected:
                                     Distortion&  ruiCost,
                                     Bool         bBi = false  );
 
+  Bool xHashMotionSearch         ( TComDataCU*  pcCU,
+                                    TComPattern* pcPatternKey,
+                                    UInt         uiPartAddr,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx,
+                                    Pel*         piRefY,
+                                    Int          iRefStride,
+                                    TComMv&      rcMv,
+                                    Distortion&  ruiDist );
+
   Void xTZSearch                  ( TComDataCU*  pcCU,
                                     TComPattern* pcPatternKey,
                                     Pel*         piRefY,
@@ -475,7 +524,8 @@ protected:
                                     TComMv*      pcMvSrchRngLT,
                                     TComMv*      pcMvSrchRngRB,
                                     TComMv&      rcMv,
-                                    Distortion&  ruiSAD );
+                                    Distortion&  ruiSAD,
+                                    const TComMv* pcMvPyramid = NULL );
 
   Void xSetSearchRange            ( TComDataCU*  pcCU,
                                     TComMv&      cMvPred,
@@ -490,7 +540,8 @@ protected:
                                     TComMv*      pcMvSrchRngLT,
                                     TComMv*      pcMvSrchRngRB,
                                     TComMv&      rcMv,
-                                    Distortion&  ruiSAD );
+                                    Distortion&  ruiSAD,
+                                    const TComMv* pcMvPyramid = NULL );
 
   Void xPatternSearch             ( TComPattern* pcPatternKey,
                                     Pel*         piRefY,
@@ -508,7 +559,8 @@ protected:
                                     TComMv&      rcMvHalf,
                                     TComMv&      rcMvQter,
                                     Distortion&  ruiCost,
-                                    Bool         biPred
+                                    Bool         biPred,
+                                    TEncPic*     pcSubPelRef = NULL
                                    );
   
   Void xExtDIFUpSamplingH( TComPattern* pcPattern, Bool biPred  );
@@ -58,6 +58,9 @@ TEncSlice::TEncSlice()
   m_pcBufferBinCoderCABACs  = NULL;
   m_pcBufferLowLatSbacCoders    = NULL;
   m_pcBufferLowLatBinCoderCABACs  = NULL;
+  m_pcWPPRowSbacCoders      = NULL;
+  m_pcWPPRowBinCoderCABACs  = NULL;
+  m_pcThreadPool            = NULL;
 }
 
 TEncSlice::~TEncSlice()
@@ -130,6 +133,23 @@ Void TEncSlice::destroy()
     delete[] m_pcBufferLowLatSbacCoders;
   if ( m_pcBufferLowLatBinCoderCABACs )
     delete[] m_pcBufferLowLatBinCoderCABACs;
+
+  for (std::vector<TEncWPPWorker*>::iterator i = m_apcWPPWorkers.begin(); i != m_apcWPPWorkers.end(); i++)
+  {
+    (*i)->destroy();
+    delete (*i);
+  }
+  m_apcWPPWorkers.clear();
+  for (std::vector<TEncBlockHash*>::iterator i = m_apcIntraBCHash.begin(); i != m_apcIntraBCHash.end(); i++)
+  {
+    (*i)->destroy();
+    delete (*i);
+  }
+  m_apcIntraBCHash.clear();
+  delete[] m_pcWPPRowSbacCoders;
+  delete[] m_pcWPPRowBinCoderCABACs;
+  m_pcWPPRowSbacCoders     = NULL;
+  m_pcWPPRowBinCoderCABACs = NULL;
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -157,6 +177,31 @@ Void TEncSlice::init( TEncTop* pcEncTop )
   m_pdRdPicQp         = (Double*)xMalloc( Double, m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_piRdPicQp         = (Int*   )xMalloc( Int,    m_pcCfg->getDeltaQpRD() * 2 + 1 );
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
+  m_pcThreadPool      = pcEncTop->getThreadPool();
+
+  // one set of CU coding tools per worker of the thread pool for wavefront-parallel CTU row compression
+  if ( m_pcThreadPool->getNumThreads() > 1 && m_pcCfg->getWaveFrontsynchro() && m_pcCfg->getUseSBACRD() )
+  {
+    for ( Int i = 0; i < m_pcThreadPool->getNumThreads(); i++ )
+    {
+      TEncWPPWorker* pcWorker = new TEncWPPWorker;
+      pcWorker->create( pcEncTop );
+      m_apcWPPWorkers.push_back( pcWorker );
+    }
+  }
+
+  // the IntraBC search range only extends into the CTU to the left, so one hash table per CTU row holds that CTU, and
+  // the rows compressed in parallel do not share a table; TEncSearch hashes the blocks overlapping the current CTU
+  if ( m_pcCfg->getUseIntraBlockCopy() && m_pcCfg->getUseIntraBlockCopyHashSearch() )
+  {
+    const Int iNumCTURows = ( m_pcCfg->getSourceHeight() + g_uiMaxCUHeight - 1 ) / g_uiMaxCUHeight;
+    for ( Int i = 0; i < iNumCTURows; i++ )
+    {
+      TEncBlockHash* pcHash = new TEncBlockHash;
+      pcHash->create( 12 );
+      m_apcIntraBCHash.push_back( pcHash );
+    }
+  }
 }
 
 
@@ -170,6 +215,7 @@ TEncSlice::setUpLambda(TComSlice* slice, const Double dLambda, Int iQP)
   // for RDO
   // in RdCost there is only one lambda because the luma and chroma bits are not separated, instead we weight the distortion of chroma.
   Double dLambdas[MAX_NUM_COMPONENT] = { dLambda };
+  Double distortionWeights[MAX_NUM_COMPONENT] = { 1.0 };
   for(UInt compIdx=1; compIdx<MAX_NUM_COMPONENT; compIdx++)
   {
     const ComponentID compID=ComponentID(compIdx);
@@ -177,9 +223,15 @@ TEncSlice::setUpLambda(TComSlice* slice, const Double dLambda, Int iQP)
     Int qpc=(iQP + chromaQPOffset < 0) ? iQP : getScaledChromaQP(iQP + chromaQPOffset, m_pcCfg->getChromaFormatIdc());
     Double tmpWeight = pow( 2.0, (iQP-qpc)/3.0 );  // takes into account of the chroma qp mapping and chroma qp Offset
     m_pcRdCost->setDistortionWeight(compID, tmpWeight);
+    distortionWeights[compIdx]=tmpWeight;
     dLambdas[compIdx]=dLambda/tmpWeight;
   }
 
+  for (std::vector<TEncWPPWorker*>::iterator i = m_apcWPPWorkers.begin(); i != m_apcWPPWorkers.end(); i++)
+  {
+    (*i)->setUpLambda( dLambda, dLambdas, distortionWeights );
+  }
+
 #if RDOQ_CHROMA_LAMBDA
 // for RDOQ
   m_pcTrQuant->setLambdas( dLambdas );
@@ -263,11 +315,20 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
   if (isField && depth>0) depth-=1;
 #endif
 
+  // nothing worth predicting from precedes a scene cut, so it is coded with an I slice, at the QP and the lambda of an
+  // intra picture (depth 0). It keeps the temporal layer, the NAL unit type and the RPS of its GOP position: it is not
+  // a random access point, and the pictures after it can still reference pictures before the cut.
+  const Bool bSceneCut = m_pcCfg->getUseLookaheadSceneCut() && dynamic_cast<TEncPic*>( pcPic )->getSceneCut();
+  if ( bSceneCut )
+  {
+    depth = 0;
+  }
+
   // slice type
   SliceType eSliceType;
 
   eSliceType=B_SLICE;
-  eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+  eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0 || bSceneCut) ? I_SLICE : eSliceType;
 
   rpcSlice->setSliceType    ( eSliceType );
 
@@ -386,7 +447,7 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
 
 #if HB_LAMBDA_FOR_LDC
   // restore original slice type
-  eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+  eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0 || bSceneCut) ? I_SLICE : eSliceType;
 
   rpcSlice->setSliceType        ( eSliceType );
 #endif
@@ -502,6 +563,10 @@ Void TEncSlice::setSearchRange( TComSlice* pcSlice )
       iRefPOC = pcSlice->getRefPic(e, iRefIdx)->getPOC();
       Int iNewSR = Clip3(8, iMaxSR, (iMaxSR*ADAPT_SR_SCALE*abs(iCurrPOC - iRefPOC)+iOffset)/iGOPSize);
       m_pcPredSearch->setAdaptiveSearchRange(iDir, iRefIdx, iNewSR);
+      for (std::vector<TEncWPPWorker*>::iterator i = m_apcWPPWorkers.begin(); i != m_apcWPPWorkers.end(); i++)
+      {
+        (*i)->getPredSearch()->setAdaptiveSearchRange(iDir, iRefIdx, iNewSR);
+      }
     }
   }
 }
@@ -732,6 +797,15 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
     for (UInt ui = 0; ui < uiTilesAcross; ui++)
       m_pcBufferLowLatSbacCoders[ui].load(m_pppcRDSbacCoder[0][CI_CURR_BEST]);  //init. state
   }
+
+  // compress the CTU rows on several threads, each one trailing the row above by two CTUs
+  if ( xUseWPPThreads( rpcPic, iNumSubstreams ) )
+  {
+    xCompressSliceWPP( rpcPic );
+    pcSlice->setNextSlice( true );
+    xRestoreWPparam( pcSlice );
+    return;
+  }
   UInt uiWidthInLCUs  = rpcPic->getPicSym()->getFrameWidthInCU();
   //UInt uiHeightInLCUs = rpcPic->getPicSym()->getFrameHeightInCU();
   UInt uiCol=0, uiLin=0, uiSubStrm=0;
@@ -851,6 +925,8 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
       m_pcEntropyCoder->updateContextTables ( sliceType, pcSlice->getSliceQp() );
       m_pcEntropyCoder->setEntropyCoder     ( m_pcSbacCoder, pcSlice );
     }
+    xSetIntraBCHash( rpcPic, uiCUAddr, m_pcPredSearch );
+
     // if RD based on SBAC is used
     if( m_pcCfg->getUseSBACRD() )
     {
@@ -984,6 +1060,8 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
       }
     }
 
+    xUpdateIntraBCHash( rpcPic, uiCUAddr );
+
     m_uiPicTotalBits += pcCU->getTotalBits();
     m_dPicRdCost     += pcCU->getTotalCost();
     m_uiPicDist      += pcCU->getTotalDistortion();
@@ -1003,6 +1081,202 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   xRestoreWPparam( pcSlice );
 }
 
+/** Check whether the CTU rows of the slice can be compressed in parallel: this needs the per-worker coding tools,
+ * a single slice and tile with one substream per CTU row, and no state that is carried from one CTU to the next
+ * in coding order (rate control, adaptive QP selection). Adaptive QP selection is also the only user of the
+ * reconstruction level buffer that all CTUs of a picture share (TComRomContext::pcGlbArlCoeff).
+ * \param pcPic           picture class
+ * \param iNumSubstreams  number of substreams of the slice
+ * \returns true if xCompressSliceWPP can be used
+ */
+Bool TEncSlice::xUseWPPThreads( TComPic* pcPic, Int iNumSubstreams )
+{
+  TComSlice* pcSlice = pcPic->getSlice(getSliceIdx());
+
+  return !m_apcWPPWorkers.empty()
+      && !m_pcCfg->getUseRateCtrl()
+#if ADAPTIVE_QP_SELECTION
+      && !m_pcCfg->getUseAdaptQpSelect()
+#endif
+      && m_pcCfg->getSliceMode() == NO_SLICES
+      && m_pcCfg->getSliceSegmentMode() == NO_SLICES
+      && !pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag()
+      && pcPic->getPicSym()->getNumTiles() == 1
+      && pcPic->getFrameHeightInCU() > 1
+      && iNumSubstreams == Int( pcPic->getFrameHeightInCU() );
+}
+
+/** Compress all CTUs of the picture on the thread pool, as a task graph with one task per CTU: a CTU waits for the
+ * CTU to its left and for the CTU above-right, whose contexts after the second CTU of a row are inherited by the row
+ * below. The result is identical to the one of the sequential loop in compressSlice.
+ * \param pcPic  picture class
+ */
+Void TEncSlice::xCompressSliceWPP( TComPic* pcPic )
+{
+  TComSlice* pcSlice      = pcPic->getSlice(getSliceIdx());
+  const UInt uiWidthInCU  = pcPic->getFrameWidthInCU();
+  const UInt uiHeightInCU = pcPic->getFrameHeightInCU();
+
+  delete[] m_pcWPPRowSbacCoders;
+  delete[] m_pcWPPRowBinCoderCABACs;
+  m_pcWPPRowSbacCoders     = new TEncSbac    [uiHeightInCU];
+  m_pcWPPRowBinCoderCABACs = new TEncBinCABAC[uiHeightInCU];
+  for (UInt ui = 0; ui < uiHeightInCU; ui++)
+  {
+    m_pcWPPRowSbacCoders[ui].init( &m_pcWPPRowBinCoderCABACs[ui] );
+  }
+
+  for (std::vector<TEncWPPWorker*>::iterator i = m_apcWPPWorkers.begin(); i != m_apcWPPWorkers.end(); i++)
+  {
+    (*i)->setUpScalingList( m_pcCfg->getUseScalingListId() != SCALING_LIST_OFF, pcSlice );
+  }
+
+  // the task index is the CTU address
+  TComTaskGraph cGraph;
+  for (UInt uiLin = 0; uiLin < uiHeightInCU; uiLin++)
+  {
+    for (UInt uiCol = 0; uiCol < uiWidthInCU; uiCol++)
+    {
+      const UInt uiCUAddr = uiLin * uiWidthInCU + uiCol;
+      cGraph.addTask( [=]( Int iWorkerIdx ) { xCompressCTUWPP( pcPic, uiCUAddr, m_apcWPPWorkers[iWorkerIdx] ); } );
+      if ( uiCol > 0 )
+      {
+        cGraph.addDependency( uiCUAddr, uiCUAddr - 1 );
+      }
+      if ( uiLin > 0 )
+      {
+        cGraph.addDependency( uiCUAddr, (uiLin - 1) * uiWidthInCU + min( uiCol + 1, uiWidthInCU - 1 ) );
+      }
+    }
+  }
+  m_pcThreadPool->run( cGraph );
+
+  // leave the encoder's own coders in the state the sequential loop ends in, as the SAO RDO picks them up
+  TEncTop*        pcEncTop      = (TEncTop*) m_pcCfg;
+  TComBitCounter* pcBitCounter  = &pcEncTop->getBitCounters()[uiHeightInCU-1];
+  m_pcEntropyCoder->setEntropyCoder ( m_pcRDGoOnSbacCoder, pcSlice );
+  m_pcEntropyCoder->setBitstream( pcBitCounter );
+  m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( pcEncTop->getRDSbacCoders()[uiHeightInCU-1][0][CI_CURR_BEST] );
+  m_pcEntropyCoder->setEntropyCoder ( m_pppcRDSbacCoder[0][CI_CURR_BEST], pcSlice );
+  m_pcEntropyCoder->setBitstream( pcBitCounter );
+  m_pcCuEncoder->setBitCounter( pcBitCounter );
+  m_pcBitCounter = pcBitCounter;
+
+  // accumulate in coding order, so that the totals do not depend on thread timing
+  for ( UInt uiCUAddr = 0; uiCUAddr < uiWidthInCU*uiHeightInCU; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    m_uiPicTotalBits += pcCU->getTotalBits();
+    m_dPicRdCost     += pcCU->getTotalCost();
+    m_uiPicDist      += pcCU->getTotalDistortion();
+  }
+}
+
+/** Task of xCompressSliceWPP: compress one CTU with the coding tools of the worker running the task. The state that
+ * is carried from one CTU to the next in a row is kept in the SBAC coder of the row's substream.
+ * \param pcPic     picture class
+ * \param uiCUAddr  CTU address
+ * \param pcWorker  coding tools of the worker
+ */
+Void TEncSlice::xCompressCTUWPP( TComPic* pcPic, UInt uiCUAddr, TEncWPPWorker* pcWorker )
+{
+  TComSlice*      pcSlice           = pcPic->getSlice(getSliceIdx());
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  const UInt      uiWidthInCU       = pcPic->getFrameWidthInCU();
+  const UInt      uiHeightInCU      = pcPic->getFrameHeightInCU();
+  const UInt      uiCol             = uiCUAddr % uiWidthInCU;
+  const UInt      uiLin             = uiCUAddr / uiWidthInCU;
+
+  TEncCu*         pcCuEncoder       = pcWorker->getCuEncoder();
+  TEncEntropy*    pcEntropyCoder    = pcWorker->getEntropyCoder();
+  TEncSbac*       pcRDSbacCoder     = pcWorker->getRDSbacCoder()[0][CI_CURR_BEST];
+  TEncSbac*       pcRDGoOnSbacCoder = pcWorker->getRDGoOnSbacCoder();
+  TEncBinCABAC*   pcRDBinCoder      = (TEncBinCABAC*) pcRDSbacCoder->getEncBinIf();
+
+  // one substream per CTU row
+  TEncSbac*       pcSubstreamSbacCoder = pcEncTop->getRDSbacCoders()[uiLin][0][CI_CURR_BEST];
+  TComBitCounter* pcBitCounter         = &pcEncTop->getBitCounters()[uiLin];
+
+  TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+  pcCU->initCU( pcPic, uiCUAddr );
+
+  // inherit the contexts after the second CTU of the row above, if it exists
+  if ( uiCol == 0 && uiLin > 0 && uiWidthInCU > 1 )
+  {
+    pcSubstreamSbacCoder->loadContexts( &m_pcWPPRowSbacCoders[uiLin-1] );
+  }
+  pcRDSbacCoder->load( pcSubstreamSbacCoder );
+
+  // set go-on entropy coder
+  pcEntropyCoder->setEntropyCoder ( pcRDGoOnSbacCoder, pcSlice );
+  pcEntropyCoder->setBitstream( pcBitCounter );
+  ((TEncBinCABAC*)pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+
+  // run CU encoder
+  xSetIntraBCHash( pcPic, uiCUAddr, pcWorker->getPredSearch() );
+  pcCuEncoder->compressCU( pcCU );
+  xUpdateIntraBCHash( pcPic, uiCUAddr );
+
+  // restore entropy coder to an initial stage
+  pcEntropyCoder->setEntropyCoder ( pcRDSbacCoder, pcSlice );
+  pcEntropyCoder->setBitstream( pcBitCounter );
+  pcCuEncoder->setBitCounter( pcBitCounter );
+  pcRDBinCoder->setBinCountingEnableFlag( true );
+  pcBitCounter->resetBits();
+  pcRDBinCoder->setBinsCoded( 0 );
+  pcCuEncoder->encodeCU( pcCU );
+  pcRDBinCoder->setBinCountingEnableFlag( false );
+
+  pcSubstreamSbacCoder->load( pcRDSbacCoder );
+
+  //Store probabilties of second LCU in line into buffer
+  if ( uiCol == 1 )
+  {
+    m_pcWPPRowSbacCoders[uiLin].loadContexts( pcSubstreamSbacCoder );
+  }
+
+  if ( uiCUAddr == uiWidthInCU * uiHeightInCU - 1 )
+  {
+    // the sequential loop leaves the go-on coder of the last CTU behind, and the SAO RDO starts from it
+    m_pcRDGoOnSbacCoder->load( pcRDGoOnSbacCoder );
+  }
+}
+
+/** Point the IntraBC hash search of pcSearch to the hash table of the CTU row, which holds the CTU to the left.
+ * \param pcPic     picture class
+ * \param uiCUAddr  address of the CTU that is compressed next
+ * \param pcSearch  encoder search class compressing the CTU
+ */
+Void TEncSlice::xSetIntraBCHash( TComPic* pcPic, UInt uiCUAddr, TEncSearch* pcSearch )
+{
+  pcSearch->setIntraBCHash( m_apcIntraBCHash.empty() ? NULL : m_apcIntraBCHash[uiCUAddr / pcPic->getFrameWidthInCU()] );
+}
+
+/** Replace the blocks in the hash table of the CTU row by the blocks of a CTU that has been compressed. The CTUs of a
+ * row are always compressed from left to right, also with tiles, so the table holds the CTU to the left of the next
+ * CTU of the row. The blocks are hashed from the reconstruction, which is final once the CTU has been compressed.
+ * \param pcPic     picture class
+ * \param uiCUAddr  address of the compressed CTU
+ */
+Void TEncSlice::xUpdateIntraBCHash( TComPic* pcPic, UInt uiCUAddr )
+{
+  if ( m_apcIntraBCHash.empty() )
+  {
+    return;
+  }
+
+  TEncBlockHash* pcHash      = m_apcIntraBCHash[uiCUAddr / pcPic->getFrameWidthInCU()];
+  TComPicYuv*    pcPicYuvRec = pcPic->getPicYuvRec();
+  TComDataCU*    pcCU        = pcPic->getCU( uiCUAddr );
+  const Int      iCUPelX     = pcCU->getCUPelX();
+  const Int      iCUPelY     = pcCU->getCUPelY();
+
+  pcHash->clear();
+  pcHash->addBlocks( pcPicYuvRec->getAddr( COMPONENT_Y ), pcPicYuvRec->getStride( COMPONENT_Y ), iCUPelX, iCUPelY,
+                     min<Int>( g_uiMaxCUWidth,  pcPicYuvRec->getWidth ( COMPONENT_Y ) - iCUPelX ),
+                     min<Int>( g_uiMaxCUHeight, pcPicYuvRec->getHeight( COMPONENT_Y ) - iCUPelY ) );
+}
+
 /**
  \param  rpcPic        picture class
  \retval rpcBitstream  bitstream class
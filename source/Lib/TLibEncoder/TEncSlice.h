@@ -43,10 +43,14 @@
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComThreadPool.h"
 #include "TEncCu.h"
+#include "TEncWPPWorker.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
 
+#include <vector>
+
 //! \ingroup TLibEncoder
 //! \{
 
@@ -103,6 +107,13 @@ private:
   UInt                    m_uiSliceIdx;
   std::vector<TEncSbac*> CTXMem;
 
+  // wavefront-parallel CTU row compression
+  TComThreadPool*         m_pcThreadPool;                       ///< thread pool of the encoder
+  std::vector<TEncWPPWorker*> m_apcWPPWorkers;                  ///< per-worker CU coding tools
+  TEncBinCABAC*           m_pcWPPRowBinCoderCABACs;             ///< per CTU row: bin coder CABAC
+  TEncSbac*               m_pcWPPRowSbacCoders;                 ///< per CTU row: contexts after the second CTU
+  std::vector<TEncBlockHash*> m_apcIntraBCHash;                 ///< per CTU row: blocks of the last coded CTU, for the IntraBC hash search
+
   Void     setUpLambda(TComSlice* slice, const Double dLambda, Int iQP);
 
 public:
@@ -136,6 +147,13 @@ public:
 
 private:
   Double  xGetQPValueAccordingToLambda ( Double lambda );
+
+  Bool    xUseWPPThreads      ( TComPic* pcPic, Int iNumSubstreams );
+  Void    xCompressSliceWPP   ( TComPic* pcPic );
+  Void    xCompressCTUWPP     ( TComPic* pcPic, UInt uiCUAddr, TEncWPPWorker* pcWorker );
+
+  Void    xSetIntraBCHash     ( TComPic* pcPic, UInt uiCUAddr, TEncSearch* pcSearch );
+  Void    xUpdateIntraBCHash  ( TComPic* pcPic, UInt uiCUAddr );
 };
 
 //! \}
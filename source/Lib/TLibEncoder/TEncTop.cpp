@@ -57,6 +57,7 @@ TEncTop::TEncTop()
   m_pppcBinCoderCABAC =  NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
 #if ENC_DEC_TRACE
+  TComRomScope cRomScope( &m_cRomContext );
   if (g_hTrace == NULL)
   {
     g_hTrace = fopen( "TraceEnc_RExt.txt", "wb" );
@@ -71,6 +72,7 @@ TEncTop::TEncTop()
   ContextModel::buildNextStateTable();
 #endif
 
+  m_iNumSubstreams         = 0;
   m_pcSbacCoders           = NULL;
   m_pcBinCoderCABACs       = NULL;
   m_ppppcRDSbacCoders      = NULL;
@@ -84,6 +86,7 @@ TEncTop::TEncTop()
 TEncTop::~TEncTop()
 {
 #if ENC_DEC_TRACE
+  TComRomScope cRomScope( &m_cRomContext );
   if (g_hTrace != stdout)
   {
     fclose( g_hTrace );
@@ -91,11 +94,19 @@ TEncTop::~TEncTop()
 #endif
 }
 
+/** The CTU geometry and bit depths are taken from the context bound to the calling thread, where the application has
+ *  set them up. The encoder works on its own copy from here on.
+ */
 Void TEncTop::create ()
 {
+  m_cRomContext.copyConfiguration( *g_pcRomContext );
+  TComRomScope cRomScope( &m_cRomContext );
+
   // initialize global variables
   initROM();
 
+  m_cThreadPool.create( getNumThreads() );
+
   // create processing unit classes
   m_cGOPEncoder.        create( );
   m_cSliceEncoder.      create( getSourceWidth(), getSourceHeight(), m_chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
@@ -109,6 +120,7 @@ Void TEncTop::create ()
 #else
     m_cEncSAO.createEncData();
 #endif
+    m_cEncSAO.setThreadPool( &m_cThreadPool );
 #else
     m_cEncSAO.setSaoLcuBoundary(getSaoLcuBoundary());
     m_cEncSAO.setSaoLcuBasedOptimization(getSaoLcuBasedOptimization());
@@ -217,6 +229,11 @@ Void TEncTop::createWPPCoders(Int iNumSubstreams)
 
 Void TEncTop::destroy ()
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
+  m_cLookahead.destroy();
+  m_cThreadPool.destroy();
+
   // destroy processing unit classes
   m_cGOPEncoder.        destroy();
   m_cSliceEncoder.      destroy();
@@ -292,6 +309,8 @@ Void TEncTop::destroy ()
 
 Void TEncTop::init(Bool isFieldCoding)
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   // initialize SPS
   xInitSPS();
 
@@ -314,6 +333,7 @@ Void TEncTop::init(Bool isFieldCoding)
   m_cGOPEncoder.  init( this );
   m_cSliceEncoder.init( this );
   m_cCuEncoder.   init( this );
+  m_cLookahead.   init( this );
 
   // initialize transform & quantization class
   m_pcCavlcCoder = getCavlcCoder();
@@ -332,6 +352,17 @@ Void TEncTop::init(Bool isFieldCoding)
   m_cSearch.init( this, &m_cTrQuant, m_iSearchRange, m_bipredSearchRange, m_iFastSearch, 0, &m_cEntropyCoder, &m_cRdCost, getRDSbacCoder(), getRDGoOnSbacCoder() );
 
   m_iMaxRefPicNum = 0;
+
+  // allocate the picture buffers up front: the DPB of the SPS plus the pictures of a GOP received ahead of coding
+  Int iNumPicBuffers = m_iGOPSize + m_cSPS.getMaxDecPicBuffering(MAX_TLAYER-1) + 2;
+  if ( getFramesToBeEncoded() > 0 )
+  {
+    iNumPicBuffers = min( iNumPicBuffers, getFramesToBeEncoded() );
+  }
+  while ( Int( m_cPicPool.getNumPics() ) < iNumPicBuffers )
+  {
+    m_cPicPool.addPic( xCreatePicBuffer() );
+  }
 }
 
 // ====================================================================================================================
@@ -340,17 +371,10 @@ Void TEncTop::init(Bool isFieldCoding)
 
 Void TEncTop::deletePicBuffer()
 {
-  TComList<TComPic*>::iterator iterPic = m_cListPic.begin();
-  Int iSize = Int( m_cListPic.size() );
-
-  for ( Int i = 0; i < iSize; i++ )
-  {
-    TComPic* pcPic = *(iterPic++);
+  TComRomScope cRomScope( &m_cRomContext );
 
-    pcPic->destroy();
-    delete pcPic;
-    pcPic = NULL;
-  }
+  m_cPicPool.destroy();
+  m_cListPic.clear();
 }
 
 /**
@@ -366,6 +390,8 @@ Void TEncTop::deletePicBuffer()
  */
 Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTrueOrg, const InputColourSpaceConversion snrCSC, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded )
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   if (pcPicYuvOrg != NULL)
   {
     // get original YUV
@@ -376,12 +402,44 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
     pcPicYuvTrueOrg->copyToPic( pcPicCurr->getPicYuvTrueOrg() );
 
     // compute image characteristics
-    if ( getUseAdaptiveQP() )
+    if ( getUseLookahead() )
     {
-      m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
+      m_cLookahead.push( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
+    else
+    {
+      if ( getUseAdaptiveQP() )
+      {
+        m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
+      }
+      if ( getUsePyramidME() )
+      {
+        m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcPicCurr ) );
+      }
     }
   }
 
+  if ( m_cGOPEncoder.getPictureOutput() )
+  {
+    // the GOP does not reorder pictures: code the received picture right away
+    if ( pcPicYuvOrg == NULL )
+    {
+      iNumEncoded = 0;
+      return;
+    }
+
+    m_cLookahead.wait();
+    m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false, snrCSC);
+
+    iNumEncoded = 1;
+    m_uiNumAllPicCoded++;
+    if ( m_iPOCLast == 0 || m_iNumPicRcvd == m_iGOPSize )
+    {
+      m_iNumPicRcvd = 0;
+    }
+    return;
+  }
+
   if ((m_iNumPicRcvd == 0) || (!flush && (m_iPOCLast != 0) && (m_iNumPicRcvd != m_iGOPSize) && (m_iGOPSize != 0)))
   {
     iNumEncoded = 0;
@@ -393,7 +451,8 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
     m_cRateCtrl.initRCGOP( m_iNumPicRcvd );
   }
 
-  // compress GOP
+  // compress GOP, once the lookahead has analysed its pictures
+  m_cLookahead.wait();
   m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false, snrCSC);
 
   if ( m_RCEnableRateControl )
@@ -430,6 +489,8 @@ void separateFields(Pel* org, Pel* dstField, UInt stride, UInt width, UInt heigh
 
 Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTrueOrg, const InputColourSpaceConversion snrCSC, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded, bool isTff)
 {
+  TComRomScope cRomScope( &m_cRomContext );
+
   iNumEncoded = 0;
 
   for (int fieldNum=0; fieldNum<2; fieldNum++)
@@ -490,15 +551,27 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTr
       }
 
       // compute image characteristics
-      if ( getUseAdaptiveQP() )
+      if ( getUseLookahead() )
       {
-        m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcField ) );
+        m_cLookahead.push( dynamic_cast<TEncPic*>( pcField ) );
+      }
+      else
+      {
+        if ( getUseAdaptiveQP() )
+        {
+          m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcField ) );
+        }
+        if ( getUsePyramidME() )
+        {
+          m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcField ) );
+        }
       }
     }
     
     if ( m_iNumPicRcvd && ((flush&&fieldNum==1) || (m_iPOCLast/2)==0 || m_iNumPicRcvd==m_iGOPSize ) )
     {
-      // compress GOP
+      // compress GOP, once the lookahead has analysed its pictures
+      m_cLookahead.wait();
       m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, true, isTff, snrCSC);
 
       iNumEncoded += m_iNumPicRcvd;
@@ -521,54 +594,60 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTr
  */
 Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
 {
-  TComSlice::sortPicList(m_cListPic);
-
-  if (m_cListPic.size() >= (UInt)(m_iGOPSize + getMaxDecPicBuffering(MAX_TLAYER-1) + 2) )
+  // pictures return to the pool in TEncGOP::compressGOP once they are no longer referenced; as the POCs increase,
+  // m_cListPic stays sorted
+  rpcPic = m_cPicPool.acquire( m_iPOCLast + 1 );
+  if ( rpcPic == NULL )
   {
-    TComList<TComPic*>::iterator iterPic  = m_cListPic.begin();
-    Int iSize = Int( m_cListPic.size() );
-    for ( Int i = 0; i < iSize; i++ )
-    {
-      rpcPic = *(iterPic++);
-      if(rpcPic->getSlice(0)->isReferenced() == false)
-      {
-        break;
-      }
-    }
+    m_cPicPool.addPic( xCreatePicBuffer() );
+    rpcPic = m_cPicPool.acquire( m_iPOCLast + 1 );
   }
-  else
+  m_cListPic.pushBack( rpcPic );
+  rpcPic->setReconMark (false);
+  if ( getUseHashME() || getUseSubPelCache() )
   {
-    if ( getUseAdaptiveQP() )
-    {
-      TEncPic* pcEPic = new TEncPic;
-      pcEPic->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, m_cPPS.getMaxCuDQPDepth()+1, m_conformanceWindow, m_defaultDisplayWindow, m_numReorderPics);
-      rpcPic = pcEPic;
-    }
-    else
-    {
-      rpcPic = new TComPic;
-      rpcPic->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, m_conformanceWindow, m_defaultDisplayWindow, m_numReorderPics, false );
-    }
-
-#if !HM_CLEANUP_SAO
-    if (getUseSAO())
-    {
-      rpcPic->getPicSym()->allocSaoParam(&m_cEncSAO);
-    }
-#endif
-
-    m_cListPic.pushBack( rpcPic );
+    // the original picture is replaced, the reconstruction will be
+    TEncPic* pcEPic = dynamic_cast<TEncPic*>( rpcPic );
+    pcEPic->invalidateBlockHash();
+    pcEPic->invalidateSubPelPlanes();
   }
-  rpcPic->setReconMark (false);
 
   m_iPOCLast++;
   m_iNumPicRcvd++;
+  m_cGOPEncoder.setPictureReceived( m_iPOCLast );
 
   rpcPic->getSlice(0)->setPOC( m_iPOCLast );
   // mark it should be extended
   rpcPic->getPicYuvRec()->setBorderExtension(false);
 }
 
+/** allocate a picture buffer
+ */
+TComPic* TEncTop::xCreatePicBuffer()
+{
+  TComPic* pcPic;
+  if ( getUseAdaptiveQP() || getUseHashME() || getUseSubPelCache() || getUsePyramidME() || getUseLookahead() )
+  {
+    TEncPic* pcEPic = new TEncPic;
+    pcEPic->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, getUseAdaptiveQP() ? m_cPPS.getMaxCuDQPDepth()+1 : 0, m_conformanceWindow, m_defaultDisplayWindow, m_numReorderPics);
+    pcPic = pcEPic;
+  }
+  else
+  {
+    pcPic = new TComPic;
+    pcPic->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth, m_conformanceWindow, m_defaultDisplayWindow, m_numReorderPics, false );
+  }
+
+#if !HM_CLEANUP_SAO
+  if (getUseSAO())
+  {
+    pcPic->getPicSym()->allocSaoParam(&m_cEncSAO);
+  }
+#endif
+
+  return pcPic;
+}
+
 Void TEncTop::xInitSPS()
 {
   ProfileTierLevel& profileTierLevel = *m_cSPS.getPTL()->getGeneralPTL();
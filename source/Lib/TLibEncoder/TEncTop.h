@@ -43,6 +43,8 @@
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/AccessUnit.h"
+#include "TLibCommon/TComThreadPool.h"
+#include "TLibCommon/TComPicPool.h"
 
 #include "TLibVideoIO/TVideoIOYuv.h"
 
@@ -55,6 +57,7 @@
 #include "TEncSearch.h"
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
+#include "TEncLookahead.h"
 #include "TEncRateCtrl.h"
 //! \ingroup TLibEncoder
 //! \{
@@ -67,11 +70,14 @@
 class TEncTop : public TEncCfg
 {
 private:
+  TComRomContext          m_cRomContext;                  ///< CTU geometry, bit depths and derived tables, bound by the entry points
+
   // picture
   Int                     m_iPOCLast;                     ///< time index (POC)
   Int                     m_iNumPicRcvd;                  ///< number of received pictures
   UInt                    m_uiNumAllPicCoded;             ///< number of coded pictures
   TComList<TComPic*>      m_cListPic;                     ///< dynamic list of pictures
+  TComPicPool             m_cPicPool;                     ///< picture buffers; m_cListPic holds the acquired ones
   
   // encoder search
   TEncSearch              m_cSearch;                      ///< encoder search class
@@ -92,6 +98,7 @@ private:
   TEncGOP                 m_cGOPEncoder;                  ///< GOP encoder
   TEncSlice               m_cSliceEncoder;                ///< slice encoder
   TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TComThreadPool          m_cThreadPool;                  ///< workers shared by the processing units
   // SPS
   TComSPS                 m_cSPS;                         ///< SPS
   TComPPS                 m_cPPS;                         ///< PPS
@@ -116,13 +123,15 @@ private:
   TEncBinCABAC*           m_pcRDGoOnBinCodersCABAC;        ///< going on bin coder CABAC for RD stage per substream
 
   // quality control
-  TEncPreanalyzer         m_cPreanalyzer;                 ///< image characteristics analyzer for TM5-step3-like adaptive QP
+  TEncPreanalyzer         m_cPreanalyzer;                 ///< image characteristics analyzer for TM5-step3-like adaptive QP and the pyramid motion search
+  TEncLookahead           m_cLookahead;                   ///< runs the analysis of the received pictures on a separate thread
 
   TComScalingList         m_scalingList;                 ///< quantization matrix information
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
   
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic );           ///< get picture buffer which will be processed
+  TComPic* xCreatePicBuffer ();                           ///< allocate a picture buffer
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
   Void  xInitPPS          ();                             ///< initialize PPS from encoder options
   
@@ -145,6 +154,7 @@ public:
   // -------------------------------------------------------------------------------------------------------------------
   
   TComList<TComPic*>*     getListPic            () { return  &m_cListPic;             }
+  TComPicPool*            getPicPool            () { return  &m_cPicPool;             }
   TEncSearch*             getPredSearch         () { return  &m_cSearch;              }
   
   TComTrQuant*            getTrQuant            () { return  &m_cTrQuant;             }
@@ -169,11 +179,14 @@ public:
   TEncSbac****            getRDSbacCoders       () { return  m_ppppcRDSbacCoders;     }
   TEncSbac*               getRDGoOnSbacCoders   () { return  m_pcRDGoOnSbacCoders;   }
   TEncRateCtrl*           getRateCtrl           () { return &m_cRateCtrl;             }
+  TComThreadPool*         getThreadPool         () { return &m_cThreadPool;           }
+  TEncPreanalyzer*        getPreanalyzer        () { return &m_cPreanalyzer;          }
   TComSPS*                getSPS                () { return  &m_cSPS;                 }
   TComPPS*                getPPS                () { return  &m_cPPS;                 }
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(TComSlice* slice, Int POCCurr, Int GOPid );
   TComScalingList*        getScalingList        () { return  &m_scalingList;         }
+  UInt                    getNumAllPicCoded     () const { return m_uiNumAllPicCoded; }
   // -------------------------------------------------------------------------------------------------------------------
   // encoder function
   // -------------------------------------------------------------------------------------------------------------------
@@ -191,7 +204,15 @@ public:
                TComList<TComPicYuv*>& rcListPicYuvRecOut,
                std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded, bool isTff);
   
-  Void printSummary(bool isField) { m_cGOPEncoder.printOutSummary (m_uiNumAllPicCoded, isField, m_printMSEBasedSequencePSNR); }
+  Void printSummary(bool isField) { TComRomScope cRomScope( &m_cRomContext ); m_cGOPEncoder.printOutSummary (m_uiNumAllPicCoded, isField, m_printMSEBasedSequencePSNR); }
+
+  /// low-latency output: the NAL units are passed to the callback as soon as they are coded, instead of (also) being
+  /// returned with the access units from encode()
+  Void setNalUnitCallback   ( const NalUnitCallback& rcCallback )    { m_cGOPEncoder.setNalUnitCallback( rcCallback );    }
+  Void setAccessUnitCallback( const AccessUnitCallback& rcCallback ) { m_cGOPEncoder.setAccessUnitCallback( rcCallback ); }
+
+  /// include the pictures coded by another instance in the summary, as if they had been coded after the ones of this one
+  Void addSummary(const TEncTop& rcEncTop) { m_cGOPEncoder.addSummary(rcEncTop.m_cGOPEncoder); m_uiNumAllPicCoded += rcEncTop.m_uiNumAllPicCoded; }
   
 };
 
@@ -0,0 +1,181 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncWPPWorker.cpp
+    \brief    per-thread CU coding tools for wavefront-parallel CTU row compression
+*/
+
+#include "TEncWPPWorker.h"
+#include "TEncTop.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncWPPWorker::TEncWPPWorker()
+: m_pppcRDSbacCoder   ( NULL )
+, m_pppcBinCoderCABAC ( NULL )
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+}
+
+TEncWPPWorker::~TEncWPPWorker()
+{
+}
+
+/** Allocate and initialise the coding tools in the same way as TEncTop does for its own set.
+ * \param pcEncTop encoder class
+ */
+Void TEncWPPWorker::create( TEncTop* pcEncTop )
+{
+  const ChromaFormat chromaFormat = pcEncTop->getChromaFormatIdc();
+
+  m_cCuEncoder.create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight, chromaFormat );
+
+  m_pppcRDSbacCoder = new TEncSbac** [g_uiMaxCUDepth+1];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [g_uiMaxCUDepth+1];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+#endif
+
+  for ( UInt iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder[iDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+    {
+      m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
+    }
+  }
+
+#if RExt__LOSSLESS_AND_MIXED_LOSSLESS_RD_COST_EVALUATION
+  m_cRdCost.setCostMode( pcEncTop->getCostMode() );
+#endif
+
+  m_cTrQuant.init( 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+                   pcEncTop->getUseRDOQ(),
+                   pcEncTop->getUseRDOQTS(),
+                   true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  ,pcEncTop->getUseAdaptQpSelect()
+#endif
+                  );
+
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), 0,
+                  &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cRdCost, &m_cEntropyCoder, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+}
+
+Void TEncWPPWorker::destroy()
+{
+  m_cCuEncoder.destroy();
+
+  if ( m_pppcRDSbacCoder )
+  {
+    for ( UInt iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+    {
+      for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+      {
+        delete m_pppcRDSbacCoder[iDepth][iCIIdx];
+        delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+      }
+      delete [] m_pppcRDSbacCoder[iDepth];
+      delete [] m_pppcBinCoderCABAC[iDepth];
+    }
+    delete [] m_pppcRDSbacCoder;
+    delete [] m_pppcBinCoderCABAC;
+    m_pppcRDSbacCoder   = NULL;
+    m_pppcBinCoderCABAC = NULL;
+  }
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** \param dLambda            lambda used for RD decisions
+ * \param dLambdas           per-component lambdas used by RDOQ
+ * \param distortionWeights  per-component distortion weights (only chroma values are used)
+ */
+Void TEncWPPWorker::setUpLambda( const Double dLambda, const Double dLambdas[MAX_NUM_COMPONENT], const Double distortionWeights[MAX_NUM_COMPONENT] )
+{
+  m_cRdCost.setLambda( dLambda );
+  for (UInt compIdx = 1; compIdx < MAX_NUM_COMPONENT; compIdx++)
+  {
+    m_cRdCost.setDistortionWeight( ComponentID(compIdx), distortionWeights[compIdx] );
+  }
+
+#if RDOQ_CHROMA_LAMBDA
+  m_cTrQuant.setLambdas( dLambdas );
+#else
+  m_cTrQuant.setLambda( dLambda );
+#endif
+}
+
+/** \param bUseScalingList  true if scaling lists are enabled
+ * \param pcSlice          slice carrying the scaling list
+ */
+Void TEncWPPWorker::setUpScalingList( Bool bUseScalingList, TComSlice* pcSlice )
+{
+  const ChromaFormat chromaFormat = pcSlice->getSPS()->getChromaFormatIdc();
+
+  if ( bUseScalingList )
+  {
+    m_cTrQuant.setScalingList( pcSlice->getScalingList(), chromaFormat );
+    m_cTrQuant.setUseScalingList( true );
+  }
+  else
+  {
+    m_cTrQuant.setFlatScalingList( chromaFormat );
+    m_cTrQuant.setUseScalingList( false );
+  }
+}
+
+//! \}
@@ -0,0 +1,100 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncWPPWorker.h
+    \brief    per-thread CU coding tools for wavefront-parallel CTU row compression (header)
+*/
+
+#ifndef __TENCWPPWORKER__
+#define __TENCWPPWORKER__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TEncCu.h"
+#include "TEncSearch.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+#include "TEncBinCoderCABACCounter.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+class TEncTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CU-level coding tools, so that one thread can compress a CTU row while others work on the rows below
+class TEncWPPWorker
+{
+private:
+  TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TEncSearch              m_cSearch;                      ///< encoder search class
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization
+  TComRdCost              m_cRdCost;                      ///< RD cost computation
+  TEncEntropy             m_cEntropyCoder;                ///< entropy encoder
+
+  TEncSbac***             m_pppcRDSbacCoder;              ///< temporal storage for RD computation
+  TEncSbac                m_cRDGoOnSbacCoder;             ///< going on SBAC model for RD stage
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#endif
+
+public:
+  TEncWPPWorker();
+  virtual ~TEncWPPWorker();
+
+  Void      create              ( TEncTop* pcEncTop );
+  Void      destroy             ();
+
+  /// copy lambdas and chroma distortion weights of the slice encoder
+  Void      setUpLambda         ( const Double dLambda, const Double dLambdas[MAX_NUM_COMPONENT], const Double distortionWeights[MAX_NUM_COMPONENT] );
+  /// set up the quantization matrices in the same way as TEncGOP does for the encoder's transform & quantization class
+  Void      setUpScalingList    ( Bool bUseScalingList, TComSlice* pcSlice );
+
+  TEncCu*         getCuEncoder        () { return &m_cCuEncoder;       }
+  TEncSearch*     getPredSearch       () { return &m_cSearch;          }
+  TEncEntropy*    getEntropyCoder     () { return &m_cEntropyCoder;    }
+  TEncSbac***     getRDSbacCoder      () { return m_pppcRDSbacCoder;   }
+  TEncSbac*       getRDGoOnSbacCoder  () { return &m_cRDGoOnSbacCoder; }
+};
+
+//! \}
+
+#endif // __TENCWPPWORKER__
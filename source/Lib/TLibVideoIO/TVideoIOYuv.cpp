@@ -42,12 +42,279 @@
 #include <fstream>
 #include <iostream>
 #include <memory.h>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #include "TLibCommon/TComRom.h"
 #include "TVideoIOYuv.h"
 
 using namespace std;
 
+// ====================================================================================================================
+// Asynchronous file access
+// ====================================================================================================================
+
+/**
+ * Bounded ring of frames in file sample format, filled from the file by an
+ * I/O thread (reader) or drained to the file by an I/O thread (writer), so
+ * that file access overlaps with coding.  The file handle is only touched by
+ * the I/O thread while the queue exists.
+ */
+class TVideoIOYuvQueue
+{
+public:
+  TVideoIOYuvQueue( fstream& rcHandle, Bool bWriteMode, UInt depth, size_t frameSize );
+  ~TVideoIOYuvQueue();
+
+  Bool pop      ( std::vector<UChar>& rFrame );   ///< reader: take the next frame, false at end of file
+  Void push     ( std::vector<UChar>& rFrame );   ///< writer: queue rFrame for writing, rFrame receives a spare buffer
+  Bool hasFailed();                               ///< writer: a write failed
+
+private:
+  Void xReadLoop  ();
+  Void xWriteLoop ();
+
+  fstream&                        m_rcHandle;
+  const UInt                      m_depth;
+  const size_t                    m_frameSize;
+  std::deque< std::vector<UChar> > m_frames;      ///< read frames not yet taken, or frames not yet written
+  std::vector< std::vector<UChar> > m_spare;      ///< buffers available for reuse
+  Bool                            m_bStop;
+  Bool                            m_bEnd;         ///< reader: the last frame has been queued
+  Bool                            m_bFailed;
+  std::mutex                      m_cMutex;
+  std::condition_variable         m_cNotFull;
+  std::condition_variable         m_cNotEmpty;
+  std::thread                     m_cThread;
+};
+
+TVideoIOYuvQueue::TVideoIOYuvQueue( fstream& rcHandle, Bool bWriteMode, UInt depth, size_t frameSize )
+: m_rcHandle ( rcHandle )
+, m_depth    ( std::max<UInt>( depth, 1 ) )
+, m_frameSize( frameSize )
+, m_bStop    ( false )
+, m_bEnd     ( false )
+, m_bFailed  ( false )
+{
+  m_cThread = std::thread( bWriteMode ? &TVideoIOYuvQueue::xWriteLoop : &TVideoIOYuvQueue::xReadLoop, this );
+}
+
+TVideoIOYuvQueue::~TVideoIOYuvQueue()
+{
+  {
+    std::lock_guard<std::mutex> cLock( m_cMutex );
+    m_bStop = true;
+  }
+  m_cNotFull.notify_all();
+  m_cNotEmpty.notify_all();
+  m_cThread.join();
+}
+
+Void TVideoIOYuvQueue::xReadLoop()
+{
+  for (;;)
+  {
+    std::vector<UChar> frame;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      m_cNotFull.wait( cLock, [this]() { return m_bStop || m_frames.size() < m_depth; } );
+      if ( m_bStop )
+      {
+        return;
+      }
+      if ( !m_spare.empty() )
+      {
+        frame.swap( m_spare.back() );
+        m_spare.pop_back();
+      }
+    }
+
+    frame.resize( m_frameSize );
+    m_rcHandle.read( reinterpret_cast<Char*>( &frame[0] ), m_frameSize );
+    frame.resize( size_t( m_rcHandle.gcount() ) );
+    const Bool bEnd = frame.size() < m_frameSize;
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_frames.push_back( std::move( frame ) );
+      m_bEnd = bEnd;
+    }
+    m_cNotEmpty.notify_one();
+
+    if ( bEnd )
+    {
+      return;
+    }
+  }
+}
+
+Bool TVideoIOYuvQueue::pop( std::vector<UChar>& rFrame )
+{
+  {
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    m_cNotEmpty.wait( cLock, [this]() { return m_bEnd || !m_frames.empty(); } );
+    if ( m_frames.empty() )
+    {
+      rFrame.clear();
+      return false;
+    }
+    m_spare.push_back( std::move( rFrame ) );
+    rFrame.swap( m_frames.front() );
+    m_frames.pop_front();
+  }
+  m_cNotFull.notify_one();
+  return true;
+}
+
+Void TVideoIOYuvQueue::xWriteLoop()
+{
+  for (;;)
+  {
+    std::vector<UChar> frame;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      m_cNotEmpty.wait( cLock, [this]() { return m_bStop || !m_frames.empty(); } );
+      if ( m_frames.empty() )
+      {
+        return; // stopped, and everything queued has been written
+      }
+      frame.swap( m_frames.front() );
+      m_frames.pop_front();
+    }
+
+    if ( !frame.empty() )
+    {
+      m_rcHandle.write( reinterpret_cast<const Char*>( &frame[0] ), frame.size() );
+    }
+    const Bool bFailed = m_rcHandle.fail();
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_bFailed = m_bFailed || bFailed;
+      m_spare.push_back( std::move( frame ) );
+    }
+    m_cNotFull.notify_one();
+  }
+}
+
+Void TVideoIOYuvQueue::push( std::vector<UChar>& rFrame )
+{
+  {
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    m_cNotFull.wait( cLock, [this]() { return m_frames.size() < m_depth; } );
+    m_frames.push_back( std::move( rFrame ) );
+    rFrame.clear();
+    if ( !m_spare.empty() )
+    {
+      rFrame.swap( m_spare.back() );
+      m_spare.pop_back();
+    }
+  }
+  m_cNotEmpty.notify_one();
+}
+
+Bool TVideoIOYuvQueue::hasFailed()
+{
+  std::lock_guard<std::mutex> cLock( m_cMutex );
+  return m_bFailed;
+}
+
+// ====================================================================================================================
+// Sample conversion kernels
+// ====================================================================================================================
+
+// Index of a file sample for picture sample x (unpack), or of a picture sample for file sample x (pack).
+template<Int resample> static inline UInt xResampleIndex( UInt x )
+{
+  return resample == YUV_ROW_DECIMATE ? x << 1 : ( resample == YUV_ROW_REPLICATE ? x >> 1 : x );
+}
+
+template<Int resample> static Void xUnpackRow8( Pel* dst, const UChar* src, UInt width )
+{
+  for (UInt x = 0; x < width; x++)
+    dst[x] = src[xResampleIndex<resample>(x)];
+}
+
+template<Int resample> static Void xUnpackRow16( Pel* dst, const UChar* src, UInt width )
+{
+  for (UInt x = 0; x < width; x++)
+  {
+    const UInt i = xResampleIndex<resample>(x);
+    dst[x] = Pel(src[i*2+0]) | (Pel(src[i*2+1])<<8);
+  }
+}
+
+template<Int resample> static Void xPackRow8( UChar* dst, const Pel* src, UInt width )
+{
+  for (UInt x = 0; x < width; x++)
+    dst[x] = (UChar)(src[xResampleIndex<resample>(x)]);
+}
+
+template<Int resample> static Void xPackRow16( UChar* dst, const Pel* src, UInt width )
+{
+  for (UInt x = 0; x < width; x++)
+  {
+    const Pel val = src[xResampleIndex<resample>(x)];
+    dst[2*x  ] = (val>>0) & 0xff;
+    dst[2*x+1] = (val>>8) & 0xff;
+  }
+}
+
+static Void xScaleRowUp( Pel* img, UInt width, Int shift, Pel, Pel )
+{
+  for (UInt x = 0; x < width; x++)
+    img[x] <<= shift;
+}
+
+static Void xScaleRowDown( Pel* img, UInt width, Int shift, Pel minval, Pel maxval )
+{
+  const Pel rounding = 1 << (shift-1);
+  for (UInt x = 0; x < width; x++)
+    img[x] = Clip3(minval, maxval, Pel((img[x] + rounding) >> shift));
+}
+
+/**
+ * Select the plain C kernels, then replace them with the SIMD kernels supported by eExt.
+ */
+Void TVideoIOYuvKernels::init( SIMDExtension eExt )
+{
+  unpackRow[0][YUV_ROW_COPY     ] = xUnpackRow8 <YUV_ROW_COPY     >;
+  unpackRow[0][YUV_ROW_DECIMATE ] = xUnpackRow8 <YUV_ROW_DECIMATE >;
+  unpackRow[0][YUV_ROW_REPLICATE] = xUnpackRow8 <YUV_ROW_REPLICATE>;
+  unpackRow[1][YUV_ROW_COPY     ] = xUnpackRow16<YUV_ROW_COPY     >;
+  unpackRow[1][YUV_ROW_DECIMATE ] = xUnpackRow16<YUV_ROW_DECIMATE >;
+  unpackRow[1][YUV_ROW_REPLICATE] = xUnpackRow16<YUV_ROW_REPLICATE>;
+
+  packRow  [0][YUV_ROW_COPY     ] = xPackRow8   <YUV_ROW_COPY     >;
+  packRow  [0][YUV_ROW_DECIMATE ] = xPackRow8   <YUV_ROW_DECIMATE >;
+  packRow  [0][YUV_ROW_REPLICATE] = xPackRow8   <YUV_ROW_REPLICATE>;
+  packRow  [1][YUV_ROW_COPY     ] = xPackRow16  <YUV_ROW_COPY     >;
+  packRow  [1][YUV_ROW_DECIMATE ] = xPackRow16  <YUV_ROW_DECIMATE >;
+  packRow  [1][YUV_ROW_REPLICATE] = xPackRow16  <YUV_ROW_REPLICATE>;
+
+  scaleRowUp   = xScaleRowUp;
+  scaleRowDown = xScaleRowDown;
+
+#if SIMD_X86
+  xInitSIMD( eExt );
+#endif
+}
+
+/// resampling that maps a row with horizontal chroma scale csxFrom onto one with scale csxTo
+static inline YuvRowResample getRowResample( UInt csxFrom, UInt csxTo )
+{
+  assert(csxFrom <= csxTo + 1 && csxTo <= csxFrom + 1);
+  return csxFrom < csxTo ? YUV_ROW_DECIMATE : ( csxFrom > csxTo ? YUV_ROW_REPLICATE : YUV_ROW_COPY );
+}
+
 // ====================================================================================================================
 // Local Functions
 // ====================================================================================================================
@@ -56,6 +323,7 @@ using namespace std;
  * Scale all pixels in img depending upon sign of shiftbits by a factor of
  * 2<sup>shiftbits</sup>.
  *
+ * @param kernels    row kernels used for the scaling
  * @param img        pointer to image to be transformed
  * @param stride  distance between vertically adjacent pixels of img.
  * @param width   width of active area in img.
@@ -67,30 +335,79 @@ using namespace std;
  * @param minval  minimum clipping value when dividing.
  * @param maxval  maximum clipping value when dividing.
  */
-static Void scalePlane(Pel* img, const UInt stride, const UInt width, const UInt height, Int shiftbits, Pel minval, Pel maxval)
+static Void scalePlane(const TVideoIOYuvKernels& kernels, Pel* img, const UInt stride, const UInt width, const UInt height, Int shiftbits, Pel minval, Pel maxval)
 {
   if (shiftbits > 0)
   {
     for (UInt y = 0; y < height; y++, img+=stride)
-      for (UInt x = 0; x < width; x++)
-        img[x] <<= shiftbits;
+      kernels.scaleRowUp(img, width, shiftbits, minval, maxval);
   }
   else if (shiftbits < 0)
   {
-    shiftbits=-shiftbits;
-
-    Pel rounding = 1 << (shiftbits-1);
     for (UInt y = 0; y < height; y++, img+=stride)
-      for (UInt x = 0; x < width; x++)
-        img[x] = Clip3(minval, maxval, Pel((img[x] + rounding) >> shiftbits));
+      kernels.scaleRowDown(img, width, -shiftbits, minval, maxval);
   }
 }
 
 
+/**
+ * Number of bytes a plane occupies in a file.
+ *
+ * @param is16bit    true if the file carries > 8bit data, false otherwise.
+ * @param width444   width of the luma plane.
+ * @param height444  height of the luma plane.
+ * @param compID     component of the plane.
+ * @param fileFormat chroma format of the file.
+ */
+static size_t planeFileSize(Bool is16bit, UInt width444, UInt height444, const ComponentID compID, const ChromaFormat fileFormat)
+{
+  if (compID!=COMPONENT_Y && fileFormat==CHROMA_400)
+    return 0;
+
+  const UInt stride_file = (width444 * (is16bit ? 2 : 1)) >> getComponentScaleX(compID, fileFormat);
+  return size_t(stride_file) * (height444 >> getComponentScaleY(compID, fileFormat));
+}
+
+/**
+ * Append one line of numBytes bytes to a frame in file format.
+ *
+ * @return the storage of the new line
+ */
+static inline UChar* appendLine(std::vector<UChar>& frame, size_t numBytes)
+{
+  const size_t pos = frame.size();
+  frame.resize(pos + numBytes);
+  return &frame[pos];
+}
+
+
 // ====================================================================================================================
 // Public member functions
 // ====================================================================================================================
 
+TVideoIOYuv::TVideoIOYuv()
+: m_pMappedFile( NULL )
+, m_mappedSize ( 0 )
+, m_mappedPos  ( 0 )
+, m_asyncDepth ( 0 )
+, m_pcQueue    ( NULL )
+, m_bEof       ( false )
+, m_bFail      ( false )
+{
+  m_kernels.init( getSIMDExtension() );
+}
+
+TVideoIOYuv::~TVideoIOYuv()
+{
+  delete m_pcQueue;
+#if !defined(_WIN32)
+  if ( m_pMappedFile )
+  {
+    munmap( (void*)m_pMappedFile, m_mappedSize );
+  }
+#endif
+}
+
 /**
  * Open file for reading/writing Y'CbCr frames.
  *
@@ -105,6 +422,9 @@ static Void scalePlane(Pel* img, const UInt stride, const UInt width, const UInt
  * \param bWriteMode       file open mode: true=read, false=write
  * \param fileBitDepth     bit-depth array of input/output file data.
  * \param internalBitDepth bit-depth array to scale image data to/from when reading/writing.
+ *
+ * When asynchronous I/O has been requested with setAsyncDepth(), regular
+ * input files are memory mapped instead of being read through a stream.
  */
 #if RExt__INPUT_MSB_EXTENSION
 Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[MAX_NUM_CHANNEL_TYPE], const Int MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE], const Int internalBitDepth[MAX_NUM_CHANNEL_TYPE] )
@@ -136,6 +456,11 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
     }
   }
 
+  m_bEof  = false;
+  m_bFail = false;
+
+  m_kernels.init( getSIMDExtension() );
+
   if ( bWriteMode )
   {
     m_cHandle.open( pchFile, ios::binary | ios::out );
@@ -148,6 +473,33 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
   }
   else
   {
+#if !defined(_WIN32)
+    if ( m_asyncDepth > 0 )
+    {
+      Int fd = ::open( pchFile, O_RDONLY );
+      struct stat fileStat;
+      if ( fd >= 0 && fstat( fd, &fileStat ) == 0 && S_ISREG( fileStat.st_mode ) && fileStat.st_size > 0 )
+      {
+        void* pMap = mmap( NULL, size_t( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+        if ( pMap != MAP_FAILED )
+        {
+          madvise( pMap, size_t( fileStat.st_size ), MADV_SEQUENTIAL );
+          m_pMappedFile = (const UChar*)pMap;
+          m_mappedSize  = size_t( fileStat.st_size );
+          m_mappedPos   = 0;
+        }
+      }
+      if ( fd >= 0 )
+      {
+        ::close( fd );
+      }
+      if ( m_pMappedFile )
+      {
+        return;
+      }
+    }
+#endif
+
     m_cHandle.open( pchFile, ios::binary | ios::in );
 
     if( m_cHandle.fail() )
@@ -162,24 +514,126 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
 
 Void TVideoIOYuv::close()
 {
+  if ( m_pcQueue )
+  {
+    // the writer drains its queue before the thread exits
+    delete m_pcQueue;
+    m_pcQueue = NULL;
+  }
+#if !defined(_WIN32)
+  if ( m_pMappedFile )
+  {
+    munmap( (void*)m_pMappedFile, m_mappedSize );
+    m_pMappedFile = NULL;
+    m_mappedSize  = 0;
+    m_mappedPos   = 0;
+    return;
+  }
+#endif
   m_cHandle.close();
 }
 
 Bool TVideoIOYuv::isEof()
 {
-  return m_cHandle.eof();
+  return m_bEof;
 }
 
 Bool TVideoIOYuv::isFail()
 {
-  return m_cHandle.fail();
+  return m_bFail;
+}
+
+/**
+ * Fetch the file samples of the next frame, from the mapped file, the
+ * prefetching reader or the stream.
+ *
+ * @param frameSize size of a frame in the file in bytes
+ * @return the samples of the frame, or NULL if the file ends before a full frame
+ */
+const UChar* TVideoIOYuv::xReadFrame( size_t frameSize )
+{
+  assert( frameSize > 0 );
+
+  if ( m_pMappedFile )
+  {
+    if ( m_mappedSize - m_mappedPos < frameSize )
+    {
+      m_mappedPos = m_mappedSize;
+      m_bEof = m_bFail = true;
+      return NULL;
+    }
+    const UChar* pFrame = m_pMappedFile + m_mappedPos;
+    m_mappedPos += frameSize;
+#if !defined(_WIN32)
+    // let the kernel page in the next frames while this one is being coded
+    const size_t pageMask = size_t( sysconf( _SC_PAGESIZE ) ) - 1;
+    const size_t begin    = m_mappedPos & ~pageMask;
+    const size_t end      = std::min( m_mappedSize, m_mappedPos + m_asyncDepth * frameSize );
+    if ( end > begin )
+    {
+      madvise( (void*)( m_pMappedFile + begin ), end - begin, MADV_WILLNEED );
+    }
+#endif
+    return pFrame;
+  }
+
+  if ( m_asyncDepth > 0 )
+  {
+    if ( m_pcQueue == NULL )
+    {
+      m_pcQueue = new TVideoIOYuvQueue( m_cHandle, false, m_asyncDepth, frameSize );
+    }
+    m_pcQueue->pop( m_frameBuffer );
+  }
+  else
+  {
+    m_frameBuffer.resize( frameSize );
+    m_cHandle.read( reinterpret_cast<Char*>( &m_frameBuffer[0] ), frameSize );
+    m_frameBuffer.resize( size_t( m_cHandle.gcount() ) );
+  }
+
+  if ( m_frameBuffer.size() < frameSize )
+  {
+    m_bEof = m_bFail = true;
+    return NULL;
+  }
+  return &m_frameBuffer[0];
+}
+
+/**
+ * Write the frame in m_frameBuffer to the file, or queue it for the
+ * write-behind writer.
+ *
+ * @return false if this or a previous write failed
+ */
+Bool TVideoIOYuv::xWriteFrame()
+{
+  if ( m_asyncDepth > 0 )
+  {
+    if ( m_pcQueue == NULL )
+    {
+      m_pcQueue = new TVideoIOYuvQueue( m_cHandle, true, m_asyncDepth, 0 );
+    }
+    m_pcQueue->push( m_frameBuffer );
+    m_bFail = m_bFail || m_pcQueue->hasFailed();
+  }
+  else
+  {
+    if ( !m_frameBuffer.empty() )
+    {
+      m_cHandle.write( reinterpret_cast<const Char*>( &m_frameBuffer[0] ), m_frameBuffer.size() );
+    }
+    m_bFail = m_bFail || m_cHandle.fail();
+  }
+  m_frameBuffer.clear();
+  return !m_bFail;
 }
 
 /**
  * Skip numFrames in input.
  *
  * This function correctly handles cases where the input file is not
- * seekable, by consuming bytes.
+ * seekable, by consuming bytes.  It must be called before the first read().
  */
 Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaFormat format)
 {
@@ -201,6 +655,13 @@ Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaForm
 
   const streamoff offset = frameSize * numFrames;
 
+  assert( m_pcQueue == NULL );
+  if ( m_pMappedFile )
+  {
+    m_mappedPos = size_t( std::min<streamoff>( m_mappedPos + offset, m_mappedSize ) );
+    return;
+  }
+
   /* attempt to seek */
   if (!!m_cHandle.seekg(offset, ios::cur))
     return; /* success */
@@ -217,22 +678,22 @@ Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaForm
 }
 
 /**
- * Read width*height pixels from fd into dst, optionally
+ * Read width*height pixels from the file samples at src into dst, optionally
  * padding the left and right edges by edge-extension.  Input may be
  * either 8bit or 16bit little-endian lsb-aligned words.
  *
  * @param dst     destination image
- * @param fd      input file stream
+ * @param src     file samples of the plane, advanced past the plane
  * @param is16bit true if input file carries > 8bit data, false otherwise.
  * @param stride  distance between vertically adjacent pixels of dst.
  * @param width   width of active area in dst.
  * @param height  height of active area in dst.
  * @param pad_x   length of horizontal padding.
  * @param pad_y   length of vertical padding.
- * @return true for success, false in case of error
  */
-static Bool readPlane(Pel* dst,
-                      istream& fd,
+static Void readPlane(const TVideoIOYuvKernels& kernels,
+                      Pel* dst,
+                      const UChar*& src,
                       Bool is16bit,
                       UInt stride444,
                       UInt width444,
@@ -260,8 +721,6 @@ static Bool readPlane(Pel* dst,
 
   const UInt stride_file      = (width444 * (is16bit ? 2 : 1)) >> csx_file;
 
-  UChar  *buf   = new UChar[stride_file];
-
   if (compID!=COMPONENT_Y && (fileFormat==CHROMA_400 || destFormat==CHROMA_400))
   {
     if (destFormat!=CHROMA_400)
@@ -276,66 +735,28 @@ static Bool readPlane(Pel* dst,
     if (fileFormat!=CHROMA_400)
     {
       const UInt height_file      = height444>>csy_file;
-      fd.seekg(height_file*stride_file, ios::cur);
-      if (fd.eof() || fd.fail() )
-      {
-        delete[] buf;
-        return false;
-      }
+      src += size_t(height_file)*stride_file;
     }
   }
   else
   {
     const UInt mask_y_file=(1<<csy_file)-1;
     const UInt mask_y_dest=(1<<csy_dest)-1;
+    const TVideoIOYuvKernels::UnpackRowFunc unpackRow = kernels.unpackRow[is16bit][getRowResample(csx_file, csx_dest)];
+    const UChar *buf = src;
     for(UInt y444=0; y444<height444; y444++)
     {
       if ((y444&mask_y_file)==0)
       {
         // read a new line
-        fd.read(reinterpret_cast<Char*>(buf), stride_file);
-        if (fd.eof() || fd.fail() )
-        {
-          delete[] buf;
-          return false;
-        }
+        buf  = src;
+        src += stride_file;
       }
 
       if ((y444&mask_y_dest)==0)
       {
         // process current destination line
-        if (csx_file < csx_dest)
-        {
-          // eg file is 444, dest is 422.
-          const UInt sx=csx_dest-csx_file;
-          if (!is16bit)
-          {
-            for (UInt x = 0; x < width_dest; x++)
-              dst[x] = buf[x<<sx];
-          }
-          else
-          {
-            for (UInt x = 0; x < width_dest; x++)
-            {
-              dst[x] = Pel(buf[(x<<sx)*2+0]) | (Pel(buf[(x<<sx)*2+1])<<8);
-            }
-          }
-        }
-        else
-        {
-          // eg file is 422, dest is 444.
-          const UInt sx=csx_file-csx_dest;
-          if (!is16bit)
-          {
-            for (UInt x = 0; x < width_dest; x++)
-              dst[x] = buf[x>>sx];
-          }
-          else
-          {
-            for (UInt x = 0; x < width_dest; x++)
-              dst[x] = Pel(buf[(x>>sx)*2+0]) | (Pel(buf[(x>>sx)*2+1])<<8);
-          }
-        }
+        unpackRow(dst, buf, width_dest);
 
         // process right hand side padding
         const Pel val=dst[width_dest-1];
@@ -348,25 +769,21 @@ static Bool readPlane(Pel* dst,
 
     // process lower padding
     for (UInt y = height_dest; y < full_height_dest; y++, dst+=stride_dest)
-      for (UInt x = 0; x < full_width_dest; x++)
-        dst[x] = (dst - stride_dest)[x];
+      memcpy(dst, dst - stride_dest, full_width_dest*sizeof(Pel));
   }
-  delete[] buf;
-  return true;
 }
 
 /**
- * Write width*height pixels info fd from src.
+ * Append width*height pixels from src to a frame in file format.
  *
- * @param fd      output file stream
+ * @param dst     file samples of the frame
  * @param src     source image
  * @param is16bit true if input file carries > 8bit data, false otherwise.
  * @param stride  distance between vertically adjacent pixels of src.
  * @param width   width of active area in src.
  * @param height  height of active area in src.
- * @return true for success, false in case of error
  */
-static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
+static Void writePlane(const TVideoIOYuvKernels& kernels, std::vector<UChar>& dst, Pel* src, Bool is16bit,
                        UInt stride444,
                        UInt width444, UInt height444,
                        const ComponentID compID,
@@ -385,8 +802,6 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
   const UInt width_file       = width444 >>csx_file;
   const UInt height_file      = height444>>csy_file;
 
-  UChar  *buf   = new UChar[stride_file];
-
   if (compID!=COMPONENT_Y && (fileFormat==CHROMA_400 || srcFormat==CHROMA_400))
   {
     if (fileFormat!=CHROMA_400)
@@ -395,6 +810,7 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
 
       for(UInt y=0; y< height_file; y++)
       {
+        UChar *buf = appendLine(dst, stride_file);
         if (!is16bit)
         {
           UChar val(value);
@@ -410,13 +826,6 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
             buf[2*x+1]= (val>>8) & 0xff;
           }
         }
-
-        fd.write(reinterpret_cast<Char*>(buf), stride_file);
-        if (fd.eof() || fd.fail() )
-        {
-          delete[] buf;
-          return false;
-        }
       }
     }
   }
@@ -424,58 +833,13 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
   {
     const UInt mask_y_file=(1<<csy_file)-1;
     const UInt mask_y_src =(1<<csy_src )-1;
+    const TVideoIOYuvKernels::PackRowFunc packRow = kernels.packRow[is16bit][getRowResample(csx_src, csx_file)];
     for(UInt y444=0; y444<height444; y444++)
     {
       if ((y444&mask_y_file)==0)
       {
         // write a new line
-        if (csx_file < csx_src)
-        {
-          // eg file is 444, source is 422.
-          const UInt sx=csx_src-csx_file;
-          if (!is16bit)
-          {
-            for (UInt x = 0; x < width_file; x++)
-            {
-              buf[x] = (UChar)(src[x>>sx]);
-            }
-          }
-          else
-          {
-            for (UInt x = 0; x < width_file; x++)
-            {
-              buf[2*x  ] = (src[x>>sx]>>0) & 0xff;
-              buf[2*x+1] = (src[x>>sx]>>8) & 0xff;
-            }
-          }
-        }
-        else
-        {
-          // eg file is 422, src is 444.
-          const UInt sx=csx_file-csx_src;
-          if (!is16bit)
-          {
-            for (UInt x = 0; x < width_file; x++)
-            {
-              buf[x] = (UChar)(src[x<<sx]);
-            }
-          }
-          else
-          {
-            for (UInt x = 0; x < width_file; x++)
-            {
-              buf[2*x  ] = (src[x<<sx]>>0) & 0xff;
-              buf[2*x+1] = (src[x<<sx]>>8) & 0xff;
-            }
-          }
-        }
-
-        fd.write(reinterpret_cast<Char*>(buf), stride_file);
-        if (fd.eof() || fd.fail() )
-        {
-          delete[] buf;
-          return false;
-        }
+        packRow(appendLine(dst, stride_file), src, width_file);
       }
 
       if ((y444&mask_y_src)==0)
@@ -485,11 +849,9 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
 
     }
   }
-  delete[] buf;
-  return true;
 }
 
-static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
+static Void writeField(const TVideoIOYuvKernels& kernels, std::vector<UChar>& dst, Pel* top, Pel* bottom, Bool is16bit,
                        UInt stride444,
                        UInt width444, UInt height444,
                        const ComponentID compID,
@@ -508,8 +870,6 @@ static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
   const UInt width_file       = width444 >>csx_file;
   const UInt height_file      = height444>>csy_file;
 
-  UChar  *buf   = new UChar[stride_file * 2];
-
   if (compID!=COMPONENT_Y && (fileFormat==CHROMA_400 || srcFormat==CHROMA_400))
   {
     if (fileFormat!=CHROMA_400)
@@ -518,6 +878,7 @@ static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
 
       for(UInt y=0; y< height_file; y++)
       {
+        UChar *buf = appendLine(dst, stride_file * 2);
         for (UInt field = 0; field < 2; field++)
         {
           UChar *fieldBuffer = buf + (field * stride_file);
@@ -538,13 +899,6 @@ static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
             }
           }
         }
-
-        fd.write(reinterpret_cast<Char*>(buf), (stride_file * 2));
-        if (fd.eof() || fd.fail() )
-        {
-          delete[] buf;
-          return false;
-        }
       }
     }
   }
@@ -552,63 +906,19 @@ static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
   {
     const UInt mask_y_file=(1<<csy_file)-1;
     const UInt mask_y_src =(1<<csy_src )-1;
+    const TVideoIOYuvKernels::PackRowFunc packRow = kernels.packRow[is16bit][getRowResample(csx_src, csx_file)];
     for(UInt y444=0; y444<height444; y444++)
     {
       if ((y444&mask_y_file)==0)
       {
+        UChar *buf = appendLine(dst, stride_file * 2);
         for (UInt field = 0; field < 2; field++)
         {
           UChar *fieldBuffer = buf + (field * stride_file);
           Pel   *src         = (((field == 0) && isTff) || ((field == 1) && (!isTff))) ? top : bottom;
 
           // write a new line
-          if (csx_file < csx_src)
-          {
-            // eg file is 444, source is 422.
-            const UInt sx=csx_src-csx_file;
-            if (!is16bit)
-            {
-              for (UInt x = 0; x < width_file; x++)
-              {
-                fieldBuffer[x] = (UChar)(src[x>>sx]);
-              }
-            }
-            else
-            {
-              for (UInt x = 0; x < width_file; x++)
-              {
-                fieldBuffer[2*x  ] = (src[x>>sx]>>0) & 0xff;
-                fieldBuffer[2*x+1] = (src[x>>sx]>>8) & 0xff;
-              }
-            }
-          }
-          else
-          {
-            // eg file is 422, src is 444.
-            const UInt sx=csx_file-csx_src;
-            if (!is16bit)
-            {
-              for (UInt x = 0; x < width_file; x++)
-              {
-                fieldBuffer[x] = (UChar)(src[x<<sx]);
-              }
-            }
-            else
-            {
-              for (UInt x = 0; x < width_file; x++)
-              {
-                fieldBuffer[2*x  ] = (src[x<<sx]>>0) & 0xff;
-                fieldBuffer[2*x+1] = (src[x<<sx]>>8) & 0xff;
-              }
-            }
-          }
-        }
-
-        fd.write(reinterpret_cast<Char*>(buf), (stride_file * 2));
-        if (fd.eof() || fd.fail() )
-        {
-          delete[] buf;
-          return false;
+          packRow(fieldBuffer, src, width_file);
         }
       }
 
@@ -620,8 +930,6 @@ static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
 
     }
   }
-  delete[] buf;
-  return true;
 }
 
 /**
@@ -663,6 +971,17 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
   const UInt width444       = width_full444 - pad_h444;
   const UInt height444      = height_full444 - pad_v444;
 
+  size_t frameSize = 0;
+  for(UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
+  {
+    frameSize += planeFileSize(is16bit, width444, height444, ComponentID(comp), format);
+  }
+  const UChar *src = xReadFrame(frameSize);
+  if (src == NULL)
+  {
+    return false;
+  }
+
   for(UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
   {
     const ComponentID compID = ComponentID(comp);
@@ -683,16 +1002,13 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
     const Pel maxval = b709Compliance? ((0xff << (desired_bitdepth - 8)) -1) : (1 << desired_bitdepth) - 1;
 #endif
 
-    if (! readPlane(pPicYuv->getAddr(compID), m_cHandle, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType]))
-    {
-      return false;
-    }
+    readPlane(m_kernels, pPicYuv->getAddr(compID), src, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType]);
 
     if (compID < pPicYuv->getNumberValidComponents() )
     {
       const UInt csx=getComponentScaleX(compID, pPicYuv->getChromaFormat());
       const UInt csy=getComponentScaleY(compID, pPicYuv->getChromaFormat());
-      scalePlane(pPicYuv->getAddr(compID), stride444>>csx, width_full444>>csx, height_full444>>csy, m_bitdepthShift[chType], minval, maxval);
+      scalePlane(m_kernels, pPicYuv->getAddr(compID), stride444>>csx, width_full444>>csx, height_full444>>csy, m_bitdepthShift[chType], minval, maxval);
     }
   }
 
@@ -784,7 +1100,7 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUser, const InputColourSpaceConversi
 #endif
 #endif
 
-      scalePlane(dstPicYuv->getAddr(compID), dstPicYuv->getStride(compID), dstPicYuv->getWidth(compID), dstPicYuv->getHeight(compID), -m_bitdepthShift[ch], minval, maxval);
+      scalePlane(m_kernels, dstPicYuv->getAddr(compID), dstPicYuv->getStride(compID), dstPicYuv->getWidth(compID), dstPicYuv->getHeight(compID), -m_bitdepthShift[ch], minval, maxval);
     }
   }
   else
@@ -792,18 +1108,17 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUser, const InputColourSpaceConversi
     dstPicYuv = pPicYuv;
   }
 
-  for(UInt comp=0; retval && comp<dstPicYuv->getNumberValidComponents(); comp++)
+  m_frameBuffer.clear();
+  for(UInt comp=0; comp<dstPicYuv->getNumberValidComponents(); comp++)
   {
     const ComponentID compID = ComponentID(comp);
     const ChannelType ch=toChannelType(compID);
     const UInt csx = pPicYuv->getComponentScaleX(compID);
     const UInt csy = pPicYuv->getComponentScaleY(compID);
     const Int planeOffset =  (confLeft>>csx) + (confTop>>csy) * pPicYuv->getStride(compID);
-    if (! writePlane(m_cHandle, dstPicYuv->getAddr(compID) + planeOffset, is16bit, iStride444, width444, height444, compID, dstPicYuv->getChromaFormat(), format, m_fileBitdepth[ch]))
-    {
-      retval=false;
-    }
+    writePlane(m_kernels, m_frameBuffer, dstPicYuv->getAddr(compID) + planeOffset, is16bit, iStride444, width444, height444, compID, dstPicYuv->getChromaFormat(), format, m_fileBitdepth[ch]);
   }
+  retval = xWriteFrame();
 
   if (nonZeroBitDepthShift)
   {
@@ -890,7 +1205,7 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUserTop, TComPicYuv* pPicYuvUserBott
 #endif
 #endif
 
-        scalePlane(dstPicYuv->getAddr(compID), dstPicYuv->getStride(compID), dstPicYuv->getWidth(compID), dstPicYuv->getHeight(compID), -m_bitdepthShift[ch], minval, maxval);
+        scalePlane(m_kernels, dstPicYuv->getAddr(compID), dstPicYuv->getStride(compID), dstPicYuv->getWidth(compID), dstPicYuv->getHeight(compID), -m_bitdepthShift[ch], minval, maxval);
       }
     }
     else
@@ -907,7 +1222,8 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUserTop, TComPicYuv* pPicYuvUserBott
   assert(dstPicYuvTop->getHeight(COMPONENT_Y)     == dstPicYuvBottom->getHeight(COMPONENT_Y)    );
   assert(dstPicYuvTop->getStride(COMPONENT_Y)     == dstPicYuvBottom->getStride(COMPONENT_Y)    );
 
-  for(UInt comp=0; retval && comp<dstPicYuvTop->getNumberValidComponents(); comp++)
+  m_frameBuffer.clear();
+  for(UInt comp=0; comp<dstPicYuvTop->getNumberValidComponents(); comp++)
   {
     const ComponentID compID = ComponentID(comp);
     const ChannelType ch=toChannelType(compID);
@@ -924,16 +1240,14 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuvUserTop, TComPicYuv* pPicYuvUserBott
     const Int planeOffsetTop    = (confLeft>>csx) + ( (confTop>>csy)      >> 1) * dstPicYuvTop->getStride(compID); //offset is for entire frame - round up for top field and down for bottom field
     const Int planeOffsetBottom = (confLeft>>csx) + (((confTop>>csy) + 1) >> 1) * dstPicYuvTop->getStride(compID); //offset is for entire frame - round up for top field and down for bottom field
 
-    if (! writeField(m_cHandle,
-                     (dstPicYuvTop   ->getAddr(compID) + planeOffsetTop),
-                     (dstPicYuvBottom->getAddr(compID) + planeOffsetBottom),
-                     is16bit,
-                     dstPicYuvTop->getStride(COMPONENT_Y),
-                     width444, height444, compID, dstPicYuvTop->getChromaFormat(), format, m_fileBitdepth[ch], isTff))
-    {
-      retval=false;
-    }
+    writeField(m_kernels, m_frameBuffer,
+               (dstPicYuvTop   ->getAddr(compID) + planeOffsetTop),
+               (dstPicYuvBottom->getAddr(compID) + planeOffsetBottom),
+               is16bit,
+               dstPicYuvTop->getStride(COMPONENT_Y),
+               width444, height444, compID, dstPicYuvTop->getChromaFormat(), format, m_fileBitdepth[ch], isTff);
   }
+  retval = xWriteFrame();
 
   if (nonZeroBitDepthShift)
   {
@@ -41,8 +41,10 @@
 #include <stdio.h>
 #include <fstream>
 #include <iostream>
+#include <vector>
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComSIMD.h"
 
 using namespace std;
 
@@ -50,20 +52,62 @@ using namespace std;
 // Class definition
 // ====================================================================================================================
 
+class TVideoIOYuvQueue;
+
+/// horizontal resampling applied while converting a row between the file and the picture chroma formats
+enum YuvRowResample
+{
+  YUV_ROW_COPY                = 0,     ///< same horizontal resolution
+  YUV_ROW_DECIMATE            = 1,     ///< keep every second sample (eg file is 444, picture is 422)
+  YUV_ROW_REPLICATE           = 2,     ///< repeat every sample      (eg file is 422, picture is 444)
+  NUMBER_OF_YUV_ROW_RESAMPLES = 3
+};
+
+/// row kernels converting between file samples (8-bit, or 16-bit little endian) and Pel, and scaling the bit depth.
+/// The plain C kernels are in TVideoIOYuv.cpp, the SSE4.1 / AVX2 kernels in TVideoIOYuvSIMD.cpp.
+struct TVideoIOYuvKernels
+{
+  typedef Void (*UnpackRowFunc)( Pel* dst, const UChar* src, UInt width );
+  typedef Void (*PackRowFunc  )( UChar* dst, const Pel* src, UInt width );
+  typedef Void (*ScaleRowFunc )( Pel* img, UInt width, Int shift, Pel minval, Pel maxval );
+
+  UnpackRowFunc unpackRow[2][NUMBER_OF_YUV_ROW_RESAMPLES]; ///< [is16bit][resample], writes width Pel
+  PackRowFunc   packRow  [2][NUMBER_OF_YUV_ROW_RESAMPLES]; ///< [is16bit][resample], writes width file samples
+  ScaleRowFunc  scaleRowUp;                                ///< img <<= shift
+  ScaleRowFunc  scaleRowDown;                              ///< img = Clip3(minval, maxval, (img + rounding) >> shift)
+
+  Void init     ( SIMDExtension eExt );
+#if SIMD_X86
+  Void xInitSIMD( SIMDExtension eExt );
+#endif
+};
+
 /// YUV file I/O class
 class TVideoIOYuv
 {
 private:
   fstream   m_cHandle;                                      ///< file handle
+  const UChar* m_pMappedFile;                               ///< memory mapped input file, or NULL when reading through m_cHandle
+  size_t    m_mappedSize;                                   ///< size of m_pMappedFile in bytes
+  size_t    m_mappedPos;                                    ///< read position in m_pMappedFile
+  UInt      m_asyncDepth;                                   ///< number of frames buffered by the I/O thread, 0 for synchronous I/O
+  TVideoIOYuvQueue* m_pcQueue;                              ///< prefetching reader or write-behind writer, started by the first read/write
+  std::vector<UChar> m_frameBuffer;                         ///< file samples of the frame being converted
+  Bool      m_bEof;                                         ///< a read came up short of a full frame
+  Bool      m_bFail;                                        ///< a read or write failed
   Int       m_fileBitdepth[MAX_NUM_CHANNEL_TYPE]; ///< bitdepth of input/output video file
 #if RExt__INPUT_MSB_EXTENSION
   Int       m_MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE];  ///< bitdepth after addition of MSBs (with value 0)
 #endif
   Int       m_bitdepthShift[MAX_NUM_CHANNEL_TYPE];  ///< number of bits to increase or decrease image by before/after write/read
+  TVideoIOYuvKernels m_kernels;                             ///< sample conversion kernels, selected by open()
+
+  const UChar* xReadFrame ( size_t frameSize );            ///< fetch the file samples of the next frame, NULL at end-of-file
+  Bool      xWriteFrame   ();                               ///< hand m_frameBuffer over to the file
 
 public:
-  TVideoIOYuv()           {}
-  virtual ~TVideoIOYuv()  {}
+  TVideoIOYuv();
+  virtual ~TVideoIOYuv();
 
 #if RExt__INPUT_MSB_EXTENSION
   Void  open  ( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[MAX_NUM_CHANNEL_TYPE], const Int MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE], const Int internalBitDepth[MAX_NUM_CHANNEL_TYPE] ); ///< open or create file
@@ -72,6 +116,8 @@ public:
 #endif
   Void  close ();                                           ///< close file
 
+  Void  setAsyncDepth ( UInt depth ) { m_asyncDepth = depth; } ///< read ahead / write behind up to depth frames on an I/O thread (0: synchronous), set before open()
+
   Void skipFrames(UInt numFrames, UInt width, UInt height, ChromaFormat format);
 
   // if fileFormat<NUM_CHROMA_FORMAT, the format of the file is that format specified, else it is the format of the TComPicYuv.
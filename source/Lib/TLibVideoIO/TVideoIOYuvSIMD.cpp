@@ -0,0 +1,338 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2013, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TVideoIOYuvSIMD.cpp
+    \brief    SSE4.1 / AVX2 sample conversion kernels for TVideoIOYuv
+    \note     All kernels are bit-exact with the plain C versions in TVideoIOYuv.cpp: 8-bit packing keeps the low byte
+              of each sample, and the rounding right shift is evaluated in 32-bit lanes before clipping. As SIMD_X86
+              implies a little endian target with 16-bit Pel, 16-bit file samples are stored exactly as Pel in memory.
+              The vector loops stop before reading past the end of the row and leave the remaining samples to a
+              scalar loop.
+*/
+
+#include "TVideoIOYuv.h"
+
+#if SIMD_X86
+
+#include <immintrin.h>
+
+// ====================================================================================================================
+// Unpack (file samples to Pel)
+// ====================================================================================================================
+
+static SIMD_TARGET_SSE41 Void xUnpackRow8_SSE41( Pel* dst, const UChar* src, UInt width )
+{
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i v = _mm_loadu_si128( (const __m128i*)( src + x ) );
+    _mm_storeu_si128( (__m128i*)( dst + x     ), _mm_cvtepu8_epi16( v ) );
+    _mm_storeu_si128( (__m128i*)( dst + x + 8 ), _mm_cvtepu8_epi16( _mm_srli_si128( v, 8 ) ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = src[x];
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xUnpackRow8Decimate_SSE41( Pel* dst, const UChar* src, UInt width )
+{
+  const __m128i lowByte = _mm_set1_epi16( 0x00ff );
+  UInt x = 0;
+  for ( ; x + 8 <= width; x += 8 )
+  {
+    _mm_storeu_si128( (__m128i*)( dst + x ), _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + 2*x ) ), lowByte ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = src[x << 1];
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xUnpackRow8Replicate_SSE41( Pel* dst, const UChar* src, UInt width )
+{
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i v = _mm_cvtepu8_epi16( _mm_loadl_epi64( (const __m128i*)( src + ( x >> 1 ) ) ) );
+    _mm_storeu_si128( (__m128i*)( dst + x     ), _mm_unpacklo_epi16( v, v ) );
+    _mm_storeu_si128( (__m128i*)( dst + x + 8 ), _mm_unpackhi_epi16( v, v ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = src[x >> 1];
+  }
+}
+
+static Void xUnpackRow16_SIMD( Pel* dst, const UChar* src, UInt width )
+{
+  memcpy( dst, src, width * sizeof( Pel ) );
+}
+
+static SIMD_TARGET_SSE41 Void xUnpackRow16Decimate_SSE41( Pel* dst, const UChar* src, UInt width )
+{
+  const Pel*    srcPel  = (const Pel*)src;
+  const __m128i lowWord = _mm_set1_epi32( 0xffff );
+  UInt x = 0;
+  for ( ; x + 8 <= width; x += 8 )
+  {
+    const __m128i a = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( srcPel + 2*x     ) ), lowWord );
+    const __m128i b = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( srcPel + 2*x + 8 ) ), lowWord );
+    _mm_storeu_si128( (__m128i*)( dst + x ), _mm_packus_epi32( a, b ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = srcPel[x << 1];
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xUnpackRow16Replicate_SSE41( Pel* dst, const UChar* src, UInt width )
+{
+  const Pel* srcPel = (const Pel*)src;
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i v = _mm_loadu_si128( (const __m128i*)( srcPel + ( x >> 1 ) ) );
+    _mm_storeu_si128( (__m128i*)( dst + x     ), _mm_unpacklo_epi16( v, v ) );
+    _mm_storeu_si128( (__m128i*)( dst + x + 8 ), _mm_unpackhi_epi16( v, v ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = srcPel[x >> 1];
+  }
+}
+
+static SIMD_TARGET_AVX2 Void xUnpackRow8_AVX2( Pel* dst, const UChar* src, UInt width )
+{
+  UInt x = 0;
+  for ( ; x + 32 <= width; x += 32 )
+  {
+    _mm256_storeu_si256( (__m256i*)( dst + x      ), _mm256_cvtepu8_epi16( _mm_loadu_si128( (const __m128i*)( src + x      ) ) ) );
+    _mm256_storeu_si256( (__m256i*)( dst + x + 16 ), _mm256_cvtepu8_epi16( _mm_loadu_si128( (const __m128i*)( src + x + 16 ) ) ) );
+  }
+  xUnpackRow8_SSE41( dst + x, src + x, width - x );
+}
+
+// ====================================================================================================================
+// Pack (Pel to file samples)
+// ====================================================================================================================
+
+static SIMD_TARGET_SSE41 Void xPackRow8_SSE41( UChar* dst, const Pel* src, UInt width )
+{
+  const __m128i lowByte = _mm_set1_epi16( 0x00ff );
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i a = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + x     ) ), lowByte );
+    const __m128i b = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + x + 8 ) ), lowByte );
+    _mm_storeu_si128( (__m128i*)( dst + x ), _mm_packus_epi16( a, b ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = (UChar)( src[x] );
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xPackRow8Decimate_SSE41( UChar* dst, const Pel* src, UInt width )
+{
+  const __m128i lowByte = _mm_set1_epi32( 0x000000ff );
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i a = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + 2*x      ) ), lowByte );
+    const __m128i b = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + 2*x +  8 ) ), lowByte );
+    const __m128i c = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + 2*x + 16 ) ), lowByte );
+    const __m128i d = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + 2*x + 24 ) ), lowByte );
+    _mm_storeu_si128( (__m128i*)( dst + x ), _mm_packus_epi16( _mm_packus_epi32( a, b ), _mm_packus_epi32( c, d ) ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = (UChar)( src[x << 1] );
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xPackRow8Replicate_SSE41( UChar* dst, const Pel* src, UInt width )
+{
+  const __m128i lowByte = _mm_set1_epi16( 0x00ff );
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i v = _mm_and_si128( _mm_loadu_si128( (const __m128i*)( src + ( x >> 1 ) ) ), lowByte );
+    const __m128i p = _mm_packus_epi16( v, v );
+    _mm_storeu_si128( (__m128i*)( dst + x ), _mm_unpacklo_epi8( p, p ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    dst[x] = (UChar)( src[x >> 1] );
+  }
+}
+
+static Void xPackRow16_SIMD( UChar* dst, const Pel* src, UInt width )
+{
+  memcpy( dst, src, width * sizeof( Pel ) );
+}
+
+static SIMD_TARGET_SSE41 Void xPackRow16Decimate_SSE41( UChar* dst, const Pel* src, UInt width )
+{
+  xUnpackRow16Decimate_SSE41( (Pel*)dst, (const UChar*)src, width );
+}
+
+static SIMD_TARGET_SSE41 Void xPackRow16Replicate_SSE41( UChar* dst, const Pel* src, UInt width )
+{
+  xUnpackRow16Replicate_SSE41( (Pel*)dst, (const UChar*)src, width );
+}
+
+static SIMD_TARGET_AVX2 Void xPackRow8_AVX2( UChar* dst, const Pel* src, UInt width )
+{
+  const __m256i lowByte = _mm256_set1_epi16( 0x00ff );
+  UInt x = 0;
+  for ( ; x + 32 <= width; x += 32 )
+  {
+    const __m256i a = _mm256_and_si256( _mm256_loadu_si256( (const __m256i*)( src + x      ) ), lowByte );
+    const __m256i b = _mm256_and_si256( _mm256_loadu_si256( (const __m256i*)( src + x + 16 ) ), lowByte );
+    // packus interleaves the 128-bit lanes of a and b, restore the sample order
+    _mm256_storeu_si256( (__m256i*)( dst + x ), _mm256_permute4x64_epi64( _mm256_packus_epi16( a, b ), 0xD8 ) );
+  }
+  xPackRow8_SSE41( dst + x, src + x, width - x );
+}
+
+// ====================================================================================================================
+// Bit depth scaling
+// ====================================================================================================================
+
+static SIMD_TARGET_SSE41 Void xScaleRowUp_SSE41( Pel* img, UInt width, Int shift, Pel, Pel )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  UInt x = 0;
+  for ( ; x + 8 <= width; x += 8 )
+  {
+    _mm_storeu_si128( (__m128i*)( img + x ), _mm_sll_epi16( _mm_loadu_si128( (const __m128i*)( img + x ) ), vShift ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    img[x] <<= shift;
+  }
+}
+
+static SIMD_TARGET_SSE41 Void xScaleRowDown_SSE41( Pel* img, UInt width, Int shift, Pel minval, Pel maxval )
+{
+  const Pel     rounding = 1 << ( shift - 1 );
+  const __m128i vRound   = _mm_set1_epi32( rounding );
+  const __m128i vShift   = _mm_cvtsi32_si128( shift );
+  const __m128i vMin     = _mm_set1_epi16( minval );
+  const __m128i vMax     = _mm_set1_epi16( maxval );
+  UInt x = 0;
+  for ( ; x + 8 <= width; x += 8 )
+  {
+    const __m128i v  = _mm_loadu_si128( (const __m128i*)( img + x ) );
+    const __m128i lo = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( v ),                     vRound ), vShift );
+    const __m128i hi = _mm_sra_epi32( _mm_add_epi32( _mm_cvtepi16_epi32( _mm_srli_si128( v, 8 ) ), vRound ), vShift );
+    _mm_storeu_si128( (__m128i*)( img + x ), _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( lo, hi ), vMin ), vMax ) );
+  }
+  for ( ; x < width; x++ )
+  {
+    img[x] = Clip3( minval, maxval, Pel( ( img[x] + rounding ) >> shift ) );
+  }
+}
+
+static SIMD_TARGET_AVX2 Void xScaleRowUp_AVX2( Pel* img, UInt width, Int shift, Pel minval, Pel maxval )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    _mm256_storeu_si256( (__m256i*)( img + x ), _mm256_sll_epi16( _mm256_loadu_si256( (const __m256i*)( img + x ) ), vShift ) );
+  }
+  xScaleRowUp_SSE41( img + x, width - x, shift, minval, maxval );
+}
+
+static SIMD_TARGET_AVX2 Void xScaleRowDown_AVX2( Pel* img, UInt width, Int shift, Pel minval, Pel maxval )
+{
+  const __m256i vRound = _mm256_set1_epi32( 1 << ( shift - 1 ) );
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  const __m256i vMin   = _mm256_set1_epi16( minval );
+  const __m256i vMax   = _mm256_set1_epi16( maxval );
+  UInt x = 0;
+  for ( ; x + 16 <= width; x += 16 )
+  {
+    const __m128i a  = _mm_loadu_si128( (const __m128i*)( img + x     ) );
+    const __m128i b  = _mm_loadu_si128( (const __m128i*)( img + x + 8 ) );
+    const __m256i lo = _mm256_sra_epi32( _mm256_add_epi32( _mm256_cvtepi16_epi32( a ), vRound ), vShift );
+    const __m256i hi = _mm256_sra_epi32( _mm256_add_epi32( _mm256_cvtepi16_epi32( b ), vRound ), vShift );
+    // packs works per 128-bit lane, restore the sample order
+    const __m256i v  = _mm256_permute4x64_epi64( _mm256_packs_epi32( lo, hi ), 0xD8 );
+    _mm256_storeu_si256( (__m256i*)( img + x ), _mm256_min_epi16( _mm256_max_epi16( v, vMin ), vMax ) );
+  }
+  xScaleRowDown_SSE41( img + x, width - x, shift, minval, maxval );
+}
+
+// ====================================================================================================================
+// Kernel selection
+// ====================================================================================================================
+
+/** replace the plain C kernels with the best kernels available for eExt
+ * \param eExt  SIMD extension supported by the CPU
+ */
+Void TVideoIOYuvKernels::xInitSIMD( SIMDExtension eExt )
+{
+  if ( eExt >= SIMD_SSE41 )
+  {
+    unpackRow[0][YUV_ROW_COPY     ] = xUnpackRow8_SSE41;
+    unpackRow[0][YUV_ROW_DECIMATE ] = xUnpackRow8Decimate_SSE41;
+    unpackRow[0][YUV_ROW_REPLICATE] = xUnpackRow8Replicate_SSE41;
+    unpackRow[1][YUV_ROW_COPY     ] = xUnpackRow16_SIMD;
+    unpackRow[1][YUV_ROW_DECIMATE ] = xUnpackRow16Decimate_SSE41;
+    unpackRow[1][YUV_ROW_REPLICATE] = xUnpackRow16Replicate_SSE41;
+
+    packRow  [0][YUV_ROW_COPY     ] = xPackRow8_SSE41;
+    packRow  [0][YUV_ROW_DECIMATE ] = xPackRow8Decimate_SSE41;
+    packRow  [0][YUV_ROW_REPLICATE] = xPackRow8Replicate_SSE41;
+    packRow  [1][YUV_ROW_COPY     ] = xPackRow16_SIMD;
+    packRow  [1][YUV_ROW_DECIMATE ] = xPackRow16Decimate_SSE41;
+    packRow  [1][YUV_ROW_REPLICATE] = xPackRow16Replicate_SSE41;
+
+    scaleRowUp   = xScaleRowUp_SSE41;
+    scaleRowDown = xScaleRowDown_SSE41;
+  }
+
+  if ( eExt >= SIMD_AVX2 )
+  {
+    unpackRow[0][YUV_ROW_COPY     ] = xUnpackRow8_AVX2;
+    packRow  [0][YUV_ROW_COPY     ] = xPackRow8_AVX2;
+
+    scaleRowUp   = xScaleRowUp_AVX2;
+    scaleRowDown = xScaleRowDown_AVX2;
+  }
+}
+
+#endif // SIMD_X86